@@ -1,8 +1,17 @@
 #include "Application.h"
 #include "Window.h"
 #include "CommandQueue.h"
+#include "FrameScheduler.h"
+#include "JobSystem.h"
 #include "Game.h"
 
+#if PLATFORM_D3D12
+#include "AssetStreamer.h"
+#include "CopyStreamingBackend.h"
+#include "HeapAllocator.h"
+#include "ResourceBarriers.h"
+#endif
+
 // STL Headers
 #include <algorithm>
 #include <cassert>
@@ -10,18 +19,58 @@
 
 APPLICATION* APPLICATION::g_application = nullptr;
 
+#if PLATFORM_D3D12
+// Shader visible CBV_SRV_UAV heap, descriptor tables of the frames in flight
+const uint32_t g_dynamicDescriptorCount = 4096;
+
+// Staging memory of the asset streamer, filled by half while the other half is copied
+const uint64_t g_streamingStagingSize = 16 * 1024 * 1024;
+
 // DirectX12 initiliazing function headers
 ComPtr<ID3D12Device2> CreateDevice(ComPtr<IDXGIAdapter4> adapter);
 ComPtr<IDXGIAdapter4> GetAdapter(bool useWarp);
+#endif
+
 APPLICATION::APPLICATION()
 {
+    _jobSystem = new JOB_SYSTEM();
+
+#if PLATFORM_NULL
+    _device = new NULL_DEVICE();
+#endif
 }
 
 APPLICATION::~APPLICATION()
 {
-    delete _commandQueue;
+    // The scheduler waits on the direct queue fence, delete it first.
+    delete _frameScheduler;
+    delete _jobSystem;
+
+#if PLATFORM_D3D12
+    // Waits for the copies in flight, the backend submits on the copy queue.
+    delete _assetStreamer;
+    delete _streamingBackend;
+#endif
+
+    for (auto queueIt : _commandQueues)
+    {
+        delete queueIt.second;
+    }
+
+#if PLATFORM_D3D12
+    // Destroying the queues runs their pending deferred releases, which free placed resources and descriptors.
+    delete _heapAllocator;
+    delete _gpuDescriptorHeap;
+    for (DESCRIPTOR_ALLOCATOR* descriptorAllocator : _descriptorAllocators)
+    {
+        delete descriptorAllocator;
+    }
+#else
+    delete _device;
+#endif
 }
 
+#if PLATFORM_D3D12
 APPLICATION* APPLICATION::CreateInstance(HINSTANCE hInstance)
 { 
 	if (g_application == nullptr) 
@@ -31,6 +80,16 @@ APPLICATION* APPLICATION::CreateInstance(HINSTANCE hInstance)
 	}
 	return g_application; 
 }
+#else
+APPLICATION* APPLICATION::CreateInstance()
+{
+    if (g_application == nullptr)
+    {
+        g_application = new APPLICATION();
+    }
+    return g_application;
+}
+#endif
 
 void APPLICATION::DeleteInstance()
 {
@@ -44,6 +103,7 @@ APPLICATION* APPLICATION::Instance()
 }
 
 
+#if PLATFORM_D3D12
 WINDOW* APPLICATION::CreateRenderWindow(const wstring& name, int width, int height, bool vSync)
 {
     // Create Window
@@ -53,8 +113,20 @@ WINDOW* APPLICATION::CreateRenderWindow(const wstring& name, int width, int heig
     ComPtr<IDXGIAdapter4> dxgiAdapter4 = GetAdapter(newWindow->GetIsWarp());
 
     _device = CreateDevice(dxgiAdapter4);
+    InitializeResourceBarriers(_device.Get(), _useLegacyBarriers == false);
+    _heapAllocator = new HEAP_ALLOCATOR(_device);
+
+    for (int type = 0; type < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; ++type)
+    {
+        _descriptorAllocators[type] = new DESCRIPTOR_ALLOCATOR(_device, static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(type));
+    }
+
+    _commandQueue = GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    _frameScheduler = new FRAME_SCHEDULER(&_commandQueue->GetFence(), _framesInFlight);
+    _gpuDescriptorHeap = new GPU_DESCRIPTOR_HEAP(_device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, _commandQueue, g_dynamicDescriptorCount);
 
-    _commandQueue = new COMMAND_QUEUE(_device, D3D12_COMMAND_LIST_TYPE_DIRECT);
+    _streamingBackend = new COPY_STREAMING_BACKEND(_device, GetCommandQueue(D3D12_COMMAND_LIST_TYPE_COPY), g_streamingStagingSize);
+    _assetStreamer = new ASSET_STREAMER(_streamingBackend);
 
     newWindow->CreateSwapChain(_device, _commandQueue->GetCommandQueue());
     newWindow->UpdateRenderTargetViews();
@@ -65,6 +137,11 @@ WINDOW* APPLICATION::CreateRenderWindow(const wstring& name, int width, int heig
     return newWindow;
 }
 
+DESCRIPTOR_ALLOCATION APPLICATION::AllocateDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t count)
+{
+    return _descriptorAllocators[type]->Allocate(count);
+}
+
 void APPLICATION::ParseCommandLineArguments()
 {
     int argc;
@@ -86,11 +163,39 @@ void APPLICATION::ParseCommandLineArguments()
         {
             _useWarp = true;
         }
+
+        if (::wcscmp(argv[i], L"--legacy-barriers") == 0)
+        {
+            _useLegacyBarriers = true;
+        }
+
+        if (::wcscmp(argv[i], L"-f") == 0 || ::wcscmp(argv[i], L"--frames") == 0)
+        {
+            SetFramesInFlight(::wcstol(argv[++i], nullptr, 10));
+        }
     }
 
     // Free memory allocated by CommandLineToArgvW
     ::LocalFree(argv);
 }
+#else
+WINDOW* APPLICATION::CreateRenderWindow(const wstring& name, int width, int height, bool vSync)
+{
+    WINDOW* newWindow = new WINDOW(name, width, height, vSync);
+
+    if (_commandQueue == nullptr)
+    {
+        _commandQueue = GetCommandQueue(NULL_COMMAND_LIST_TYPE_DIRECT);
+        _frameScheduler = new FRAME_SCHEDULER(&_commandQueue->GetFence(), _framesInFlight);
+    }
+
+    newWindow->SetIsInitialized();
+
+    WINDOW::gs_Windows.push_back(newWindow);
+
+    return newWindow;
+}
+#endif
 
 void APPLICATION::Update()
 {
@@ -107,10 +212,12 @@ void APPLICATION::Update()
     elapsedSeconds += deltaTime.count() * 1e-9;
     if (elapsedSeconds > 1.0)
     {
+#if PLATFORM_D3D12
         wchar_t buffer[500] = {};
         auto fps = frameCounter / elapsedSeconds;
         swprintf_s(&buffer[0], 500, L"FPS: %f\n", fps);
         OutputDebugString(buffer);
+#endif
 
         frameCounter = 0;
         elapsedSeconds = 0.0;
@@ -119,11 +226,26 @@ void APPLICATION::Update()
 
 void APPLICATION::Flush()
 {
-    _commandQueue->Flush();
     for (auto queueIt : _commandQueues)
     {
         queueIt.second->Flush();
     }
+
+    // Every frame is complete, run their retire callbacks.
+    if (_frameScheduler)
+    {
+        _frameScheduler->WaitForIdle();
+    }
+}
+
+void APPLICATION::SetFramesInFlight(uint32_t framesInFlight)
+{
+    _framesInFlight = std::max<uint32_t>(1, std::min(framesInFlight, FRAME_SCHEDULER::MAX_FRAMES_IN_FLIGHT));
+
+    if (_frameScheduler)
+    {
+        _frameScheduler->SetFramesInFlight(_framesInFlight);
+    }
 }
 
 int APPLICATION::Run(std::shared_ptr<GAME> pGame)
@@ -131,6 +253,7 @@ int APPLICATION::Run(std::shared_ptr<GAME> pGame)
     if (!pGame->Initialize()) return 1;
     if (!pGame->LoadContent()) return 2;
 
+#if PLATFORM_D3D12
     MSG msg = { 0 };
     while (msg.message != WM_QUIT)
     {
@@ -140,6 +263,28 @@ int APPLICATION::Run(std::shared_ptr<GAME> pGame)
             DispatchMessage(&msg);
         }
     }
+#else
+    while (WINDOW::gs_Windows.empty() == false)
+    {
+        // Every window renders a frame per iteration, as on WM_PAINT.
+        for (size_t i = 0; i < WINDOW::gs_Windows.size(); ++i)
+        {
+            // Delta time will be filled in by the Window.
+            UpdateEventArgs updateEventArgs(0.0f, 0.0f);
+            WINDOW::gs_Windows[i]->OnUpdate(updateEventArgs);
+            RenderEventArgs renderEventArgs(0.0f, 0.0f);
+            WINDOW::gs_Windows[i]->OnRender(renderEventArgs);
+        }
+
+        // Closed windows are destroyed as on WM_DESTROY, the last one quits the application.
+        auto closedIt = std::stable_partition(WINDOW::gs_Windows.begin(), WINDOW::gs_Windows.end(), [](WINDOW* window) { return window->IsClosed() == false; });
+        for (auto windowIt = closedIt; windowIt != WINDOW::gs_Windows.end(); ++windowIt)
+        {
+            delete *windowIt;
+        }
+        WINDOW::gs_Windows.erase(closedIt, WINDOW::gs_Windows.end());
+    }
+#endif
 
     // Flush any commands in the commands queues before quiting.
     Flush();
@@ -147,7 +292,11 @@ int APPLICATION::Run(std::shared_ptr<GAME> pGame)
     pGame->UnloadContent();
     pGame->Destroy();
 
+#if PLATFORM_D3D12
     return static_cast<int>(msg.wParam);
+#else
+    return 0;
+#endif
 }
 
 void APPLICATION::Quit()
@@ -155,6 +304,7 @@ void APPLICATION::Quit()
     DeleteInstance();
 }
 
+#if PLATFORM_D3D12
 ComPtr<ID3D12Device2> CreateDevice(ComPtr<IDXGIAdapter4> adapter)
 {
     ComPtr<ID3D12Device2> d3d12Device2;
@@ -254,4 +404,16 @@ COMMAND_QUEUE* APPLICATION::GetCommandQueue(D3D12_COMMAND_LIST_TYPE commandListT
         return _commandQueues[commandListType];
     }
     return (it->second);
-}
\ No newline at end of file
+}
+#else
+COMMAND_QUEUE* APPLICATION::GetCommandQueue(NULL_COMMAND_LIST_TYPE commandListType)
+{
+    auto it = _commandQueues.find(commandListType);
+    if (it == _commandQueues.end())
+    {
+        _commandQueues[commandListType] = new COMMAND_QUEUE(_device, commandListType);
+        return _commandQueues[commandListType];
+    }
+    return (it->second);
+}
+#endif
\ No newline at end of file
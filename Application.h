@@ -1,28 +1,70 @@
 #pragma once
 
+#include "Platform.h"
+
+#if PLATFORM_D3D12
 #include "Helpers.h"
+#include "DescriptorAllocator.h"
+#else
+#include "NullDevice.h"
+#endif
 
+#include <memory>
+#include <string>
 #include <unordered_map>
 using namespace std;
 
 class WINDOW;
 class COMMAND_QUEUE;
+class FRAME_SCHEDULER;
+class HEAP_ALLOCATOR;
+class JOB_SYSTEM;
+class ASSET_STREAMER;
+class STREAMING_BACKEND;
 class GAME;
 
 class APPLICATION
 {
 public:
+#if PLATFORM_D3D12
 	static APPLICATION* CreateInstance(HINSTANCE hInstance);
+#else
+	static APPLICATION* CreateInstance();
+#endif
 	static void			DeleteInstance();
 	static APPLICATION* Instance();
 
 	WINDOW* CreateRenderWindow(const wstring& name, int width, int height, bool vSync);
+#if PLATFORM_D3D12
 	void ParseCommandLineArguments();
+#endif
 
 	//inline WINDOW* GetWindow() { return _windowInst; }
 	inline COMMAND_QUEUE* GetCommandQueue() { return _commandQueue; }
+#if PLATFORM_D3D12
 	COMMAND_QUEUE* GetCommandQueue(D3D12_COMMAND_LIST_TYPE commandListType);
 	inline ComPtr<ID3D12Device2> GetDevice() { return _device; }
+#else
+	COMMAND_QUEUE* GetCommandQueue(NULL_COMMAND_LIST_TYPE commandListType);
+	inline NULL_DEVICE* GetDevice() { return _device; }
+#endif
+	inline FRAME_SCHEDULER* GetFrameScheduler() { return _frameScheduler; }
+#if PLATFORM_D3D12
+	inline HEAP_ALLOCATOR* GetHeapAllocator() { return _heapAllocator; }
+	inline DESCRIPTOR_ALLOCATOR* GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE type) { return _descriptorAllocators[type]; }
+	inline GPU_DESCRIPTOR_HEAP* GetGpuDescriptorHeap() { return _gpuDescriptorHeap; }
+#endif
+	inline JOB_SYSTEM* GetJobSystem() { return _jobSystem; }
+#if PLATFORM_D3D12
+	inline ASSET_STREAMER* GetAssetStreamer() { return _assetStreamer; }
+
+	// Staging (CPU only) descriptors, views are created in them and copied to the GPU heap when bound.
+	DESCRIPTOR_ALLOCATION AllocateDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t count = 1);
+#endif
+
+	// Number of frames the CPU can record ahead of the GPU.
+	void SetFramesInFlight(uint32_t framesInFlight);
+	inline uint32_t GetFramesInFlight() const { return _framesInFlight; }
 
 	void Update();
 	void Flush();
@@ -37,12 +79,41 @@ private:
 	// Application Instance
 	static APPLICATION* g_application;
 
-	// 
-	COMMAND_QUEUE*	_commandQueue = nullptr; // TODO : fuse
+	// Direct queue used by the swap chain, also stored in _commandQueues.
+	COMMAND_QUEUE*	_commandQueue = nullptr;
+#if PLATFORM_D3D12
 	unordered_map<D3D12_COMMAND_LIST_TYPE, COMMAND_QUEUE*> _commandQueues;
+#else
+	unordered_map<NULL_COMMAND_LIST_TYPE, COMMAND_QUEUE*> _commandQueues;
+#endif
+
+	// Frame pacing on the direct queue
+	FRAME_SCHEDULER*	_frameScheduler = nullptr;
+	uint32_t			_framesInFlight = g_numFrames;
+
+#if PLATFORM_D3D12
+	// Placed resources for every DEFAULT heap buffer and texture
+	HEAP_ALLOCATOR*		_heapAllocator = nullptr;
+
+	// Descriptor heaps
+	DESCRIPTOR_ALLOCATOR*	_descriptorAllocators[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES] = {};
+	GPU_DESCRIPTOR_HEAP*	_gpuDescriptorHeap = nullptr;
+#endif
+
+	// Workers recording render passes
+	JOB_SYSTEM*			_jobSystem = nullptr;
+
+#if PLATFORM_D3D12
+	// Background uploads on the copy queue
+	STREAMING_BACKEND*	_streamingBackend = nullptr;
+	ASSET_STREAMER*		_assetStreamer = nullptr;
 
 	// DirectX12 objects
 	ComPtr<ID3D12Device2>		 _device;
+#else
+	// Null device the queues replay their command lists on
+	NULL_DEVICE*		_device = nullptr;
+#endif
 
 	//
 	wstring _Name;
@@ -50,7 +121,10 @@ private:
 	int _height = 1;
 	bool _vSync = false;
 	bool _useWarp = false;
+	bool _useLegacyBarriers = false;
 
+#if PLATFORM_D3D12
 	// The application instance handle that this application was created with.
 	HINSTANCE _hInstance;
+#endif
 };
\ No newline at end of file
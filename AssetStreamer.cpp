@@ -0,0 +1,288 @@
+#include "AssetStreamer.h"
+
+#include <algorithm>
+
+// Staging offsets suit texture copies as well (D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT).
+static const uint64_t g_stagingAlignment = 512;
+
+ASSET_STREAMER::ASSET_STREAMER(STREAMING_BACKEND* backend, uint64_t chunkSize) :
+	_backend(backend),
+	_chunkSize(std::max<uint64_t>(1, std::min(chunkSize, backend->GetStagingSize() / 2))),
+	_staging(backend->GetStagingSize())
+{
+	_thread = std::thread(&ASSET_STREAMER::ThreadMain, this);
+}
+
+ASSET_STREAMER::~ASSET_STREAMER()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (const auto& pending : _pending)
+		{
+			Finish(pending.second, STREAM_CANCELLED);
+		}
+		_pending.clear();
+		_stop = true;
+	}
+	_condition.notify_one();
+	_backend->GetFence().Interrupt();
+
+	_thread.join();
+}
+
+uint64_t ASSET_STREAMER::Request(STREAM_REQUEST request)
+{
+	uint64_t requestId = INVALID_REQUEST;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		if (_requests.empty())
+		{
+			_busyStart = std::chrono::steady_clock::now();
+		}
+
+		requestId = _nextRequestId++;
+		REQUEST_STATE& state = _requests[requestId];
+		state.request = std::move(request);
+		_statistics.requestCount++;
+
+		if (state.request.size > 0)
+		{
+			_pending.insert(std::make_pair(state.request.priority, requestId));
+		}
+		else
+		{
+			Finish(requestId, STREAM_COMPLETED);
+		}
+	}
+	_condition.notify_one();
+	_backend->GetFence().Interrupt();
+
+	return requestId;
+}
+
+bool ASSET_STREAMER::Cancel(uint64_t requestId)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto it = _requests.find(requestId);
+		if (it == _requests.end() || it->second.finished)
+		{
+			return false;
+		}
+
+		_pending.erase(std::make_pair(it->second.request.priority, requestId));
+		Finish(requestId, STREAM_CANCELLED);
+	}
+	_condition.notify_one();
+	_backend->GetFence().Interrupt();
+
+	return true;
+}
+
+void ASSET_STREAMER::WaitForIdle()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idleCondition.wait(lock, [&]() { return _requests.empty(); });
+}
+
+ASSET_STREAMER::STATISTICS ASSET_STREAMER::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	STATISTICS statistics = _statistics;
+	if (_requests.empty() == false)
+	{
+		statistics.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - _busyStart).count();
+	}
+	return statistics;
+}
+
+void ASSET_STREAMER::Finish(uint64_t requestId, STREAM_STATUS status)
+{
+	REQUEST_STATE& state = _requests[requestId];
+	state.finished = true;
+	state.status = status;
+
+	// Chunks recorded in the current batch, retired by SubmitBatch().
+	if (state.inBatch)
+	{
+		return;
+	}
+
+	_inFlight.emplace(state.fenceValue, requestId);
+}
+
+void ASSET_STREAMER::SubmitBatch()
+{
+	uint64_t fenceValue = _backend->Submit();
+	_staging.FinishFrame(fenceValue);
+	_submittedBytes.emplace(fenceValue, _batchBytes);
+	_batchBytes = 0;
+	_statistics.submitCount++;
+
+	for (uint64_t requestId : _batch)
+	{
+		REQUEST_STATE& state = _requests[requestId];
+		state.inBatch = false;
+		state.fenceValue = fenceValue;
+		if (state.finished)
+		{
+			_inFlight.emplace(fenceValue, requestId);
+		}
+	}
+	_batch.clear();
+}
+
+void ASSET_STREAMER::ThreadMain()
+{
+	FENCE& fence = _backend->GetFence();
+	std::vector<std::pair<std::function<void(STREAM_STATUS)>, STREAM_STATUS>> completions;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		// Retire the submissions the backend completed.
+		uint64_t completedValue = fence.GetCompletedValue();
+		_staging.Retire(completedValue);
+
+		auto submittedEnd = _submittedBytes.upper_bound(completedValue);
+		for (auto it = _submittedBytes.begin(); it != submittedEnd; ++it)
+		{
+			_statistics.streamedBytes += it->second;
+		}
+		_submittedBytes.erase(_submittedBytes.begin(), submittedEnd);
+
+		auto inFlightEnd = _inFlight.upper_bound(completedValue);
+		for (auto it = _inFlight.begin(); it != inFlightEnd; ++it)
+		{
+			REQUEST_STATE& state = _requests[it->second];
+			switch (state.status)
+			{
+			case STREAM_COMPLETED: _statistics.completedCount++; break;
+			case STREAM_CANCELLED: _statistics.cancelledCount++; break;
+			case STREAM_FAILED: _statistics.failedCount++; break;
+			}
+
+			completions.push_back(std::make_pair(std::move(state.request.completion), state.status));
+			_requests.erase(it->second);
+		}
+		if (completions.empty() == false && _requests.empty())
+		{
+			_statistics.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - _busyStart).count();
+		}
+		_inFlight.erase(_inFlight.begin(), inFlightEnd);
+
+		if (completions.empty() == false)
+		{
+			lock.unlock();
+			for (auto& completion : completions)
+			{
+				if (completion.first)
+				{
+					completion.first(completion.second);
+				}
+			}
+			completions.clear();
+			lock.lock();
+			continue;
+		}
+
+		if (_requests.empty())
+		{
+			_idleCondition.notify_all();
+			if (_stop)
+			{
+				break;
+			}
+
+			_condition.wait(lock, [&]() { return _stop || _requests.empty() == false; });
+			if (_requests.empty() == false)
+			{
+				continue;
+			}
+			break;
+		}
+
+		if (_pending.empty())
+		{
+			// Nothing left to record, submit and wait for the copies in flight.
+			if (_batch.empty() == false)
+			{
+				SubmitBatch();
+				continue;
+			}
+
+			uint64_t fenceValue = _inFlight.begin()->first;
+			lock.unlock();
+			fence.Wait(fenceValue);
+			lock.lock();
+			continue;
+		}
+
+		const uint64_t requestId = _pending.begin()->second;
+		REQUEST_STATE& state = _requests[requestId];
+		const uint64_t sourceOffset = state.streamedBytes;
+		const uint64_t chunkSize = std::min(_chunkSize, state.request.size - sourceOffset);
+
+		uint64_t stagingOffset = _staging.Allocate(chunkSize, g_stagingAlignment);
+		if (stagingOffset == RING_ALLOCATOR::INVALID_OFFSET)
+		{
+			// The staging memory comes back once the recorded copies completed, chunks
+			// of cancelled requests may hold it without anything recorded.
+			if (_batch.empty() == false || _staging.HasPendingFrames() == false)
+			{
+				SubmitBatch();
+				continue;
+			}
+
+			_statistics.stagingStallCount++;
+			uint64_t fenceValue = _staging.GetOldestFenceValue();
+			lock.unlock();
+			fence.Wait(fenceValue);
+			lock.lock();
+			continue;
+		}
+
+		// Reading may be slow, requests can be queued or cancelled meanwhile.
+		std::function<bool(void*, uint64_t, uint64_t)> read = state.request.read;
+		lock.unlock();
+		bool succeeded = read && read(_backend->GetStagingMemory() + stagingOffset, sourceOffset, chunkSize);
+		lock.lock();
+
+		// The state stays alive, only this thread retires requests.
+		if (state.finished)
+		{
+			continue;
+		}
+
+		if (succeeded == false)
+		{
+			_pending.erase(std::make_pair(state.request.priority, requestId));
+			Finish(requestId, STREAM_FAILED);
+			continue;
+		}
+
+		_backend->Copy(state.request.destination, state.request.destinationOffset + sourceOffset, stagingOffset, chunkSize);
+		state.streamedBytes += chunkSize;
+		_batchBytes += chunkSize;
+		if (state.inBatch == false)
+		{
+			state.inBatch = true;
+			_batch.push_back(requestId);
+		}
+
+		if (state.streamedBytes == state.request.size)
+		{
+			_pending.erase(std::make_pair(state.request.priority, requestId));
+			Finish(requestId, STREAM_COMPLETED);
+		}
+
+		// Half the staging memory in one submission keeps the backend busy while the other half is filled.
+		if (_batchBytes >= _backend->GetStagingSize() / 2)
+		{
+			SubmitBatch();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "FenceCompletionService.h"
+#include "RingAllocator.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Destination side of the streamer: staging memory, copies and a timeline.
+// COPY_STREAMING_BACKEND records the copies on the COPY queue, any other
+// implementation (e.g. a file) lets the streamer run without a GPU.
+class STREAMING_BACKEND
+{
+public:
+	virtual ~STREAMING_BACKEND() { ; }
+
+	// CPU visible staging memory, recycled by the streamer once the copies reading it completed.
+	virtual uint8_t* GetStagingMemory() = 0;
+	virtual uint64_t GetStagingSize() const = 0;
+
+	// Records a copy from the staging memory into the destination of a request.
+	virtual void Copy(void* destination, uint64_t destinationOffset, uint64_t stagingOffset, uint64_t size) = 0;
+
+	// Submits the copies recorded so far, returns the fence value signaled once they completed.
+	virtual uint64_t Submit() = 0;
+
+	virtual FENCE& GetFence() = 0;
+};
+
+enum STREAM_STATUS
+{
+	STREAM_COMPLETED,
+	STREAM_CANCELLED,
+	STREAM_FAILED
+};
+
+struct STREAM_REQUEST
+{
+	void*		destination = nullptr;		// Opaque to the streamer, e.g. an ID3D12Resource*
+	uint64_t	destinationOffset = 0;
+	uint64_t	size = 0;
+	int			priority = 0;				// Higher first, requests of equal priority are streamed in order
+
+	// Fills 'staging' with 'size' bytes of the source starting at 'sourceOffset', returns false on error.
+	// Called on the streamer thread, once per chunk.
+	std::function<bool(void* staging, uint64_t sourceOffset, uint64_t size)> read;
+
+	// Called on the streamer thread once the copies completed on the backend
+	// timeline, or once a cancelled or failed request no longer uses the destination.
+	std::function<void(STREAM_STATUS status)> completion;
+};
+
+// Streams requests into a backend from a background thread through a fixed
+// staging budget. Requests are split in chunks, a higher priority request
+// takes over between two chunks. Copies are batched into a single submission
+// until the staging memory is full or the queue runs dry.
+class ASSET_STREAMER
+{
+public:
+	static const uint64_t INVALID_REQUEST = 0;
+
+	struct STATISTICS
+	{
+		uint64_t	requestCount = 0;
+		uint64_t	completedCount = 0;
+		uint64_t	cancelledCount = 0;
+		uint64_t	failedCount = 0;
+		uint64_t	streamedBytes = 0;		// Copies of completed submissions
+		uint64_t	submitCount = 0;
+		uint64_t	stagingStallCount = 0;	// Waits for staging memory
+		double		busySeconds = 0.0;		// Time with requests queued or in flight
+
+		double GetBytesPerSecond() const { return busySeconds > 0.0 ? streamedBytes / busySeconds : 0.0; }
+	};
+
+	// The backend must outlive the streamer, 'chunkSize' is capped to half the staging memory.
+	ASSET_STREAMER(STREAMING_BACKEND* backend, uint64_t chunkSize = 1024 * 1024);
+
+	// Cancels the queued requests and waits for the ones in flight.
+	~ASSET_STREAMER();
+
+	uint64_t Request(STREAM_REQUEST request);
+
+	// Returns false when the request already completed or is unknown. The completion
+	// callback still runs, with STREAM_CANCELLED, once its copies in flight completed.
+	bool Cancel(uint64_t requestId);
+
+	// Blocks until every request completed.
+	void WaitForIdle();
+
+	STATISTICS GetStatistics() const;
+
+private:
+	struct REQUEST_STATE
+	{
+		STREAM_REQUEST	request;
+		uint64_t		streamedBytes = 0;		// Bytes recorded
+		uint64_t		fenceValue = 0;			// Submission holding the last recorded chunk
+		bool			inBatch = false;		// Chunks recorded since the last submission
+		bool			finished = false;		// No more chunks to record
+		STREAM_STATUS	status = STREAM_COMPLETED;
+	};
+
+	// Priority order, then request order.
+	struct PENDING_ORDER
+	{
+		bool operator()(const std::pair<int, uint64_t>& a, const std::pair<int, uint64_t>& b) const
+		{
+			return a.first != b.first ? a.first > b.first : a.second < b.second;
+		}
+	};
+
+	void ThreadMain();
+
+	// Both are called with the lock held. Completion callbacks are always run by the
+	// thread, a request finished without copies in flight is retired with fence value 0.
+	void Finish(uint64_t requestId, STREAM_STATUS status);
+	void SubmitBatch();
+
+	STREAMING_BACKEND*	_backend;
+	uint64_t			_chunkSize;
+
+	mutable std::mutex			_mutex;
+	std::condition_variable		_condition;
+	std::condition_variable		_idleCondition;
+
+	RING_ALLOCATOR	_staging;
+	uint64_t		_batchBytes = 0;
+	uint64_t		_nextRequestId = 1;
+
+	std::unordered_map<uint64_t, REQUEST_STATE>				_requests;
+	std::set<std::pair<int, uint64_t>, PENDING_ORDER>		_pending;		// Requests with chunks left
+	std::vector<uint64_t>									_batch;
+	std::multimap<uint64_t, uint64_t>						_inFlight;		// Fence value -> finished request
+	std::multimap<uint64_t, uint64_t>						_submittedBytes;	// Fence value -> bytes
+
+	STATISTICS									_statistics;
+	std::chrono::steady_clock::time_point		_busyStart;
+	bool										_stop = false;
+
+	std::thread	_thread;
+};
\ No newline at end of file
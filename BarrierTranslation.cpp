@@ -0,0 +1,131 @@
+#include "BarrierTranslation.h"
+
+#include <cassert>
+
+// Legacy D3D12_RESOURCE_STATES bits
+enum : uint32_t
+{
+	STATE_VERTEX_AND_CONSTANT_BUFFER	= 0x1,
+	STATE_INDEX_BUFFER					= 0x2,
+	STATE_RENDER_TARGET					= 0x4,
+	STATE_UNORDERED_ACCESS				= 0x8,
+	STATE_DEPTH_WRITE					= 0x10,
+	STATE_DEPTH_READ					= 0x20,
+	STATE_NON_PIXEL_SHADER_RESOURCE		= 0x40,
+	STATE_PIXEL_SHADER_RESOURCE			= 0x80,
+	STATE_INDIRECT_ARGUMENT				= 0x200,
+	STATE_COPY_DEST						= 0x400,
+	STATE_COPY_SOURCE					= 0x800,
+	STATE_RESOLVE_DEST					= 0x1000,
+	STATE_RESOLVE_SOURCE				= 0x2000,
+
+	STATE_WRITE_MASK = STATE_RENDER_TARGET | STATE_UNORDERED_ACCESS | STATE_DEPTH_WRITE | STATE_COPY_DEST | STATE_RESOLVE_DEST
+};
+
+struct STATE_ACCESS
+{
+	uint32_t state;
+	BARRIER_ACCESS_DESC desc;
+};
+
+static const STATE_ACCESS g_stateAccesses[] =
+{
+	{ STATE_VERTEX_AND_CONSTANT_BUFFER,	{ BARRIER_SYNC_ALL_SHADING, BARRIER_ACCESS_VERTEX_BUFFER | BARRIER_ACCESS_CONSTANT_BUFFER, BARRIER_LAYOUT_GENERIC_READ } },
+	{ STATE_INDEX_BUFFER,				{ BARRIER_SYNC_INDEX_INPUT, BARRIER_ACCESS_INDEX_BUFFER, BARRIER_LAYOUT_GENERIC_READ } },
+	{ STATE_RENDER_TARGET,				{ BARRIER_SYNC_RENDER_TARGET, BARRIER_ACCESS_RENDER_TARGET, BARRIER_LAYOUT_RENDER_TARGET } },
+	{ STATE_UNORDERED_ACCESS,			{ BARRIER_SYNC_ALL_SHADING, BARRIER_ACCESS_UNORDERED_ACCESS, BARRIER_LAYOUT_UNORDERED_ACCESS } },
+	{ STATE_DEPTH_WRITE,				{ BARRIER_SYNC_DEPTH_STENCIL, BARRIER_ACCESS_DEPTH_STENCIL_WRITE, BARRIER_LAYOUT_DEPTH_STENCIL_WRITE } },
+	{ STATE_DEPTH_READ,					{ BARRIER_SYNC_DEPTH_STENCIL, BARRIER_ACCESS_DEPTH_STENCIL_READ, BARRIER_LAYOUT_DEPTH_STENCIL_READ } },
+	{ STATE_NON_PIXEL_SHADER_RESOURCE,	{ BARRIER_SYNC_NON_PIXEL_SHADING, BARRIER_ACCESS_SHADER_RESOURCE, BARRIER_LAYOUT_SHADER_RESOURCE } },
+	{ STATE_PIXEL_SHADER_RESOURCE,		{ BARRIER_SYNC_PIXEL_SHADING, BARRIER_ACCESS_SHADER_RESOURCE, BARRIER_LAYOUT_SHADER_RESOURCE } },
+	{ STATE_INDIRECT_ARGUMENT,			{ BARRIER_SYNC_EXECUTE_INDIRECT, BARRIER_ACCESS_INDIRECT_ARGUMENT, BARRIER_LAYOUT_GENERIC_READ } },
+	{ STATE_COPY_DEST,					{ BARRIER_SYNC_COPY, BARRIER_ACCESS_COPY_DEST, BARRIER_LAYOUT_COPY_DEST } },
+	{ STATE_COPY_SOURCE,				{ BARRIER_SYNC_COPY, BARRIER_ACCESS_COPY_SOURCE, BARRIER_LAYOUT_COPY_SOURCE } },
+	{ STATE_RESOLVE_DEST,				{ BARRIER_SYNC_RESOLVE, BARRIER_ACCESS_RESOLVE_DEST, BARRIER_LAYOUT_RESOLVE_DEST } },
+	{ STATE_RESOLVE_SOURCE,				{ BARRIER_SYNC_RESOLVE, BARRIER_ACCESS_RESOLVE_SOURCE, BARRIER_LAYOUT_RESOLVE_SOURCE } },
+};
+
+BARRIER_ACCESS_DESC GetBarrierAccess(uint32_t legacyState, bool texture)
+{
+	// COMMON (and PRESENT) can be accessed by anything, synchronize with everything.
+	if (legacyState == 0)
+	{
+		return BARRIER_ACCESS_DESC{ BARRIER_SYNC_ALL, BARRIER_ACCESS_COMMON, texture ? BARRIER_LAYOUT_COMMON : BARRIER_LAYOUT_UNDEFINED };
+	}
+
+	BARRIER_ACCESS_DESC desc = { BARRIER_SYNC_NONE, BARRIER_ACCESS_COMMON, BARRIER_LAYOUT_UNDEFINED };
+	for (const STATE_ACCESS& stateAccess : g_stateAccesses)
+	{
+		if ((legacyState & stateAccess.state) == 0)
+		{
+			continue;
+		}
+
+		desc.sync |= stateAccess.desc.sync;
+		desc.access |= stateAccess.desc.access;
+
+		// Several read states share the generic read layout.
+		if (desc.layout == BARRIER_LAYOUT_UNDEFINED || desc.layout == stateAccess.desc.layout)
+		{
+			desc.layout = stateAccess.desc.layout;
+		}
+		else
+		{
+			assert((legacyState & STATE_WRITE_MASK) == 0 && "Write states cannot be combined.");
+			desc.layout = BARRIER_LAYOUT_GENERIC_READ;
+		}
+	}
+
+	// Pixel and non pixel shading together cover every shader stage.
+	if ((desc.sync & BARRIER_SYNC_PIXEL_SHADING) && (desc.sync & BARRIER_SYNC_NON_PIXEL_SHADING))
+	{
+		desc.sync = (desc.sync & ~(BARRIER_SYNC_PIXEL_SHADING | BARRIER_SYNC_NON_PIXEL_SHADING)) | BARRIER_SYNC_ALL_SHADING;
+	}
+
+	if (texture == false)
+	{
+		desc.layout = BARRIER_LAYOUT_UNDEFINED;
+	}
+
+	return desc;
+}
+
+bool TranslateBarrier(const RESOURCE_STATE_TRACKER::BARRIER& barrier, bool texture, ENHANCED_BARRIER& enhancedBarrier)
+{
+	enhancedBarrier.resource = barrier.resource;
+	enhancedBarrier.texture = texture;
+	enhancedBarrier.subresource = barrier.subresource;
+
+	if (barrier.type == RESOURCE_STATE_TRACKER::BARRIER_UAV)
+	{
+		// Orders the unordered accesses before the barrier with the ones after, no layout change.
+		uint32_t layout = texture ? BARRIER_LAYOUT_UNORDERED_ACCESS : BARRIER_LAYOUT_UNDEFINED;
+		enhancedBarrier.syncBefore = BARRIER_SYNC_ALL_SHADING;
+		enhancedBarrier.syncAfter = BARRIER_SYNC_ALL_SHADING;
+		enhancedBarrier.accessBefore = BARRIER_ACCESS_UNORDERED_ACCESS;
+		enhancedBarrier.accessAfter = BARRIER_ACCESS_UNORDERED_ACCESS;
+		enhancedBarrier.layoutBefore = layout;
+		enhancedBarrier.layoutAfter = layout;
+		return true;
+	}
+
+	BARRIER_ACCESS_DESC before = GetBarrierAccess(barrier.before, texture);
+	BARRIER_ACCESS_DESC after = GetBarrierAccess(barrier.after, texture);
+
+	// Reads do not need to wait on reads, only a layout change would require a barrier.
+	// COMMON is kept since it may hide writes from implicit promotions.
+	bool readOnly = barrier.before != 0 && barrier.after != 0 &&
+		((barrier.before | barrier.after) & STATE_WRITE_MASK) == 0;
+	if (readOnly && before.layout == after.layout)
+	{
+		return false;
+	}
+
+	enhancedBarrier.syncBefore = before.sync;
+	enhancedBarrier.syncAfter = after.sync;
+	enhancedBarrier.accessBefore = before.access;
+	enhancedBarrier.accessAfter = after.access;
+	enhancedBarrier.layoutBefore = before.layout;
+	enhancedBarrier.layoutAfter = after.layout;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "ResourceStateTracker.h"
+
+#include <cstdint>
+
+// Enhanced barrier values, they match D3D12_BARRIER_SYNC, D3D12_BARRIER_ACCESS
+// and D3D12_BARRIER_LAYOUT so the translation runs without the D3D12 headers.
+enum BARRIER_SYNC : uint32_t
+{
+	BARRIER_SYNC_NONE				= 0x0,
+	BARRIER_SYNC_ALL				= 0x1,
+	BARRIER_SYNC_DRAW				= 0x2,
+	BARRIER_SYNC_INDEX_INPUT		= 0x4,
+	BARRIER_SYNC_VERTEX_SHADING		= 0x8,
+	BARRIER_SYNC_PIXEL_SHADING		= 0x10,
+	BARRIER_SYNC_DEPTH_STENCIL		= 0x20,
+	BARRIER_SYNC_RENDER_TARGET		= 0x40,
+	BARRIER_SYNC_COMPUTE_SHADING	= 0x80,
+	BARRIER_SYNC_COPY				= 0x200,
+	BARRIER_SYNC_RESOLVE			= 0x400,
+	BARRIER_SYNC_EXECUTE_INDIRECT	= 0x800,
+	BARRIER_SYNC_ALL_SHADING		= 0x1000,
+	BARRIER_SYNC_NON_PIXEL_SHADING	= 0x2000
+};
+
+enum BARRIER_ACCESS : uint32_t
+{
+	BARRIER_ACCESS_COMMON				= 0x0,
+	BARRIER_ACCESS_VERTEX_BUFFER		= 0x1,
+	BARRIER_ACCESS_CONSTANT_BUFFER		= 0x2,
+	BARRIER_ACCESS_INDEX_BUFFER			= 0x4,
+	BARRIER_ACCESS_RENDER_TARGET		= 0x8,
+	BARRIER_ACCESS_UNORDERED_ACCESS		= 0x10,
+	BARRIER_ACCESS_DEPTH_STENCIL_WRITE	= 0x20,
+	BARRIER_ACCESS_DEPTH_STENCIL_READ	= 0x40,
+	BARRIER_ACCESS_SHADER_RESOURCE		= 0x80,
+	BARRIER_ACCESS_INDIRECT_ARGUMENT	= 0x200,
+	BARRIER_ACCESS_COPY_DEST			= 0x400,
+	BARRIER_ACCESS_COPY_SOURCE			= 0x800,
+	BARRIER_ACCESS_RESOLVE_DEST			= 0x1000,
+	BARRIER_ACCESS_RESOLVE_SOURCE		= 0x2000,
+	BARRIER_ACCESS_NO_ACCESS			= 0x80000000
+};
+
+enum BARRIER_LAYOUT : uint32_t
+{
+	BARRIER_LAYOUT_COMMON				= 0,
+	BARRIER_LAYOUT_GENERIC_READ			= 1,
+	BARRIER_LAYOUT_RENDER_TARGET		= 2,
+	BARRIER_LAYOUT_UNORDERED_ACCESS		= 3,
+	BARRIER_LAYOUT_DEPTH_STENCIL_WRITE	= 4,
+	BARRIER_LAYOUT_DEPTH_STENCIL_READ	= 5,
+	BARRIER_LAYOUT_SHADER_RESOURCE		= 6,
+	BARRIER_LAYOUT_COPY_SOURCE			= 7,
+	BARRIER_LAYOUT_COPY_DEST			= 8,
+	BARRIER_LAYOUT_RESOLVE_SOURCE		= 9,
+	BARRIER_LAYOUT_RESOLVE_DEST			= 10,
+	BARRIER_LAYOUT_UNDEFINED			= 0xffffffff
+};
+
+// Synchronization scope, access and layout of a legacy resource state.
+struct BARRIER_ACCESS_DESC
+{
+	uint32_t sync;
+	uint32_t access;
+	uint32_t layout;	// BARRIER_LAYOUT_UNDEFINED for buffers
+};
+
+struct ENHANCED_BARRIER
+{
+	const void*	resource;	// nullptr for a global barrier
+	bool		texture;
+	uint32_t	subresource;
+	uint32_t	syncBefore;
+	uint32_t	syncAfter;
+	uint32_t	accessBefore;
+	uint32_t	accessAfter;
+	uint32_t	layoutBefore;
+	uint32_t	layoutAfter;
+};
+
+// Combined read states (e.g. GENERIC_READ) map to the union of their scopes.
+BARRIER_ACCESS_DESC GetBarrierAccess(uint32_t legacyState, bool texture);
+
+// Translates a legacy transition or UAV barrier, pure function.
+// Returns false when no enhanced barrier is needed: read to read transitions
+// of buffers, and of textures staying in the same layout, do not flush any cache.
+bool TranslateBarrier(const RESOURCE_STATE_TRACKER::BARRIER& barrier, bool texture, ENHANCED_BARRIER& enhancedBarrier);
\ No newline at end of file
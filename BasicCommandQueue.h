@@ -0,0 +1,517 @@
+#pragma once
+
+#include "CommandAllocatorPool.h"
+#include "DeferredReleaseQueue.h"
+#include "FenceCompletionService.h"
+#include "QueueDependencyTracker.h"
+#include "ResourceStateTracker.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Waits and signals of every queue, shared so transitive waits are known.
+inline QUEUE_DEPENDENCY_TRACKER& GetQueueDependencies()
+{
+	static QUEUE_DEPENDENCY_TRACKER queueDependencies;
+	return queueDependencies;
+}
+
+// Unique id used to validate the per-thread pool cache.
+inline uint64_t GetNextCommandQueueId()
+{
+	static std::atomic<uint64_t> nextQueueId{ 1 };
+	return nextQueueId++;
+}
+
+// Command list recycling and submission of COMMAND_QUEUE, written once for every
+// device it runs on. DEVICE owns one hardware queue and its fence and provides:
+//   ALLOCATOR, LIST						Reference counted handles
+//   CreateCommandAllocator()				ResetCommandAllocator(allocator)
+//   CreateCommandList(allocator)			ResetCommandList(list, allocator), CloseCommandList(list)
+//   SetListContext(list, allocator, pool)	GetListContext(list, allocator, pool)
+//   SetStateTracker(list, tracker)			GetStateTracker(list), FlushBarriers(list), RecordBarriers(list, barriers)
+//   GetGlobalStates()						DecaysAllStates(), true for copy queues
+//   ExecuteCommandLists(lists, count)		Signal(value), Wait(otherDevice, value)
+//   GetCompletedValue()					WaitForValue(value, duration), uninterruptible
+//   GetFence(), GetCompletionFence()		Two FENCE on the queue timeline, interrupted independently
+template<typename DEVICE>
+class BASIC_COMMAND_QUEUE
+{
+public:
+	typedef typename DEVICE::ALLOCATOR ALLOCATOR;
+	typedef typename DEVICE::LIST LIST;
+	using ALLOCATOR_POOL = COMMAND_ALLOCATOR_POOL<ALLOCATOR>;
+
+	template<typename... DEVICE_ARGS>
+	explicit BASIC_COMMAND_QUEUE(size_t maxAllocatorsPerThread, DEVICE_ARGS&&... deviceArgs);
+	virtual ~BASIC_COMMAND_QUEUE();
+
+	// Can be called from any thread, each recording thread owns its own allocators and lists.
+	LIST GetCommandList();
+
+	// Can be called from any thread, submissions are serialized on the queue.
+	uint64_t ExecuteCommandList(LIST commandList);
+
+	// Closes and submits the lists in a single ExecuteCommandLists call followed by a single Signal.
+	// Every allocator is retired with the returned fence value. Resource states assumed by the
+	// lists are checked against the global states, stale ones get a fix-up list submitted before them.
+	uint64_t ExecuteCommandLists(const LIST* commandLists, size_t count);
+	uint64_t ExecuteCommandLists(const std::vector<LIST>& commandLists);
+
+	// Closes a list without submitting it and hands it back to its recording thread,
+	// for recordings that turned out to have nothing to do.
+	void DiscardCommandList(LIST commandList);
+
+	// GPU side wait on another queue reaching 'fenceValue', work submitted next on this queue
+	// starts after it. Skipped when the value completed or an earlier wait, on that queue or
+	// transitively through another one, already covers it.
+	void Wait(BASIC_COMMAND_QUEUE& other, uint64_t fenceValue);
+
+	uint64_t Signal();
+	// Value of the latest Signal(), the work submitted so far completes with it.
+	uint64_t GetLastSignaledFenceValue();
+	uint64_t GetCompletedFenceValue() const;
+	bool IsFenceComplete(uint64_t fenceValue) const;
+	void WaitForFenceValue(uint64_t fenceValue, std::chrono::milliseconds duration = std::chrono::milliseconds::max());
+	void Flush();
+
+	// Runs the callback on the queue completion thread once the fence value is reached.
+	void OnFenceCompletion(uint64_t fenceValue, std::function<void()> callback);
+	std::future<void> GetFenceFuture(uint64_t fenceValue);
+
+	// Keeps the object alive until the work already submitted on this queue completed.
+	// Call it once the last command list using the object has been executed.
+	void ReleaseDeferred(uint64_t sizeInBytes, std::function<void()> release);
+	void CollectDeferredReleases();
+	inline DEFERRED_RELEASE_QUEUE::STATISTICS GetDeferredReleaseStatistics() const { return _DeferredReleaseQueue.GetStatistics(); }
+
+	// Fence of the queue timeline, its interrupt is never used by the queue itself.
+	inline FENCE& GetFence() { return _Device.GetFence(); }
+	inline DEVICE& GetDevice() { return _Device; }
+
+	// Allocation, reuse and stall counters summed over every recording thread.
+	typename ALLOCATOR_POOL::STATISTICS GetAllocatorStatistics();
+
+protected:
+	DEVICE	_Device;
+
+private:
+	// GetCommandList() without collecting the deferred releases, safe to call while submitting.
+	LIST AcquireCommandList();
+
+	uint64_t SignalInternal();
+
+	// Allocator and list handed back to their recording thread once submitted.
+	struct SUBMITTED_ENTRY
+	{
+		uint64_t fenceValue = 0;
+		ALLOCATOR commandAllocator;
+		LIST commandList;
+		SUBMITTED_ENTRY* next = nullptr;
+	};
+
+	// Allocators and lists owned by a single recording thread.
+	// Only the owning thread touches the queues, any submitting thread
+	// pushes back into the lock-free inbox.
+	struct THREAD_POOL
+	{
+		THREAD_POOL(size_t maxAllocators) : allocatorPool(maxAllocators) { ; }
+		~THREAD_POOL();
+
+		void PushSubmitted(SUBMITTED_ENTRY* entry);
+		void DrainSubmitted();
+
+		ALLOCATOR_POOL										allocatorPool;
+		std::queue<LIST>									commandListQueue;
+		std::vector<std::unique_ptr<RESOURCE_STATE_TRACKER>>	stateTrackers;		// One per list created by the thread
+		std::atomic<SUBMITTED_ENTRY*>						submittedInbox{ nullptr };
+	};
+
+	THREAD_POOL& GetThreadPool();
+	FENCE_COMPLETION_SERVICE& GetCompletionService();
+
+	uint64_t	_FenceValue = 0;
+	size_t		_MaxAllocatorsPerThread = 0;
+	uint64_t	_QueueId = 0;
+
+	// Index in the cross-queue dependency tracker.
+	uint32_t	_DependencyIndex = 0;
+
+	std::mutex															_SubmitMutex;
+	std::mutex															_ThreadPoolsMutex;
+	std::unordered_map<std::thread::id, std::unique_ptr<THREAD_POOL>>	_ThreadPools;
+
+	DEFERRED_RELEASE_QUEUE	_DeferredReleaseQueue;
+
+	// Created on first use so queues nobody waits on do not spawn a thread.
+	std::once_flag								_CompletionServiceOnce;
+	std::unique_ptr<FENCE_COMPLETION_SERVICE>	_CompletionService;
+};
+
+template<typename DEVICE>
+template<typename... DEVICE_ARGS>
+BASIC_COMMAND_QUEUE<DEVICE>::BASIC_COMMAND_QUEUE(size_t maxAllocatorsPerThread, DEVICE_ARGS&&... deviceArgs) :
+	_Device(std::forward<DEVICE_ARGS>(deviceArgs)...),
+	_MaxAllocatorsPerThread(maxAllocatorsPerThread),
+	_QueueId(GetNextCommandQueueId()),
+	_DependencyIndex(GetQueueDependencies().AddQueue())
+{
+}
+
+template<typename DEVICE>
+BASIC_COMMAND_QUEUE<DEVICE>::~BASIC_COMMAND_QUEUE()
+{
+	Flush();
+
+	// Stop the completion thread before the fence it waits on goes away.
+	_CompletionService.reset();
+
+	GetQueueDependencies().RemoveQueue(_DependencyIndex);
+}
+
+template<typename DEVICE>
+BASIC_COMMAND_QUEUE<DEVICE>::THREAD_POOL::~THREAD_POOL()
+{
+	// Release the entries which were never picked back up by the owning thread.
+	DrainSubmitted();
+}
+
+template<typename DEVICE>
+void BASIC_COMMAND_QUEUE<DEVICE>::THREAD_POOL::PushSubmitted(SUBMITTED_ENTRY* entry)
+{
+	SUBMITTED_ENTRY* head = submittedInbox.load(std::memory_order_relaxed);
+	do
+	{
+		entry->next = head;
+	} while (submittedInbox.compare_exchange_weak(head, entry, std::memory_order_release, std::memory_order_relaxed) == false);
+}
+
+template<typename DEVICE>
+void BASIC_COMMAND_QUEUE<DEVICE>::THREAD_POOL::DrainSubmitted()
+{
+	SUBMITTED_ENTRY* entry = submittedInbox.exchange(nullptr, std::memory_order_acquire);
+
+	// The inbox is a stack, reverse it so the allocators stay sorted by fence value.
+	SUBMITTED_ENTRY* ordered = nullptr;
+	while (entry)
+	{
+		SUBMITTED_ENTRY* next = entry->next;
+		entry->next = ordered;
+		ordered = entry;
+		entry = next;
+	}
+
+	while (ordered)
+	{
+		SUBMITTED_ENTRY* next = ordered->next;
+		allocatorPool.Release(ordered->commandAllocator, ordered->fenceValue);
+		commandListQueue.push(ordered->commandList);
+		delete ordered;
+		ordered = next;
+	}
+}
+
+template<typename DEVICE>
+typename BASIC_COMMAND_QUEUE<DEVICE>::THREAD_POOL& BASIC_COMMAND_QUEUE<DEVICE>::GetThreadPool()
+{
+	// Most threads keep recording for the same queue, remember the last lookup.
+	thread_local uint64_t cachedQueueId = 0;
+	thread_local THREAD_POOL* cachedPool = nullptr;
+
+	if (cachedQueueId == _QueueId)
+	{
+		return *cachedPool;
+	}
+
+	std::lock_guard<std::mutex> lock(_ThreadPoolsMutex);
+
+	std::unique_ptr<THREAD_POOL>& pool = _ThreadPools[std::this_thread::get_id()];
+	if (pool == nullptr)
+	{
+		pool = std::make_unique<THREAD_POOL>(_MaxAllocatorsPerThread);
+	}
+
+	cachedQueueId = _QueueId;
+	cachedPool = pool.get();
+
+	return *pool;
+}
+
+template<typename DEVICE>
+typename BASIC_COMMAND_QUEUE<DEVICE>::LIST BASIC_COMMAND_QUEUE<DEVICE>::GetCommandList()
+{
+	CollectDeferredReleases();
+
+	return AcquireCommandList();
+}
+
+template<typename DEVICE>
+typename BASIC_COMMAND_QUEUE<DEVICE>::LIST BASIC_COMMAND_QUEUE<DEVICE>::AcquireCommandList()
+{
+	ALLOCATOR commandAllocator;
+	LIST commandList;
+
+	THREAD_POOL& pool = GetThreadPool();
+	pool.DrainSubmitted();
+
+	typename ALLOCATOR_POOL::ACQUIRE_RESULT result = pool.allocatorPool.Acquire(GetCompletedFenceValue(), commandAllocator);
+	if (result == ALLOCATOR_POOL::ACQUIRE_STALL)
+	{
+		// The pool is full, wait for the oldest allocator to retire instead of growing.
+		WaitForFenceValue(pool.allocatorPool.GetOldestFenceValue());
+		result = pool.allocatorPool.Acquire(GetCompletedFenceValue(), commandAllocator);
+	}
+
+	if (result == ALLOCATOR_POOL::ACQUIRE_REUSED)
+	{
+		_Device.ResetCommandAllocator(commandAllocator);
+	}
+	else
+	{
+		commandAllocator = _Device.CreateCommandAllocator();
+	}
+
+	if (pool.commandListQueue.empty() == false)
+	{
+		commandList = pool.commandListQueue.front();
+		pool.commandListQueue.pop();
+
+		_Device.ResetCommandList(commandList, commandAllocator);
+		_Device.GetStateTracker(commandList)->Reset();
+	}
+	else
+	{
+		commandList = _Device.CreateCommandList(commandAllocator);
+
+		// Copy queues decay every resource they access back to COMMON.
+		pool.stateTrackers.push_back(std::make_unique<RESOURCE_STATE_TRACKER>(&_Device.GetGlobalStates(), _Device.DecaysAllStates()));
+		_Device.SetStateTracker(commandList, pool.stateTrackers.back().get());
+	}
+
+	_Device.SetListContext(commandList, commandAllocator, &pool);
+
+	return commandList;
+}
+
+template<typename DEVICE>
+uint64_t BASIC_COMMAND_QUEUE<DEVICE>::ExecuteCommandList(LIST commandList)
+{
+	// ComPtr overloads operator&, take the address of the smart pointer itself.
+	return ExecuteCommandLists(std::addressof(commandList), 1);
+}
+
+template<typename DEVICE>
+uint64_t BASIC_COMMAND_QUEUE<DEVICE>::ExecuteCommandLists(const std::vector<LIST>& commandLists)
+{
+	return ExecuteCommandLists(commandLists.data(), commandLists.size());
+}
+
+template<typename DEVICE>
+uint64_t BASIC_COMMAND_QUEUE<DEVICE>::ExecuteCommandLists(const LIST* commandLists, size_t count)
+{
+	std::vector<RESOURCE_STATE_TRACKER*> trackers(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		// Transitions still batched at the end of the list, e.g. back to PRESENT.
+		_Device.FlushBarriers(commandLists[i]);
+		trackers[i] = _Device.GetStateTracker(commandLists[i]);
+	}
+
+	std::lock_guard<std::mutex> lock(_SubmitMutex);
+
+	// Lists are resolved in submission order, each one sees the final states of the previous ones.
+	std::vector<std::vector<RESOURCE_STATE_TRACKER::BARRIER>> fixUpBarriers(count);
+	{
+		GLOBAL_RESOURCE_STATES& globalStates = _Device.GetGlobalStates();
+		std::unique_lock<std::mutex> statesLock = globalStates.Lock();
+
+		std::vector<const void*> decayed;
+		for (size_t i = 0; i < count; ++i)
+		{
+			trackers[i]->ResolvePendingBarriers(fixUpBarriers[i]);
+			trackers[i]->CommitFinalStates(decayed);
+		}
+		globalStates.Decay(decayed);
+	}
+
+	// A list recorded against states changed since gets the missing transitions right before it.
+	std::vector<LIST> submittedLists;
+	submittedLists.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (fixUpBarriers[i].empty() == false)
+		{
+			LIST fixUpList = AcquireCommandList();
+			_Device.RecordBarriers(fixUpList, fixUpBarriers[i]);
+			submittedLists.push_back(fixUpList);
+		}
+		submittedLists.push_back(commandLists[i]);
+	}
+
+	size_t submittedCount = submittedLists.size();
+	std::vector<SUBMITTED_ENTRY*> submittedEntries(submittedCount);
+	std::vector<THREAD_POOL*> pools(submittedCount);
+
+	for (size_t i = 0; i < submittedCount; ++i)
+	{
+		_Device.CloseCommandList(submittedLists[i]);
+
+		void* pool = nullptr;
+		submittedEntries[i] = new SUBMITTED_ENTRY();
+		_Device.GetListContext(submittedLists[i], submittedEntries[i]->commandAllocator, pool);
+		submittedEntries[i]->commandList = submittedLists[i];
+		pools[i] = static_cast<THREAD_POOL*>(pool);
+	}
+
+	_Device.ExecuteCommandLists(submittedLists.data(), submittedCount);
+	uint64_t fenceValue = SignalInternal();
+
+	// Pushed under the submit lock so each inbox stays sorted by fence value.
+	for (size_t i = 0; i < submittedCount; ++i)
+	{
+		submittedEntries[i]->fenceValue = fenceValue;
+		pools[i]->PushSubmitted(submittedEntries[i]);
+	}
+
+	return fenceValue;
+}
+
+template<typename DEVICE>
+void BASIC_COMMAND_QUEUE<DEVICE>::DiscardCommandList(LIST commandList)
+{
+	_Device.CloseCommandList(commandList);
+
+	void* pool = nullptr;
+	SUBMITTED_ENTRY* entry = new SUBMITTED_ENTRY();
+	_Device.GetListContext(commandList, entry->commandAllocator, pool);
+	entry->commandList = commandList;
+
+	// The GPU never sees the allocator, retiring it with the work already submitted
+	// keeps the inbox sorted by fence value.
+	std::lock_guard<std::mutex> lock(_SubmitMutex);
+	entry->fenceValue = _FenceValue;
+	static_cast<THREAD_POOL*>(pool)->PushSubmitted(entry);
+}
+
+template<typename DEVICE>
+void BASIC_COMMAND_QUEUE<DEVICE>::Wait(BASIC_COMMAND_QUEUE& other, uint64_t fenceValue)
+{
+	if (&other == this || other.IsFenceComplete(fenceValue))
+	{
+		return;
+	}
+
+	// Ordered with the submissions of this queue.
+	std::lock_guard<std::mutex> lock(_SubmitMutex);
+	if (GetQueueDependencies().AddWait(_DependencyIndex, other._DependencyIndex, fenceValue))
+	{
+		_Device.Wait(other._Device, fenceValue);
+	}
+}
+
+template<typename DEVICE>
+uint64_t BASIC_COMMAND_QUEUE<DEVICE>::Signal()
+{
+	std::lock_guard<std::mutex> lock(_SubmitMutex);
+	return SignalInternal();
+}
+
+template<typename DEVICE>
+uint64_t BASIC_COMMAND_QUEUE<DEVICE>::SignalInternal()
+{
+	uint64_t fenceValueForSignal = ++_FenceValue;
+	_Device.Signal(fenceValueForSignal);
+	GetQueueDependencies().AddSignal(_DependencyIndex, fenceValueForSignal);
+
+	return fenceValueForSignal;
+}
+
+template<typename DEVICE>
+uint64_t BASIC_COMMAND_QUEUE<DEVICE>::GetLastSignaledFenceValue()
+{
+	std::lock_guard<std::mutex> lock(_SubmitMutex);
+	return _FenceValue;
+}
+
+template<typename DEVICE>
+uint64_t BASIC_COMMAND_QUEUE<DEVICE>::GetCompletedFenceValue() const
+{
+	return _Device.GetCompletedValue();
+}
+
+template<typename DEVICE>
+bool BASIC_COMMAND_QUEUE<DEVICE>::IsFenceComplete(uint64_t fenceValue) const
+{
+	return GetCompletedFenceValue() >= fenceValue;
+}
+
+template<typename DEVICE>
+void BASIC_COMMAND_QUEUE<DEVICE>::WaitForFenceValue(uint64_t fenceValue, std::chrono::milliseconds duration)
+{
+	_Device.WaitForValue(fenceValue, duration);
+}
+
+template<typename DEVICE>
+void BASIC_COMMAND_QUEUE<DEVICE>::Flush()
+{
+	uint64_t fenceValue = Signal();
+	WaitForFenceValue(fenceValue);
+
+	CollectDeferredReleases();
+}
+
+template<typename DEVICE>
+void BASIC_COMMAND_QUEUE<DEVICE>::ReleaseDeferred(uint64_t sizeInBytes, std::function<void()> release)
+{
+	_DeferredReleaseQueue.Retire(GetLastSignaledFenceValue(), sizeInBytes, std::move(release));
+}
+
+template<typename DEVICE>
+void BASIC_COMMAND_QUEUE<DEVICE>::CollectDeferredReleases()
+{
+	_DeferredReleaseQueue.Collect(GetCompletedFenceValue());
+}
+
+template<typename DEVICE>
+FENCE_COMPLETION_SERVICE& BASIC_COMMAND_QUEUE<DEVICE>::GetCompletionService()
+{
+	std::call_once(_CompletionServiceOnce, [this]() { _CompletionService = std::make_unique<FENCE_COMPLETION_SERVICE>(&_Device.GetCompletionFence()); });
+	return *_CompletionService;
+}
+
+template<typename DEVICE>
+void BASIC_COMMAND_QUEUE<DEVICE>::OnFenceCompletion(uint64_t fenceValue, std::function<void()> callback)
+{
+	GetCompletionService().OnCompletion(fenceValue, std::move(callback));
+}
+
+template<typename DEVICE>
+std::future<void> BASIC_COMMAND_QUEUE<DEVICE>::GetFenceFuture(uint64_t fenceValue)
+{
+	return GetCompletionService().GetFuture(fenceValue);
+}
+
+template<typename DEVICE>
+typename BASIC_COMMAND_QUEUE<DEVICE>::ALLOCATOR_POOL::STATISTICS BASIC_COMMAND_QUEUE<DEVICE>::GetAllocatorStatistics()
+{
+	typename ALLOCATOR_POOL::STATISTICS statistics;
+
+	std::lock_guard<std::mutex> lock(_ThreadPoolsMutex);
+	for (auto& poolIt : _ThreadPools)
+	{
+		typename ALLOCATOR_POOL::STATISTICS poolStatistics = poolIt.second->allocatorPool.GetStatistics();
+		statistics.allocations += poolStatistics.allocations;
+		statistics.reuses += poolStatistics.reuses;
+		statistics.stalls += poolStatistics.stalls;
+	}
+
+	return statistics;
+}
@@ -0,0 +1,81 @@
+#include "Application.h"
+#include "CommandQueue.h"
+#include "FrameScheduler.h"
+#include "Game.h"
+#include "Window.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+// Busy CPU time per frame, stands in for the update and recording work.
+static void SpinFor(std::chrono::microseconds duration)
+{
+	auto end = std::chrono::steady_clock::now() + duration;
+	while (std::chrono::steady_clock::now() < end)
+	{
+	}
+}
+
+// Runs one frame per benchmark iteration through APPLICATION::Run(), closes the window once done.
+class BENCHMARK_GAME : public GAME
+{
+public:
+	BENCHMARK_GAME(benchmark::State& state, std::chrono::microseconds cpuTimePerFrame) :
+		GAME(L"Benchmark", 1280, 720, false),
+		_state(state),
+		_cpuTimePerFrame(cpuTimePerFrame)
+	{
+	}
+
+	virtual bool LoadContent() override { return true; }
+	virtual void UnloadContent() override { ; }
+
+protected:
+	virtual void OnRender(RenderEventArgs&) override
+	{
+		if (_state.KeepRunning() == false)
+		{
+			_window->Close();
+			return;
+		}
+
+		APPLICATION* application = APPLICATION::Instance();
+		FRAME_SCHEDULER* frameScheduler = application->GetFrameScheduler();
+		COMMAND_QUEUE* commandQueue = application->GetCommandQueue();
+
+		frameScheduler->BeginFrame();
+
+		COMMAND_QUEUE::LIST commandList = commandQueue->GetCommandList();
+		SpinFor(_cpuTimePerFrame);
+
+		uint64_t fenceValue = commandQueue->ExecuteCommandList(commandList);
+		_window->Present();
+		frameScheduler->EndFrame(fenceValue);
+	}
+
+private:
+	benchmark::State&			_state;
+	std::chrono::microseconds	_cpuTimePerFrame;
+};
+
+// Frames per second of the headless frame loop for 1 to MAX_FRAMES_IN_FLIGHT frames in flight,
+// with as much CPU as GPU time per frame. A single frame in flight serializes both.
+static void BM_FrameLoop(benchmark::State& state)
+{
+	const std::chrono::microseconds frameTime(500);
+
+	APPLICATION* application = APPLICATION::CreateInstance();
+	application->SetFramesInFlight(static_cast<uint32_t>(state.range(0)));
+	application->GetDevice()->SetGpuTimePerList(frameTime);
+
+	application->Run(std::make_shared<BENCHMARK_GAME>(state, frameTime));
+
+	const FRAME_SCHEDULER::STATISTICS& statistics = application->GetFrameScheduler()->GetStatistics();
+	state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+	state.counters["cpuWaitMs"] = statistics.averageCpuWaitMs;
+	state.counters["framesQueued"] = statistics.averageFramesQueued;
+
+	APPLICATION::DeleteInstance();
+}
+BENCHMARK(BM_FrameLoop)->Arg(1)->Arg(2)->Arg(3)->Arg(FRAME_SCHEDULER::MAX_FRAMES_IN_FLIGHT)->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,224 @@
+#include "AssetStreamer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+// Stand-in for the COPY queue: the copies of a submission are written to the destination
+// file by a background thread, which then signals the fence. Destinations are FILE*.
+class FILE_STREAMING_BACKEND : public STREAMING_BACKEND
+{
+public:
+	FILE_STREAMING_BACKEND(uint64_t stagingSize) :
+		_staging(stagingSize)
+	{
+		_thread = std::thread(&FILE_STREAMING_BACKEND::ThreadMain, this);
+	}
+
+	virtual ~FILE_STREAMING_BACKEND()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_condition.notify_one();
+		_thread.join();
+	}
+
+	virtual uint8_t* GetStagingMemory() override { return _staging.data(); }
+	virtual uint64_t GetStagingSize() const override { return _staging.size(); }
+
+	virtual void Copy(void* destination, uint64_t destinationOffset, uint64_t stagingOffset, uint64_t size) override
+	{
+		_recorded.push_back(COPY{ static_cast<std::FILE*>(destination), destinationOffset, stagingOffset, size });
+	}
+
+	virtual uint64_t Submit() override
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_submissions.push_back(SUBMISSION{ ++_fenceValue, std::move(_recorded) });
+		_recorded.clear();
+		_condition.notify_one();
+		return _fenceValue;
+	}
+
+	virtual FENCE& GetFence() override { return _fence; }
+
+private:
+	struct COPY
+	{
+		std::FILE*	destination;
+		uint64_t	destinationOffset;
+		uint64_t	stagingOffset;
+		uint64_t	size;
+	};
+
+	struct SUBMISSION
+	{
+		uint64_t			fenceValue;
+		std::vector<COPY>	copies;
+	};
+
+	void ThreadMain()
+	{
+		while (true)
+		{
+			SUBMISSION submission;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_condition.wait(lock, [this]() { return _stop || _submissions.empty() == false; });
+				if (_submissions.empty())
+				{
+					return;
+				}
+				submission = std::move(_submissions.front());
+				_submissions.pop_front();
+			}
+
+			for (const COPY& copy : submission.copies)
+			{
+				std::fseek(copy.destination, static_cast<long>(copy.destinationOffset), SEEK_SET);
+				std::fwrite(_staging.data() + copy.stagingOffset, 1, static_cast<size_t>(copy.size), copy.destination);
+			}
+			_fence.Signal(submission.fenceValue);
+		}
+	}
+
+	std::vector<uint8_t>	_staging;
+	std::vector<COPY>		_recorded;		// Streamer thread only
+	SOFTWARE_FENCE			_fence;
+
+	std::mutex				_mutex;
+	std::condition_variable	_condition;
+	std::deque<SUBMISSION>	_submissions;
+	uint64_t				_fenceValue = 0;
+	bool					_stop = false;
+
+	std::thread	_thread;
+};
+
+// Source and destination files of the benchmarks, removed when closed.
+class STREAMING_FILES
+{
+public:
+	STREAMING_FILES(uint64_t size)
+	{
+		_source = std::tmpfile();
+		_destination = std::tmpfile();
+
+		std::vector<uint8_t> data(1 << 20);
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			data[i] = static_cast<uint8_t>(i * 31);
+		}
+		for (uint64_t offset = 0; offset < size; offset += data.size())
+		{
+			std::fwrite(data.data(), 1, data.size(), _source);
+		}
+		std::fflush(_source);
+	}
+
+	~STREAMING_FILES()
+	{
+		std::fclose(_source);
+		std::fclose(_destination);
+	}
+
+	// Request streaming [offset, offset + size) of the source to the same place in the destination.
+	STREAM_REQUEST MakeRequest(uint64_t offset, uint64_t size, int priority, std::function<void(STREAM_STATUS)> completion)
+	{
+		STREAM_REQUEST request;
+		request.destination = _destination;
+		request.destinationOffset = offset;
+		request.size = size;
+		request.priority = priority;
+		request.read = [this, offset](void* staging, uint64_t sourceOffset, uint64_t chunkSize)
+		{
+			std::fseek(_source, static_cast<long>(offset + sourceOffset), SEEK_SET);
+			return std::fread(staging, 1, static_cast<size_t>(chunkSize), _source) == chunkSize;
+		};
+		request.completion = std::move(completion);
+		return request;
+	}
+
+private:
+	std::FILE*	_source = nullptr;
+	std::FILE*	_destination = nullptr;
+};
+
+// Bytes per second streamed from file to file through 16 MiB of staging memory, in
+// requests of 4 MiB split in chunks of state.range(0) bytes.
+static void BM_StreamFiles(benchmark::State& state)
+{
+	const uint64_t totalSize = 64 << 20;
+	const uint64_t requestSize = 4 << 20;
+
+	STREAMING_FILES files(totalSize);
+	FILE_STREAMING_BACKEND backend(16 << 20);
+	ASSET_STREAMER streamer(&backend, static_cast<uint64_t>(state.range(0)));
+
+	for (auto _ : state)
+	{
+		for (uint64_t offset = 0; offset < totalSize; offset += requestSize)
+		{
+			streamer.Request(files.MakeRequest(offset, requestSize, 0, nullptr));
+		}
+		streamer.WaitForIdle();
+	}
+
+	ASSET_STREAMER::STATISTICS statistics = streamer.GetStatistics();
+	state.SetBytesProcessed(state.iterations() * totalSize);
+	state.counters["submits"] = static_cast<double>(statistics.submitCount) / state.iterations();
+	state.counters["stagingStalls"] = static_cast<double>(statistics.stagingStallCount) / state.iterations();
+}
+BENCHMARK(BM_StreamFiles)->RangeMultiplier(4)->Range(64 << 10, 4 << 20)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Time from startup until the 4 MiB the first frame needs are streamed, requested
+// after 60 MiB of background assets. state.range(0) gives the first frame a higher
+// priority so it takes over at the next chunk, without it the first frame waits in line.
+static void BM_StartupToFirstFrame(benchmark::State& state)
+{
+	const uint64_t backgroundSize = 60 << 20;
+	const uint64_t firstFrameSize = 4 << 20;
+	const uint64_t requestSize = 1 << 20;
+	const int firstFramePriority = state.range(0) ? 1 : 0;
+
+	STREAMING_FILES files(backgroundSize + firstFrameSize);
+
+	for (auto _ : state)
+	{
+		std::unique_ptr<FILE_STREAMING_BACKEND> backend = std::make_unique<FILE_STREAMING_BACKEND>(16 << 20);
+		std::unique_ptr<ASSET_STREAMER> streamer = std::make_unique<ASSET_STREAMER>(backend.get(), 256 << 10);
+
+		for (uint64_t offset = 0; offset < backgroundSize; offset += requestSize)
+		{
+			streamer->Request(files.MakeRequest(offset, requestSize, 0, nullptr));
+		}
+
+		std::promise<void> firstFrame;
+		std::atomic<uint64_t> remaining{ firstFrameSize / requestSize };
+		for (uint64_t offset = backgroundSize; offset < backgroundSize + firstFrameSize; offset += requestSize)
+		{
+			streamer->Request(files.MakeRequest(offset, requestSize, firstFramePriority, [&](STREAM_STATUS)
+			{
+				if (--remaining == 0)
+				{
+					firstFrame.set_value();
+				}
+			}));
+		}
+		firstFrame.get_future().wait();
+
+		// The background assets left are cancelled, only the first frame is timed.
+		state.PauseTiming();
+		streamer.reset();
+		backend.reset();
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(BM_StartupToFirstFrame)->ArgName("prioritized")->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
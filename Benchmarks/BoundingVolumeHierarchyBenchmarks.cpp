@@ -0,0 +1,232 @@
+#include "BoundingVolumeHierarchy.h"
+#include "JobSystem.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace VectorMath;
+
+const float g_sceneDensity = 1.0f / 1000.0f;	// Volumes per cubic unit
+const uint32_t g_raysPerIteration = 256;
+
+// state.range(0) cubes scattered at a constant density, seen from the center of the scene
+// along +z with a 60 degrees field of view, about a tenth of them are visible. 'moved' holds
+// the same cubes a step further, as the refit of a frame sees them.
+class BVH_SCENE
+{
+public:
+	BVH_SCENE(uint32_t volumeCount)
+	{
+		sceneRadius = 0.5f * std::cbrt(volumeCount / g_sceneDensity);
+
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> position(-sceneRadius, sceneRadius);
+		std::uniform_real_distribution<float> size(0.5f, 4.0f);
+		std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+
+		volumes.Resize(volumeCount);
+		moved.Resize(volumeCount);
+		for (uint32_t i = 0; i < volumeCount; ++i)
+		{
+			float center[3] = { position(random), position(random), position(random) };
+			float halfSize = size(random);
+			float extent[3] = { halfSize, halfSize, halfSize };
+			volumes.Set(i, center, extent, halfSize * 1.7320508f);
+
+			float movedCenter[3] = { center[0] + step(random), center[1] + step(random), center[2] + step(random) };
+			moved.Set(i, movedCenter, extent, halfSize * 1.7320508f);
+		}
+		visible.resize(volumes.GetPaddedCount());
+
+		MATRIX view = MatrixLookAtLH(VectorSet(0.0f, 0.0f, 0.0f, 1.0f), VectorSet(0.0f, 0.0f, 1.0f, 1.0f), VectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		MATRIX projection = MatrixPerspectiveFovLH(ConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 2.0f * sceneRadius);
+		frustum = ExtractFrustum(MatrixMultiply(view, projection));
+	}
+
+	// Rays from random points of the scene in random directions.
+	void CreateRays(std::vector<FLOAT3>& origins, std::vector<FLOAT3>& directions) const
+	{
+		std::mt19937 random(13);
+		std::uniform_real_distribution<float> position(-sceneRadius, sceneRadius);
+		std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+		origins.resize(g_raysPerIteration);
+		directions.resize(g_raysPerIteration);
+		for (uint32_t i = 0; i < g_raysPerIteration; ++i)
+		{
+			origins[i] = { position(random), position(random), position(random) };
+			directions[i] = { direction(random), direction(random), direction(random) };
+		}
+	}
+
+	BOUNDING_VOLUMES		volumes;
+	BOUNDING_VOLUMES		moved;
+	std::vector<uint32_t>	visible;
+	FRUSTUM					frustum;
+	float					sceneRadius = 0.0f;
+};
+
+static void BM_BuildBoundingVolumeHierarchy(benchmark::State& state)
+{
+	BVH_SCENE scene(static_cast<uint32_t>(state.range(0)));
+	BOUNDING_VOLUME_HIERARCHY hierarchy;
+
+	for (auto _ : state)
+	{
+		hierarchy.Build(scene.volumes);
+		benchmark::DoNotOptimize(hierarchy.GetNodes().data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["nodes"] = static_cast<double>(hierarchy.GetNodes().size());
+}
+BENCHMARK(BM_BuildBoundingVolumeHierarchy)->RangeMultiplier(8)->Range(1 << 14, 1 << 20)->Unit(benchmark::kMillisecond);
+
+// Subtrees of more than 4096 primitives built across the job system.
+static void BM_BuildBoundingVolumeHierarchyParallel(benchmark::State& state)
+{
+	JOB_SYSTEM jobSystem;
+	BVH_SCENE scene(static_cast<uint32_t>(state.range(0)));
+	BOUNDING_VOLUME_HIERARCHY hierarchy;
+
+	for (auto _ : state)
+	{
+		hierarchy.Build(scene.volumes, &jobSystem);
+		benchmark::DoNotOptimize(hierarchy.GetNodes().data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["workers"] = jobSystem.GetWorkerCount();
+}
+BENCHMARK(BM_BuildBoundingVolumeHierarchyParallel)->RangeMultiplier(8)->Range(1 << 14, 1 << 20)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Every primitive moved, alternating between two positions, the topology is kept.
+static void BM_RefitBoundingVolumeHierarchy(benchmark::State& state)
+{
+	BVH_SCENE scene(static_cast<uint32_t>(state.range(0)));
+	BOUNDING_VOLUME_HIERARCHY hierarchy;
+	hierarchy.Build(scene.volumes);
+
+	bool moved = false;
+	for (auto _ : state)
+	{
+		moved = !moved;
+		hierarchy.Refit(moved ? scene.moved : scene.volumes);
+		benchmark::DoNotOptimize(hierarchy.GetNodes().data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RefitBoundingVolumeHierarchy)->RangeMultiplier(8)->Range(1 << 14, 1 << 20)->Unit(benchmark::kMillisecond);
+
+// Frustum query through the hierarchy, against culling every volume below.
+static void BM_QueryFrustumHierarchy(benchmark::State& state)
+{
+	BVH_SCENE scene(static_cast<uint32_t>(state.range(0)));
+	BOUNDING_VOLUME_HIERARCHY hierarchy;
+	hierarchy.Build(scene.volumes);
+
+	uint32_t visibleCount = 0;
+	for (auto _ : state)
+	{
+		visibleCount = hierarchy.QueryFrustum(scene.frustum, scene.visible.data());
+		benchmark::DoNotOptimize(visibleCount);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["visible"] = static_cast<double>(visibleCount) / static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_QueryFrustumHierarchy)->RangeMultiplier(8)->Range(1 << 14, 1 << 20)->Unit(benchmark::kMicrosecond);
+
+// Brute force, every volume tested with the best instruction set.
+static void BM_QueryFrustumFlat(benchmark::State& state)
+{
+	BVH_SCENE scene(static_cast<uint32_t>(state.range(0)));
+
+	uint32_t visibleCount = 0;
+	for (auto _ : state)
+	{
+		visibleCount = CullBoundingVolumes(scene.frustum, scene.volumes, 0, scene.volumes.count, scene.visible.data(), GetBestCullingIsa());
+		benchmark::DoNotOptimize(visibleCount);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["visible"] = static_cast<double>(visibleCount) / static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_QueryFrustumFlat)->RangeMultiplier(8)->Range(1 << 14, 1 << 20)->Unit(benchmark::kMicrosecond);
+
+// 256 rays through the hierarchy, items are rays.
+static void BM_RaycastHierarchy(benchmark::State& state)
+{
+	BVH_SCENE scene(static_cast<uint32_t>(state.range(0)));
+	BOUNDING_VOLUME_HIERARCHY hierarchy;
+	hierarchy.Build(scene.volumes);
+	std::vector<FLOAT3> origins, directions;
+	scene.CreateRays(origins, directions);
+
+	uint32_t hitCount = 0;
+	for (auto _ : state)
+	{
+		hitCount = 0;
+		for (uint32_t i = 0; i < g_raysPerIteration; ++i)
+		{
+			RAY_HIT hit;
+			hitCount += hierarchy.Raycast(&origins[i].x, &directions[i].x, FLT_MAX, hit) ? 1 : 0;
+		}
+		benchmark::DoNotOptimize(hitCount);
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_raysPerIteration);
+	state.counters["hits"] = static_cast<double>(hitCount) / g_raysPerIteration;
+}
+BENCHMARK(BM_RaycastHierarchy)->RangeMultiplier(8)->Range(1 << 14, 1 << 20)->Unit(benchmark::kMicrosecond);
+
+// The same rays tested against every box with the slab test, up to 256K boxes as a
+// single iteration already takes seconds past that.
+static void BM_RaycastFlat(benchmark::State& state)
+{
+	BVH_SCENE scene(static_cast<uint32_t>(state.range(0)));
+	std::vector<FLOAT3> origins, directions;
+	scene.CreateRays(origins, directions);
+	const BOUNDING_VOLUMES& volumes = scene.volumes;
+
+	uint32_t hitCount = 0;
+	for (auto _ : state)
+	{
+		hitCount = 0;
+		for (uint32_t i = 0; i < g_raysPerIteration; ++i)
+		{
+			const float origin[3] = { origins[i].x, origins[i].y, origins[i].z };
+			const float inverseDirection[3] = { 1.0f / directions[i].x, 1.0f / directions[i].y, 1.0f / directions[i].z };
+
+			float closest = FLT_MAX;
+			for (uint32_t v = 0; v < volumes.count; ++v)
+			{
+				const float center[3] = { volumes.centerX[v], volumes.centerY[v], volumes.centerZ[v] };
+				const float extent[3] = { volumes.extentX[v], volumes.extentY[v], volumes.extentZ[v] };
+
+				float entry = 0.0f;
+				float exit = closest;
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					float t0 = (center[axis] - extent[axis] - origin[axis]) * inverseDirection[axis];
+					float t1 = (center[axis] + extent[axis] - origin[axis]) * inverseDirection[axis];
+					entry = std::max(entry, std::min(t0, t1));
+					exit = std::min(exit, std::max(t0, t1));
+				}
+				closest = entry <= exit ? entry : closest;
+			}
+			hitCount += closest != FLT_MAX ? 1 : 0;
+		}
+		benchmark::DoNotOptimize(hitCount);
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_raysPerIteration);
+	state.counters["hits"] = static_cast<double>(hitCount) / g_raysPerIteration;
+}
+BENCHMARK(BM_RaycastFlat)->RangeMultiplier(8)->Range(1 << 14, 1 << 18)->Unit(benchmark::kMicrosecond);
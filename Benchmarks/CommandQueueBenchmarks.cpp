@@ -0,0 +1,97 @@
+#include "CommandQueue.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+// Draws recorded in each command list.
+const int g_drawsPerList = 64;
+
+static NULL_DEVICE*		g_device = nullptr;
+static COMMAND_QUEUE*	g_commandQueue = nullptr;
+
+// Command lists recorded and submitted per second on one queue, from 1 to 16 recording
+// threads. Each thread owns its allocators and lists, only the submission is serialized.
+static void BM_RecordCommandLists(benchmark::State& state)
+{
+	if (state.thread_index() == 0)
+	{
+		g_device = new NULL_DEVICE();
+		g_commandQueue = new COMMAND_QUEUE(g_device, NULL_COMMAND_LIST_TYPE_DIRECT);
+	}
+
+	for (auto _ : state)
+	{
+		COMMAND_QUEUE::LIST commandList = g_commandQueue->GetCommandList();
+		for (int i = 0; i < g_drawsPerList; ++i)
+		{
+			commandList->Record(nullptr);
+		}
+		benchmark::DoNotOptimize(g_commandQueue->ExecuteCommandList(commandList));
+	}
+
+	state.SetItemsProcessed(state.iterations());
+
+	if (state.thread_index() == 0)
+	{
+		COMMAND_QUEUE::ALLOCATOR_POOL::STATISTICS statistics = g_commandQueue->GetAllocatorStatistics();
+		state.counters["allocations"] = static_cast<double>(statistics.allocations);
+		state.counters["stalls"] = static_cast<double>(statistics.stalls);
+
+		delete g_commandQueue;
+		delete g_device;
+	}
+}
+BENCHMARK(BM_RecordCommandLists)->ThreadRange(1, 16)->UseRealTime();
+
+// One frame of state.range(0) command lists, submitted one ExecuteCommandList() at a time
+// or in a single ExecuteCommandLists() batch, each submission signals the fence once.
+static void SubmitFrames(benchmark::State& state, bool batched)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE commandQueue(&device, NULL_COMMAND_LIST_TYPE_DIRECT);
+
+	std::vector<COMMAND_QUEUE::LIST> commandLists(static_cast<size_t>(state.range(0)));
+	for (auto _ : state)
+	{
+		for (COMMAND_QUEUE::LIST& commandList : commandLists)
+		{
+			commandList = commandQueue.GetCommandList();
+			for (int i = 0; i < g_drawsPerList; ++i)
+			{
+				commandList->Record(nullptr);
+			}
+		}
+
+		uint64_t fenceValue = 0;
+		if (batched)
+		{
+			fenceValue = commandQueue.ExecuteCommandLists(commandLists);
+		}
+		else
+		{
+			for (const COMMAND_QUEUE::LIST& commandList : commandLists)
+			{
+				fenceValue = commandQueue.ExecuteCommandList(commandList);
+			}
+		}
+		commandQueue.WaitForFenceValue(fenceValue);
+	}
+
+	NULL_QUEUE_DEVICE::STATISTICS statistics = commandQueue.GetDevice().GetStatistics();
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["submissions"] = static_cast<double>(statistics.executeCalls) / static_cast<double>(state.iterations());
+	state.counters["signals"] = static_cast<double>(statistics.signals) / static_cast<double>(state.iterations());
+}
+
+static void BM_SubmitPerList(benchmark::State& state)
+{
+	SubmitFrames(state, false);
+}
+BENCHMARK(BM_SubmitPerList)->RangeMultiplier(4)->Range(1, 64)->UseRealTime();
+
+static void BM_SubmitBatched(benchmark::State& state)
+{
+	SubmitFrames(state, true);
+}
+BENCHMARK(BM_SubmitBatched)->RangeMultiplier(4)->Range(1, 64)->UseRealTime();
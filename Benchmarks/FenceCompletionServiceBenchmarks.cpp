@@ -0,0 +1,48 @@
+#include "FenceCompletionService.h"
+
+#include <benchmark/benchmark.h>
+
+#include <future>
+
+// Callbacks retired per second, state.range(0) fence values are pending when the
+// fence jumps over all of them at once.
+static void BM_RetireCallbacks(benchmark::State& state)
+{
+	SOFTWARE_FENCE fence;
+	FENCE_COMPLETION_SERVICE service(&fence);
+
+	uint64_t fenceValue = 0;
+	uint64_t retired = 0;
+	for (auto _ : state)
+	{
+		for (int64_t i = 0; i < state.range(0); ++i)
+		{
+			service.OnCompletion(++fenceValue, [&retired]() { retired++; });
+		}
+		std::future<void> future = service.GetFuture(fenceValue);
+
+		fence.Signal(fenceValue);
+		future.wait();
+	}
+
+	benchmark::DoNotOptimize(retired);
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RetireCallbacks)->RangeMultiplier(8)->Range(1, 4096)->UseRealTime();
+
+// Time from Signal() to a future of that value being ready, one round trip through the
+// service thread.
+static void BM_SignalToFuture(benchmark::State& state)
+{
+	SOFTWARE_FENCE fence;
+	FENCE_COMPLETION_SERVICE service(&fence);
+
+	uint64_t fenceValue = 0;
+	for (auto _ : state)
+	{
+		std::future<void> future = service.GetFuture(++fenceValue);
+		fence.Signal(fenceValue);
+		future.wait();
+	}
+}
+BENCHMARK(BM_SignalToFuture)->UseRealTime();
@@ -0,0 +1,62 @@
+#include "FreeListAllocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Free and Allocate pairs per second on a heap of state.range(0) descriptors kept about
+// half full, with the table sizes of a typical root signature (1 to 32 descriptors).
+static void BM_FreeListAllocateFree(benchmark::State& state)
+{
+	const uint32_t capacity = static_cast<uint32_t>(state.range(0));
+
+	FREE_LIST_ALLOCATOR allocator(capacity);
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<uint32_t> counts(1, 32);
+
+	struct RANGE
+	{
+		uint32_t offset;
+		uint32_t count;
+	};
+	std::vector<RANGE> live;
+	for (uint32_t count = counts(random); allocator.GetLargestFreeRange() >= count; count = counts(random))
+	{
+		live.push_back(RANGE{ allocator.Allocate(count), count });
+	}
+
+	// Every other range freed, the free list starts fragmented.
+	std::shuffle(live.begin(), live.end(), random);
+	for (size_t i = live.size() / 2; i < live.size(); ++i)
+	{
+		allocator.Free(live[i].offset, live[i].count);
+	}
+	live.resize(live.size() / 2);
+
+	std::vector<uint32_t> newCounts(1024);
+	for (uint32_t& count : newCounts)
+	{
+		count = counts(random);
+	}
+
+	// Each iteration frees a live range and allocates one of a different size in its place.
+	size_t step = 0;
+	for (auto _ : state)
+	{
+		RANGE& range = live[step % live.size()];
+		if (range.offset != FREE_LIST_ALLOCATOR::INVALID_OFFSET)
+		{
+			allocator.Free(range.offset, range.count);
+		}
+		range.count = newCounts[step % newCounts.size()];
+		range.offset = allocator.Allocate(range.count);
+		benchmark::DoNotOptimize(range.offset);
+		++step;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.counters["freeRanges"] = static_cast<double>(allocator.GetFreeRangeCount());
+}
+BENCHMARK(BM_FreeListAllocateFree)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
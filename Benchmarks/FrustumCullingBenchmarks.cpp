@@ -0,0 +1,100 @@
+#include "FrustumCulling.h"
+#include "JobSystem.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace VectorMath;
+
+const uint32_t g_volumeCount = 1000000;
+const float g_sceneRadius = 500.0f;
+
+// Cubes of random sizes scattered in the scene, seen from its center along +z
+// with a 60 degrees field of view, about a tenth of them are visible.
+class CULLING_SCENE
+{
+public:
+	CULLING_SCENE()
+	{
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> position(-g_sceneRadius, g_sceneRadius);
+		std::uniform_real_distribution<float> size(0.5f, 4.0f);
+
+		volumes.Resize(g_volumeCount);
+		for (uint32_t i = 0; i < g_volumeCount; ++i)
+		{
+			float center[3] = { position(random), position(random), position(random) };
+			float halfSize = size(random);
+			float extent[3] = { halfSize, halfSize, halfSize };
+			volumes.Set(i, center, extent, halfSize * 1.7320508f);
+		}
+		visible.resize(volumes.GetPaddedCount());
+
+		MATRIX view = MatrixLookAtLH(VectorSet(0.0f, 0.0f, 0.0f, 1.0f), VectorSet(0.0f, 0.0f, 1.0f, 1.0f), VectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		MATRIX projection = MatrixPerspectiveFovLH(ConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 2.0f * g_sceneRadius);
+		frustum = ExtractFrustum(MatrixMultiply(view, projection));
+	}
+
+	BOUNDING_VOLUMES		volumes;
+	std::vector<uint32_t>	visible;
+	FRUSTUM					frustum;
+};
+
+// AVX2 is only run when the CPU has it, SSE2 everywhere on x86.
+static bool IsCullingIsaSupported(CULLING_ISA isa)
+{
+	CULLING_ISA best = GetBestCullingIsa();
+	return isa == CULLING_ISA_SCALAR || (best != CULLING_ISA_SCALAR && isa <= best);
+}
+
+// 1M volumes culled on one thread with the instruction set state.range(0).
+static void BM_CullBoundingVolumes(benchmark::State& state)
+{
+	CULLING_ISA isa = static_cast<CULLING_ISA>(state.range(0));
+	state.SetLabel(GetCullingIsaName(isa));
+	if (IsCullingIsaSupported(isa) == false)
+	{
+		state.SkipWithError("Instruction set not supported by this CPU.");
+		return;
+	}
+
+	CULLING_SCENE scene;
+	uint32_t visibleCount = 0;
+	for (auto _ : state)
+	{
+		visibleCount = CullBoundingVolumes(scene.frustum, scene.volumes, 0, g_volumeCount, scene.visible.data(), isa);
+		benchmark::DoNotOptimize(visibleCount);
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_volumeCount);
+	state.counters["visible"] = static_cast<double>(visibleCount) / g_volumeCount;
+}
+BENCHMARK(BM_CullBoundingVolumes)->Arg(CULLING_ISA_SCALAR)->Arg(CULLING_ISA_SSE2)->Arg(CULLING_ISA_AVX2)->Unit(benchmark::kMicrosecond);
+
+// Same across the job system, chunks compacted in order as the tutorial culls them.
+static void BM_CullBoundingVolumesParallel(benchmark::State& state)
+{
+	CULLING_ISA isa = static_cast<CULLING_ISA>(state.range(0));
+	state.SetLabel(GetCullingIsaName(isa));
+	if (IsCullingIsaSupported(isa) == false)
+	{
+		state.SkipWithError("Instruction set not supported by this CPU.");
+		return;
+	}
+
+	JOB_SYSTEM jobSystem;
+	CULLING_SCENE scene;
+	uint32_t visibleCount = 0;
+	for (auto _ : state)
+	{
+		visibleCount = CullBoundingVolumes(scene.frustum, scene.volumes, scene.visible.data(), &jobSystem, isa);
+		benchmark::DoNotOptimize(visibleCount);
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_volumeCount);
+	state.counters["visible"] = static_cast<double>(visibleCount) / g_volumeCount;
+	state.counters["workers"] = jobSystem.GetWorkerCount();
+}
+BENCHMARK(BM_CullBoundingVolumesParallel)->Arg(CULLING_ISA_SSE2)->Arg(CULLING_ISA_AVX2)->UseRealTime()->Unit(benchmark::kMicrosecond);
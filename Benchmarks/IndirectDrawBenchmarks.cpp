@@ -0,0 +1,90 @@
+#include "IndirectDraw.h"
+#include "JobSystem.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <vector>
+
+// One draw per object of the stress scene with a few submeshes each, as drawn per object.
+const uint32_t g_drawCount = 1000000;
+const uint32_t g_submeshCount = 4;
+const uint32_t g_indirectDrawsPerJob = 16384;
+
+// Draws in the order the tutorial lists them, instance by instance then submesh by submesh.
+static void CreateDraws(std::vector<INDIRECT_DRAW>& draws, std::vector<MESH_SUBMESH>& submeshes)
+{
+	submeshes.resize(g_submeshCount);
+	for (uint32_t i = 0; i < g_submeshCount; ++i)
+	{
+		MESH_SUBMESH& submesh = submeshes[i];
+		submesh = {};
+		submesh.firstIndex = i * 36;
+		submesh.indexCount = 36;
+		submesh.baseVertex = static_cast<int32_t>(i * 24);
+	}
+
+	draws.resize(g_drawCount);
+	for (uint32_t i = 0; i < g_drawCount; ++i)
+	{
+		INDIRECT_DRAW& draw = draws[i];
+		draw.submesh = i % g_submeshCount;
+		draw.firstInstance = i / g_submeshCount;
+		draw.instanceCount = 1;
+	}
+}
+
+static void SetDrawCounters(benchmark::State& state, std::chrono::duration<double, std::milli> packTime)
+{
+	state.SetItemsProcessed(state.iterations() * g_drawCount);
+	state.counters["drawsPerMs"] = static_cast<double>(state.iterations()) * g_drawCount / packTime.count();
+}
+
+// 1M commands packed on one thread, reported in draws per millisecond.
+static void BM_PackIndirectDraws(benchmark::State& state)
+{
+	std::vector<INDIRECT_DRAW> draws;
+	std::vector<MESH_SUBMESH> submeshes;
+	CreateDraws(draws, submeshes);
+	std::vector<INDIRECT_DRAW_COMMAND> commands(g_drawCount);
+
+	std::chrono::duration<double, std::milli> packTime(0.0);
+	for (auto _ : state)
+	{
+		auto start = std::chrono::steady_clock::now();
+		PackIndirectDraws(commands.data(), draws.data(), 0, g_drawCount, submeshes.data());
+		benchmark::DoNotOptimize(commands.data());
+		benchmark::ClobberMemory();
+		packTime += std::chrono::steady_clock::now() - start;
+	}
+
+	SetDrawCounters(state, packTime);
+}
+BENCHMARK(BM_PackIndirectDraws)->Unit(benchmark::kMillisecond);
+
+// Split over the job system in ranges of 16384 draws, as the tutorial packs them.
+static void BM_PackIndirectDrawsParallel(benchmark::State& state)
+{
+	JOB_SYSTEM jobSystem;
+	std::vector<INDIRECT_DRAW> draws;
+	std::vector<MESH_SUBMESH> submeshes;
+	CreateDraws(draws, submeshes);
+	std::vector<INDIRECT_DRAW_COMMAND> commands(g_drawCount);
+
+	std::chrono::duration<double, std::milli> packTime(0.0);
+	for (auto _ : state)
+	{
+		auto start = std::chrono::steady_clock::now();
+		jobSystem.ParallelFor(g_drawCount, g_indirectDrawsPerJob, [&](uint32_t begin, uint32_t end)
+		{
+			PackIndirectDraws(commands.data(), draws.data(), begin, end, submeshes.data());
+		});
+		benchmark::DoNotOptimize(commands.data());
+		benchmark::ClobberMemory();
+		packTime += std::chrono::steady_clock::now() - start;
+	}
+
+	SetDrawCounters(state, packTime);
+	state.counters["workers"] = jobSystem.GetWorkerCount();
+}
+BENCHMARK(BM_PackIndirectDrawsParallel)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,85 @@
+#include "InstanceTransforms.h"
+#include "JobSystem.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace VectorMath;
+
+// The stress scene of the tutorial.
+const uint32_t g_instanceCount = 100000;
+const float g_instanceSpacing = 4.0f;
+const FLOAT3 g_axis = { 0.0f, 1.0f, 0.0f };
+const float g_angularSpeed = 1.0f;
+
+static void BM_BuildInstanceTransforms(benchmark::State& state)
+{
+	INSTANCE_SET instances;
+	CreateInstanceGrid(instances, g_instanceCount, g_instanceSpacing);
+	std::vector<FLOAT4X4> transforms(g_instanceCount);
+	const MATRIX base = MatrixScaling(0.5f, 0.5f, 0.5f);
+
+	float time = 0.0f;
+	for (auto _ : state)
+	{
+		BuildInstanceTransforms(transforms.data(), instances, 0, instances.GetGroupCount(), base, g_axis, time, g_angularSpeed);
+		benchmark::DoNotOptimize(transforms.data());
+		time += 0.016f;
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_instanceCount);
+}
+BENCHMARK(BM_BuildInstanceTransforms)->Unit(benchmark::kMicrosecond);
+
+// Same matrices one instance at a time with the matrix functions, the way the tutorial
+// built them before the instances were stored as structure of arrays.
+static void BM_BuildInstanceTransformsPerInstance(benchmark::State& state)
+{
+	INSTANCE_SET instances;
+	CreateInstanceGrid(instances, g_instanceCount, g_instanceSpacing);
+	std::vector<FLOAT4X4> transforms(g_instanceCount);
+	const MATRIX base = MatrixScaling(0.5f, 0.5f, 0.5f);
+	const VECTOR axis = VectorSet(g_axis.x, g_axis.y, g_axis.z, 0.0f);
+
+	float time = 0.0f;
+	for (auto _ : state)
+	{
+		for (uint32_t i = 0; i < g_instanceCount; ++i)
+		{
+			MATRIX rotation = MatrixRotationQuaternion(QuaternionRotationNormal(axis, instances.phase[i] + time * g_angularSpeed));
+			MATRIX translation = MatrixTranslation(instances.positionX[i], instances.positionY[i], instances.positionZ[i]);
+			StoreFloat4x4(&transforms[i], MatrixTranspose(MatrixMultiply(MatrixMultiply(base, rotation), translation)));
+		}
+		benchmark::DoNotOptimize(transforms.data());
+		time += 0.016f;
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_instanceCount);
+}
+BENCHMARK(BM_BuildInstanceTransformsPerInstance)->Unit(benchmark::kMicrosecond);
+
+// Split over the job system in ranges of 1024 groups, as the tutorial builds them.
+static void BM_BuildInstanceTransformsParallel(benchmark::State& state)
+{
+	JOB_SYSTEM jobSystem;
+	INSTANCE_SET instances;
+	CreateInstanceGrid(instances, g_instanceCount, g_instanceSpacing);
+	std::vector<FLOAT4X4> transforms(g_instanceCount);
+	const MATRIX base = MatrixScaling(0.5f, 0.5f, 0.5f);
+
+	float time = 0.0f;
+	for (auto _ : state)
+	{
+		jobSystem.ParallelFor(instances.GetGroupCount(), 1024, [&](uint32_t begin, uint32_t end)
+		{
+			BuildInstanceTransforms(transforms.data(), instances, begin, end, base, g_axis, time, g_angularSpeed);
+		});
+		benchmark::DoNotOptimize(transforms.data());
+		time += 0.016f;
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_instanceCount);
+	state.counters["workers"] = jobSystem.GetWorkerCount();
+}
+BENCHMARK(BM_BuildInstanceTransformsParallel)->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,168 @@
+#include "JobSystem.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Worker counts from 1 to one per hardware thread.
+static void WorkerCounts(benchmark::internal::Benchmark* benchmark)
+{
+	uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (uint32_t workerCount = 1; workerCount < hardwareThreads; workerCount *= 2)
+	{
+		benchmark->Arg(workerCount);
+	}
+	benchmark->Arg(hardwareThreads);
+}
+
+// Each call spawns a job for one branch and waits on it, thousands of tiny jobs
+// spawned from inside jobs, dominated by the scheduling cost.
+static uint64_t Fibonacci(JOB_SYSTEM& jobSystem, uint32_t n)
+{
+	if (n < 12)
+	{
+		return n < 2 ? n : Fibonacci(jobSystem, n - 1) + Fibonacci(jobSystem, n - 2);
+	}
+
+	uint64_t a = 0;
+	JOB_COUNTER counter;
+	jobSystem.Run([&jobSystem, &a, n]() { a = Fibonacci(jobSystem, n - 1); }, &counter);
+	uint64_t b = Fibonacci(jobSystem, n - 2);
+	jobSystem.Wait(counter);
+
+	return a + b;
+}
+
+static void BM_JobFibonacci(benchmark::State& state)
+{
+	JOB_SYSTEM jobSystem(static_cast<uint32_t>(state.range(0)));
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(Fibonacci(jobSystem, 30));
+	}
+}
+BENCHMARK(BM_JobFibonacci)->Apply(WorkerCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Sum of squares over 16M floats in ranges of 64K, memory bound.
+static void BM_JobParallelFor(benchmark::State& state)
+{
+	const uint32_t count = 16 << 20;
+	const uint32_t grainSize = 64 << 10;
+
+	JOB_SYSTEM jobSystem(static_cast<uint32_t>(state.range(0)));
+	std::vector<float> values(count, 1.0f);
+	std::vector<double> sums(count / grainSize);
+
+	for (auto _ : state)
+	{
+		jobSystem.ParallelFor(count, grainSize, [&](uint32_t begin, uint32_t end)
+		{
+			double sum = 0.0;
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				sum += values[i] * values[i];
+			}
+			sums[begin / grainSize] = sum;
+		});
+		benchmark::DoNotOptimize(sums.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * count * sizeof(float));
+}
+BENCHMARK(BM_JobParallelFor)->Apply(WorkerCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Layers of nodes depending on two random nodes of the previous layer, the way the
+// passes of a frame depend on each other. A node is queued by its last finishing
+// predecessor, nothing waits in between.
+class JOB_DAG
+{
+public:
+	JOB_DAG(uint32_t layerCount, uint32_t layerWidth) :
+		_nodes(layerCount * layerWidth)
+	{
+		std::mt19937 random(1234);
+		for (uint32_t layer = 1; layer < layerCount; ++layer)
+		{
+			for (uint32_t i = 0; i < layerWidth; ++i)
+			{
+				uint32_t node = layer * layerWidth + i;
+				for (int edge = 0; edge < 2; ++edge)
+				{
+					uint32_t predecessor = (layer - 1) * layerWidth + random() % layerWidth;
+					_nodes[predecessor].successors.push_back(node);
+					_nodes[node].predecessorCount++;
+				}
+			}
+		}
+	}
+
+	void Run(JOB_SYSTEM& jobSystem, uint32_t workPerNode)
+	{
+		JOB_COUNTER counter;
+		for (uint32_t i = 0; i < _nodes.size(); ++i)
+		{
+			_nodes[i].remaining.store(_nodes[i].predecessorCount, std::memory_order_relaxed);
+		}
+		for (uint32_t i = 0; i < _nodes.size(); ++i)
+		{
+			if (_nodes[i].predecessorCount == 0)
+			{
+				Queue(jobSystem, counter, i, workPerNode);
+			}
+		}
+		jobSystem.Wait(counter);
+	}
+
+private:
+	void Queue(JOB_SYSTEM& jobSystem, JOB_COUNTER& counter, uint32_t node, uint32_t workPerNode)
+	{
+		jobSystem.Run([this, &jobSystem, &counter, node, workPerNode]()
+		{
+			float value = static_cast<float>(node);
+			for (uint32_t i = 0; i < workPerNode; ++i)
+			{
+				value = value * 0.999f + 1.0f;
+			}
+			benchmark::DoNotOptimize(value);
+
+			for (uint32_t successor : _nodes[node].successors)
+			{
+				if (_nodes[successor].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					Queue(jobSystem, counter, successor, workPerNode);
+				}
+			}
+		}, &counter);
+	}
+
+	struct NODE
+	{
+		std::vector<uint32_t>	successors;
+		uint32_t				predecessorCount = 0;
+		std::atomic<uint32_t>	remaining{ 0 };
+	};
+
+	std::vector<NODE>	_nodes;
+};
+
+static void BM_JobDag(benchmark::State& state)
+{
+	const uint32_t layerCount = 64;
+	const uint32_t layerWidth = 64;
+
+	JOB_SYSTEM jobSystem(static_cast<uint32_t>(state.range(0)));
+	JOB_DAG dag(layerCount, layerWidth);
+
+	for (auto _ : state)
+	{
+		dag.Run(jobSystem, 2000);
+	}
+
+	state.SetItemsProcessed(state.iterations() * layerCount * layerWidth);
+}
+BENCHMARK(BM_JobDag)->Apply(WorkerCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
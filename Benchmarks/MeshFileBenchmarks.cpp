@@ -0,0 +1,155 @@
+#include "MeshFile.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <vector>
+
+// Grid of state.range(0) x state.range(0) vertices with positions and normals, written
+// to the working directory and removed once the benchmark is done.
+class GRID_MESH_FILE
+{
+public:
+	GRID_MESH_FILE(uint32_t gridSize) :
+		_path("MeshFileBenchmark.mesh")
+	{
+		MESH_DATA mesh;
+		mesh.vertexCount = gridSize * gridSize;
+
+		MESH_DATA::STREAM positions = { MESH_SEMANTIC_POSITION, MESH_FORMAT_FLOAT3, {} };
+		MESH_DATA::STREAM normals = { MESH_SEMANTIC_NORMAL, MESH_FORMAT_FLOAT3, {} };
+		std::vector<float> position(3 * mesh.vertexCount);
+		std::vector<float> normal(3 * mesh.vertexCount);
+		for (uint32_t y = 0; y < gridSize; ++y)
+		{
+			for (uint32_t x = 0; x < gridSize; ++x)
+			{
+				uint32_t vertex = y * gridSize + x;
+				position[3 * vertex + 0] = static_cast<float>(x);
+				position[3 * vertex + 1] = 0.0f;
+				position[3 * vertex + 2] = static_cast<float>(y);
+				normal[3 * vertex + 1] = 1.0f;
+			}
+		}
+		positions.data.assign(reinterpret_cast<const uint8_t*>(position.data()), reinterpret_cast<const uint8_t*>(position.data() + position.size()));
+		normals.data.assign(reinterpret_cast<const uint8_t*>(normal.data()), reinterpret_cast<const uint8_t*>(normal.data() + normal.size()));
+		mesh.streams.push_back(positions);
+		mesh.streams.push_back(normals);
+
+		for (uint32_t y = 0; y + 1 < gridSize; ++y)
+		{
+			for (uint32_t x = 0; x + 1 < gridSize; ++x)
+			{
+				uint32_t vertex = y * gridSize + x;
+				uint32_t quad[6] = { vertex, vertex + gridSize, vertex + 1, vertex + 1, vertex + gridSize, vertex + gridSize + 1 };
+				mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+			}
+		}
+
+		MESH_SUBMESH submesh = {};
+		submesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+		mesh.submeshes.push_back(submesh);
+		ComputeMeshBounds(mesh);
+
+		_valid = WriteMeshFile(_path, mesh);
+	}
+
+	~GRID_MESH_FILE()
+	{
+		std::remove(_path.c_str());
+	}
+
+	inline bool IsValid() const { return _valid; }
+	inline const std::string& GetPath() const { return _path; }
+
+private:
+	std::string	_path;
+	bool		_valid = false;
+};
+
+// Reads one byte per page, what copying the sections to upload memory costs at least.
+static uint64_t TouchPages(const uint8_t* data, uint64_t size)
+{
+	uint64_t sum = 0;
+	for (uint64_t offset = 0; offset < size; offset += g_meshSectionAlignment)
+	{
+		sum += data[offset];
+	}
+	return sum;
+}
+
+// Time to load a mesh already in the OS file cache, mapped in place by MESH_FILE or
+// read() into a buffer first. Both then go through every section once.
+static void BM_LoadMeshMapped(benchmark::State& state)
+{
+	GRID_MESH_FILE file(static_cast<uint32_t>(state.range(0)));
+	if (file.IsValid() == false)
+	{
+		state.SkipWithError("Cannot write the mesh file.");
+		return;
+	}
+
+	uint64_t fileSize = 0;
+	for (auto _ : state)
+	{
+		MESH_FILE mesh;
+		if (mesh.Open(file.GetPath()) == false)
+		{
+			state.SkipWithError("Cannot open the mesh file.");
+			break;
+		}
+
+		const MESH_HEADER& header = mesh.GetHeader();
+		uint64_t sum = TouchPages(mesh.GetIndexData(), header.indexSize);
+		for (uint32_t i = 0; i < header.streamCount; ++i)
+		{
+			sum += TouchPages(mesh.GetStreamData(mesh.GetStream(i)), mesh.GetStream(i).size);
+		}
+		benchmark::DoNotOptimize(sum);
+		fileSize = header.fileSize;
+	}
+
+	state.SetBytesProcessed(state.iterations() * fileSize);
+}
+BENCHMARK(BM_LoadMeshMapped)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMicrosecond);
+
+static void BM_LoadMeshRead(benchmark::State& state)
+{
+	GRID_MESH_FILE file(static_cast<uint32_t>(state.range(0)));
+	if (file.IsValid() == false)
+	{
+		state.SkipWithError("Cannot write the mesh file.");
+		return;
+	}
+
+	uint64_t fileSize = 0;
+	for (auto _ : state)
+	{
+		std::FILE* stream = std::fopen(file.GetPath().c_str(), "rb");
+		if (stream == nullptr)
+		{
+			state.SkipWithError("Cannot open the mesh file.");
+			break;
+		}
+
+		std::fseek(stream, 0, SEEK_END);
+		std::vector<uint8_t> data(static_cast<size_t>(std::ftell(stream)));
+		std::fseek(stream, 0, SEEK_SET);
+		size_t readSize = std::fread(data.data(), 1, data.size(), stream);
+		std::fclose(stream);
+
+		const MESH_HEADER& header = *reinterpret_cast<const MESH_HEADER*>(data.data());
+		const MESH_STREAM* streams = reinterpret_cast<const MESH_STREAM*>(data.data() + sizeof(MESH_HEADER));
+		uint64_t sum = readSize;
+		sum += TouchPages(data.data() + header.indexOffset, header.indexSize);
+		for (uint32_t i = 0; i < header.streamCount; ++i)
+		{
+			sum += TouchPages(data.data() + streams[i].offset, streams[i].size);
+		}
+		benchmark::DoNotOptimize(sum);
+		fileSize = data.size();
+	}
+
+	state.SetBytesProcessed(state.iterations() * fileSize);
+}
+BENCHMARK(BM_LoadMeshRead)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMicrosecond);
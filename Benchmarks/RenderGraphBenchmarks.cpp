@@ -0,0 +1,79 @@
+#include "RenderGraph.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Resource states, D3D12_RESOURCE_STATES values.
+const uint32_t STATE_RENDER_TARGET = 0x4;
+const uint32_t STATE_UNORDERED_ACCESS = 0x8;
+const uint32_t STATE_PIXEL_SHADER_RESOURCE = 0x80;
+
+// state.range(0) passes, each writing a transient of 64 KiB to 16 MiB read by one of the
+// next 8 passes, ending in a write to the back buffer. One pass in 8 has side effects,
+// the chains of outputs never reaching one are culled.
+static void BuildGraph(RENDER_GRAPH& graph, int64_t passCount, int backBuffer)
+{
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<uint64_t> sizes(1, 256);
+	std::uniform_int_distribution<int64_t> distances(1, 8);
+
+	graph.Reset();
+	RENDER_GRAPH::RESOURCE_HANDLE backBufferHandle = graph.ImportResource("BackBuffer", &backBuffer, 0, 0);
+
+	std::vector<std::vector<RENDER_GRAPH::RESOURCE_HANDLE>> inputs(static_cast<size_t>(passCount));
+	for (int64_t i = 0; i < passCount; ++i)
+	{
+		RENDER_GRAPH::PASS_HANDLE pass = graph.AddPass("Pass", nullptr);
+		if (random() % 8 == 0)
+		{
+			graph.SetSideEffect(pass);
+		}
+		for (RENDER_GRAPH::RESOURCE_HANDLE input : inputs[i])
+		{
+			graph.Read(pass, input, STATE_PIXEL_SHADER_RESOURCE);
+		}
+
+		if (i == passCount - 1)
+		{
+			graph.Write(pass, backBufferHandle, STATE_RENDER_TARGET);
+			break;
+		}
+
+		RENDER_GRAPH::RESOURCE_HANDLE output = graph.CreateTransient("Target", sizes(random) << 16, 1 << 16);
+		graph.Write(pass, output, random() % 4 == 0 ? STATE_UNORDERED_ACCESS : STATE_RENDER_TARGET);
+
+		if (random() % 16 != 0)
+		{
+			inputs[static_cast<size_t>(std::min(i + distances(random), passCount - 1))].push_back(output);
+		}
+	}
+}
+
+// Compile time per graph, and the transient heap placed by lifetime against every
+// transient resource in its own allocation.
+static void BM_CompileRenderGraph(benchmark::State& state)
+{
+	int backBuffer = 0;
+	RENDER_GRAPH graph;
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		BuildGraph(graph, state.range(0), backBuffer);
+		state.ResumeTiming();
+
+		graph.Compile();
+	}
+
+	const RENDER_GRAPH::STATISTICS& statistics = graph.GetStatistics();
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["culledPasses"] = statistics.culledPassCount;
+	state.counters["transients"] = statistics.transientCount;
+	state.counters["heapMiB"] = static_cast<double>(statistics.transientHeapBytes) / (1 << 20);
+	state.counters["naiveMiB"] = static_cast<double>(statistics.naiveTransientBytes) / (1 << 20);
+	state.counters["heapRatio"] = static_cast<double>(statistics.transientHeapBytes) / statistics.naiveTransientBytes;
+}
+BENCHMARK(BM_CompileRenderGraph)->Arg(64)->Arg(256)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,51 @@
+#include "RingAllocator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+// Allocations per second of a frame loop three frames ahead of a simulated GPU, with
+// allocations up to state.range(0) bytes and the alignments of constant buffers and
+// structured data. Reports the part of the consumed space lost to padding and wrapping.
+static void BM_RingAllocate(benchmark::State& state)
+{
+	const uint64_t framesInFlight = 3;
+	const int allocationsPerFrame = 256;
+
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<uint64_t> sizes(1, static_cast<uint64_t>(state.range(0)));
+	const uint64_t alignments[] = { 4, 16, 256 };
+
+	std::vector<uint64_t> requests(allocationsPerFrame * 2);
+	for (size_t i = 0; i < requests.size(); i += 2)
+	{
+		requests[i] = sizes(random);
+		requests[i + 1] = alignments[random() % 3];
+	}
+
+	// Room for the frames in flight and the one being recorded.
+	RING_ALLOCATOR ring((framesInFlight + 1) * allocationsPerFrame * (state.range(0) + 256));
+
+	uint64_t frame = 0;
+	for (auto _ : state)
+	{
+		++frame;
+		if (frame > framesInFlight)
+		{
+			ring.Retire(frame - framesInFlight);
+		}
+
+		for (size_t i = 0; i < requests.size(); i += 2)
+		{
+			benchmark::DoNotOptimize(ring.Allocate(requests[i], requests[i + 1]));
+		}
+		ring.FinishFrame(frame);
+	}
+
+	const RING_ALLOCATOR::STATISTICS& statistics = ring.GetStatistics();
+	state.SetItemsProcessed(state.iterations() * allocationsPerFrame);
+	state.counters["fragmentation"] = statistics.GetFragmentation();
+	state.counters["failed"] = static_cast<double>(statistics.failedAllocationCount);
+}
+BENCHMARK(BM_RingAllocate)->RangeMultiplier(8)->Range(64, 64 << 10);
@@ -0,0 +1,113 @@
+#include "JobSystem.h"
+#include "TransformHierarchy.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace VectorMath;
+
+const uint32_t g_transformCount = 1000000;
+const uint32_t g_rootCount = 64;
+const uint32_t g_childrenPerNode = 4;
+
+// 64 trees of 4 children per node, about 10 levels deep, added breadth first.
+class SCENE_TRANSFORMS
+{
+public:
+	SCENE_TRANSFORMS()
+	{
+		handles.reserve(g_transformCount);
+		for (uint32_t i = 0; i < g_rootCount; ++i)
+		{
+			handles.push_back(transforms.Add());
+		}
+		for (uint32_t parent = 0; handles.size() < g_transformCount; ++parent)
+		{
+			for (uint32_t i = 0; i < g_childrenPerNode && handles.size() < g_transformCount; ++i)
+			{
+				HANDLE node = transforms.Add(handles[parent]);
+				transforms.SetLocal(node, FLOAT3{ 1.0f, 0.0f, 0.0f }, FLOAT4{ 0.0f, 0.0f, 0.0f, 1.0f }, FLOAT3{ 0.9f, 0.9f, 0.9f });
+				handles.push_back(node);
+			}
+		}
+		transforms.Update();
+	}
+
+	typedef TRANSFORM_HIERARCHY::HANDLE HANDLE;
+
+	TRANSFORM_HIERARCHY	transforms;
+	std::vector<HANDLE>	handles;
+};
+
+static FLOAT4 GetRotation(float angle)
+{
+	FLOAT4 rotation;
+	StoreFloat4(&rotation, QuaternionRotationNormal(VectorSet(0.0f, 1.0f, 0.0f, 0.0f), angle));
+	return rotation;
+}
+
+// Every root rotated each frame, all 1M world matrices are recomputed.
+static void UpdateAll(benchmark::State& state, JOB_SYSTEM* jobSystem)
+{
+	SCENE_TRANSFORMS scene;
+
+	float angle = 0.0f;
+	for (auto _ : state)
+	{
+		angle += 0.01f;
+		FLOAT4 rotation = GetRotation(angle);
+		for (uint32_t i = 0; i < g_rootCount; ++i)
+		{
+			scene.transforms.SetLocalRotation(scene.handles[i], rotation);
+		}
+		scene.transforms.Update(jobSystem);
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_transformCount);
+	state.counters["updated"] = scene.transforms.GetUpdatedCount();
+}
+
+static void BM_UpdateTransformHierarchy(benchmark::State& state)
+{
+	UpdateAll(state, nullptr);
+}
+BENCHMARK(BM_UpdateTransformHierarchy)->Unit(benchmark::kMillisecond);
+
+// Each depth level split across the job system.
+static void BM_UpdateTransformHierarchyParallel(benchmark::State& state)
+{
+	JOB_SYSTEM jobSystem;
+	UpdateAll(state, &jobSystem);
+	state.counters["workers"] = jobSystem.GetWorkerCount();
+}
+BENCHMARK(BM_UpdateTransformHierarchyParallel)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// One node in state.range(0) rotated each frame, chosen at random, only their subtrees
+// are recomputed. Items are the transforms of the hierarchy, not the updated ones.
+static void BM_UpdateTransformHierarchyDirty(benchmark::State& state)
+{
+	SCENE_TRANSFORMS scene;
+	std::mt19937 random(17);
+	std::uniform_int_distribution<uint32_t> node(0, g_transformCount - 1);
+	const uint32_t dirtyCount = g_transformCount / static_cast<uint32_t>(state.range(0));
+
+	float angle = 0.0f;
+	uint64_t updatedCount = 0;
+	for (auto _ : state)
+	{
+		angle += 0.01f;
+		FLOAT4 rotation = GetRotation(angle);
+		for (uint32_t i = 0; i < dirtyCount; ++i)
+		{
+			scene.transforms.SetLocalRotation(scene.handles[node(random)], rotation);
+		}
+		scene.transforms.Update();
+		updatedCount += scene.transforms.GetUpdatedCount();
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_transformCount);
+	state.counters["updated"] = static_cast<double>(updatedCount) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_UpdateTransformHierarchyDirty)->Arg(10)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
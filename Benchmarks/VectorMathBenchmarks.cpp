@@ -0,0 +1,238 @@
+#include "VectorMath.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+// DirectXMath comes with the Windows SDK, elsewhere CMake adds it when installed or fetched
+// with DIRECTX12_TUTORIAL_FETCH_DIRECTXMATH.
+#if defined(__has_include)
+#if __has_include(<DirectXMath.h>)
+#define VECTOR_MATH_BENCHMARKS_DIRECTXMATH 1
+#include <DirectXMath.h>
+#endif
+#endif
+
+using namespace VectorMath;
+
+const uint32_t g_matrixCount = 100000;
+
+// Random rotations about normalized axes and positions, the same for both libraries.
+class MATH_SCENE
+{
+public:
+	MATH_SCENE()
+	{
+		std::mt19937 random(19);
+		std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+
+		axes.resize(g_matrixCount);
+		angles.resize(g_matrixCount);
+		positions.resize(g_matrixCount);
+		sources.resize(g_matrixCount);
+		destinations.resize(g_matrixCount);
+		for (uint32_t i = 0; i < g_matrixCount; ++i)
+		{
+			FLOAT3 axis = { component(random), component(random), component(random) };
+			StoreFloat3(&axes[i], Vector3Normalize(LoadFloat3(&axis)));
+			angles[i] = 10.0f * component(random);
+			positions[i] = { 100.0f * component(random), 100.0f * component(random), 100.0f * component(random) };
+			for (auto& row : sources[i].m)
+			{
+				for (float& value : row)
+				{
+					value = component(random);
+				}
+			}
+		}
+
+		MATRIX view = MatrixLookAtLH(VectorSet(0.0f, 0.0f, -200.0f, 1.0f), VectorSet(0.0f, 0.0f, 0.0f, 1.0f), VectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		StoreFloat4x4(&viewProjection, MatrixMultiply(view, MatrixPerspectiveFovLH(ConvertToRadians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f)));
+	}
+
+	std::vector<FLOAT3>		axes;
+	std::vector<float>		angles;
+	std::vector<FLOAT3>		positions;
+	std::vector<FLOAT4X4>	sources;
+	std::vector<FLOAT4X4>	destinations;
+	FLOAT4X4				viewProjection;
+};
+
+// Every matrix multiplied by the view projection, one MatrixMultiply() each.
+static void BM_MatrixMultiply(benchmark::State& state)
+{
+	MATH_SCENE scene;
+	const MATRIX transform = LoadFloat4x4(&scene.viewProjection);
+
+	for (auto _ : state)
+	{
+		for (uint32_t i = 0; i < g_matrixCount; ++i)
+		{
+			StoreFloat4x4(&scene.destinations[i], MatrixMultiply(LoadFloat4x4(&scene.sources[i]), transform));
+		}
+		benchmark::DoNotOptimize(scene.destinations.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_matrixCount);
+}
+BENCHMARK(BM_MatrixMultiply)->Unit(benchmark::kMicrosecond);
+
+// The same through MultiplyMatrices() with the instruction set state.range(0).
+static void BM_MultiplyMatrices(benchmark::State& state)
+{
+	MATH_ISA isa = static_cast<MATH_ISA>(state.range(0));
+	state.SetLabel(GetMathIsaName(isa));
+	MATH_ISA best = GetBestMathIsa();
+	if (isa != MATH_ISA_SCALAR && isa != best && (isa != MATH_ISA_SSE2 || best != MATH_ISA_AVX2))
+	{
+		state.SkipWithError("Instruction set not supported by this CPU.");
+		return;
+	}
+
+	MATH_SCENE scene;
+	const MATRIX transform = LoadFloat4x4(&scene.viewProjection);
+
+	for (auto _ : state)
+	{
+		MultiplyMatrices(scene.destinations.data(), scene.sources.data(), g_matrixCount, transform, isa);
+		benchmark::DoNotOptimize(scene.destinations.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_matrixCount);
+}
+BENCHMARK(BM_MultiplyMatrices)->Arg(MATH_ISA_SCALAR)->Arg(MATH_ISA_SSE2)->Arg(MATH_ISA_AVX2)->Arg(MATH_ISA_NEON)->Unit(benchmark::kMicrosecond);
+
+// Per object world view projection: quaternion, rotation matrix, translation, then
+// transposed for the shader, as the tutorial uploads a single object.
+static void BM_ObjectMvp(benchmark::State& state)
+{
+	MATH_SCENE scene;
+	const MATRIX viewProjection = LoadFloat4x4(&scene.viewProjection);
+
+	for (auto _ : state)
+	{
+		for (uint32_t i = 0; i < g_matrixCount; ++i)
+		{
+			const FLOAT3& position = scene.positions[i];
+			MATRIX world = MatrixRotationQuaternion(QuaternionRotationNormal(LoadFloat3(&scene.axes[i]), scene.angles[i]));
+			world = MatrixMultiply(world, MatrixTranslation(position.x, position.y, position.z));
+			StoreFloat4x4(&scene.destinations[i], MatrixTranspose(MatrixMultiply(world, viewProjection)));
+		}
+		benchmark::DoNotOptimize(scene.destinations.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_matrixCount);
+}
+BENCHMARK(BM_ObjectMvp)->Unit(benchmark::kMicrosecond);
+
+// Sine and cosine of 4 angles per call.
+static void BM_VectorSinCos(benchmark::State& state)
+{
+	MATH_SCENE scene;
+
+	for (auto _ : state)
+	{
+		for (uint32_t i = 0; i + 4 <= g_matrixCount; i += 4)
+		{
+			VECTOR sine, cosine;
+			VectorSinCos(&sine, &cosine, VectorSet(scene.angles[i], scene.angles[i + 1], scene.angles[i + 2], scene.angles[i + 3]));
+			benchmark::DoNotOptimize(sine);
+			benchmark::DoNotOptimize(cosine);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_matrixCount);
+}
+BENCHMARK(BM_VectorSinCos)->Unit(benchmark::kMicrosecond);
+
+#if VECTOR_MATH_BENCHMARKS_DIRECTXMATH
+
+// DirectXMath counterparts, over copies of the same data.
+
+static std::vector<DirectX::XMFLOAT4X4> CopyMatrices(const std::vector<FLOAT4X4>& source)
+{
+	std::vector<DirectX::XMFLOAT4X4> destination;
+	destination.reserve(source.size());
+	for (const FLOAT4X4& matrix : source)
+	{
+		destination.emplace_back(&matrix.m[0][0]);
+	}
+	return destination;
+}
+
+static void BM_XMMatrixMultiply(benchmark::State& state)
+{
+	using namespace DirectX;
+
+	MATH_SCENE scene;
+	const XMFLOAT4X4 viewProjection(&scene.viewProjection.m[0][0]);
+	const XMMATRIX transform = XMLoadFloat4x4(&viewProjection);
+	const std::vector<XMFLOAT4X4> sources = CopyMatrices(scene.sources);
+	std::vector<XMFLOAT4X4> destinations(g_matrixCount);
+
+	for (auto _ : state)
+	{
+		for (uint32_t i = 0; i < g_matrixCount; ++i)
+		{
+			XMStoreFloat4x4(&destinations[i], XMMatrixMultiply(XMLoadFloat4x4(&sources[i]), transform));
+		}
+		benchmark::DoNotOptimize(destinations.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_matrixCount);
+}
+BENCHMARK(BM_XMMatrixMultiply)->Unit(benchmark::kMicrosecond);
+
+static void BM_XMObjectMvp(benchmark::State& state)
+{
+	using namespace DirectX;
+
+	MATH_SCENE scene;
+	const XMFLOAT4X4 viewProjectionStorage(&scene.viewProjection.m[0][0]);
+	const XMMATRIX viewProjection = XMLoadFloat4x4(&viewProjectionStorage);
+	std::vector<XMFLOAT3> axes;
+	for (const FLOAT3& axis : scene.axes)
+	{
+		axes.emplace_back(&axis.x);
+	}
+	std::vector<XMFLOAT4X4> destinations(g_matrixCount);
+
+	for (auto _ : state)
+	{
+		for (uint32_t i = 0; i < g_matrixCount; ++i)
+		{
+			const FLOAT3& position = scene.positions[i];
+			XMMATRIX world = XMMatrixRotationQuaternion(XMQuaternionRotationNormal(XMLoadFloat3(&axes[i]), scene.angles[i]));
+			world = XMMatrixMultiply(world, XMMatrixTranslation(position.x, position.y, position.z));
+			XMStoreFloat4x4(&destinations[i], XMMatrixTranspose(XMMatrixMultiply(world, viewProjection)));
+		}
+		benchmark::DoNotOptimize(destinations.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_matrixCount);
+}
+BENCHMARK(BM_XMObjectMvp)->Unit(benchmark::kMicrosecond);
+
+static void BM_XMVectorSinCos(benchmark::State& state)
+{
+	using namespace DirectX;
+
+	MATH_SCENE scene;
+
+	for (auto _ : state)
+	{
+		for (uint32_t i = 0; i + 4 <= g_matrixCount; i += 4)
+		{
+			XMVECTOR sine, cosine;
+			XMVectorSinCos(&sine, &cosine, XMVectorSet(scene.angles[i], scene.angles[i + 1], scene.angles[i + 2], scene.angles[i + 3]));
+			benchmark::DoNotOptimize(sine);
+			benchmark::DoNotOptimize(cosine);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_matrixCount);
+}
+BENCHMARK(BM_XMVectorSinCos)->Unit(benchmark::kMicrosecond);
+
+#endif
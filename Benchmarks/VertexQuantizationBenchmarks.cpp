@@ -0,0 +1,126 @@
+#include "VertexQuantization.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+const size_t g_vertexCount = 1 << 20;
+
+// Random positions in [-100, 100], unit normals and colors.
+static std::vector<float> MakeVectors(size_t vertexCount, uint32_t components, float minValue, float maxValue)
+{
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> values(minValue, maxValue);
+
+	std::vector<float> vectors(vertexCount * components);
+	for (float& value : vectors)
+	{
+		value = values(random);
+	}
+	return vectors;
+}
+
+static void BM_EncodePositionsSnorm16(benchmark::State& state)
+{
+	std::vector<float> positions = MakeVectors(g_vertexCount, 3, -100.0f, 100.0f);
+	std::vector<int16_t> encoded(g_vertexCount * 4);
+	const MESH_BOUNDS bounds = { { -100.0f, -100.0f, -100.0f }, { 100.0f, 100.0f, 100.0f } };
+
+	for (auto _ : state)
+	{
+		EncodePositionsSnorm16(encoded.data(), positions.data(), 3, g_vertexCount, bounds);
+		benchmark::DoNotOptimize(encoded.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_vertexCount);
+}
+BENCHMARK(BM_EncodePositionsSnorm16)->Unit(benchmark::kMillisecond);
+
+static void BM_EncodeNormalsOctahedral(benchmark::State& state)
+{
+	std::vector<float> normals = MakeVectors(g_vertexCount, 3, -1.0f, 1.0f);
+	std::vector<int16_t> encoded(g_vertexCount * 2);
+
+	for (auto _ : state)
+	{
+		EncodeNormalsOctahedral(encoded.data(), normals.data(), g_vertexCount);
+		benchmark::DoNotOptimize(encoded.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_vertexCount);
+}
+BENCHMARK(BM_EncodeNormalsOctahedral)->Unit(benchmark::kMillisecond);
+
+static void BM_EncodeColorsUnorm8(benchmark::State& state)
+{
+	std::vector<float> colors = MakeVectors(g_vertexCount, 4, 0.0f, 1.0f);
+	std::vector<uint8_t> encoded(g_vertexCount * 4);
+
+	for (auto _ : state)
+	{
+		EncodeColorsUnorm8(encoded.data(), colors.data(), 4, g_vertexCount);
+		benchmark::DoNotOptimize(encoded.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * g_vertexCount);
+}
+BENCHMARK(BM_EncodeColorsUnorm8)->Unit(benchmark::kMillisecond);
+
+// Whole mesh quantization, reports the size and the measured errors.
+static void BM_QuantizeMesh(benchmark::State& state)
+{
+	const size_t vertexCount = 1 << 18;
+
+	MESH_DATA source;
+	source.vertexCount = static_cast<uint32_t>(vertexCount);
+
+	const struct
+	{
+		MESH_SEMANTIC	semantic;
+		MESH_FORMAT		format;
+		uint32_t		components;
+		float			minValue;
+		float			maxValue;
+	} streams[] =
+	{
+		{ MESH_SEMANTIC_POSITION, MESH_FORMAT_FLOAT3, 3, -100.0f, 100.0f },
+		{ MESH_SEMANTIC_NORMAL, MESH_FORMAT_FLOAT3, 3, -1.0f, 1.0f },
+		{ MESH_SEMANTIC_COLOR, MESH_FORMAT_FLOAT4, 4, 0.0f, 1.0f },
+	};
+	for (const auto& stream : streams)
+	{
+		std::vector<float> values = MakeVectors(vertexCount, stream.components, stream.minValue, stream.maxValue);
+		MESH_DATA::STREAM meshStream = { stream.semantic, stream.format, {} };
+		meshStream.data.assign(reinterpret_cast<const uint8_t*>(values.data()), reinterpret_cast<const uint8_t*>(values.data() + values.size()));
+		source.streams.push_back(meshStream);
+	}
+
+	source.indices.resize(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		source.indices[i] = i;
+	}
+	MESH_SUBMESH submesh = {};
+	submesh.indexCount = static_cast<uint32_t>(vertexCount);
+	source.submeshes.push_back(submesh);
+	ComputeMeshBounds(source);
+
+	VERTEX_QUANTIZATION_STATISTICS statistics;
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		MESH_DATA mesh = source;
+		state.ResumeTiming();
+
+		statistics = QuantizeMesh(mesh);
+	}
+
+	state.SetItemsProcessed(state.iterations() * vertexCount);
+	state.counters["sizeRatio"] = static_cast<double>(statistics.quantizedBytes) / statistics.sourceBytes;
+	state.counters["positionError"] = statistics.positionError;
+	state.counters["positionErrorBound"] = statistics.positionErrorBound;
+	state.counters["normalErrorDegrees"] = statistics.normalError * 57.29578f;
+	state.counters["colorError"] = statistics.colorError;
+}
+BENCHMARK(BM_QuantizeMesh)->Unit(benchmark::kMillisecond);
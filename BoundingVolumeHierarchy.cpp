@@ -0,0 +1,526 @@
+#include "BoundingVolumeHierarchy.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+
+using namespace VectorMath;
+
+// Binned SAH split candidates per node.
+static const uint32_t g_sahBinCount = 16;
+// Cost of visiting a node, relative to testing a primitive.
+static const float g_sahTraversalCost = 1.0f;
+// Smaller nodes are built on the thread of their parent.
+static const uint32_t g_parallelBuildThreshold = 4096;
+
+struct BVH_BOX
+{
+	float	min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float	max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	inline void Grow(const float point[3])
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			min[axis] = std::min(min[axis], point[axis]);
+			max[axis] = std::max(max[axis], point[axis]);
+		}
+	}
+
+	inline void Grow(const BVH_BOX& box)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			min[axis] = std::min(min[axis], box.min[axis]);
+			max[axis] = std::max(max[axis], box.max[axis]);
+		}
+	}
+
+	inline float GetCentroid(int axis) const { return (min[axis] + max[axis]) * 0.5f; }
+
+	inline float GetHalfArea() const
+	{
+		float size[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			size[axis] = std::max(0.0f, max[axis] - min[axis]);
+		}
+		return size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+	}
+};
+
+// Partitioned with its box rather than through an index, the build reads memory in order.
+struct BVH_BUILD_PRIMITIVE
+{
+	BVH_BOX		box;
+	uint32_t	volume;
+};
+
+// Top-down build into nodes allocated by pairs, flattened in depth first order afterwards.
+struct BVH_BUILDER
+{
+	std::vector<BVH_BUILD_PRIMITIVE>	primitives;
+	BOUNDING_VOLUME_HIERARCHY::NODE*	nodes = nullptr;
+	std::atomic<uint32_t>	nodeCount{ 1 };
+	JOB_SYSTEM*				jobSystem = nullptr;
+
+	void BuildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t depth)
+	{
+		BVH_BOX bounds;
+		BVH_BOX centroidBounds;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const BVH_BOX& box = primitives[i].box;
+			const float centroid[3] = { box.GetCentroid(0), box.GetCentroid(1), box.GetCentroid(2) };
+			bounds.Grow(box);
+			centroidBounds.Grow(centroid);
+		}
+
+		BOUNDING_VOLUME_HIERARCHY::NODE& node = nodes[nodeIndex];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			node.min[axis] = bounds.min[axis];
+			node.max[axis] = bounds.max[axis];
+		}
+
+		uint32_t count = end - begin;
+		uint32_t middle = count > 1 && depth < BOUNDING_VOLUME_HIERARCHY::MAX_DEPTH ? FindSplit(bounds, centroidBounds, begin, end) : end;
+		if (middle == end)
+		{
+			node.index = begin;
+			node.count = count;
+			return;
+		}
+
+		uint32_t children = nodeCount.fetch_add(2, std::memory_order_relaxed);
+		node.index = children;
+		node.count = 0;
+
+		if (jobSystem && count >= g_parallelBuildThreshold)
+		{
+			JOB_COUNTER counter;
+			jobSystem->Run([this, children, begin, middle, depth]() { BuildNode(children, begin, middle, depth + 1); }, &counter);
+			BuildNode(children + 1, middle, end, depth + 1);
+			jobSystem->Wait(counter);
+		}
+		else
+		{
+			BuildNode(children, begin, middle, depth + 1);
+			BuildNode(children + 1, middle, end, depth + 1);
+		}
+	}
+
+	// Partitions [begin, end) and returns the first index of the right child, or 'end' for a leaf.
+	uint32_t FindSplit(const BVH_BOX& bounds, const BVH_BOX& centroidBounds, uint32_t begin, uint32_t end)
+	{
+		uint32_t count = end - begin;
+
+		int axis = 0;
+		float extents[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			extents[i] = centroidBounds.max[i] - centroidBounds.min[i];
+			if (extents[i] > extents[axis])
+			{
+				axis = i;
+			}
+		}
+
+		// Coincident centroids cannot be binned, they are split in halves when too many for a leaf.
+		if (extents[axis] <= 0.0f)
+		{
+			return count <= BOUNDING_VOLUME_HIERARCHY::MAX_LEAF_SIZE ? end : SplitMedian(axis, begin, end);
+		}
+
+		BVH_BOX binBoxes[g_sahBinCount];
+		uint32_t binCounts[g_sahBinCount] = {};
+		const float binScale = g_sahBinCount / extents[axis] * 0.99999f;
+		auto getBin = [&](const BVH_BUILD_PRIMITIVE& primitive)
+		{
+			return std::min(g_sahBinCount - 1, static_cast<uint32_t>((primitive.box.GetCentroid(axis) - centroidBounds.min[axis]) * binScale));
+		};
+
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			uint32_t bin = getBin(primitives[i]);
+			binBoxes[bin].Grow(primitives[i].box);
+			binCounts[bin]++;
+		}
+
+		// Sweeps from the right for the right side areas, then from the left to evaluate each plane.
+		float rightAreas[g_sahBinCount];
+		BVH_BOX rightBox;
+		for (uint32_t bin = g_sahBinCount - 1; bin > 0; --bin)
+		{
+			rightBox.Grow(binBoxes[bin]);
+			rightAreas[bin] = rightBox.GetHalfArea();
+		}
+
+		float bestCost = FLT_MAX;
+		uint32_t bestBin = 0;
+		BVH_BOX leftBox;
+		uint32_t leftCount = 0;
+		for (uint32_t bin = 1; bin < g_sahBinCount; ++bin)
+		{
+			leftBox.Grow(binBoxes[bin - 1]);
+			leftCount += binCounts[bin - 1];
+			if (leftCount == 0 || leftCount == count)
+			{
+				continue;
+			}
+
+			float cost = leftCount * leftBox.GetHalfArea() + (count - leftCount) * rightAreas[bin];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestBin = bin;
+			}
+		}
+
+		if (bestBin == 0)
+		{
+			return count <= BOUNDING_VOLUME_HIERARCHY::MAX_LEAF_SIZE ? end : SplitMedian(axis, begin, end);
+		}
+
+		float area = bounds.GetHalfArea();
+		float splitCost = area > 0.0f ? g_sahTraversalCost + bestCost / area : g_sahTraversalCost + count;
+		if (splitCost >= count && count <= BOUNDING_VOLUME_HIERARCHY::MAX_LEAF_SIZE)
+		{
+			return end;
+		}
+
+		auto middle = std::partition(primitives.begin() + begin, primitives.begin() + end, [&](const BVH_BUILD_PRIMITIVE& primitive) { return getBin(primitive) < bestBin; });
+		return static_cast<uint32_t>(middle - primitives.begin());
+	}
+
+	uint32_t SplitMedian(int axis, uint32_t begin, uint32_t end)
+	{
+		uint32_t middle = begin + (end - begin) / 2;
+		std::nth_element(primitives.begin() + begin, primitives.begin() + middle, primitives.begin() + end,
+			[axis](const BVH_BUILD_PRIMITIVE& a, const BVH_BUILD_PRIMITIVE& b) { return a.box.GetCentroid(axis) < b.box.GetCentroid(axis); });
+		return middle;
+	}
+};
+
+void BOUNDING_VOLUME_HIERARCHY::Build(const BOUNDING_VOLUMES& volumes, JOB_SYSTEM* jobSystem)
+{
+	Clear();
+
+	uint32_t count = volumes.count;
+	if (count == 0)
+	{
+		return;
+	}
+
+	BVH_BUILDER builder;
+	builder.primitives.resize(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const float center[3] = { volumes.centerX[i], volumes.centerY[i], volumes.centerZ[i] };
+		const float extent[3] = { volumes.extentX[i], volumes.extentY[i], volumes.extentZ[i] };
+		BVH_BUILD_PRIMITIVE& primitive = builder.primitives[i];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			primitive.box.min[axis] = center[axis] - extent[axis];
+			primitive.box.max[axis] = center[axis] + extent[axis];
+		}
+		primitive.volume = i;
+	}
+
+	// A binary tree over 'count' leaves at most, the root then sibling pairs.
+	std::vector<NODE> buildNodes(2 * static_cast<size_t>(count));
+	builder.nodes = buildNodes.data();
+	builder.jobSystem = jobSystem;
+	builder.BuildNode(0, 0, count, 0);
+
+	_primitiveIndices.resize(count);
+	_primitiveSlots.resize(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		_primitiveIndices[i] = builder.primitives[i].volume;
+		_primitiveSlots[builder.primitives[i].volume] = i;
+	}
+
+	// Parallel builds allocate pairs in any order, the depth first layout does not depend on it.
+	_nodes.resize(builder.nodeCount.load());
+	std::vector<std::pair<uint32_t, uint32_t>> stack;
+	stack.emplace_back(0, 0);
+	uint32_t nextNode = 1;
+	while (stack.empty() == false)
+	{
+		std::pair<uint32_t, uint32_t> entry = stack.back();
+		stack.pop_back();
+
+		NODE node = buildNodes[entry.first];
+		if (node.count == 0)
+		{
+			uint32_t children = node.index;
+			node.index = nextNode;
+			nextNode += 2;
+			stack.emplace_back(children + 1, node.index + 1);
+			stack.emplace_back(children, node.index);
+		}
+		_nodes[entry.second] = node;
+	}
+
+	_primitives.resize(count);
+	Refit(volumes);
+}
+
+void BOUNDING_VOLUME_HIERARCHY::Refit(const BOUNDING_VOLUMES& volumes)
+{
+	// Reads the volumes in order and scatters them, one cache miss per primitive.
+	for (uint32_t volume = 0; volume < _primitiveSlots.size(); ++volume)
+	{
+		PRIMITIVE& primitive = _primitives[_primitiveSlots[volume]];
+		primitive.center[0] = volumes.centerX[volume];
+		primitive.center[1] = volumes.centerY[volume];
+		primitive.center[2] = volumes.centerZ[volume];
+		primitive.radius = volumes.radius[volume];
+		primitive.extent[0] = volumes.extentX[volume];
+		primitive.extent[1] = volumes.extentY[volume];
+		primitive.extent[2] = volumes.extentZ[volume];
+		primitive.padding = 0.0f;
+	}
+
+	// Children always follow their parent, a reverse pass sees them first.
+	for (size_t i = _nodes.size(); i-- > 0;)
+	{
+		NODE& node = _nodes[i];
+		BVH_BOX bounds;
+		if (node.count > 0)
+		{
+			for (uint32_t p = node.index; p < node.index + node.count; ++p)
+			{
+				const PRIMITIVE& primitive = _primitives[p];
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					bounds.min[axis] = std::min(bounds.min[axis], primitive.center[axis] - primitive.extent[axis]);
+					bounds.max[axis] = std::max(bounds.max[axis], primitive.center[axis] + primitive.extent[axis]);
+				}
+			}
+		}
+		else
+		{
+			for (uint32_t child = node.index; child < node.index + 2; ++child)
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					bounds.min[axis] = std::min(bounds.min[axis], _nodes[child].min[axis]);
+					bounds.max[axis] = std::max(bounds.max[axis], _nodes[child].max[axis]);
+				}
+			}
+		}
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			node.min[axis] = bounds.min[axis];
+			node.max[axis] = bounds.max[axis];
+		}
+	}
+}
+
+void BOUNDING_VOLUME_HIERARCHY::Clear()
+{
+	_nodes.clear();
+	_primitives.clear();
+	_primitiveIndices.clear();
+	_primitiveSlots.clear();
+}
+
+uint32_t BOUNDING_VOLUME_HIERARCHY::QueryFrustum(const FRUSTUM& frustum, uint32_t* visible) const
+{
+	if (_nodes.empty())
+	{
+		return 0;
+	}
+
+	const uint32_t allPlanes = (1u << FRUSTUM::PLANE_COUNT) - 1;
+
+	struct ENTRY
+	{
+		uint32_t	node;
+		uint32_t	planeMask;		// Planes the node is not known to be inside of
+	};
+	ENTRY stack[MAX_DEPTH + 2];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = { 0, allPlanes };
+
+	uint32_t visibleCount = 0;
+	while (stackSize > 0)
+	{
+		ENTRY entry = stack[--stackSize];
+		const NODE& node = _nodes[entry.node];
+
+		uint32_t planeMask = entry.planeMask;
+		bool outside = false;
+		for (uint32_t p = 0; p < FRUSTUM::PLANE_COUNT && outside == false; ++p)
+		{
+			if ((planeMask & (1u << p)) == 0)
+			{
+				continue;
+			}
+
+			const FLOAT4& plane = frustum.planes[p];
+			const float normal[3] = { plane.x, plane.y, plane.z };
+			float distance = plane.w;
+			float projectedExtent = 0.0f;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				distance += normal[axis] * (node.min[axis] + node.max[axis]) * 0.5f;
+				projectedExtent += std::fabs(normal[axis]) * (node.max[axis] - node.min[axis]) * 0.5f;
+			}
+
+			outside = distance + projectedExtent < 0.0f;
+			if (distance - projectedExtent >= 0.0f)
+			{
+				planeMask &= ~(1u << p);
+			}
+		}
+
+		if (outside)
+		{
+			continue;
+		}
+
+		if (node.count == 0)
+		{
+			stack[stackSize++] = { node.index + 1, planeMask };
+			stack[stackSize++] = { node.index, planeMask };
+			continue;
+		}
+
+		// Primitives only face the planes their leaf crosses.
+		for (uint32_t i = node.index; i < node.index + node.count; ++i)
+		{
+			const PRIMITIVE& primitive = _primitives[i];
+			bool inside = true;
+			for (uint32_t p = 0; p < FRUSTUM::PLANE_COUNT; ++p)
+			{
+				if (planeMask & (1u << p))
+				{
+					const FLOAT4& plane = frustum.planes[p];
+					// Summed as CullBoundingVolumes() does, both return the same volumes.
+					float distance = (plane.x * primitive.center[0] + plane.y * primitive.center[1]) + (plane.z * primitive.center[2] + plane.w);
+					float boxRadius = (std::fabs(plane.x) * primitive.extent[0] + std::fabs(plane.y) * primitive.extent[1]) + std::fabs(plane.z) * primitive.extent[2];
+					inside &= distance + std::min(primitive.radius, boxRadius) >= 0.0f;
+				}
+			}
+
+			visible[visibleCount] = _primitiveIndices[i];
+			visibleCount += inside ? 1 : 0;
+		}
+	}
+
+	return visibleCount;
+}
+
+// Entry distance of the ray in the box, FLT_MAX when it misses it within [0, maxDistance].
+static inline float IntersectBox(const float min[3], const float max[3], const float origin[3], const float inverseDirection[3], float maxDistance)
+{
+	float entry = 0.0f;
+	float exit = maxDistance;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float t0 = (min[axis] - origin[axis]) * inverseDirection[axis];
+		float t1 = (max[axis] - origin[axis]) * inverseDirection[axis];
+		entry = std::max(entry, std::min(t0, t1));
+		exit = std::min(exit, std::max(t0, t1));
+	}
+
+	return entry <= exit ? entry : FLT_MAX;
+}
+
+bool BOUNDING_VOLUME_HIERARCHY::Raycast(const float origin[3], const float direction[3], float maxDistance, RAY_HIT& hit) const
+{
+	if (_nodes.empty())
+	{
+		return false;
+	}
+
+	// Zero components divide to infinities, the slabs of that axis then never clip the ray.
+	float inverseDirection[3];
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		inverseDirection[axis] = 1.0f / direction[axis];
+	}
+
+	float closest = maxDistance;
+	uint32_t closestPrimitive = UINT32_MAX;
+
+	struct ENTRY
+	{
+		uint32_t	node;
+		float		distance;	// Where the ray enters the node
+	};
+	ENTRY stack[MAX_DEPTH + 2];
+	uint32_t stackSize = 0;
+	float rootDistance = IntersectBox(_nodes[0].min, _nodes[0].max, origin, inverseDirection, closest);
+	if (rootDistance != FLT_MAX)
+	{
+		stack[stackSize++] = { 0, rootDistance };
+	}
+
+	while (stackSize > 0)
+	{
+		ENTRY entry = stack[--stackSize];
+		if (closestPrimitive != UINT32_MAX && entry.distance >= closest)
+		{
+			continue;
+		}
+		const NODE& node = _nodes[entry.node];
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.index; i < node.index + node.count; ++i)
+			{
+				const PRIMITIVE& primitive = _primitives[i];
+				float min[3], max[3];
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					min[axis] = primitive.center[axis] - primitive.extent[axis];
+					max[axis] = primitive.center[axis] + primitive.extent[axis];
+				}
+
+				float distance = IntersectBox(min, max, origin, inverseDirection, closest);
+				if (distance != FLT_MAX && (distance < closest || closestPrimitive == UINT32_MAX))
+				{
+					closest = distance;
+					closestPrimitive = _primitiveIndices[i];
+				}
+			}
+			continue;
+		}
+
+		// The nearer child is popped first, the other one is skipped once a closer hit is known.
+		uint32_t first = node.index;
+		uint32_t second = node.index + 1;
+		float firstDistance = IntersectBox(_nodes[first].min, _nodes[first].max, origin, inverseDirection, closest);
+		float secondDistance = IntersectBox(_nodes[second].min, _nodes[second].max, origin, inverseDirection, closest);
+		if (secondDistance < firstDistance)
+		{
+			std::swap(first, second);
+			std::swap(firstDistance, secondDistance);
+		}
+
+		if (secondDistance != FLT_MAX)
+		{
+			stack[stackSize++] = { second, secondDistance };
+		}
+		if (firstDistance != FLT_MAX)
+		{
+			stack[stackSize++] = { first, firstDistance };
+		}
+	}
+
+	if (closestPrimitive == UINT32_MAX)
+	{
+		return false;
+	}
+
+	hit.primitive = closestPrimitive;
+	hit.distance = closest;
+	return true;
+}
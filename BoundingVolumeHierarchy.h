@@ -0,0 +1,67 @@
+#pragma once
+
+#include "FrustumCulling.h"
+
+#include <cstdint>
+#include <vector>
+
+class JOB_SYSTEM;
+
+// Closest primitive box hit by a ray.
+struct RAY_HIT
+{
+	uint32_t	primitive = UINT32_MAX;		// Index in the BOUNDING_VOLUMES the hierarchy was built from
+	float		distance = 0.0f;			// Along the ray, in units of its direction
+};
+
+// Bounding volume hierarchy over the boxes of a BOUNDING_VOLUMES set.
+// Built top-down with a binned surface area heuristic, the subtrees of large
+// nodes are built in parallel on the job system. Nodes are flattened in depth
+// first order with the two children of a node side by side, so a node and its
+// sibling share a cache line. Refit() updates the bounds of moving primitives
+// without changing the topology, in a single reverse pass.
+class BOUNDING_VOLUME_HIERARCHY
+{
+public:
+	struct NODE
+	{
+		float		min[3];
+		uint32_t	index;		// Leaf: first primitive, interior node: first of its two children
+		float		max[3];
+		uint32_t	count;		// Primitives of a leaf, 0 for interior nodes
+	};
+	static_assert(sizeof(NODE) == 32, "Two sibling nodes fill a cache line");
+
+	static const uint32_t MAX_LEAF_SIZE = 8;
+	static const uint32_t MAX_DEPTH = 48;
+
+	void Build(const BOUNDING_VOLUMES& volumes, JOB_SYSTEM* jobSystem = nullptr);
+	// 'volumes' holds the same primitives as when built, moved.
+	void Refit(const BOUNDING_VOLUMES& volumes);
+	void Clear();
+
+	// Same visibility test as CullBoundingVolumes(), sub-trees fully inside a plane stop
+	// testing it. 'visible' needs room for every primitive, the indices are not sorted.
+	uint32_t QueryFrustum(const FRUSTUM& frustum, uint32_t* visible) const;
+
+	// Closest primitive box crossed by the ray in [0, maxDistance], 'direction' need not be normalized.
+	bool Raycast(const float origin[3], const float direction[3], float maxDistance, RAY_HIT& hit) const;
+
+	inline const std::vector<NODE>& GetNodes() const { return _nodes; }
+	inline uint32_t GetPrimitiveCount() const { return static_cast<uint32_t>(_primitiveIndices.size()); }
+
+private:
+	// Primitive volume in leaf order, read by the queries.
+	struct PRIMITIVE
+	{
+		float	center[3];
+		float	radius;
+		float	extent[3];
+		float	padding;
+	};
+
+	std::vector<NODE>		_nodes;
+	std::vector<PRIMITIVE>	_primitives;
+	std::vector<uint32_t>	_primitiveIndices;	// Leaf order to volume index
+	std::vector<uint32_t>	_primitiveSlots;	// Volume index to leaf order
+};
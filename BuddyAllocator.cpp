@@ -0,0 +1,157 @@
+#include "BuddyAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+const uint64_t BUDDY_ALLOCATOR::INVALID_OFFSET;
+
+static inline bool IsPowerOfTwo(uint64_t value)
+{
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+static inline uint64_t NextPowerOfTwo(uint64_t value)
+{
+	uint64_t result = 1;
+	while (result < value)
+	{
+		result <<= 1;
+	}
+	return result;
+}
+
+BUDDY_ALLOCATOR::BUDDY_ALLOCATOR(uint64_t size, uint64_t minBlockSize) :
+	_size(size),
+	_minBlockSize(minBlockSize)
+{
+	assert(IsPowerOfTwo(size) && IsPowerOfTwo(minBlockSize) && minBlockSize <= size);
+
+	_levelCount = GetLevel(minBlockSize) + 1;
+	_freeBlocks.resize(_levelCount);
+	_freeBlocks[0].insert(0);
+}
+
+uint32_t BUDDY_ALLOCATOR::GetLevel(uint64_t blockSize) const
+{
+	uint32_t level = 0;
+	while ((_size >> level) > blockSize)
+	{
+		level++;
+	}
+	return level;
+}
+
+uint64_t BUDDY_ALLOCATOR::Allocate(uint64_t size, uint64_t alignment)
+{
+	assert(IsPowerOfTwo(alignment));
+
+	uint64_t blockSize = std::max(NextPowerOfTwo(std::max<uint64_t>(size, 1)), _minBlockSize);
+	if (blockSize > _size)
+	{
+		return INVALID_OFFSET;
+	}
+
+	uint32_t level = GetLevel(blockSize);
+
+	// Find the smallest free block able to hold the allocation at the requested alignment.
+	// Blocks at least as large as the alignment are always aligned, smaller ones are checked.
+	uint64_t offset = INVALID_OFFSET;
+	int32_t foundLevel = static_cast<int32_t>(level);
+	for (; foundLevel >= 0; --foundLevel)
+	{
+		std::set<uint64_t>& freeBlocks = _freeBlocks[foundLevel];
+		for (uint64_t freeOffset : freeBlocks)
+		{
+			if ((freeOffset & (alignment - 1)) == 0)
+			{
+				offset = freeOffset;
+				break;
+			}
+
+			if (GetBlockSize(foundLevel) >= alignment)
+			{
+				break;
+			}
+		}
+
+		if (offset != INVALID_OFFSET)
+		{
+			freeBlocks.erase(offset);
+			break;
+		}
+	}
+
+	if (offset == INVALID_OFFSET)
+	{
+		return INVALID_OFFSET;
+	}
+
+	// Split down to the requested level, keeping the left half and freeing the right buddies.
+	for (uint32_t splitLevel = static_cast<uint32_t>(foundLevel) + 1; splitLevel <= level; ++splitLevel)
+	{
+		_freeBlocks[splitLevel].insert(offset + GetBlockSize(splitLevel));
+	}
+
+	_allocations[offset] = ALLOCATION{ level, size };
+	_requestedBytes += size;
+	_allocatedBytes += blockSize;
+
+	return offset;
+}
+
+void BUDDY_ALLOCATOR::Free(uint64_t offset)
+{
+	auto it = _allocations.find(offset);
+	assert(it != _allocations.end() && "Freeing an offset which was not allocated.");
+	if (it == _allocations.end())
+	{
+		return;
+	}
+
+	uint32_t level = it->second.level;
+	_requestedBytes -= it->second.requestedSize;
+	_allocatedBytes -= GetBlockSize(level);
+	_allocations.erase(it);
+
+	// Merge with the buddy as long as it is free.
+	while (level > 0)
+	{
+		uint64_t buddyOffset = offset ^ GetBlockSize(level);
+		auto buddyIt = _freeBlocks[level].find(buddyOffset);
+		if (buddyIt == _freeBlocks[level].end())
+		{
+			break;
+		}
+
+		_freeBlocks[level].erase(buddyIt);
+		offset = std::min(offset, buddyOffset);
+		level--;
+	}
+
+	_freeBlocks[level].insert(offset);
+}
+
+uint64_t BUDDY_ALLOCATOR::GetAllocationSize(uint64_t offset) const
+{
+	auto it = _allocations.find(offset);
+	return it != _allocations.end() ? GetBlockSize(it->second.level) : 0;
+}
+
+BUDDY_ALLOCATOR::STATISTICS BUDDY_ALLOCATOR::GetStatistics() const
+{
+	STATISTICS statistics;
+	statistics.allocationCount = _allocations.size();
+	statistics.requestedBytes = _requestedBytes;
+	statistics.allocatedBytes = _allocatedBytes;
+
+	for (uint32_t level = 0; level < _levelCount; ++level)
+	{
+		if (_freeBlocks[level].empty() == false)
+		{
+			statistics.largestFreeBlock = GetBlockSize(level);
+			break;
+		}
+	}
+
+	return statistics;
+}
\ No newline at end of file
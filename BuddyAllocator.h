@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Power of two buddy allocator over a range of offsets.
+// Blocks are naturally aligned to their size, which keeps placed resources
+// on their 64 KiB / 4 MiB placement alignment without extra bookkeeping.
+// Does not touch any memory, so it can be fuzzed and benchmarked without a GPU.
+class BUDDY_ALLOCATOR
+{
+public:
+	static const uint64_t INVALID_OFFSET = UINT64_MAX;
+
+	struct STATISTICS
+	{
+		uint64_t allocationCount = 0;
+		uint64_t requestedBytes = 0;	// Sizes asked by the callers
+		uint64_t allocatedBytes = 0;	// Sizes of the blocks handed out
+		uint64_t largestFreeBlock = 0;
+	};
+
+	// Size and minimum block size must be powers of two.
+	BUDDY_ALLOCATOR(uint64_t size, uint64_t minBlockSize);
+
+	// Alignment must be a power of two, returns INVALID_OFFSET when no block is available.
+	uint64_t Allocate(uint64_t size, uint64_t alignment);
+	void Free(uint64_t offset);
+
+	inline uint64_t GetSize() const { return _size; }
+	inline uint64_t GetUsedSize() const { return _allocatedBytes; }
+	inline bool IsEmpty() const { return _allocations.empty(); }
+	uint64_t GetAllocationSize(uint64_t offset) const;
+	STATISTICS GetStatistics() const;
+
+private:
+	struct ALLOCATION
+	{
+		uint32_t level;
+		uint64_t requestedSize;
+	};
+
+	inline uint64_t GetBlockSize(uint32_t level) const { return _size >> level; }
+	uint32_t GetLevel(uint64_t blockSize) const;
+
+	uint64_t	_size = 0;
+	uint64_t	_minBlockSize = 0;
+	uint32_t	_levelCount = 0;
+
+	// Free blocks per level, level 0 is the whole range. Ordered so the lowest offsets are used first.
+	std::vector<std::set<uint64_t>>			_freeBlocks;
+	std::unordered_map<uint64_t, ALLOCATION>	_allocations;
+
+	uint64_t	_requestedBytes = 0;
+	uint64_t	_allocatedBytes = 0;
+};
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <utility>
+
+// Recycles command allocators along the fence timeline of a queue.
+// An allocator is only handed out again once the fence value of its last
+// submission has been reached by the GPU. The pool does not talk to D3D12
+// itself, the caller passes the completed fence value, so it can be driven
+// by a simulated fence.
+template<typename ALLOCATOR>
+class COMMAND_ALLOCATOR_POOL
+{
+public:
+	struct STATISTICS
+	{
+		uint64_t allocations = 0;	// Allocators created because none had retired
+		uint64_t reuses = 0;		// Allocators recycled after their fence value retired
+		uint64_t stalls = 0;		// Acquires that had to wait for the oldest fence value
+	};
+
+	enum ACQUIRE_RESULT
+	{
+		ACQUIRE_REUSED,	// 'allocator' holds a retired allocator, it must be reset before use
+		ACQUIRE_CREATE,	// The caller must create a new allocator
+		ACQUIRE_STALL	// The pool is full, wait for GetOldestFenceValue() and acquire again
+	};
+
+	explicit COMMAND_ALLOCATOR_POOL(size_t maxSize) : _maxSize(maxSize) { ; }
+
+	// Pure query on the pool state, the completed value is read by the caller.
+	ACQUIRE_RESULT Acquire(uint64_t completedFenceValue, ALLOCATOR& allocator)
+	{
+		if (_entries.empty() == false && _entries.front().fenceValue <= completedFenceValue)
+		{
+			allocator = std::move(_entries.front().allocator);
+			_entries.pop();
+			_reuses++;
+			return ACQUIRE_REUSED;
+		}
+
+		// When every allocator is still being recorded there is nothing to wait on,
+		// the limit is exceeded rather than dead locking the recording thread.
+		if (_allocatorCount < _maxSize || _entries.empty())
+		{
+			_allocatorCount++;
+			_allocations++;
+			return ACQUIRE_CREATE;
+		}
+
+		_stalls++;
+		return ACQUIRE_STALL;
+	}
+
+	// Allocators must be released in submission order.
+	void Release(ALLOCATOR allocator, uint64_t fenceValue)
+	{
+		_entries.push(ENTRY{ fenceValue, std::move(allocator) });
+	}
+
+	inline uint64_t GetOldestFenceValue() const { return _entries.empty() ? 0 : _entries.front().fenceValue; }
+	inline size_t GetAllocatorCount() const { return _allocatorCount; }
+	inline size_t GetMaxSize() const { return _maxSize; }
+
+	// Can be read from any thread.
+	STATISTICS GetStatistics() const
+	{
+		STATISTICS statistics;
+		statistics.allocations = _allocations.load(std::memory_order_relaxed);
+		statistics.reuses = _reuses.load(std::memory_order_relaxed);
+		statistics.stalls = _stalls.load(std::memory_order_relaxed);
+		return statistics;
+	}
+
+private:
+	struct ENTRY
+	{
+		uint64_t fenceValue;
+		ALLOCATOR allocator;
+	};
+
+	std::queue<ENTRY>	_entries;
+	size_t				_maxSize = 0;
+	size_t				_allocatorCount = 0;
+
+	std::atomic<uint64_t> _allocations{ 0 };
+	std::atomic<uint64_t> _reuses{ 0 };
+	std::atomic<uint64_t> _stalls{ 0 };
+};
\ No newline at end of file
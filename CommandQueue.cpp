@@ -1,6 +1,79 @@
 #include "CommandQueue.h"
 
-COMMAND_QUEUE::COMMAND_QUEUE(ComPtr<ID3D12Device2> device, D3D12_COMMAND_LIST_TYPE type) :
+#if PLATFORM_D3D12
+
+#include "ResourceBarriers.h"
+
+// Private data key used to find the thread pool a command list was recorded from.
+static const GUID THREAD_POOL_GUID = { 0x6f1c2a4e, 0x93b5, 0x4d0a, { 0x8e, 0x27, 0x51, 0xc4, 0x0b, 0x9d, 0x3a, 0x62 } };
+
+// One event per waiting thread, so several threads can wait on different fence values.
+struct THREAD_FENCE_EVENT
+{
+	THREAD_FENCE_EVENT()
+	{
+		handle = ::CreateEvent(nullptr, false, false, nullptr);
+		assert(handle && "Failed to create fence event handle.");
+	}
+	~THREAD_FENCE_EVENT() { ::CloseHandle(handle); }
+
+	HANDLE handle;
+};
+
+static HANDLE GetThreadFenceEvent()
+{
+	thread_local THREAD_FENCE_EVENT fenceEvent;
+	return fenceEvent.handle;
+}
+
+GPU_FENCE::GPU_FENCE(ComPtr<ID3D12Fence> fence) :
+	_d3d12Fence(fence)
+{
+	_InterruptEvent = ::CreateEvent(nullptr, false, false, nullptr);
+	assert(_InterruptEvent && "Failed to create interrupt event handle.");
+}
+
+GPU_FENCE::~GPU_FENCE()
+{
+	::CloseHandle(_InterruptEvent);
+}
+
+uint64_t GPU_FENCE::GetCompletedValue() const
+{
+	return _d3d12Fence->GetCompletedValue();
+}
+
+void GPU_FENCE::Wait(uint64_t value)
+{
+	if (_d3d12Fence->GetCompletedValue() < value)
+	{
+		HANDLE fenceEvent = GetThreadFenceEvent();
+		ThrowIfFailed(_d3d12Fence->SetEventOnCompletion(value, fenceEvent));
+
+		HANDLE events[] = { fenceEvent, _InterruptEvent };
+		::WaitForMultipleObjects(_countof(events), events, false, INFINITE);
+	}
+}
+
+void GPU_FENCE::Interrupt()
+{
+	::SetEvent(_InterruptEvent);
+}
+
+bool GPU_FENCE::Wait(uint64_t value, std::chrono::milliseconds duration)
+{
+	if (_d3d12Fence->GetCompletedValue() < value)
+	{
+		HANDLE fenceEvent = GetThreadFenceEvent();
+		ThrowIfFailed(_d3d12Fence->SetEventOnCompletion(value, fenceEvent));
+
+		return ::WaitForSingleObject(fenceEvent, static_cast<DWORD>(duration.count())) == WAIT_OBJECT_0;
+	}
+
+	return true;
+}
+
+D3D12_QUEUE_DEVICE::D3D12_QUEUE_DEVICE(ComPtr<ID3D12Device2> device, D3D12_COMMAND_LIST_TYPE type) :
 	_CommandListType(type),
 	_d3d12Device(device)
 {
@@ -11,13 +84,13 @@ COMMAND_QUEUE::COMMAND_QUEUE(ComPtr<ID3D12Device2> device, D3D12_COMMAND_LIST_TY
 	desc.NodeMask = 0;
 
 	ThrowIfFailed(_d3d12Device->CreateCommandQueue(&desc, IID_PPV_ARGS(&_d3d12CommandQueue)));
-	ThrowIfFailed(_d3d12Device->CreateFence(_FenceValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&_d3d12Fence)));
+	ThrowIfFailed(_d3d12Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&_d3d12Fence)));
 
-	_FenceEvent = ::CreateEvent(nullptr, false, false, nullptr);
-	assert(_FenceEvent && "Failed to create fence event handle.");
+	_Fence = make_unique<GPU_FENCE>(_d3d12Fence);
+	_CompletionFence = make_unique<GPU_FENCE>(_d3d12Fence);
 }
 
-ComPtr<ID3D12CommandAllocator> COMMAND_QUEUE::CreateCommandAllocator()
+D3D12_QUEUE_DEVICE::ALLOCATOR D3D12_QUEUE_DEVICE::CreateCommandAllocator()
 {
 	ComPtr<ID3D12CommandAllocator> commandAllocator;
 	ThrowIfFailed(_d3d12Device->CreateCommandAllocator(_CommandListType, IID_PPV_ARGS(&commandAllocator)));
@@ -25,7 +98,12 @@ ComPtr<ID3D12CommandAllocator> COMMAND_QUEUE::CreateCommandAllocator()
 	return commandAllocator;
 }
 
-ComPtr<ID3D12GraphicsCommandList2> COMMAND_QUEUE::CreateCommandList(ComPtr<ID3D12CommandAllocator> allocator)
+void D3D12_QUEUE_DEVICE::ResetCommandAllocator(const ALLOCATOR& allocator)
+{
+	ThrowIfFailed(allocator->Reset());
+}
+
+D3D12_QUEUE_DEVICE::LIST D3D12_QUEUE_DEVICE::CreateCommandList(const ALLOCATOR& allocator)
 {
 	ComPtr<ID3D12GraphicsCommandList2> commandList;
 	ThrowIfFailed(_d3d12Device->CreateCommandList(0, _CommandListType, allocator.Get(), nullptr, IID_PPV_ARGS(&commandList)));
@@ -33,104 +111,113 @@ ComPtr<ID3D12GraphicsCommandList2> COMMAND_QUEUE::CreateCommandList(ComPtr<ID3D1
 	return commandList;
 }
 
-COMMAND_QUEUE::~COMMAND_QUEUE()
+void D3D12_QUEUE_DEVICE::ResetCommandList(const LIST& commandList, const ALLOCATOR& allocator)
 {
-	Flush();
+	ThrowIfFailed(commandList->Reset(allocator.Get(), nullptr));
 }
 
-ComPtr<ID3D12GraphicsCommandList2> COMMAND_QUEUE::GetCommandList()
+void D3D12_QUEUE_DEVICE::CloseCommandList(const LIST& commandList)
 {
-	ComPtr<ID3D12CommandAllocator> commandAllocator;
-	ComPtr<ID3D12GraphicsCommandList2> commandList;
+	ThrowIfFailed(commandList->Close());
+}
 
-	if (_CommandAllocatorQueue.empty() == false && IsFenceComplete(_CommandAllocatorQueue.front().fenceValue))
-	{
-		commandAllocator = _CommandAllocatorQueue.front().commandAllocator;
-		_CommandAllocatorQueue.pop();
+void D3D12_QUEUE_DEVICE::SetListContext(const LIST& commandList, const ALLOCATOR& allocator, void* pool)
+{
+	ThrowIfFailed(commandList->SetPrivateDataInterface(__uuidof(ID3D12CommandAllocator), allocator.Get()));
+	ThrowIfFailed(commandList->SetPrivateData(THREAD_POOL_GUID, sizeof(pool), &pool));
+}
 
-		ThrowIfFailed(commandAllocator.Reset());
-	}
-	else
-	{
-		commandAllocator = CreateCommandAllocator();
-	}
+void D3D12_QUEUE_DEVICE::GetListContext(const LIST& commandList, ALLOCATOR& allocator, void*& pool) const
+{
+	// GetPrivateData adds a reference to the interface, attach it so it is released with the ComPtr.
+	ID3D12CommandAllocator* commandAllocator = nullptr;
+	UINT dataSize = sizeof(commandAllocator);
+	ThrowIfFailed(commandList->GetPrivateData(__uuidof(ID3D12CommandAllocator), &dataSize, &commandAllocator));
+	allocator.Attach(commandAllocator);
 
-	if (_CommandListQueue.empty() == false)
-	{
-		commandList = _CommandListQueue.front();
-		_CommandListQueue.pop();
+	dataSize = sizeof(pool);
+	ThrowIfFailed(commandList->GetPrivateData(THREAD_POOL_GUID, &dataSize, &pool));
+}
 
-		ThrowIfFailed(commandList->Reset(commandAllocator.Get(), nullptr));
-	}
-	else
-	{
-		commandList = CreateCommandList(commandAllocator);
-	}
+void D3D12_QUEUE_DEVICE::SetStateTracker(const LIST& commandList, RESOURCE_STATE_TRACKER* tracker)
+{
+	SetResourceStateTracker(commandList.Get(), tracker);
+}
 
-	ThrowIfFailed(commandList->SetPrivateDataInterface(__uuidof(ID3D12CommandAllocator), commandAllocator.Get()));
+RESOURCE_STATE_TRACKER* D3D12_QUEUE_DEVICE::GetStateTracker(const LIST& commandList) const
+{
+	return GetResourceStateTracker(commandList.Get());
+}
 
-	return commandList;
+void D3D12_QUEUE_DEVICE::FlushBarriers(const LIST& commandList)
+{
+	FlushResourceBarriers(commandList);
 }
 
-uint64_t COMMAND_QUEUE::ExecuteCommandList(ComPtr<ID3D12GraphicsCommandList2> commandList)
+void D3D12_QUEUE_DEVICE::RecordBarriers(const LIST& commandList, const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& barriers)
 {
-	ThrowIfFailed(commandList->Close());
+	RecordResourceBarriers(commandList.Get(), barriers);
+}
 
-	ID3D12CommandAllocator* commandAllocator = nullptr; // Temp, must be released after push to decrement ref count or leak
-	UINT dataSize = sizeof(commandAllocator);
-	ThrowIfFailed(commandList->GetPrivateData(__uuidof(ID3D12CommandAllocator), &dataSize, &commandAllocator));
+GLOBAL_RESOURCE_STATES& D3D12_QUEUE_DEVICE::GetGlobalStates()
+{
+	return GetGlobalResourceStates();
+}
 
-	ID3D12CommandList* const aCommandList[] =
+void D3D12_QUEUE_DEVICE::ExecuteCommandLists(const LIST* commandLists, size_t count)
+{
+	vector<ID3D12CommandList*> d3d12CommandLists(count);
+	for (size_t i = 0; i < count; ++i)
 	{
-		commandList.Get()
-	};
-
-	_d3d12CommandQueue->ExecuteCommandLists(1, aCommandList);
-	uint64_t fenceValue = Signal();
-
-	_CommandAllocatorQueue.emplace(COMMAND_ALLOCATOR_ENTRY{ fenceValue, commandAllocator });
-	_CommandListQueue.push(commandList);
+		d3d12CommandLists[i] = commandLists[i].Get();
+	}
 
-	commandAllocator->Release();
+	_d3d12CommandQueue->ExecuteCommandLists(static_cast<UINT>(count), d3d12CommandLists.data());
+}
 
-	return fenceValue;
+void D3D12_QUEUE_DEVICE::Signal(uint64_t value)
+{
+	ThrowIfFailed(_d3d12CommandQueue->Signal(_d3d12Fence.Get(), value));
 }
 
-uint64_t COMMAND_QUEUE::Signal()
+void D3D12_QUEUE_DEVICE::Wait(D3D12_QUEUE_DEVICE& other, uint64_t value)
 {
-	uint64_t fenceValueForSignal = ++_FenceValue;
-	ThrowIfFailed(_d3d12CommandQueue->Signal(_d3d12Fence.Get(), fenceValueForSignal));
+	ThrowIfFailed(_d3d12CommandQueue->Wait(other._d3d12Fence.Get(), value));
+}
 
-	return fenceValueForSignal;
+uint64_t D3D12_QUEUE_DEVICE::GetCompletedValue() const
+{
+	return _d3d12Fence->GetCompletedValue();
 }
 
-bool COMMAND_QUEUE::IsFenceComplete(uint64_t fenceValue)
+void D3D12_QUEUE_DEVICE::WaitForValue(uint64_t value, std::chrono::milliseconds duration)
 {
-	if (_d3d12Fence->GetCompletedValue() < fenceValue)
-	{
-		ThrowIfFailed(_d3d12Fence->SetEventOnCompletion(fenceValue, _FenceEvent));
-		return true;
-	}
+	_Fence->Wait(value, duration);
+}
 
-	return false;
+COMMAND_QUEUE::COMMAND_QUEUE(ComPtr<ID3D12Device2> device, D3D12_COMMAND_LIST_TYPE type, size_t maxAllocatorsPerThread) :
+	BASIC_COMMAND_QUEUE(maxAllocatorsPerThread, device, type)
+{
 }
 
-void COMMAND_QUEUE::WaitForFenceValue(uint64_t fenceValue, std::chrono::milliseconds duration)
+void COMMAND_QUEUE::ReleaseDeferred(ComPtr<ID3D12Resource> resource)
 {
-	if (_d3d12Fence->GetCompletedValue() < fenceValue)
+	if (resource == nullptr)
 	{
-		ThrowIfFailed(_d3d12Fence->SetEventOnCompletion(fenceValue, _FenceEvent));
-		::WaitForSingleObject(_FenceEvent, static_cast<DWORD>(duration.count()));
+		return;
 	}
+
+	D3D12_RESOURCE_DESC desc = resource->GetDesc();
+	uint64_t sizeInBytes = _Device.GetDevice()->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+
+	ReleaseDeferred(sizeInBytes, [resource]() mutable { resource.Reset(); });
 }
 
-void COMMAND_QUEUE::Flush()
+#else
+
+COMMAND_QUEUE::COMMAND_QUEUE(NULL_DEVICE* device, NULL_COMMAND_LIST_TYPE type, size_t maxAllocatorsPerThread) :
+	BASIC_COMMAND_QUEUE(maxAllocatorsPerThread, device, type)
 {
-	uint64_t fenceValue = Signal();
-	WaitForFenceValue(fenceValue);
 }
 
-ComPtr<ID3D12CommandQueue> COMMAND_QUEUE::GetCommandQueue() const
-{
-	return _d3d12CommandQueue;
-}
\ No newline at end of file
+#endif
@@ -1,44 +1,105 @@
 #pragma once
 
+#include "Platform.h"
+#include "BasicCommandQueue.h"
+
+#if PLATFORM_D3D12
+
 #include "Helpers.h"
 
-#include <queue>
+#include <vector>
 using namespace std;
 
-class COMMAND_QUEUE
+// FENCE implementation on top of an ID3D12Fence.
+class GPU_FENCE : public FENCE
 {
 public:
-	COMMAND_QUEUE(ComPtr<ID3D12Device2> device, D3D12_COMMAND_LIST_TYPE type);
-	virtual ~COMMAND_QUEUE();
+	GPU_FENCE(ComPtr<ID3D12Fence> fence);
+	virtual ~GPU_FENCE();
+
+	virtual uint64_t GetCompletedValue() const override;
+	virtual void Wait(uint64_t value) override;
+	virtual void Interrupt() override;
 
-	ComPtr<ID3D12GraphicsCommandList2> GetCommandList();
-	
-	uint64_t ExecuteCommandList(ComPtr<ID3D12GraphicsCommandList2> commandList);
-	
-	uint64_t Signal();
-	bool IsFenceComplete(uint64_t fenceValue);
-	void WaitForFenceValue(uint64_t fenceValue, std::chrono::milliseconds duration = std::chrono::milliseconds::max());
-	void Flush();
+	// Waits without being interruptible, returns false on time out.
+	bool Wait(uint64_t value, std::chrono::milliseconds duration);
 
-	ComPtr<ID3D12CommandQueue> GetCommandQueue() const;
+	inline ComPtr<ID3D12Fence> GetFence() const { return _d3d12Fence; }
 
 private:
-	ComPtr<ID3D12CommandAllocator> CreateCommandAllocator();
-	ComPtr<ID3D12GraphicsCommandList2> CreateCommandList(ComPtr<ID3D12CommandAllocator> allocator);
+	ComPtr<ID3D12Fence>	_d3d12Fence;
+	HANDLE				_InterruptEvent;
+};
+
+// One ID3D12CommandQueue and its fence, the DEVICE of BASIC_COMMAND_QUEUE.
+// The allocator and the recording thread pool of a list are stored in its private data.
+class D3D12_QUEUE_DEVICE
+{
+public:
+	typedef ComPtr<ID3D12CommandAllocator> ALLOCATOR;
+	typedef ComPtr<ID3D12GraphicsCommandList2> LIST;
+
+	D3D12_QUEUE_DEVICE(ComPtr<ID3D12Device2> device, D3D12_COMMAND_LIST_TYPE type);
+
+	ALLOCATOR CreateCommandAllocator();
+	void ResetCommandAllocator(const ALLOCATOR& allocator);
+	LIST CreateCommandList(const ALLOCATOR& allocator);
+	void ResetCommandList(const LIST& commandList, const ALLOCATOR& allocator);
+	void CloseCommandList(const LIST& commandList);
+
+	void SetListContext(const LIST& commandList, const ALLOCATOR& allocator, void* pool);
+	void GetListContext(const LIST& commandList, ALLOCATOR& allocator, void*& pool) const;
+
+	void SetStateTracker(const LIST& commandList, RESOURCE_STATE_TRACKER* tracker);
+	RESOURCE_STATE_TRACKER* GetStateTracker(const LIST& commandList) const;
+	void FlushBarriers(const LIST& commandList);
+	void RecordBarriers(const LIST& commandList, const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& barriers);
+
+	GLOBAL_RESOURCE_STATES& GetGlobalStates();
+	inline bool DecaysAllStates() const { return _CommandListType == D3D12_COMMAND_LIST_TYPE_COPY; }
+
+	void ExecuteCommandLists(const LIST* commandLists, size_t count);
+	void Signal(uint64_t value);
+	void Wait(D3D12_QUEUE_DEVICE& other, uint64_t value);
 
-	struct COMMAND_ALLOCATOR_ENTRY
-	{
-		uint64_t fenceValue;
-		ComPtr<ID3D12CommandAllocator> commandAllocator;
-	};
+	uint64_t GetCompletedValue() const;
+	void WaitForValue(uint64_t value, std::chrono::milliseconds duration);
+	inline GPU_FENCE& GetFence() { return *_Fence; }
+	inline GPU_FENCE& GetCompletionFence() { return *_CompletionFence; }
 
+	inline ComPtr<ID3D12Device2> GetDevice() const { return _d3d12Device; }
+	inline ComPtr<ID3D12CommandQueue> GetCommandQueue() const { return _d3d12CommandQueue; }
+
+private:
 	D3D12_COMMAND_LIST_TYPE		_CommandListType;
 	ComPtr<ID3D12Device2>		_d3d12Device;
 	ComPtr<ID3D12CommandQueue>	_d3d12CommandQueue;
 	ComPtr<ID3D12Fence>			_d3d12Fence;
-	HANDLE						_FenceEvent;
-	uint64_t					_FenceValue = 0;
+	unique_ptr<GPU_FENCE>		_Fence;
+	unique_ptr<GPU_FENCE>		_CompletionFence;
+};
+
+class COMMAND_QUEUE : public BASIC_COMMAND_QUEUE<D3D12_QUEUE_DEVICE>
+{
+public:
+	COMMAND_QUEUE(ComPtr<ID3D12Device2> device, D3D12_COMMAND_LIST_TYPE type, size_t maxAllocatorsPerThread = 16);
+
+	// Keeps the resource alive until the work already submitted on this queue completed.
+	// Call it once the last command list using the resource has been executed.
+	using BASIC_COMMAND_QUEUE::ReleaseDeferred;
+	void ReleaseDeferred(ComPtr<ID3D12Resource> resource);
+
+	inline ComPtr<ID3D12CommandQueue> GetCommandQueue() const { return _Device.GetCommandQueue(); }
+};
+
+#else
+
+#include "NullDevice.h"
+
+class COMMAND_QUEUE : public BASIC_COMMAND_QUEUE<NULL_QUEUE_DEVICE>
+{
+public:
+	COMMAND_QUEUE(NULL_DEVICE* device, NULL_COMMAND_LIST_TYPE type, size_t maxAllocatorsPerThread = 16);
+};
 
-	queue<COMMAND_ALLOCATOR_ENTRY>				_CommandAllocatorQueue;
-	queue<ComPtr<ID3D12GraphicsCommandList2>>	_CommandListQueue;
-};
\ No newline at end of file
+#endif
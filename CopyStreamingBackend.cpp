@@ -0,0 +1,54 @@
+#include "CopyStreamingBackend.h"
+#include "CommandQueue.h"
+
+COPY_STREAMING_BACKEND::COPY_STREAMING_BACKEND(ComPtr<ID3D12Device2> device, COMMAND_QUEUE* copyQueue, uint64_t stagingSize) :
+	_copyQueue(copyQueue),
+	_stagingSize(stagingSize)
+{
+	CD3DX12_HEAP_PROPERTIES heapProp(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(stagingSize);
+	ThrowIfFailed(device->CreateCommittedResource(
+		&heapProp,
+		D3D12_HEAP_FLAG_NONE,
+		&resourceDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&_staging)));
+
+	// Upload heaps can stay mapped for the lifetime of the resource.
+	CD3DX12_RANGE readRange(0, 0);
+	ThrowIfFailed(_staging->Map(0, &readRange, reinterpret_cast<void**>(&_cpuBase)));
+}
+
+COPY_STREAMING_BACKEND::~COPY_STREAMING_BACKEND()
+{
+	// The streamer waited for its copies, the staging buffer is no longer read.
+	_staging->Unmap(0, nullptr);
+}
+
+void COPY_STREAMING_BACKEND::Copy(void* destination, uint64_t destinationOffset, uint64_t stagingOffset, uint64_t size)
+{
+	if (_commandList == nullptr)
+	{
+		_commandList = _copyQueue->GetCommandList();
+	}
+
+	_commandList->CopyBufferRegion(static_cast<ID3D12Resource*>(destination), destinationOffset, _staging.Get(), stagingOffset, size);
+}
+
+uint64_t COPY_STREAMING_BACKEND::Submit()
+{
+	if (_commandList == nullptr)
+	{
+		return _copyQueue->Signal();
+	}
+
+	uint64_t fenceValue = _copyQueue->ExecuteCommandList(_commandList);
+	_commandList = nullptr;
+	return fenceValue;
+}
+
+FENCE& COPY_STREAMING_BACKEND::GetFence()
+{
+	return _copyQueue->GetFence();
+}
\ No newline at end of file
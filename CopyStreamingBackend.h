@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Helpers.h"
+#include "AssetStreamer.h"
+
+class COMMAND_QUEUE;
+
+// ASSET_STREAMER backend recording buffer copies on a COPY queue.
+// Request destinations are ID3D12Resource* buffers in the COMMON state,
+// they decay back to COMMON once the copy queue is done with them.
+class COPY_STREAMING_BACKEND : public STREAMING_BACKEND
+{
+public:
+	COPY_STREAMING_BACKEND(ComPtr<ID3D12Device2> device, COMMAND_QUEUE* copyQueue, uint64_t stagingSize);
+	virtual ~COPY_STREAMING_BACKEND();
+
+	virtual uint8_t* GetStagingMemory() override { return _cpuBase; }
+	virtual uint64_t GetStagingSize() const override { return _stagingSize; }
+
+	// Called on the streamer thread only.
+	virtual void Copy(void* destination, uint64_t destinationOffset, uint64_t stagingOffset, uint64_t size) override;
+	virtual uint64_t Submit() override;
+
+	virtual FENCE& GetFence() override;
+
+private:
+	COMMAND_QUEUE*			_copyQueue;
+	ComPtr<ID3D12Resource>	_staging;
+	uint8_t*				_cpuBase = nullptr;
+	uint64_t				_stagingSize;
+
+	ComPtr<ID3D12GraphicsCommandList2>	_commandList;	// Copies since the last submission
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "DeferredReleaseQueue.h"
+
+#include <algorithm>
+#include <vector>
+
+DEFERRED_RELEASE_QUEUE::~DEFERRED_RELEASE_QUEUE()
+{
+	// The owner is expected to have flushed the GPU before destroying the queue.
+	Collect(UINT64_MAX);
+}
+
+void DEFERRED_RELEASE_QUEUE::Retire(uint64_t fenceValue, uint64_t sizeInBytes, std::function<void()> release)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_entries.emplace(fenceValue, ENTRY{ sizeInBytes, std::chrono::steady_clock::now(), std::move(release) });
+	_pendingBytes += sizeInBytes;
+}
+
+size_t DEFERRED_RELEASE_QUEUE::Collect(uint64_t completedFenceValue)
+{
+	std::vector<std::function<void()>> releases;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto end = _entries.upper_bound(completedFenceValue);
+		if (end == _entries.begin())
+		{
+			return 0;
+		}
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		for (auto it = _entries.begin(); it != end; ++it)
+		{
+			double latencyMs = std::chrono::duration<double, std::milli>(now - it->second.retireTime).count();
+			_totalLatencyMs += latencyMs;
+			_maxLatencyMs = std::max(_maxLatencyMs, latencyMs);
+
+			_pendingBytes -= it->second.sizeInBytes;
+			_releasedBytes += it->second.sizeInBytes;
+			_releasedCount++;
+
+			releases.push_back(std::move(it->second.release));
+		}
+		_entries.erase(_entries.begin(), end);
+	}
+
+	// Released outside of the lock, a release may retire other objects.
+	for (auto& release : releases)
+	{
+		if (release)
+		{
+			release();
+		}
+	}
+
+	return releases.size();
+}
+
+DEFERRED_RELEASE_QUEUE::STATISTICS DEFERRED_RELEASE_QUEUE::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	STATISTICS statistics;
+	statistics.pendingCount = _entries.size();
+	statistics.pendingBytes = _pendingBytes;
+	statistics.releasedCount = _releasedCount;
+	statistics.releasedBytes = _releasedBytes;
+	statistics.averageLatencyMs = _releasedCount > 0 ? _totalLatencyMs / _releasedCount : 0.0;
+	statistics.maxLatencyMs = _maxLatencyMs;
+
+	return statistics;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+
+// Keeps objects alive until the GPU is done with them.
+// Objects are retired with the fence value of their last use and released
+// once that value has completed, instead of flushing the whole queue.
+class DEFERRED_RELEASE_QUEUE
+{
+public:
+	struct STATISTICS
+	{
+		size_t		pendingCount = 0;
+		uint64_t	pendingBytes = 0;
+		uint64_t	releasedCount = 0;
+		uint64_t	releasedBytes = 0;
+		double		averageLatencyMs = 0.0;	// Time between Retire and the actual release
+		double		maxLatencyMs = 0.0;
+	};
+
+	~DEFERRED_RELEASE_QUEUE();
+
+	// 'release' is invoked and destroyed once 'fenceValue' completed.
+	void Retire(uint64_t fenceValue, uint64_t sizeInBytes, std::function<void()> release);
+
+	// Releases every object whose fence value completed, returns the number released.
+	size_t Collect(uint64_t completedFenceValue);
+
+	STATISTICS GetStatistics() const;
+
+private:
+	struct ENTRY
+	{
+		uint64_t								sizeInBytes;
+		std::chrono::steady_clock::time_point	retireTime;
+		std::function<void()>					release;
+	};
+
+	mutable std::mutex				_mutex;
+	std::multimap<uint64_t, ENTRY>	_entries;
+
+	uint64_t	_pendingBytes = 0;
+	uint64_t	_releasedCount = 0;
+	uint64_t	_releasedBytes = 0;
+	double		_totalLatencyMs = 0.0;
+	double		_maxLatencyMs = 0.0;
+};
\ No newline at end of file
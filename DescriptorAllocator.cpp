@@ -0,0 +1,171 @@
+#include "DescriptorAllocator.h"
+#include "CommandQueue.h"
+
+DESCRIPTOR_ALLOCATOR::DESCRIPTOR_ALLOCATOR(ComPtr<ID3D12Device2> device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t descriptorsPerPage) :
+	_device(device),
+	_type(type),
+	_descriptorsPerPage(descriptorsPerPage)
+{
+	_descriptorSize = _device->GetDescriptorHandleIncrementSize(type);
+}
+
+DESCRIPTOR_ALLOCATION DESCRIPTOR_ALLOCATOR::Allocate(uint32_t count)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	uint32_t pageIndex = 0;
+	uint32_t offset = FREE_LIST_ALLOCATOR::INVALID_OFFSET;
+	for (; pageIndex < _pages.size(); ++pageIndex)
+	{
+		offset = _pages[pageIndex]->freeList.Allocate(count);
+		if (offset != FREE_LIST_ALLOCATOR::INVALID_OFFSET)
+		{
+			break;
+		}
+	}
+
+	if (offset == FREE_LIST_ALLOCATOR::INVALID_OFFSET)
+	{
+		// Ranges larger than a page get a page of their own size.
+		uint32_t pageSize = std::max(count, _descriptorsPerPage);
+		std::unique_ptr<PAGE> page = std::make_unique<PAGE>(pageSize);
+
+		D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+		desc.Type = _type;
+		desc.NumDescriptors = pageSize;
+		desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+		ThrowIfFailed(_device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&page->heap)));
+		page->base = page->heap->GetCPUDescriptorHandleForHeapStart();
+
+		offset = page->freeList.Allocate(count);
+		pageIndex = static_cast<uint32_t>(_pages.size());
+		_pages.push_back(std::move(page));
+	}
+
+	DESCRIPTOR_ALLOCATION allocation;
+	allocation.cpu = CD3DX12_CPU_DESCRIPTOR_HANDLE(_pages[pageIndex]->base, offset, _descriptorSize);
+	allocation.heapIndex = offset;
+	allocation.count = count;
+	allocation.descriptorSize = _descriptorSize;
+	allocation.page = pageIndex;
+
+	return allocation;
+}
+
+void DESCRIPTOR_ALLOCATOR::Free(const DESCRIPTOR_ALLOCATION& allocation)
+{
+	if (allocation.IsNull())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_pages[allocation.page]->freeList.Free(allocation.heapIndex, allocation.count);
+}
+
+void DESCRIPTOR_ALLOCATOR::ReleaseDeferred(COMMAND_QUEUE* commandQueue, const DESCRIPTOR_ALLOCATION& allocation)
+{
+	if (allocation.IsNull())
+	{
+		return;
+	}
+
+	commandQueue->ReleaseDeferred(0, [this, allocation]() { Free(allocation); });
+}
+
+size_t DESCRIPTOR_ALLOCATOR::GetPageCount()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _pages.size();
+}
+
+GPU_DESCRIPTOR_HEAP::GPU_DESCRIPTOR_HEAP(ComPtr<ID3D12Device2> device,
+	D3D12_DESCRIPTOR_HEAP_TYPE type,
+	COMMAND_QUEUE* commandQueue,
+	uint32_t dynamicCount) :
+	_device(device),
+	_type(type),
+	_commandQueue(commandQueue),
+	_dynamic(dynamicCount)
+{
+	assert(type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV || type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+
+	D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+	desc.Type = type;
+	desc.NumDescriptors = dynamicCount;
+	desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	ThrowIfFailed(_device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&_heap)));
+
+	_cpuBase = _heap->GetCPUDescriptorHandleForHeapStart();
+	_gpuBase = _heap->GetGPUDescriptorHandleForHeapStart();
+	_descriptorSize = _device->GetDescriptorHandleIncrementSize(type);
+}
+
+DESCRIPTOR_ALLOCATION GPU_DESCRIPTOR_HEAP::MakeAllocation(uint32_t heapIndex, uint32_t count) const
+{
+	DESCRIPTOR_ALLOCATION allocation;
+	allocation.cpu = CD3DX12_CPU_DESCRIPTOR_HANDLE(_cpuBase, heapIndex, _descriptorSize);
+	allocation.gpu = CD3DX12_GPU_DESCRIPTOR_HANDLE(_gpuBase, heapIndex, _descriptorSize);
+	allocation.heapIndex = heapIndex;
+	allocation.count = count;
+	allocation.descriptorSize = _descriptorSize;
+
+	return allocation;
+}
+
+DESCRIPTOR_ALLOCATION GPU_DESCRIPTOR_HEAP::AllocateDynamic(uint32_t count)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (count > _dynamic.GetCapacity())
+	{
+		ThrowIfFailed(E_OUTOFMEMORY);
+	}
+
+	_dynamic.Retire(_commandQueue->GetCompletedFenceValue());
+
+	uint64_t offset = _dynamic.Allocate(count, 1);
+	while (offset == RING_ALLOCATOR::INVALID_OFFSET)
+	{
+		// Everything in use belongs to the frame being recorded, waiting would never end.
+		if (_dynamic.HasPendingFrames() == false)
+		{
+			ThrowIfFailed(E_OUTOFMEMORY);
+		}
+
+		_commandQueue->WaitForFenceValue(_dynamic.GetOldestFenceValue());
+		_dynamic.Retire(_commandQueue->GetCompletedFenceValue());
+
+		offset = _dynamic.Allocate(count, 1);
+	}
+
+	return MakeAllocation(static_cast<uint32_t>(offset), count);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE GPU_DESCRIPTOR_HEAP::CopyDescriptors(const D3D12_CPU_DESCRIPTOR_HANDLE* descriptors, uint32_t count)
+{
+	DESCRIPTOR_ALLOCATION table = AllocateDynamic(count);
+
+	// Source descriptors are not contiguous, each one is a range of size 1.
+	_device->CopyDescriptors(1, &table.cpu, &count, count, descriptors, nullptr, _type);
+
+	return table.gpu;
+}
+
+void GPU_DESCRIPTOR_HEAP::Commit(uint64_t fenceValue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_dynamic.FinishFrame(fenceValue);
+}
+
+void GPU_DESCRIPTOR_HEAP::Retire(uint64_t completedFenceValue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_dynamic.Retire(completedFenceValue);
+}
+
+RING_ALLOCATOR::STATISTICS GPU_DESCRIPTOR_HEAP::GetDynamicStatistics()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _dynamic.GetStatistics();
+}
\ No newline at end of file
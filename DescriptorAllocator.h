@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Helpers.h"
+#include "FreeListAllocator.h"
+#include "RingAllocator.h"
+
+#include <mutex>
+#include <vector>
+
+class COMMAND_QUEUE;
+
+// Contiguous range of descriptors in a descriptor heap.
+struct DESCRIPTOR_ALLOCATION
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE	cpu = {};
+	D3D12_GPU_DESCRIPTOR_HANDLE	gpu = {};	// Only set for shader visible heaps
+	uint32_t					heapIndex = 0;	// Index of the first descriptor in its heap
+	uint32_t					count = 0;
+	uint32_t					descriptorSize = 0;
+	uint32_t					page = 0;
+
+	inline bool IsNull() const { return count == 0; }
+
+	inline D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(uint32_t index = 0) const { return CD3DX12_CPU_DESCRIPTOR_HANDLE(cpu, index, descriptorSize); }
+	inline D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(uint32_t index = 0) const { return CD3DX12_GPU_DESCRIPTOR_HANDLE(gpu, index, descriptorSize); }
+};
+
+// CPU only descriptor heaps where views are created and staged.
+// Heaps are allocated in pages, each page is sub-allocated with a free list.
+class DESCRIPTOR_ALLOCATOR
+{
+public:
+	DESCRIPTOR_ALLOCATOR(ComPtr<ID3D12Device2> device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t descriptorsPerPage = 256);
+
+	// Can be called from any thread.
+	DESCRIPTOR_ALLOCATION Allocate(uint32_t count = 1);
+
+	// The GPU must be done with the descriptors, see ReleaseDeferred().
+	void Free(const DESCRIPTOR_ALLOCATION& allocation);
+	void ReleaseDeferred(COMMAND_QUEUE* commandQueue, const DESCRIPTOR_ALLOCATION& allocation);
+
+	inline D3D12_DESCRIPTOR_HEAP_TYPE GetType() const { return _type; }
+	inline uint32_t GetDescriptorSize() const { return _descriptorSize; }
+	size_t GetPageCount();
+
+private:
+	struct PAGE
+	{
+		PAGE(uint32_t count) : freeList(count) { ; }
+
+		ComPtr<ID3D12DescriptorHeap>	heap;
+		D3D12_CPU_DESCRIPTOR_HANDLE		base = {};
+		FREE_LIST_ALLOCATOR				freeList;
+	};
+
+	ComPtr<ID3D12Device2>		_device;
+	D3D12_DESCRIPTOR_HEAP_TYPE	_type;
+	uint32_t					_descriptorsPerPage = 0;
+	uint32_t					_descriptorSize = 0;
+
+	std::mutex					_mutex;
+	std::vector<std::unique_ptr<PAGE>>	_pages;
+};
+
+// Shader visible CBV_SRV_UAV or SAMPLER heap, bound with SetDescriptorHeaps().
+// Used as a ring where the descriptor tables of a frame are copied from the
+// staging heaps, recycled once the fence value passed to Commit() completed.
+class GPU_DESCRIPTOR_HEAP
+{
+public:
+	GPU_DESCRIPTOR_HEAP(ComPtr<ID3D12Device2> device,
+		D3D12_DESCRIPTOR_HEAP_TYPE type,
+		COMMAND_QUEUE* commandQueue,
+		uint32_t dynamicCount);
+
+	// Waits on the owning queue when the ring is full.
+	DESCRIPTOR_ALLOCATION AllocateDynamic(uint32_t count);
+
+	// Copies the descriptors into a contiguous table of the dynamic region.
+	D3D12_GPU_DESCRIPTOR_HANDLE CopyDescriptors(const D3D12_CPU_DESCRIPTOR_HANDLE* descriptors, uint32_t count);
+
+	// Dynamic descriptors allocated since the previous commit are recycled once 'fenceValue' completed.
+	void Commit(uint64_t fenceValue);
+	// Recycles the committed tables whose fence value is at most 'completedFenceValue'.
+	void Retire(uint64_t completedFenceValue);
+
+	inline ID3D12DescriptorHeap* GetHeap() const { return _heap.Get(); }
+	RING_ALLOCATOR::STATISTICS GetDynamicStatistics();
+
+private:
+	DESCRIPTOR_ALLOCATION MakeAllocation(uint32_t heapIndex, uint32_t count) const;
+
+	ComPtr<ID3D12Device2>			_device;
+	ComPtr<ID3D12DescriptorHeap>	_heap;
+	D3D12_DESCRIPTOR_HEAP_TYPE		_type;
+	COMMAND_QUEUE*					_commandQueue = nullptr;
+
+	D3D12_CPU_DESCRIPTOR_HANDLE	_cpuBase = {};
+	D3D12_GPU_DESCRIPTOR_HANDLE	_gpuBase = {};
+	uint32_t					_descriptorSize = 0;
+
+	std::mutex			_mutex;
+	RING_ALLOCATOR		_dynamic;
+};
\ No newline at end of file
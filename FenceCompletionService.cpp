@@ -0,0 +1,139 @@
+#include "FenceCompletionService.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+uint64_t SOFTWARE_FENCE::GetCompletedValue() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _completedValue;
+}
+
+void SOFTWARE_FENCE::Wait(uint64_t value)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_condition.wait(lock, [&]() { return _completedValue >= value || _interrupted; });
+	_interrupted = false;
+}
+
+void SOFTWARE_FENCE::Interrupt()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_interrupted = true;
+	}
+	_condition.notify_all();
+}
+
+bool SOFTWARE_FENCE::Wait(uint64_t value, std::chrono::milliseconds duration)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto reached = [&]() { return _completedValue >= value; };
+
+	// No deadline for the default infinite duration, it would overflow the clock.
+	if (duration == std::chrono::milliseconds::max())
+	{
+		_condition.wait(lock, reached);
+		return true;
+	}
+	return _condition.wait_for(lock, duration, reached);
+}
+
+void SOFTWARE_FENCE::Signal(uint64_t value)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_completedValue = std::max(_completedValue, value);
+	}
+	_condition.notify_all();
+}
+
+FENCE_COMPLETION_SERVICE::FENCE_COMPLETION_SERVICE(FENCE* fence) :
+	_fence(fence)
+{
+	_thread = std::thread(&FENCE_COMPLETION_SERVICE::ThreadMain, this);
+}
+
+FENCE_COMPLETION_SERVICE::~FENCE_COMPLETION_SERVICE()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_condition.notify_one();
+	_fence->Interrupt();
+
+	_thread.join();
+}
+
+void FENCE_COMPLETION_SERVICE::OnCompletion(uint64_t fenceValue, std::function<void()> callback)
+{
+	bool isOldest = false;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _pending.emplace(fenceValue, std::move(callback));
+		isOldest = (it == _pending.begin());
+	}
+	_condition.notify_one();
+
+	// The thread may be waiting on a later value, make it pick the new oldest one.
+	if (isOldest)
+	{
+		_fence->Interrupt();
+	}
+}
+
+std::future<void> FENCE_COMPLETION_SERVICE::GetFuture(uint64_t fenceValue)
+{
+	std::shared_ptr<std::promise<void>> promise = std::make_shared<std::promise<void>>();
+	std::future<void> future = promise->get_future();
+
+	OnCompletion(fenceValue, [promise]() { promise->set_value(); });
+
+	return future;
+}
+
+size_t FENCE_COMPLETION_SERVICE::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _pending.size();
+}
+
+void FENCE_COMPLETION_SERVICE::ThreadMain()
+{
+	std::vector<std::function<void()>> completed;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		_condition.wait(lock, [&]() { return _stop || _pending.empty() == false; });
+		if (_stop)
+		{
+			break;
+		}
+
+		uint64_t oldestValue = _pending.begin()->first;
+
+		lock.unlock();
+		_fence->Wait(oldestValue);
+		uint64_t completedValue = _fence->GetCompletedValue();
+		lock.lock();
+
+		// Retire every value reached so far, in fence order.
+		auto end = _pending.upper_bound(completedValue);
+		for (auto it = _pending.begin(); it != end; ++it)
+		{
+			completed.push_back(std::move(it->second));
+		}
+		_pending.erase(_pending.begin(), end);
+
+		lock.unlock();
+		for (auto& callback : completed)
+		{
+			callback();
+		}
+		completed.clear();
+		lock.lock();
+	}
+}
\ No newline at end of file
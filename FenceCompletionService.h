@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+
+// Timeline fence the completion service waits on.
+// COMMAND_QUEUE implements it on top of ID3D12Fence, SOFTWARE_FENCE lets the
+// service run without a GPU.
+class FENCE
+{
+public:
+	virtual ~FENCE() { ; }
+
+	virtual uint64_t GetCompletedValue() const = 0;
+
+	// Blocks until the value is reached or until Interrupt() is called.
+	// An Interrupt() issued before the wait starts is not lost.
+	virtual void Wait(uint64_t value) = 0;
+	virtual void Interrupt() = 0;
+};
+
+// Fence signalled from the CPU, used to simulate a GPU timeline.
+class SOFTWARE_FENCE : public FENCE
+{
+public:
+	virtual uint64_t GetCompletedValue() const override;
+	virtual void Wait(uint64_t value) override;
+	virtual void Interrupt() override;
+
+	// Waits without being interruptible, returns false on time out.
+	bool Wait(uint64_t value, std::chrono::milliseconds duration);
+
+	void Signal(uint64_t value);
+
+private:
+	mutable std::mutex		_mutex;
+	std::condition_variable	_condition;
+	uint64_t				_completedValue = 0;
+	bool					_interrupted = false;
+};
+
+// Retires fence values in order on a single background thread.
+// Callers register callbacks or get futures for a fence value instead of
+// blocking their own thread, callbacks run on the service thread.
+class FENCE_COMPLETION_SERVICE
+{
+public:
+	// The fence must outlive the service.
+	FENCE_COMPLETION_SERVICE(FENCE* fence);
+	~FENCE_COMPLETION_SERVICE();
+
+	void OnCompletion(uint64_t fenceValue, std::function<void()> callback);
+	std::future<void> GetFuture(uint64_t fenceValue);
+
+	size_t GetPendingCount() const;
+
+private:
+	void ThreadMain();
+
+	FENCE*	_fence = nullptr;
+
+	mutable std::mutex								_mutex;
+	std::condition_variable							_condition;
+	std::multimap<uint64_t, std::function<void()>>	_pending;
+	bool											_stop = false;
+
+	std::thread	_thread;
+};
\ No newline at end of file
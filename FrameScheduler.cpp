@@ -0,0 +1,108 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <cassert>
+
+const uint32_t FRAME_SCHEDULER::MAX_FRAMES_IN_FLIGHT;
+
+FRAME_SCHEDULER::FRAME_SCHEDULER(FENCE* fence, uint32_t framesInFlight) :
+	_fence(fence),
+	_framesInFlight(std::max<uint32_t>(1, std::min(framesInFlight, MAX_FRAMES_IN_FLIGHT)))
+{
+}
+
+FRAME_SCHEDULER::~FRAME_SCHEDULER()
+{
+	WaitForIdle();
+}
+
+uint32_t FRAME_SCHEDULER::BeginFrame()
+{
+	_frameIndex = static_cast<uint32_t>(_frameNumber % _framesInFlight);
+
+	uint64_t completedValue = _fence->GetCompletedValue();
+
+	// Count how many of the previous frames the GPU still has to process.
+	uint32_t framesQueued = 0;
+	for (uint32_t i = 0; i < _framesInFlight; ++i)
+	{
+		if (_frames[i].fenceValue > completedValue)
+		{
+			framesQueued++;
+		}
+	}
+	_totalFramesQueued += framesQueued;
+	if (framesQueued == 0 && _frameNumber > 0)
+	{
+		_statistics.gpuStarvedFrames++;
+	}
+
+	FRAME_CONTEXT& frame = _frames[_frameIndex];
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+	WaitForValue(frame.fenceValue);
+	auto t1 = std::chrono::high_resolution_clock::now();
+
+	RetireFrame(frame);
+
+	_statistics.lastCpuWaitMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+	_totalCpuWaitMs += _statistics.lastCpuWaitMs;
+	_statistics.frameCount++;
+	_statistics.averageCpuWaitMs = _totalCpuWaitMs / _statistics.frameCount;
+	_statistics.averageFramesQueued = static_cast<double>(_totalFramesQueued) / _statistics.frameCount;
+
+	return _frameIndex;
+}
+
+void FRAME_SCHEDULER::EndFrame(uint64_t fenceValue)
+{
+	_frames[_frameIndex].fenceValue = fenceValue;
+	_frameNumber++;
+}
+
+void FRAME_SCHEDULER::OnFrameRetired(std::function<void()> callback)
+{
+	_frames[_frameIndex].retireCallbacks.push_back(std::move(callback));
+}
+
+void FRAME_SCHEDULER::WaitForIdle()
+{
+	for (uint32_t i = 0; i < _framesInFlight; ++i)
+	{
+		WaitForValue(_frames[i].fenceValue);
+		RetireFrame(_frames[i]);
+	}
+}
+
+void FRAME_SCHEDULER::SetFramesInFlight(uint32_t framesInFlight)
+{
+	WaitForIdle();
+
+	// Frame contexts are indexed by frame number, reset them all.
+	for (FRAME_CONTEXT& frame : _frames)
+	{
+		frame.fenceValue = 0;
+	}
+
+	_framesInFlight = std::max<uint32_t>(1, std::min(framesInFlight, MAX_FRAMES_IN_FLIGHT));
+	_frameNumber = 0;
+	_frameIndex = 0;
+}
+
+void FRAME_SCHEDULER::WaitForValue(uint64_t fenceValue)
+{
+	// FENCE::Wait can return early when interrupted.
+	while (_fence->GetCompletedValue() < fenceValue)
+	{
+		_fence->Wait(fenceValue);
+	}
+}
+
+void FRAME_SCHEDULER::RetireFrame(FRAME_CONTEXT& frame)
+{
+	for (auto& callback : frame.retireCallbacks)
+	{
+		callback();
+	}
+	frame.retireCallbacks.clear();
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "FenceCompletionService.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Paces the CPU against the GPU timeline of the rendering queue.
+// BeginFrame() blocks until the frame recorded N frames ago has completed,
+// so the CPU never runs more than N frames ahead of the GPU.
+// Only depends on FENCE, a SOFTWARE_FENCE can stand in for the GPU.
+class FRAME_SCHEDULER
+{
+public:
+	static const uint32_t MAX_FRAMES_IN_FLIGHT = 8;
+
+	struct STATISTICS
+	{
+		uint64_t	frameCount = 0;
+		double		lastCpuWaitMs = 0.0;		// Time BeginFrame() blocked on the GPU
+		double		averageCpuWaitMs = 0.0;
+		double		averageFramesQueued = 0.0;	// Frames still on the GPU when a new one begins
+		uint64_t	gpuStarvedFrames = 0;		// Frames begun while the GPU had nothing queued
+	};
+
+	// The fence must outlive the scheduler.
+	FRAME_SCHEDULER(FENCE* fence, uint32_t framesInFlight);
+	~FRAME_SCHEDULER();
+
+	// Returns the index of the frame context to record into, in [0, framesInFlight).
+	uint32_t BeginFrame();
+	// Fence value signalled after the last submission of the frame.
+	void EndFrame(uint64_t fenceValue);
+
+	// Runs the callback once the GPU is done with the current frame,
+	// used to recycle per-frame transient memory.
+	void OnFrameRetired(std::function<void()> callback);
+
+	// Waits for every frame in flight and retires them.
+	void WaitForIdle();
+
+	// Takes effect after waiting for the frames in flight.
+	void SetFramesInFlight(uint32_t framesInFlight);
+
+	inline uint32_t GetFramesInFlight() const { return _framesInFlight; }
+	inline uint32_t GetFrameIndex() const { return _frameIndex; }
+	inline uint64_t GetFrameNumber() const { return _frameNumber; }
+	inline const STATISTICS& GetStatistics() const { return _statistics; }
+
+private:
+	struct FRAME_CONTEXT
+	{
+		uint64_t							fenceValue = 0;
+		std::vector<std::function<void()>>	retireCallbacks;
+	};
+
+	void WaitForValue(uint64_t fenceValue);
+	void RetireFrame(FRAME_CONTEXT& frame);
+
+	FENCE*			_fence = nullptr;
+	uint32_t		_framesInFlight = 1;
+	uint32_t		_frameIndex = 0;
+	uint64_t		_frameNumber = 0;
+	FRAME_CONTEXT	_frames[MAX_FRAMES_IN_FLIGHT];
+
+	STATISTICS		_statistics;
+	double			_totalCpuWaitMs = 0.0;
+	uint64_t		_totalFramesQueued = 0;
+};
\ No newline at end of file
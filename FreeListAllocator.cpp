@@ -0,0 +1,85 @@
+#include "FreeListAllocator.h"
+
+#include <cassert>
+#include <iterator>
+
+const uint32_t FREE_LIST_ALLOCATOR::INVALID_OFFSET;
+
+FREE_LIST_ALLOCATOR::FREE_LIST_ALLOCATOR(uint32_t capacity) :
+	_capacity(capacity)
+{
+	if (capacity > 0)
+	{
+		AddFreeRange(0, capacity);
+	}
+}
+
+void FREE_LIST_ALLOCATOR::AddFreeRange(uint32_t offset, uint32_t count)
+{
+	auto offsetIt = _freeByOffset.emplace(offset, FREE_RANGE{ count, _freeBySize.end() }).first;
+	offsetIt->second.sizeIt = _freeBySize.emplace(count, offsetIt);
+	_freeCount += count;
+}
+
+uint32_t FREE_LIST_ALLOCATOR::Allocate(uint32_t count)
+{
+	// Smallest free range able to hold the allocation.
+	auto sizeIt = _freeBySize.lower_bound(count);
+	if (count == 0 || sizeIt == _freeBySize.end())
+	{
+		return INVALID_OFFSET;
+	}
+
+	auto offsetIt = sizeIt->second;
+	uint32_t offset = offsetIt->first;
+	uint32_t rangeCount = offsetIt->second.count;
+
+	_freeBySize.erase(sizeIt);
+	_freeByOffset.erase(offsetIt);
+	_freeCount -= rangeCount;
+
+	// Give the remainder back to the free list.
+	if (rangeCount > count)
+	{
+		AddFreeRange(offset + count, rangeCount - count);
+	}
+
+	return offset;
+}
+
+void FREE_LIST_ALLOCATOR::Free(uint32_t offset, uint32_t count)
+{
+	assert(offset + count <= _capacity);
+
+	auto nextIt = _freeByOffset.upper_bound(offset);
+	assert(nextIt == _freeByOffset.end() || offset + count <= nextIt->first);
+
+	// Merge with the previous range when it ends right before this one.
+	if (nextIt != _freeByOffset.begin())
+	{
+		auto previousIt = std::prev(nextIt);
+		assert(previousIt->first + previousIt->second.count <= offset);
+
+		if (previousIt->first + previousIt->second.count == offset)
+		{
+			offset = previousIt->first;
+			count += previousIt->second.count;
+
+			_freeCount -= previousIt->second.count;
+			_freeBySize.erase(previousIt->second.sizeIt);
+			_freeByOffset.erase(previousIt);
+		}
+	}
+
+	// Merge with the next range when it starts right after this one.
+	if (nextIt != _freeByOffset.end() && offset + count == nextIt->first)
+	{
+		count += nextIt->second.count;
+
+		_freeCount -= nextIt->second.count;
+		_freeBySize.erase(nextIt->second.sizeIt);
+		_freeByOffset.erase(nextIt);
+	}
+
+	AddFreeRange(offset, count);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+// Best fit free list over a range of offsets, adjacent free ranges are merged on Free().
+// Free ranges are indexed by offset (for merging) and by size (for allocation).
+// Works on offsets only, used for descriptor heap pages.
+class FREE_LIST_ALLOCATOR
+{
+public:
+	static const uint32_t INVALID_OFFSET = UINT32_MAX;
+
+	explicit FREE_LIST_ALLOCATOR(uint32_t capacity);
+
+	// Returns INVALID_OFFSET when no free range is large enough.
+	uint32_t Allocate(uint32_t count);
+	void Free(uint32_t offset, uint32_t count);
+
+	inline uint32_t GetCapacity() const { return _capacity; }
+	inline uint32_t GetFreeCount() const { return _freeCount; }
+	inline uint32_t GetLargestFreeRange() const { return _freeBySize.empty() ? 0 : _freeBySize.rbegin()->first; }
+	inline size_t GetFreeRangeCount() const { return _freeByOffset.size(); }
+
+private:
+	struct FREE_RANGE;
+	using FREE_BY_OFFSET = std::map<uint32_t, FREE_RANGE>;
+	using FREE_BY_SIZE = std::multimap<uint32_t, FREE_BY_OFFSET::iterator>;
+
+	struct FREE_RANGE
+	{
+		uint32_t				count;
+		FREE_BY_SIZE::iterator	sizeIt;
+	};
+
+	void AddFreeRange(uint32_t offset, uint32_t count);
+
+	FREE_BY_OFFSET	_freeByOffset;
+	FREE_BY_SIZE	_freeBySize;
+
+	uint32_t	_capacity = 0;
+	uint32_t	_freeCount = 0;
+};
\ No newline at end of file
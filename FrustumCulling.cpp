@@ -0,0 +1,293 @@
+#include "FrustumCulling.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_CULLING_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FRUSTUM_CULLING_AVX2_TARGET
+#else
+#define FRUSTUM_CULLING_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+using namespace VectorMath;
+
+// Volumes culled by one job.
+static const uint32_t g_cullingChunkSize = 16384;
+static_assert(g_cullingChunkSize % BOUNDING_VOLUMES::PADDING == 0, "Chunks must start on a padded boundary");
+
+FRUSTUM ExtractFrustum(const MATRIX& viewProjection)
+{
+	FLOAT4X4 m;
+	StoreFloat4x4(&m, viewProjection);
+
+	// Row vectors: clip = p * M, the planes combine the columns of M.
+	VECTOR column[4];
+	for (int j = 0; j < 4; ++j)
+	{
+		column[j] = VectorSet(m.m[0][j], m.m[1][j], m.m[2][j], m.m[3][j]);
+	}
+
+	VECTOR planes[FRUSTUM::PLANE_COUNT];
+	planes[FRUSTUM::LEFT] = VectorAdd(column[3], column[0]);
+	planes[FRUSTUM::RIGHT] = VectorSubtract(column[3], column[0]);
+	planes[FRUSTUM::BOTTOM] = VectorAdd(column[3], column[1]);
+	planes[FRUSTUM::TOP] = VectorSubtract(column[3], column[1]);
+	planes[FRUSTUM::NEAR_PLANE] = column[2];
+	planes[FRUSTUM::FAR_PLANE] = VectorSubtract(column[3], column[2]);
+
+	FRUSTUM frustum;
+	for (int i = 0; i < FRUSTUM::PLANE_COUNT; ++i)
+	{
+		StoreFloat4(&frustum.planes[i], PlaneNormalize(planes[i]));
+	}
+
+	return frustum;
+}
+
+void BOUNDING_VOLUMES::Resize(uint32_t volumeCount)
+{
+	count = volumeCount;
+
+	// The padding radius makes every plane test fail.
+	size_t paddedCount = GetPaddedCount();
+	centerX.assign(paddedCount, 0.0f);
+	centerY.assign(paddedCount, 0.0f);
+	centerZ.assign(paddedCount, 0.0f);
+	extentX.assign(paddedCount, 0.0f);
+	extentY.assign(paddedCount, 0.0f);
+	extentZ.assign(paddedCount, 0.0f);
+	radius.assign(paddedCount, -FLT_MAX);
+}
+
+void BOUNDING_VOLUMES::Set(uint32_t index, const float center[3], const float extent[3], float sphereRadius)
+{
+	centerX[index] = center[0];
+	centerY[index] = center[1];
+	centerZ[index] = center[2];
+	extentX[index] = extent[0];
+	extentY[index] = extent[1];
+	extentZ[index] = extent[2];
+	radius[index] = sphereRadius;
+}
+
+CULLING_ISA GetBestCullingIsa()
+{
+#if FRUSTUM_CULLING_SSE2
+	static const CULLING_ISA isa = []()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		// AVX2 needs the OS to save the YMM registers.
+		int info[4];
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		bool ymmState = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+		__cpuidex(info, 7, 0);
+		bool avx2 = (info[1] & (1 << 5)) != 0;
+		return avx && ymmState && avx2 ? CULLING_ISA_AVX2 : CULLING_ISA_SSE2;
+#else
+		return __builtin_cpu_supports("avx2") ? CULLING_ISA_AVX2 : CULLING_ISA_SSE2;
+#endif
+	}();
+	return isa;
+#else
+	return CULLING_ISA_SCALAR;
+#endif
+}
+
+const char* GetCullingIsaName(CULLING_ISA isa)
+{
+	switch (isa)
+	{
+	case CULLING_ISA_SSE2: return "SSE2";
+	case CULLING_ISA_AVX2: return "AVX2";
+	default: return "scalar";
+	}
+}
+
+// Per plane, the signed distance of the center must not be below minus the smaller
+// of the sphere radius and the box extent projected on the normal.
+static uint32_t CullScalar(const FRUSTUM& frustum, const BOUNDING_VOLUMES& volumes, uint32_t begin, uint32_t end, uint32_t* visible)
+{
+	uint32_t visibleCount = 0;
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		bool inside = true;
+		for (const FLOAT4& plane : frustum.planes)
+		{
+			// Summed in the order of the SIMD paths so every instruction set culls the same volumes.
+			float distance = (plane.x * volumes.centerX[i] + plane.y * volumes.centerY[i]) + (plane.z * volumes.centerZ[i] + plane.w);
+			float boxRadius = (std::fabs(plane.x) * volumes.extentX[i] + std::fabs(plane.y) * volumes.extentY[i]) + std::fabs(plane.z) * volumes.extentZ[i];
+			inside &= distance + std::min(volumes.radius[i], boxRadius) >= 0.0f;
+		}
+
+		visible[visibleCount] = i;
+		visibleCount += inside ? 1 : 0;
+	}
+
+	return visibleCount;
+}
+
+#if FRUSTUM_CULLING_SSE2
+static uint32_t CullSse2(const FRUSTUM& frustum, const BOUNDING_VOLUMES& volumes, uint32_t begin, uint32_t end, uint32_t* visible)
+{
+	__m128 planeX[FRUSTUM::PLANE_COUNT], planeY[FRUSTUM::PLANE_COUNT], planeZ[FRUSTUM::PLANE_COUNT], planeW[FRUSTUM::PLANE_COUNT];
+	__m128 absX[FRUSTUM::PLANE_COUNT], absY[FRUSTUM::PLANE_COUNT], absZ[FRUSTUM::PLANE_COUNT];
+	for (int p = 0; p < FRUSTUM::PLANE_COUNT; ++p)
+	{
+		const FLOAT4& plane = frustum.planes[p];
+		planeX[p] = _mm_set1_ps(plane.x);
+		planeY[p] = _mm_set1_ps(plane.y);
+		planeZ[p] = _mm_set1_ps(plane.z);
+		planeW[p] = _mm_set1_ps(plane.w);
+		absX[p] = _mm_set1_ps(std::fabs(plane.x));
+		absY[p] = _mm_set1_ps(std::fabs(plane.y));
+		absZ[p] = _mm_set1_ps(std::fabs(plane.z));
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+
+	uint32_t visibleCount = 0;
+	for (uint32_t i = begin; i < end; i += 4)
+	{
+		__m128 cx = _mm_loadu_ps(&volumes.centerX[i]);
+		__m128 cy = _mm_loadu_ps(&volumes.centerY[i]);
+		__m128 cz = _mm_loadu_ps(&volumes.centerZ[i]);
+		__m128 ex = _mm_loadu_ps(&volumes.extentX[i]);
+		__m128 ey = _mm_loadu_ps(&volumes.extentY[i]);
+		__m128 ez = _mm_loadu_ps(&volumes.extentZ[i]);
+		__m128 r = _mm_loadu_ps(&volumes.radius[i]);
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < FRUSTUM::PLANE_COUNT; ++p)
+		{
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)), _mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeW[p]));
+			__m128 boxRadius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)), _mm_mul_ps(absZ[p], ez));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, _mm_min_ps(r, boxRadius)), zero));
+		}
+
+		// Branchless compaction, every lane is written and the count only advances for visible ones.
+		int mask = _mm_movemask_ps(inside);
+		for (uint32_t lane = 0; lane < 4; ++lane)
+		{
+			visible[visibleCount] = i + lane;
+			visibleCount += (mask >> lane) & 1;
+		}
+	}
+
+	return visibleCount;
+}
+
+FRUSTUM_CULLING_AVX2_TARGET
+static uint32_t CullAvx2(const FRUSTUM& frustum, const BOUNDING_VOLUMES& volumes, uint32_t begin, uint32_t end, uint32_t* visible)
+{
+	__m256 planeX[FRUSTUM::PLANE_COUNT], planeY[FRUSTUM::PLANE_COUNT], planeZ[FRUSTUM::PLANE_COUNT], planeW[FRUSTUM::PLANE_COUNT];
+	__m256 absX[FRUSTUM::PLANE_COUNT], absY[FRUSTUM::PLANE_COUNT], absZ[FRUSTUM::PLANE_COUNT];
+	for (int p = 0; p < FRUSTUM::PLANE_COUNT; ++p)
+	{
+		const FLOAT4& plane = frustum.planes[p];
+		planeX[p] = _mm256_set1_ps(plane.x);
+		planeY[p] = _mm256_set1_ps(plane.y);
+		planeZ[p] = _mm256_set1_ps(plane.z);
+		planeW[p] = _mm256_set1_ps(plane.w);
+		absX[p] = _mm256_set1_ps(std::fabs(plane.x));
+		absY[p] = _mm256_set1_ps(std::fabs(plane.y));
+		absZ[p] = _mm256_set1_ps(std::fabs(plane.z));
+	}
+
+	const __m256 zero = _mm256_setzero_ps();
+
+	uint32_t visibleCount = 0;
+	for (uint32_t i = begin; i < end; i += 8)
+	{
+		__m256 cx = _mm256_loadu_ps(&volumes.centerX[i]);
+		__m256 cy = _mm256_loadu_ps(&volumes.centerY[i]);
+		__m256 cz = _mm256_loadu_ps(&volumes.centerZ[i]);
+		__m256 ex = _mm256_loadu_ps(&volumes.extentX[i]);
+		__m256 ey = _mm256_loadu_ps(&volumes.extentY[i]);
+		__m256 ez = _mm256_loadu_ps(&volumes.extentZ[i]);
+		__m256 r = _mm256_loadu_ps(&volumes.radius[i]);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int p = 0; p < FRUSTUM::PLANE_COUNT; ++p)
+		{
+			__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], cx), _mm256_mul_ps(planeY[p], cy)), _mm256_add_ps(_mm256_mul_ps(planeZ[p], cz), planeW[p]));
+			__m256 boxRadius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(absX[p], ex), _mm256_mul_ps(absY[p], ey)), _mm256_mul_ps(absZ[p], ez));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, _mm256_min_ps(r, boxRadius)), zero, _CMP_GE_OQ));
+		}
+
+		int mask = _mm256_movemask_ps(inside);
+		for (uint32_t lane = 0; lane < 8; ++lane)
+		{
+			visible[visibleCount] = i + lane;
+			visibleCount += (mask >> lane) & 1;
+		}
+	}
+
+	return visibleCount;
+}
+#endif
+
+uint32_t CullBoundingVolumes(const FRUSTUM& frustum,
+	const BOUNDING_VOLUMES& volumes,
+	uint32_t begin,
+	uint32_t end,
+	uint32_t* visible,
+	CULLING_ISA isa)
+{
+	// The padding volumes are culled, the SIMD loops run to the padded end.
+	end = std::min((end + BOUNDING_VOLUMES::PADDING - 1) / BOUNDING_VOLUMES::PADDING * BOUNDING_VOLUMES::PADDING, volumes.GetPaddedCount());
+
+#if FRUSTUM_CULLING_SSE2
+	switch (isa)
+	{
+	case CULLING_ISA_AVX2: return CullAvx2(frustum, volumes, begin, end, visible);
+	case CULLING_ISA_SSE2: return CullSse2(frustum, volumes, begin, end, visible);
+	default: break;
+	}
+#endif
+
+	return CullScalar(frustum, volumes, begin, end, visible);
+}
+
+uint32_t CullBoundingVolumes(const FRUSTUM& frustum,
+	const BOUNDING_VOLUMES& volumes,
+	uint32_t* visible,
+	JOB_SYSTEM* jobSystem,
+	CULLING_ISA isa)
+{
+	uint32_t chunkCount = (volumes.count + g_cullingChunkSize - 1) / g_cullingChunkSize;
+	if (chunkCount <= 1 || jobSystem == nullptr)
+	{
+		return CullBoundingVolumes(frustum, volumes, 0, volumes.count, visible, isa);
+	}
+
+	// Each chunk compacts at its own offset, the chunks are then moved down in order.
+	std::vector<uint32_t> chunkVisibleCounts(chunkCount);
+	jobSystem->ParallelFor(chunkCount, 1, [&](uint32_t beginChunk, uint32_t endChunk)
+	{
+		for (uint32_t chunk = beginChunk; chunk < endChunk; ++chunk)
+		{
+			uint32_t begin = chunk * g_cullingChunkSize;
+			uint32_t end = std::min(volumes.count, begin + g_cullingChunkSize);
+			chunkVisibleCounts[chunk] = CullBoundingVolumes(frustum, volumes, begin, end, visible + begin, isa);
+		}
+	});
+
+	uint32_t visibleCount = chunkVisibleCounts[0];
+	for (uint32_t chunk = 1; chunk < chunkCount; ++chunk)
+	{
+		memmove(visible + visibleCount, visible + chunk * g_cullingChunkSize, chunkVisibleCounts[chunk] * sizeof(uint32_t));
+		visibleCount += chunkVisibleCounts[chunk];
+	}
+
+	return visibleCount;
+}
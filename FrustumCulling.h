@@ -0,0 +1,72 @@
+#pragma once
+
+#include "VectorMath.h"
+
+#include <cstdint>
+#include <vector>
+
+class JOB_SYSTEM;
+
+// Planes of a view frustum, pointing inwards and normalized: a point p is inside
+// when dot(plane.xyz, p) + plane.w >= 0 for all of them.
+struct FRUSTUM
+{
+	enum PLANE { LEFT, RIGHT, BOTTOM, TOP, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+	VectorMath::FLOAT4	planes[PLANE_COUNT];
+};
+
+// Gribb-Hartmann extraction from a row-vector view * projection matrix with D3D depth in [0, 1].
+FRUSTUM ExtractFrustum(const VectorMath::MATRIX& viewProjection);
+
+// Bounding spheres and axis aligned boxes in structure of arrays, the box is stored
+// as center and half extents and shares the sphere center. The arrays are padded to
+// a multiple of 8 with volumes that are never visible, so SIMD loops need no tail.
+struct BOUNDING_VOLUMES
+{
+	static const uint32_t PADDING = 8;
+
+	std::vector<float>	centerX;
+	std::vector<float>	centerY;
+	std::vector<float>	centerZ;
+	std::vector<float>	extentX;
+	std::vector<float>	extentY;
+	std::vector<float>	extentZ;
+	std::vector<float>	radius;
+	uint32_t			count = 0;
+
+	void Resize(uint32_t volumeCount);
+	void Set(uint32_t index, const float center[3], const float extent[3], float sphereRadius);
+
+	inline uint32_t GetPaddedCount() const { return (count + PADDING - 1) / PADDING * PADDING; }
+};
+
+enum CULLING_ISA
+{
+	CULLING_ISA_SCALAR,
+	CULLING_ISA_SSE2,		// 4 volumes per iteration
+	CULLING_ISA_AVX2		// 8 volumes per iteration
+};
+
+// Best instruction set supported by the CPU, AVX2 is detected at run time.
+CULLING_ISA GetBestCullingIsa();
+const char* GetCullingIsaName(CULLING_ISA isa);
+
+// A volume is visible when both its sphere and its box intersect the frustum.
+// Culls volumes [begin, end), 'begin' a multiple of PADDING, and writes the indices
+// of the visible ones to 'visible', returns their count. Every tested lane is stored
+// before the count is advanced, 'visible' needs room for end - begin rounded up to PADDING.
+uint32_t CullBoundingVolumes(const FRUSTUM& frustum,
+	const BOUNDING_VOLUMES& volumes,
+	uint32_t begin,
+	uint32_t end,
+	uint32_t* visible,
+	CULLING_ISA isa);
+
+// Culls all the volumes in chunks across the job system, the visible indices are
+// compacted in increasing order. 'visible' holds GetPaddedCount() entries.
+uint32_t CullBoundingVolumes(const FRUSTUM& frustum,
+	const BOUNDING_VOLUMES& volumes,
+	uint32_t* visible,
+	JOB_SYSTEM* jobSystem,
+	CULLING_ISA isa = GetBestCullingIsa());
@@ -18,11 +18,13 @@ GAME::~GAME()
 
 bool GAME::Initialize()
 {
+#if PLATFORM_D3D12
 	if (DirectX::XMVerifyCPUSupport() == false)
 	{
 		MessageBoxA(nullptr, "Failed to verify DirectX Math library support.", "Error", MB_OK | MB_ICONERROR);
 		return false;
 	}
+#endif
 
 	_window = APPLICATION::Instance()->CreateRenderWindow(L"DX12WindowClass", 1280, 720, false); 
 	_window->RegisterCallbacks(shared_from_this());
@@ -1,11 +1,15 @@
 #pragma once
 
+#include "Platform.h"
+
+#if PLATFORM_D3D12
 #include "Helpers.h"
+#endif
 
 #include <Events.h>
 
-#include <memory.h>
-#include <string.h>
+#include <memory>
+#include <string>
 using namespace std;
 
 class WINDOW;
@@ -27,15 +31,15 @@ public:
 protected :
 	friend class WINDOW;
 
-	virtual void OnUpdate(UpdateEventArgs& e) { ; }
-	virtual void OnRender(RenderEventArgs& e) { ; }
-	virtual void OnKeyPressed(KeyEventArgs& e) { ; }
-	virtual void OnKeyReleased(KeyEventArgs& e) { ; }
-	virtual void OnMouseMoved(MouseMotionEventArgs& e) { ; }
-	virtual void OnMouseButtonPressed(MouseButtonEventArgs& e) { ; }
-	virtual void OnMouseButtonReleased(MouseButtonEventArgs& e) { ; }
-	virtual void OnMouseWheel(MouseWheelEventArgs& e) { ; }
-	virtual void OnResize(ResizeEventArgs& e) { ; }
+	virtual void OnUpdate(UpdateEventArgs&) { ; }
+	virtual void OnRender(RenderEventArgs&) { ; }
+	virtual void OnKeyPressed(KeyEventArgs&) { ; }
+	virtual void OnKeyReleased(KeyEventArgs&) { ; }
+	virtual void OnMouseMoved(MouseMotionEventArgs&) { ; }
+	virtual void OnMouseButtonPressed(MouseButtonEventArgs&) { ; }
+	virtual void OnMouseButtonReleased(MouseButtonEventArgs&) { ; }
+	virtual void OnMouseWheel(MouseWheelEventArgs&) { ; }
+	virtual void OnResize(ResizeEventArgs&) { ; }
 	virtual void OnWindowDestroy() { ; }
 
 	WINDOW* _window = nullptr;
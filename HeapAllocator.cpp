@@ -0,0 +1,400 @@
+#include "HeapAllocator.h"
+#include "CommandQueue.h"
+#include "ResourceBarriers.h"
+
+static inline uint64_t NextPowerOfTwo(uint64_t value)
+{
+	uint64_t result = 1;
+	while (result < value)
+	{
+		result <<= 1;
+	}
+	return result;
+}
+
+HEAP_ALLOCATOR::HEAP_ALLOCATOR(ComPtr<ID3D12Device2> device, uint64_t heapSize) :
+	_device(device),
+	_heapSize(heapSize)
+{
+	D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+	if (SUCCEEDED(_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))))
+	{
+		_mixedHeaps = options.ResourceHeapTier >= D3D12_RESOURCE_HEAP_TIER_2;
+	}
+
+	const D3D12_HEAP_TYPE heapTypes[] = { D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_TYPE_UPLOAD, D3D12_HEAP_TYPE_READBACK };
+	const D3D12_HEAP_FLAGS categoryFlags[HEAP_CATEGORY_COUNT] = {
+		D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+		D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+		D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES
+	};
+
+	for (int type = 0; type < _countof(heapTypes); ++type)
+	{
+		for (int category = 0; category < HEAP_CATEGORY_COUNT; ++category)
+		{
+			_pools[type][category].heapType = heapTypes[type];
+			_pools[type][category].heapFlags = _mixedHeaps ? D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES : categoryFlags[category];
+		}
+	}
+}
+
+HEAP_ALLOCATOR::~HEAP_ALLOCATOR()
+{
+	for (auto& pools : _pools)
+	{
+		for (POOL& pool : pools)
+		{
+			for (auto& block : pool.blocks)
+			{
+				assert(block->allocations.empty() && "Placed resources still alive when destroying the heap allocator.");
+				for (ALLOCATION* allocation : block->allocations)
+				{
+					delete allocation;
+				}
+			}
+		}
+	}
+}
+
+HEAP_ALLOCATOR::POOL& HEAP_ALLOCATOR::GetPool(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& desc)
+{
+	int type = heapType == D3D12_HEAP_TYPE_UPLOAD ? 1 : (heapType == D3D12_HEAP_TYPE_READBACK ? 2 : 0);
+
+	// Tier 2 hardware can mix every kind of resource in a single heap.
+	if (_mixedHeaps || desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+	{
+		return _pools[type][HEAP_CATEGORY_BUFFERS];
+	}
+
+	if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+	{
+		return _pools[type][HEAP_CATEGORY_RT_DS_TEXTURES];
+	}
+
+	return _pools[type][HEAP_CATEGORY_NON_RT_DS_TEXTURES];
+}
+
+HEAP_ALLOCATOR::HEAP_BLOCK* HEAP_ALLOCATOR::CreateBlock(POOL& pool, uint64_t size, bool dedicated)
+{
+	std::unique_ptr<HEAP_BLOCK> block = std::make_unique<HEAP_BLOCK>(size);
+	block->dedicated = dedicated;
+
+	// Heaps that may hold MSAA textures need the 4 MiB placement alignment.
+	uint64_t heapAlignment = (pool.heapFlags == D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS) ?
+		D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+
+	CD3DX12_HEAP_DESC heapDesc(size, pool.heapType, heapAlignment, pool.heapFlags);
+	ThrowIfFailed(_device->CreateHeap(&heapDesc, IID_PPV_ARGS(&block->heap)));
+
+	pool.blocks.push_back(std::move(block));
+	return pool.blocks.back().get();
+}
+
+void HEAP_ALLOCATOR::ReleaseBlock(POOL& pool, HEAP_BLOCK* block)
+{
+	auto it = std::find_if(pool.blocks.begin(), pool.blocks.end(),
+		[block](const std::unique_ptr<HEAP_BLOCK>& entry) { return entry.get() == block; });
+
+	if (it != pool.blocks.end())
+	{
+		pool.blocks.erase(it);
+	}
+}
+
+HEAP_ALLOCATOR::ALLOCATION* HEAP_ALLOCATOR::CreateResource(D3D12_HEAP_TYPE heapType,
+	const D3D12_RESOURCE_DESC& desc,
+	D3D12_RESOURCE_STATES initialState,
+	const D3D12_CLEAR_VALUE* clearValue)
+{
+	// Small alignment is not used, every resource gets at least 64 KiB.
+	D3D12_RESOURCE_ALLOCATION_INFO info = _device->GetResourceAllocationInfo(0, 1, &desc);
+	if (info.SizeInBytes == UINT64_MAX)
+	{
+		ThrowIfFailed(E_INVALIDARG);
+	}
+
+	uint64_t alignment = std::max<uint64_t>(info.Alignment, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	POOL& pool = GetPool(heapType, desc);
+
+	HEAP_BLOCK* block = nullptr;
+	uint64_t offset = BUDDY_ALLOCATOR::INVALID_OFFSET;
+
+	if (info.SizeInBytes > _heapSize)
+	{
+		block = CreateBlock(pool, NextPowerOfTwo(info.SizeInBytes), true);
+		offset = block->allocator.Allocate(info.SizeInBytes, alignment);
+	}
+	else
+	{
+		for (auto& candidate : pool.blocks)
+		{
+			if (candidate->dedicated == false)
+			{
+				offset = candidate->allocator.Allocate(info.SizeInBytes, alignment);
+				if (offset != BUDDY_ALLOCATOR::INVALID_OFFSET)
+				{
+					block = candidate.get();
+					break;
+				}
+			}
+		}
+
+		if (block == nullptr)
+		{
+			block = CreateBlock(pool, _heapSize, false);
+			offset = block->allocator.Allocate(info.SizeInBytes, alignment);
+		}
+	}
+
+	ALLOCATION* allocation = new ALLOCATION();
+	allocation->desc = desc;
+	allocation->offset = offset;
+	allocation->size = info.SizeInBytes;
+	allocation->alignment = alignment;
+	allocation->block = block;
+
+	HRESULT hr = _device->CreatePlacedResource(block->heap.Get(), offset, &desc, initialState, clearValue, IID_PPV_ARGS(&allocation->resource));
+	if (FAILED(hr))
+	{
+		block->allocator.Free(offset);
+		if (block->allocator.IsEmpty() && block->dedicated)
+		{
+			ReleaseBlock(pool, block);
+		}
+		delete allocation;
+		ThrowIfFailed(hr);
+	}
+
+	block->allocations.insert(allocation);
+	RegisterResourceState(allocation->resource.Get(), initialState);
+
+	return allocation;
+}
+
+void HEAP_ALLOCATOR::Free(ALLOCATION* allocation)
+{
+	if (allocation == nullptr)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	HEAP_BLOCK* block = allocation->block;
+	POOL& pool = GetPool(block->heap->GetDesc().Properties.Type, allocation->desc);
+
+	block->allocator.Free(allocation->offset);
+	block->allocations.erase(allocation);
+	UnregisterResourceState(allocation->resource.Get());
+	allocation->resource.Reset();
+	delete allocation;
+
+	// Keep a single empty block around per pool so alternating allocations do not recreate heaps.
+	if (block->allocations.empty())
+	{
+		size_t emptyBlocks = std::count_if(pool.blocks.begin(), pool.blocks.end(),
+			[](const std::unique_ptr<HEAP_BLOCK>& entry) { return entry->allocations.empty() && entry->dedicated == false; });
+
+		if (block->dedicated || emptyBlocks > 1)
+		{
+			ReleaseBlock(pool, block);
+		}
+	}
+}
+
+void HEAP_ALLOCATOR::ReleaseDeferred(COMMAND_QUEUE* commandQueue, ALLOCATION* allocation)
+{
+	if (allocation == nullptr)
+	{
+		return;
+	}
+
+	commandQueue->ReleaseDeferred(allocation->size, [this, allocation]() { Free(allocation); });
+}
+
+uint64_t HEAP_ALLOCATOR::Defragment(COMMAND_QUEUE* copyQueue, COMMAND_QUEUE* graphicsQueue)
+{
+	// Acquired before locking, getting a list collects deferred releases which may call Free().
+	ComPtr<ID3D12GraphicsCommandList2> commandList = copyQueue->GetCommandList();
+
+	std::vector<ComPtr<ID3D12Resource>> retiredResources;
+	std::vector<ComPtr<ID3D12Heap>> retiredHeaps;
+	uint64_t retiredBytes = 0;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		// Only DEFAULT heaps are moved, UPLOAD and READBACK resources are mapped by their users.
+		for (POOL& pool : _pools[0])
+		{
+			auto isCandidate = [](const HEAP_BLOCK* block)
+			{
+				if (block->dedicated || block->allocations.empty())
+				{
+					return false;
+				}
+
+				// Buffers can be copied without explicit barriers, they decay to COMMON after each submission.
+				for (const ALLOCATION* allocation : block->allocations)
+				{
+					if (allocation->desc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER)
+					{
+						return false;
+					}
+				}
+				return true;
+			};
+
+			std::vector<HEAP_BLOCK*> candidates;
+			for (auto& block : pool.blocks)
+			{
+				if (isCandidate(block.get()))
+				{
+					candidates.push_back(block.get());
+				}
+			}
+
+			std::sort(candidates.begin(), candidates.end(),
+				[](const HEAP_BLOCK* a, const HEAP_BLOCK* b) { return a->allocator.GetUsedSize() < b->allocator.GetUsedSize(); });
+
+			// Blocks written by the copies of this call, copying out of them in the same
+			// command list would read the buffers before they were written.
+			std::unordered_set<const HEAP_BLOCK*> movedInto;
+
+			for (HEAP_BLOCK* source : candidates)
+			{
+				if (movedInto.count(source) > 0)
+				{
+					continue;
+				}
+
+				// Fill the fullest blocks first so the emptiest ones are the next to be evacuated,
+				// moving into an empty block would not release anything.
+				std::vector<HEAP_BLOCK*> targets;
+				for (auto& block : pool.blocks)
+				{
+					if (block.get() != source && block->dedicated == false && block->allocations.empty() == false)
+					{
+						targets.push_back(block.get());
+					}
+				}
+
+				std::sort(targets.begin(), targets.end(),
+					[](const HEAP_BLOCK* a, const HEAP_BLOCK* b) { return a->allocator.GetUsedSize() > b->allocator.GetUsedSize(); });
+
+				struct MOVE
+				{
+					ALLOCATION* allocation;
+					HEAP_BLOCK* target;
+					uint64_t offset;
+				};
+				std::vector<MOVE> moves;
+
+				bool evacuated = true;
+				for (ALLOCATION* allocation : source->allocations)
+				{
+					MOVE move = { allocation, nullptr, BUDDY_ALLOCATOR::INVALID_OFFSET };
+					for (HEAP_BLOCK* target : targets)
+					{
+						move.offset = target->allocator.Allocate(allocation->size, allocation->alignment);
+						if (move.offset != BUDDY_ALLOCATOR::INVALID_OFFSET)
+						{
+							move.target = target;
+							break;
+						}
+					}
+
+					if (move.target == nullptr)
+					{
+						evacuated = false;
+						break;
+					}
+					moves.push_back(move);
+				}
+
+				// The block can only be released when everything fits elsewhere.
+				if (evacuated == false)
+				{
+					for (const MOVE& move : moves)
+					{
+						move.target->allocator.Free(move.offset);
+					}
+					continue;
+				}
+
+				for (const MOVE& move : moves)
+				{
+					ALLOCATION* allocation = move.allocation;
+
+					ComPtr<ID3D12Resource> resource;
+					ThrowIfFailed(_device->CreatePlacedResource(move.target->heap.Get(), move.offset, &allocation->desc,
+						D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&resource)));
+
+					commandList->CopyBufferRegion(resource.Get(), 0, allocation->resource.Get(), 0, allocation->desc.Width);
+					RegisterResourceState(resource.Get(), D3D12_RESOURCE_STATE_COMMON);
+					UnregisterResourceState(allocation->resource.Get());
+
+					retiredResources.push_back(allocation->resource);
+					retiredBytes += allocation->size;
+
+					allocation->resource = resource;
+					allocation->offset = move.offset;
+					allocation->block = move.target;
+					move.target->allocations.insert(allocation);
+					movedInto.insert(move.target);
+				}
+
+				source->allocations.clear();
+				retiredHeaps.push_back(source->heap);
+				ReleaseBlock(pool, source);
+			}
+		}
+	}
+
+	// Nothing moved, neither queue has anything to wait for.
+	if (retiredResources.empty())
+	{
+		copyQueue->DiscardCommandList(commandList);
+		return 0;
+	}
+
+	// The buffers may still be written by frames in flight, the copies start once the
+	// graphics queue finished the work submitted so far.
+	copyQueue->Wait(*graphicsQueue, graphicsQueue->GetLastSignaledFenceValue());
+	uint64_t fenceValue = copyQueue->ExecuteCommandList(commandList);
+
+	// The previous resources may still be read by frames in flight on the graphics queue
+	// and are the copy source on the copy queue, keep them until both are done.
+	auto keepAlive = [retiredResources, retiredHeaps]() { ; };
+	copyQueue->ReleaseDeferred(retiredBytes, keepAlive);
+	graphicsQueue->ReleaseDeferred(0, keepAlive);
+
+	return fenceValue;
+}
+
+HEAP_ALLOCATOR::STATISTICS HEAP_ALLOCATOR::GetStatistics()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	STATISTICS statistics;
+	for (auto& pools : _pools)
+	{
+		for (POOL& pool : pools)
+		{
+			for (auto& block : pool.blocks)
+			{
+				BUDDY_ALLOCATOR::STATISTICS blockStatistics = block->allocator.GetStatistics();
+				statistics.heapCount++;
+				statistics.heapBytes += block->allocator.GetSize();
+				statistics.allocationCount += blockStatistics.allocationCount;
+				statistics.requestedBytes += blockStatistics.requestedBytes;
+				statistics.allocatedBytes += blockStatistics.allocatedBytes;
+			}
+		}
+	}
+
+	return statistics;
+}
\ No newline at end of file
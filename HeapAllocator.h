@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Helpers.h"
+#include "BuddyAllocator.h"
+
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+class COMMAND_QUEUE;
+
+// Hands out placed resources sub-allocated from large ID3D12Heap blocks.
+// Each block is managed by a BUDDY_ALLOCATOR, resources larger than a block
+// get a dedicated heap. On resource heap tier 1 hardware buffers, render
+// target / depth stencil textures and other textures live in separate heaps.
+class HEAP_ALLOCATOR
+{
+	struct HEAP_BLOCK;
+
+public:
+	struct ALLOCATION
+	{
+		// Replaced when Defragment() moves the allocation, do not cache the
+		// resource or its GPU virtual address across a defragmentation.
+		ComPtr<ID3D12Resource>	resource;
+		D3D12_RESOURCE_DESC		desc = {};
+		uint64_t				offset = 0;
+		uint64_t				size = 0;
+		uint64_t				alignment = 0;
+
+	private:
+		friend class HEAP_ALLOCATOR;
+		HEAP_BLOCK*				block = nullptr;
+	};
+
+	struct STATISTICS
+	{
+		uint64_t heapCount = 0;
+		uint64_t heapBytes = 0;
+		uint64_t allocationCount = 0;
+		uint64_t requestedBytes = 0;	// Sizes reported by GetResourceAllocationInfo
+		uint64_t allocatedBytes = 0;	// Sizes of the buddy blocks
+	};
+
+	// The heap size must be a power of two multiple of 4 MiB.
+	HEAP_ALLOCATOR(ComPtr<ID3D12Device2> device, uint64_t heapSize = 64 * 1024 * 1024);
+	~HEAP_ALLOCATOR();
+
+	ALLOCATION* CreateResource(D3D12_HEAP_TYPE heapType,
+		const D3D12_RESOURCE_DESC& desc,
+		D3D12_RESOURCE_STATES initialState,
+		const D3D12_CLEAR_VALUE* clearValue = nullptr);
+
+	// The GPU must be done with the resource, see ReleaseDeferred().
+	void Free(ALLOCATION* allocation);
+
+	// Frees the allocation once the work already submitted on the queue completed.
+	void ReleaseDeferred(COMMAND_QUEUE* commandQueue, ALLOCATION* allocation);
+
+	// Moves the buffers of the least used DEFAULT heaps into the other heaps and
+	// releases the heaps left empty. The copies are submitted on 'copyQueue' after the work
+	// already submitted on 'graphicsQueue', the previous resources and heaps are kept alive
+	// until both queues are done with them.
+	// Returns the copy queue fence value the users of the moved buffers must wait on, 0 if nothing moved.
+	uint64_t Defragment(COMMAND_QUEUE* copyQueue, COMMAND_QUEUE* graphicsQueue);
+
+	STATISTICS GetStatistics();
+
+private:
+	enum HEAP_CATEGORY
+	{
+		HEAP_CATEGORY_BUFFERS,
+		HEAP_CATEGORY_RT_DS_TEXTURES,
+		HEAP_CATEGORY_NON_RT_DS_TEXTURES,
+		HEAP_CATEGORY_COUNT
+	};
+
+	struct HEAP_BLOCK
+	{
+		HEAP_BLOCK(uint64_t size) : allocator(size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT) { ; }
+
+		ComPtr<ID3D12Heap>				heap;
+		BUDDY_ALLOCATOR					allocator;
+		std::unordered_set<ALLOCATION*>	allocations;
+		bool							dedicated = false;
+	};
+
+	struct POOL
+	{
+		D3D12_HEAP_TYPE							heapType = D3D12_HEAP_TYPE_DEFAULT;
+		D3D12_HEAP_FLAGS						heapFlags = D3D12_HEAP_FLAG_NONE;
+		std::vector<std::unique_ptr<HEAP_BLOCK>>	blocks;
+	};
+
+	POOL& GetPool(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& desc);
+	HEAP_BLOCK* CreateBlock(POOL& pool, uint64_t size, bool dedicated);
+	void ReleaseBlock(POOL& pool, HEAP_BLOCK* block);
+
+	ComPtr<ID3D12Device2>	_device;
+	uint64_t				_heapSize = 0;
+	bool					_mixedHeaps = false;	// Resource heap tier 2
+
+	std::mutex	_mutex;
+	POOL		_pools[3][HEAP_CATEGORY_COUNT];	// DEFAULT, UPLOAD, READBACK
+};
\ No newline at end of file
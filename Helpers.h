@@ -1,6 +1,8 @@
 #pragma once
 #define WIN32_LEAN_AND_MEAN
 
+#include "Platform.h"
+
 #include <Windows.h>
 #include <vcruntime_exception.h>
 #include <shellapi.h> // For CommandLineToArgvW
@@ -38,9 +40,6 @@
 #include <wrl.h>
 using namespace Microsoft::WRL;
 
-// The number of swap chain back buffers.
-const uint8_t g_numFrames = 3;
-
 inline void ThrowIfFailed(HRESULT hr)
 {
     if (FAILED(hr))
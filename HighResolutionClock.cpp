@@ -1,5 +1,4 @@
-#include <Helpers.h>
-#include <HighResolutionClock.h>
+#include "HighResolutionClock.h"
 
 HighResolutionClock::HighResolutionClock()
     : m_DeltaTime(0)
@@ -0,0 +1,63 @@
+#include "IndirectDraw.h"
+
+#include <cstring>
+
+INDIRECT_DRAW_BUFFER_LAYOUT GetIndirectDrawBufferLayout(uint32_t maxCommands)
+{
+	INDIRECT_DRAW_BUFFER_LAYOUT layout;
+	layout.maxCommands = maxCommands;
+	layout.commandsOffset = 0;
+	layout.countOffset = static_cast<uint64_t>(maxCommands) * sizeof(INDIRECT_DRAW_COMMAND);
+	layout.size = layout.countOffset + sizeof(uint32_t);
+
+	return layout;
+}
+
+#if PLATFORM_D3D12
+ComPtr<ID3D12CommandSignature> CreateIndirectDrawSignature(ComPtr<ID3D12Device2> device,
+	ID3D12RootSignature* rootSignature,
+	uint32_t rootParameterIndex)
+{
+	D3D12_INDIRECT_ARGUMENT_DESC arguments[2] = {};
+	arguments[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+	arguments[0].Constant.RootParameterIndex = rootParameterIndex;
+	arguments[0].Constant.DestOffsetIn32BitValues = 0;
+	arguments[0].Constant.Num32BitValuesToSet = 1;
+	arguments[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+
+	D3D12_COMMAND_SIGNATURE_DESC signatureDesc = {};
+	signatureDesc.ByteStride = sizeof(INDIRECT_DRAW_COMMAND);
+	signatureDesc.NumArgumentDescs = _countof(arguments);
+	signatureDesc.pArgumentDescs = arguments;
+
+	// The root signature is required as the command changes a root argument.
+	ComPtr<ID3D12CommandSignature> commandSignature;
+	ThrowIfFailed(device->CreateCommandSignature(&signatureDesc, rootSignature, IID_PPV_ARGS(&commandSignature)));
+
+	return commandSignature;
+}
+#endif
+
+void PackIndirectDraws(INDIRECT_DRAW_COMMAND* destination,
+	const INDIRECT_DRAW* draws,
+	uint32_t begin,
+	uint32_t end,
+	const MESH_SUBMESH* submeshes)
+{
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		const INDIRECT_DRAW& draw = draws[i];
+		const MESH_SUBMESH& submesh = submeshes[draw.submesh];
+
+		// Built on the stack, the destination is only written, never read back.
+		INDIRECT_DRAW_COMMAND command;
+		command.firstInstance = draw.firstInstance;
+		command.draw.IndexCountPerInstance = submesh.indexCount;
+		command.draw.InstanceCount = draw.instanceCount;
+		command.draw.StartIndexLocation = submesh.firstIndex;
+		command.draw.BaseVertexLocation = submesh.baseVertex;
+		command.draw.StartInstanceLocation = 0;
+
+		memcpy(destination + i, &command, sizeof(command));
+	}
+}
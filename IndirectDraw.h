@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Platform.h"
+#include "MeshFile.h"
+
+#if PLATFORM_D3D12
+#include "Helpers.h"
+typedef D3D12_DRAW_INDEXED_ARGUMENTS DRAW_INDEXED_ARGUMENTS;
+#else
+#include "NullDevice.h"
+typedef NULL_DRAW_INDEXED_ARGUMENTS DRAW_INDEXED_ARGUMENTS;
+#endif
+
+#include <cstdint>
+
+// One ExecuteIndirect command: the index of the first instance of the draw
+// in the instance buffer, set as a root constant, then the indexed draw.
+// SV_InstanceID does not include StartInstanceLocation, the root constant
+// carries the offset instead.
+struct INDIRECT_DRAW_COMMAND
+{
+	uint32_t				firstInstance;
+	DRAW_INDEXED_ARGUMENTS	draw;
+};
+static_assert(sizeof(INDIRECT_DRAW_COMMAND) == 24, "INDIRECT_DRAW_COMMAND must match the command signature stride");
+
+// Object to draw: a submesh of the bound mesh over a range of the instance buffer.
+struct INDIRECT_DRAW
+{
+	uint32_t	submesh;
+	uint32_t	firstInstance;
+	uint32_t	instanceCount;
+};
+
+// Argument buffer layout, the same whether the CPU or a GPU culling pass fills it:
+// 'maxCommands' INDIRECT_DRAW_COMMAND from offset 0, then the 32-bit command
+// count read by ExecuteIndirect. A GPU producer appends commands with an atomic
+// increment of the count, which must be cleared first.
+struct INDIRECT_DRAW_BUFFER_LAYOUT
+{
+	uint64_t	commandsOffset = 0;
+	uint64_t	countOffset = 0;
+	uint64_t	size = 0;
+	uint32_t	maxCommands = 0;
+};
+INDIRECT_DRAW_BUFFER_LAYOUT GetIndirectDrawBufferLayout(uint32_t maxCommands);
+
+#if PLATFORM_D3D12
+// Command signature for INDIRECT_DRAW_COMMAND, 'rootParameterIndex' is a single 32-bit constant
+// of 'rootSignature' receiving firstInstance.
+ComPtr<ID3D12CommandSignature> CreateIndirectDrawSignature(ComPtr<ID3D12Device2> device,
+	ID3D12RootSignature* rootSignature,
+	uint32_t rootParameterIndex);
+#endif
+
+// Packs draws [begin, end) into destination[begin, end), commands are written in order,
+// whole, so write-combined upload memory is filled sequentially. Disjoint ranges can be
+// packed from several threads.
+void PackIndirectDraws(INDIRECT_DRAW_COMMAND* destination,
+	const INDIRECT_DRAW* draws,
+	uint32_t begin,
+	uint32_t end,
+	const MESH_SUBMESH* submeshes);
@@ -0,0 +1,193 @@
+#include "InstanceTransforms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace VectorMath;
+
+void INSTANCE_SET::Resize(uint32_t instanceCount)
+{
+	count = instanceCount;
+
+	size_t paddedCount = static_cast<size_t>(GetGroupCount()) * 4;
+	positionX.assign(paddedCount, 0.0f);
+	positionY.assign(paddedCount, 0.0f);
+	positionZ.assign(paddedCount, 0.0f);
+	phase.assign(paddedCount, 0.0f);
+}
+
+float CreateInstanceGrid(INSTANCE_SET& instances, uint32_t count, float spacing)
+{
+	instances.Resize(count);
+
+	uint32_t side = 1;
+	while (side * side * side < count)
+	{
+		side++;
+	}
+	const float origin = (side - 1) * spacing * 0.5f;
+
+	// Fixed seed, the scene is the same from run to run.
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> phaseDistribution(0.0f, TWO_PI);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		instances.positionX[i] = (i % side) * spacing - origin;
+		instances.positionY[i] = ((i / side) % side) * spacing - origin;
+		instances.positionZ[i] = (i / (side * side)) * spacing - origin;
+		instances.phase[i] = phaseDistribution(random);
+	}
+
+	return origin * std::sqrt(3.0f);
+}
+
+// Constants of one build, shared by the groups of 4 instances.
+struct TRANSFORM_BUILDER
+{
+	VECTOR	outer[3][3];
+	VECTOR	negativeCross[3][3];
+	VECTOR	base[4][3];
+	VECTOR	time;
+	VECTOR	speed;
+
+	TRANSFORM_BUILDER(const MATRIX& baseTransform, const FLOAT3& axis, float buildTime, float angularSpeed)
+	{
+		// Rotation of row vectors: R = cos * I + (1 - cos) * a * aT - sin * [a]x,
+		// every element is a linear combination of cos and sin shared by the 4 lanes.
+		const float a[3] = { axis.x, axis.y, axis.z };
+		const float cross[3][3] = {
+			{ 0.0f, -a[2], a[1] },
+			{ a[2], 0.0f, -a[0] },
+			{ -a[1], a[0], 0.0f }
+		};
+
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				outer[i][j] = VectorReplicate(a[i] * a[j]);
+				negativeCross[i][j] = VectorReplicate(-cross[i][j]);
+			}
+		}
+
+		FLOAT4X4 baseElements;
+		StoreFloat4x4(&baseElements, baseTransform);
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				base[i][k] = VectorReplicate(baseElements.m[i][k]);
+			}
+		}
+
+		time = VectorReplicate(buildTime);
+		speed = VectorReplicate(angularSpeed);
+	}
+
+	// Writes the matrices of the first 'laneCount' lanes to destination[0, laneCount).
+	void Build(FLOAT4X4* destination, uint32_t laneCount, VECTOR phase, VECTOR positionX, VECTOR positionY, VECTOR positionZ) const
+	{
+		const VECTOR one = VectorSplatOne();
+		const VECTOR zero = VectorZero();
+
+		VECTOR angle = VectorMultiplyAdd(time, speed, phase);
+		VECTOR sin, cos;
+		VectorSinCos(&sin, &cos, angle);
+		VECTOR oneMinusCos = VectorSubtract(one, cos);
+
+		VECTOR rotation[3][3];
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				rotation[i][j] = VectorMultiplyAdd(oneMinusCos, outer[i][j], VectorMultiply(sin, negativeCross[i][j]));
+			}
+			rotation[i][i] = VectorAdd(rotation[i][i], cos);
+		}
+
+		// World = base * rotation * translation, one vector per matrix element.
+		const VECTOR translation[3] = { positionX, positionY, positionZ };
+
+		// Transposed per row, rows[i].r[lane] is row i of the instance in that lane.
+		MATRIX rows[4];
+		for (int i = 0; i < 4; ++i)
+		{
+			VECTOR world[3];
+			for (int j = 0; j < 3; ++j)
+			{
+				world[j] = i == 3 ? translation[j] : zero;
+				for (int k = 0; k < 3; ++k)
+				{
+					world[j] = VectorMultiplyAdd(base[i][k], rotation[k][j], world[j]);
+				}
+			}
+			rows[i] = MatrixTranspose(MatrixSet(world[0], world[1], world[2], i == 3 ? one : zero));
+		}
+
+		// One instance after the other, upload heaps are write-combined.
+		for (uint32_t lane = 0; lane < laneCount; ++lane)
+		{
+			FLOAT4X4& matrix = destination[lane];
+			for (int i = 0; i < 4; ++i)
+			{
+				VectorStore(matrix.m[i], rows[i].r[lane]);
+			}
+		}
+	}
+};
+
+void BuildInstanceTransforms(FLOAT4X4* destination,
+	const INSTANCE_SET& instances,
+	uint32_t beginGroup,
+	uint32_t endGroup,
+	const MATRIX& baseTransform,
+	const FLOAT3& axis,
+	float time,
+	float angularSpeed)
+{
+	TRANSFORM_BUILDER builder(baseTransform, axis, time, angularSpeed);
+
+	for (uint32_t group = beginGroup; group < endGroup; ++group)
+	{
+		const uint32_t first = group * 4;
+		builder.Build(destination + first, std::min(4u, instances.count - first),
+			VectorLoad(&instances.phase[first]),
+			VectorLoad(&instances.positionX[first]),
+			VectorLoad(&instances.positionY[first]),
+			VectorLoad(&instances.positionZ[first]));
+	}
+}
+
+void BuildInstanceTransforms(FLOAT4X4* destination,
+	const INSTANCE_SET& instances,
+	const uint32_t* indices,
+	uint32_t indexCount,
+	uint32_t beginGroup,
+	uint32_t endGroup,
+	const MATRIX& baseTransform,
+	const FLOAT3& axis,
+	float time,
+	float angularSpeed)
+{
+	TRANSFORM_BUILDER builder(baseTransform, axis, time, angularSpeed);
+
+	for (uint32_t group = beginGroup; group < endGroup; ++group)
+	{
+		// Gathered into lanes, the missing ones of the last group repeat the last index.
+		const uint32_t first = group * 4;
+		const uint32_t laneCount = std::min(4u, indexCount - first);
+		uint32_t lanes[4];
+		for (uint32_t lane = 0; lane < 4; ++lane)
+		{
+			lanes[lane] = indices[first + std::min(lane, laneCount - 1)];
+		}
+
+		builder.Build(destination + first, laneCount,
+			VectorSet(instances.phase[lanes[0]], instances.phase[lanes[1]], instances.phase[lanes[2]], instances.phase[lanes[3]]),
+			VectorSet(instances.positionX[lanes[0]], instances.positionX[lanes[1]], instances.positionX[lanes[2]], instances.positionX[lanes[3]]),
+			VectorSet(instances.positionY[lanes[0]], instances.positionY[lanes[1]], instances.positionY[lanes[2]], instances.positionY[lanes[3]]),
+			VectorSet(instances.positionZ[lanes[0]], instances.positionZ[lanes[1]], instances.positionZ[lanes[2]], instances.positionZ[lanes[3]]));
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "VectorMath.h"
+
+#include <cstdint>
+#include <vector>
+
+// Placement of objects spinning around a shared axis, stored as structure of
+// arrays so BuildInstanceTransforms() processes 4 instances per SIMD operation.
+// The arrays are padded to a multiple of 4, the padding is never written out.
+struct INSTANCE_SET
+{
+	std::vector<float>	positionX;
+	std::vector<float>	positionY;
+	std::vector<float>	positionZ;
+	std::vector<float>	phase;				// Rotation angle at time 0, in radians
+	uint32_t			count = 0;
+
+	void Resize(uint32_t instanceCount);
+	inline uint32_t GetGroupCount() const { return (count + 3) / 4; }
+};
+
+// Fills a cubic grid centered on the origin with random phases.
+// Returns the radius of the sphere enclosing the instance positions.
+float CreateInstanceGrid(INSTANCE_SET& instances, uint32_t count, float spacing);
+
+// Writes the world matrices of the instances in groups [beginGroup, endGroup):
+// baseTransform * rotation(axis, phase + time * angularSpeed) * translation(position).
+// 'baseTransform' must be affine (last column 0, 0, 0, 1), 'axis' normalized.
+// The matrices are stored in the row-major layout the vertex shader reads.
+void BuildInstanceTransforms(VectorMath::FLOAT4X4* destination,
+	const INSTANCE_SET& instances,
+	uint32_t beginGroup,
+	uint32_t endGroup,
+	const VectorMath::MATRIX& baseTransform,
+	const VectorMath::FLOAT3& axis,
+	float time,
+	float angularSpeed);
+
+// Same for the instances listed in 'indices', compacted: destination[i] is the
+// matrix of instance indices[i]. The groups are groups of 4 indices.
+void BuildInstanceTransforms(VectorMath::FLOAT4X4* destination,
+	const INSTANCE_SET& instances,
+	const uint32_t* indices,
+	uint32_t indexCount,
+	uint32_t beginGroup,
+	uint32_t endGroup,
+	const VectorMath::MATRIX& baseTransform,
+	const VectorMath::FLOAT3& axis,
+	float time,
+	float angularSpeed);
@@ -0,0 +1,204 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// Worker identity of the calling thread.
+struct WORKER_IDENTITY
+{
+	const JOB_SYSTEM*	system;
+	int					index;
+};
+
+static thread_local WORKER_IDENTITY t_worker = { nullptr, -1 };
+
+JOB_SYSTEM::JOB_SYSTEM(uint32_t workerCount)
+{
+	if (workerCount == 0)
+	{
+		workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+	}
+
+	// Every deque exists before a worker may try to steal from it.
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		_workers.push_back(std::make_unique<WORKER>());
+	}
+
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		_workers[i]->thread = std::thread(&JOB_SYSTEM::WorkerMain, this, i);
+	}
+}
+
+JOB_SYSTEM::~JOB_SYSTEM()
+{
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_stop = true;
+	}
+	_sleepCondition.notify_all();
+
+	// Workers drain the queued jobs before leaving.
+	for (auto& worker : _workers)
+	{
+		worker->thread.join();
+	}
+}
+
+int JOB_SYSTEM::GetCurrentWorkerIndex() const
+{
+	return t_worker.system == this ? t_worker.index : -1;
+}
+
+void JOB_SYSTEM::Run(std::function<void()> job, JOB_COUNTER* counter)
+{
+	if (counter)
+	{
+		counter->_pending.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	int workerIndex = GetCurrentWorkerIndex();
+	if (workerIndex >= 0)
+	{
+		WORKER& worker = *_workers[workerIndex];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.jobs.push_back(JOB{ std::move(job), counter });
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(_injectorMutex);
+		_injector.push_back(JOB{ std::move(job), counter });
+	}
+
+	_queuedJobs.fetch_add(1, std::memory_order_release);
+
+	// Taking the lock orders the increment with a worker about to sleep.
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+	}
+	_sleepCondition.notify_one();
+}
+
+void JOB_SYSTEM::Wait(JOB_COUNTER& counter)
+{
+	int workerIndex = GetCurrentWorkerIndex();
+
+	while (counter.IsDone() == false)
+	{
+		JOB job;
+		if (TryGetJob(workerIndex, job))
+		{
+			Execute(job);
+		}
+		else
+		{
+			// The remaining jobs run on other threads.
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JOB_SYSTEM::ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t begin, uint32_t end)>& body)
+{
+	grainSize = std::max(1u, grainSize);
+
+	JOB_COUNTER counter;
+	for (uint32_t begin = 0; begin < count; begin += grainSize)
+	{
+		uint32_t end = std::min(count, begin + grainSize);
+		Run([&body, begin, end]() { body(begin, end); }, &counter);
+	}
+
+	Wait(counter);
+}
+
+void JOB_SYSTEM::WorkerMain(uint32_t workerIndex)
+{
+	t_worker.system = this;
+	t_worker.index = static_cast<int>(workerIndex);
+
+	while (true)
+	{
+		JOB job;
+		if (TryGetJob(workerIndex, job))
+		{
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+		_sleepCondition.wait(lock, [&]() { return _stop || _queuedJobs.load(std::memory_order_acquire) > 0; });
+		if (_stop && _queuedJobs.load(std::memory_order_acquire) == 0)
+		{
+			break;
+		}
+	}
+}
+
+bool JOB_SYSTEM::TryGetJob(int workerIndex, JOB& job)
+{
+	if (_queuedJobs.load(std::memory_order_acquire) == 0)
+	{
+		return false;
+	}
+
+	auto popFront = [&](std::mutex& mutex, std::deque<JOB>& jobs)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (jobs.empty())
+		{
+			return false;
+		}
+		job = std::move(jobs.front());
+		jobs.pop_front();
+		return true;
+	};
+
+	bool found = false;
+
+	// Newest job of the own deque first, its data is likely still in cache.
+	if (workerIndex >= 0)
+	{
+		WORKER& worker = *_workers[workerIndex];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (worker.jobs.empty() == false)
+		{
+			job = std::move(worker.jobs.back());
+			worker.jobs.pop_back();
+			found = true;
+		}
+	}
+
+	if (found == false)
+	{
+		found = popFront(_injectorMutex, _injector);
+	}
+
+	// Oldest jobs of the other workers, they tend to be the largest.
+	const size_t workerCount = _workers.size();
+	const size_t start = workerIndex >= 0 ? workerIndex + 1 : 0;
+	for (size_t i = 0; i < workerCount && found == false; ++i)
+	{
+		size_t victim = (start + i) % workerCount;
+		if (static_cast<int>(victim) != workerIndex)
+		{
+			found = popFront(_workers[victim]->mutex, _workers[victim]->jobs);
+		}
+	}
+
+	if (found)
+	{
+		_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	}
+	return found;
+}
+
+void JOB_SYSTEM::Execute(JOB& job)
+{
+	job.function();
+
+	if (job.counter)
+	{
+		job.counter->_pending.fetch_sub(1, std::memory_order_release);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts the unfinished jobs of a group, JOB_SYSTEM::Wait() blocks until it reaches zero.
+class JOB_COUNTER
+{
+public:
+	inline bool IsDone() const { return _pending.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JOB_SYSTEM;
+	std::atomic<uint32_t> _pending{ 0 };
+};
+
+// Work-stealing job scheduler.
+// Each worker owns a deque, it pushes and pops its own jobs at the back and
+// steals from the front of the other deques when empty. Jobs pushed from
+// threads outside the system go to a global injector queue. Waiting threads,
+// workers or not, run jobs until their counter is done, so jobs may spawn and
+// wait on other jobs without blocking a worker.
+class JOB_SYSTEM
+{
+public:
+	// 0 uses one worker per hardware thread, minus the calling thread.
+	explicit JOB_SYSTEM(uint32_t workerCount = 0);
+	~JOB_SYSTEM();
+
+	void Run(std::function<void()> job, JOB_COUNTER* counter = nullptr);
+	void Wait(JOB_COUNTER& counter);
+
+	// Splits [0, count) in ranges of at most 'grainSize' and waits for them.
+	void ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t begin, uint32_t end)>& body);
+
+	inline uint32_t GetWorkerCount() const { return static_cast<uint32_t>(_workers.size()); }
+
+	// Index of the calling worker in this system, -1 for other threads.
+	int GetCurrentWorkerIndex() const;
+
+private:
+	struct JOB
+	{
+		std::function<void()>	function;
+		JOB_COUNTER*			counter;
+	};
+
+	struct WORKER
+	{
+		std::mutex			mutex;
+		std::deque<JOB>		jobs;
+		std::thread			thread;
+	};
+
+	void WorkerMain(uint32_t workerIndex);
+
+	// Pops a job from the own deque, the injector, then steals from the other workers.
+	bool TryGetJob(int workerIndex, JOB& job);
+	void Execute(JOB& job);
+
+	std::vector<std::unique_ptr<WORKER>>	_workers;
+
+	std::mutex				_injectorMutex;
+	std::deque<JOB>			_injector;
+
+	// Sleeping workers are woken when jobs are queued.
+	std::mutex				_sleepMutex;
+	std::condition_variable	_sleepCondition;
+	std::atomic<uint32_t>	_queuedJobs{ 0 };
+	bool					_stop = false;
+};
\ No newline at end of file
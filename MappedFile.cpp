@@ -0,0 +1,154 @@
+#include "MappedFile.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MAPPED_FILE::~MAPPED_FILE()
+{
+	Close();
+}
+
+#if defined(_WIN32)
+
+bool MAPPED_FILE::Open(const std::string& path)
+{
+	Close();
+
+	HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	_file = file;
+
+	LARGE_INTEGER size = {};
+	if (::GetFileSizeEx(file, &size) == FALSE || size.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	_mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (_mapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	_data = static_cast<const uint8_t*>(::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (_data == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	_size = static_cast<uint64_t>(size.QuadPart);
+	return true;
+}
+
+void MAPPED_FILE::Close()
+{
+	if (_data)
+	{
+		::UnmapViewOfFile(_data);
+	}
+	if (_mapping)
+	{
+		::CloseHandle(_mapping);
+	}
+	if (_file)
+	{
+		::CloseHandle(_file);
+	}
+
+	_data = nullptr;
+	_size = 0;
+	_mapping = nullptr;
+	_file = nullptr;
+}
+
+void MAPPED_FILE::Prefetch(uint64_t offset, uint64_t size) const
+{
+	if (_data == nullptr || offset >= _size)
+	{
+		return;
+	}
+
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = const_cast<uint8_t*>(_data + offset);
+	range.NumberOfBytes = static_cast<SIZE_T>(std::min(size, _size - offset));
+	::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+}
+
+#else
+
+bool MAPPED_FILE::Open(const std::string& path)
+{
+	Close();
+
+	_file = ::open(path.c_str(), O_RDONLY);
+	if (_file < 0)
+	{
+		return false;
+	}
+
+	struct stat status = {};
+	if (::fstat(_file, &status) != 0 || status.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+
+	void* data = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, _file, 0);
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	_data = static_cast<const uint8_t*>(data);
+	_size = static_cast<uint64_t>(status.st_size);
+	return true;
+}
+
+void MAPPED_FILE::Close()
+{
+	if (_data)
+	{
+		::munmap(const_cast<uint8_t*>(_data), static_cast<size_t>(_size));
+	}
+	if (_file >= 0)
+	{
+		::close(_file);
+	}
+
+	_data = nullptr;
+	_size = 0;
+	_file = -1;
+}
+
+void MAPPED_FILE::Prefetch(uint64_t offset, uint64_t size) const
+{
+	if (_data == nullptr || offset >= _size)
+	{
+		return;
+	}
+
+	// madvise() wants a page aligned address.
+	const uint64_t pageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+	const uint64_t begin = offset / pageSize * pageSize;
+	const uint64_t end = std::min(_size, offset + size);
+	::madvise(const_cast<uint8_t*>(_data + begin), static_cast<size_t>(end - begin), MADV_WILLNEED);
+}
+
+#endif
\ No newline at end of file
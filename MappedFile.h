@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Read-only mapping of a whole file. Pages are brought in by the OS on first
+// access, reading a section costs no intermediate copy nor allocation.
+class MAPPED_FILE
+{
+public:
+	MAPPED_FILE() { ; }
+	~MAPPED_FILE();
+
+	MAPPED_FILE(const MAPPED_FILE&) = delete;
+	MAPPED_FILE& operator=(const MAPPED_FILE&) = delete;
+
+	// Returns false when the file cannot be opened or is empty.
+	bool Open(const std::string& path);
+	void Close();
+
+	// Hints the OS that [offset, offset + size) is about to be read.
+	void Prefetch(uint64_t offset, uint64_t size) const;
+
+	inline bool IsOpen() const { return _data != nullptr; }
+	inline const uint8_t* GetData() const { return _data; }
+	inline uint64_t GetSize() const { return _size; }
+
+private:
+	const uint8_t*	_data = nullptr;
+	uint64_t		_size = 0;
+
+#if defined(_WIN32)
+	void*	_file = nullptr;
+	void*	_mapping = nullptr;
+#else
+	int		_file = -1;
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,346 @@
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <fstream>
+
+static_assert(sizeof(MESH_HEADER) == 80, "MESH_HEADER is part of the file format.");
+static_assert(sizeof(MESH_STREAM) == 32, "MESH_STREAM is part of the file format.");
+static_assert(sizeof(MESH_SUBMESH) == 40, "MESH_SUBMESH is part of the file format.");
+
+static inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+static MESH_BOUNDS EmptyBounds()
+{
+	MESH_BOUNDS bounds;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		bounds.min[axis] = FLT_MAX;
+		bounds.max[axis] = -FLT_MAX;
+	}
+	return bounds;
+}
+
+static void GrowBounds(MESH_BOUNDS& bounds, const float* position)
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		bounds.min[axis] = std::min(bounds.min[axis], position[axis]);
+		bounds.max[axis] = std::max(bounds.max[axis], position[axis]);
+	}
+}
+
+static const MESH_DATA::STREAM* FindPositions(const MESH_DATA& mesh)
+{
+	for (const MESH_DATA::STREAM& stream : mesh.streams)
+	{
+		if (stream.semantic == MESH_SEMANTIC_POSITION && (stream.format == MESH_FORMAT_FLOAT3 || stream.format == MESH_FORMAT_FLOAT4 || stream.format == MESH_FORMAT_SNORM16X4))
+		{
+			return &stream;
+		}
+	}
+	return nullptr;
+}
+
+uint32_t GetMeshFormatSize(MESH_FORMAT format)
+{
+	switch (format)
+	{
+	case MESH_FORMAT_FLOAT2: return 2 * sizeof(float);
+	case MESH_FORMAT_FLOAT3: return 3 * sizeof(float);
+	case MESH_FORMAT_FLOAT4: return 4 * sizeof(float);
+	case MESH_FORMAT_SNORM16X4: return 4 * sizeof(int16_t);
+	case MESH_FORMAT_UNORM8X4: return 4 * sizeof(uint8_t);
+	case MESH_FORMAT_SNORM16X2: return 2 * sizeof(int16_t);
+	default: return 0;
+	}
+}
+
+void DecodeMeshPosition(MESH_FORMAT format, const uint8_t* vertex, const MESH_BOUNDS& bounds, float position[3])
+{
+	if (format == MESH_FORMAT_SNORM16X4)
+	{
+		// Same conversion as the input assembler, the half extent is applied in the same order as the encoder.
+		int16_t encoded[3];
+		memcpy(encoded, vertex, sizeof(encoded));
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float center = (bounds.min[axis] + bounds.max[axis]) * 0.5f;
+			float halfExtent = (bounds.max[axis] - bounds.min[axis]) * 0.5f;
+			position[axis] = center + std::max(encoded[axis] / 32767.0f, -1.0f) * halfExtent;
+		}
+	}
+	else
+	{
+		memcpy(position, vertex, 3 * sizeof(float));
+	}
+}
+
+void ComputeMeshBounds(MESH_DATA& mesh)
+{
+	const MESH_DATA::STREAM* positions = FindPositions(mesh);
+	const uint32_t stride = positions ? GetMeshFormatSize(positions->format) : 0;
+
+	if (positions && positions->format != MESH_FORMAT_SNORM16X4)
+	{
+		mesh.bounds = EmptyBounds();
+		for (uint32_t vertex = 0; vertex < mesh.vertexCount; ++vertex)
+		{
+			float position[3];
+			memcpy(position, &positions->data[vertex * stride], sizeof(position));
+			GrowBounds(mesh.bounds, position);
+		}
+	}
+
+	for (MESH_SUBMESH& submesh : mesh.submeshes)
+	{
+		submesh.bounds = EmptyBounds();
+		if (positions == nullptr)
+		{
+			continue;
+		}
+
+		for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; ++i)
+		{
+			float position[3];
+			DecodeMeshPosition(positions->format, &positions->data[(mesh.indices[i] + submesh.baseVertex) * stride], mesh.bounds, position);
+			GrowBounds(submesh.bounds, position);
+		}
+	}
+}
+
+bool WriteMeshFile(const std::string& path, const MESH_DATA& mesh)
+{
+	const bool shortIndices = mesh.vertexCount <= UINT16_MAX + 1u;
+	const uint32_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+	MESH_HEADER header = {};
+	header.magic = g_meshMagic;
+	header.version = g_meshVersion;
+	header.streamCount = static_cast<uint32_t>(mesh.streams.size());
+	header.submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+	header.vertexCount = mesh.vertexCount;
+	header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+	header.indexFormat = shortIndices ? MESH_INDEX_UINT16 : MESH_INDEX_UINT32;
+	header.bounds = mesh.bounds;
+
+	// Sections follow the tables, each on its own page.
+	std::vector<MESH_STREAM> streams(mesh.streams.size());
+	uint64_t offset = AlignUp(sizeof(MESH_HEADER) + streams.size() * sizeof(MESH_STREAM) + mesh.submeshes.size() * sizeof(MESH_SUBMESH), g_meshSectionAlignment);
+	for (size_t i = 0; i < streams.size(); ++i)
+	{
+		streams[i].semantic = mesh.streams[i].semantic;
+		streams[i].format = mesh.streams[i].format;
+		streams[i].stride = GetMeshFormatSize(mesh.streams[i].format);
+		streams[i].reserved = 0;
+		streams[i].offset = offset;
+		streams[i].size = static_cast<uint64_t>(streams[i].stride) * mesh.vertexCount;
+		if (streams[i].size != mesh.streams[i].data.size())
+		{
+			return false;
+		}
+		offset = AlignUp(offset + streams[i].size, g_meshSectionAlignment);
+	}
+
+	header.indexOffset = offset;
+	header.indexSize = static_cast<uint64_t>(indexSize) * mesh.indices.size();
+	header.fileSize = AlignUp(offset + header.indexSize, g_meshSectionAlignment);
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (file.is_open() == false)
+	{
+		return false;
+	}
+
+	auto pad = [&file](uint64_t target)
+	{
+		static const char zeros[g_meshSectionAlignment] = {};
+		uint64_t position = static_cast<uint64_t>(file.tellp());
+		file.write(zeros, static_cast<std::streamsize>(target - position));
+	};
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(streams.data()), streams.size() * sizeof(MESH_STREAM));
+	file.write(reinterpret_cast<const char*>(mesh.submeshes.data()), mesh.submeshes.size() * sizeof(MESH_SUBMESH));
+
+	for (size_t i = 0; i < streams.size(); ++i)
+	{
+		pad(streams[i].offset);
+		file.write(reinterpret_cast<const char*>(mesh.streams[i].data.data()), mesh.streams[i].data.size());
+	}
+
+	pad(header.indexOffset);
+	if (shortIndices)
+	{
+		std::vector<uint16_t> indices(mesh.indices.begin(), mesh.indices.end());
+		file.write(reinterpret_cast<const char*>(indices.data()), header.indexSize);
+	}
+	else
+	{
+		file.write(reinterpret_cast<const char*>(mesh.indices.data()), header.indexSize);
+	}
+	pad(header.fileSize);
+
+	return file.good();
+}
+
+// Every index of a submesh, offset by its base vertex, addresses a vertex of the mesh.
+// Without submeshes the whole index buffer is drawn from vertex 0.
+static bool AreIndicesInRange(const MESH_DATA& mesh)
+{
+	auto isInRange = [&mesh](uint32_t firstIndex, uint32_t indexCount, int32_t baseVertex)
+	{
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; ++i)
+		{
+			int64_t vertex = int64_t(mesh.indices[i]) + baseVertex;
+			if (vertex < 0 || vertex >= mesh.vertexCount)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	if (mesh.submeshes.empty())
+	{
+		return isInRange(0, static_cast<uint32_t>(mesh.indices.size()), 0);
+	}
+
+	for (const MESH_SUBMESH& submesh : mesh.submeshes)
+	{
+		if (isInRange(submesh.firstIndex, submesh.indexCount, submesh.baseVertex) == false)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ReadMeshData(const MESH_FILE& file, MESH_DATA& mesh)
+{
+	const MESH_HEADER& header = file.GetHeader();
+
+	mesh = MESH_DATA();
+	mesh.vertexCount = header.vertexCount;
+	mesh.bounds = header.bounds;
+	for (uint32_t i = 0; i < header.streamCount; ++i)
+	{
+		const MESH_STREAM& stream = file.GetStream(i);
+		const uint8_t* data = file.GetStreamData(stream);
+
+		MESH_DATA::STREAM meshStream = { static_cast<MESH_SEMANTIC>(stream.semantic), static_cast<MESH_FORMAT>(stream.format), {} };
+		meshStream.data.assign(data, data + stream.size);
+		mesh.streams.push_back(std::move(meshStream));
+	}
+
+	mesh.indices.resize(header.indexCount);
+	if (header.indexFormat == MESH_INDEX_UINT16)
+	{
+		const uint16_t* indices = reinterpret_cast<const uint16_t*>(file.GetIndexData());
+		std::copy(indices, indices + header.indexCount, mesh.indices.begin());
+	}
+	else
+	{
+		memcpy(mesh.indices.data(), file.GetIndexData(), header.indexSize);
+	}
+
+	for (uint32_t i = 0; i < header.submeshCount; ++i)
+	{
+		mesh.submeshes.push_back(file.GetSubmesh(i));
+	}
+
+	if (AreIndicesInRange(mesh) == false)
+	{
+		mesh = MESH_DATA();
+		return false;
+	}
+	return true;
+}
+
+bool MESH_FILE::Open(const std::string& path)
+{
+	Close();
+
+	if (_file.Open(path) == false)
+	{
+		return false;
+	}
+
+	const uint64_t fileSize = _file.GetSize();
+	const uint8_t* data = _file.GetData();
+
+	// A section is valid when aligned and fully inside the file, written to avoid overflows.
+	auto isValidSection = [fileSize](uint64_t offset, uint64_t size)
+	{
+		return offset % g_meshSectionAlignment == 0 && offset <= fileSize && size <= fileSize - offset;
+	};
+
+	const MESH_HEADER* header = reinterpret_cast<const MESH_HEADER*>(data);
+	bool valid = fileSize >= sizeof(MESH_HEADER) &&
+		header->magic == g_meshMagic &&
+		header->version == g_meshVersion &&
+		header->fileSize == fileSize &&
+		sizeof(MESH_HEADER) + uint64_t(header->streamCount) * sizeof(MESH_STREAM) + uint64_t(header->submeshCount) * sizeof(MESH_SUBMESH) <= fileSize;
+
+	if (valid)
+	{
+		const uint64_t indexStride = header->indexFormat == MESH_INDEX_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+		valid = header->indexFormat <= MESH_INDEX_UINT32 &&
+			header->indexSize == indexStride * header->indexCount &&
+			isValidSection(header->indexOffset, header->indexSize);
+	}
+
+	const MESH_STREAM* streams = reinterpret_cast<const MESH_STREAM*>(data + sizeof(MESH_HEADER));
+	for (uint32_t i = 0; valid && i < header->streamCount; ++i)
+	{
+		const MESH_STREAM& stream = streams[i];
+		valid = stream.semantic < MESH_SEMANTIC_COUNT &&
+			stream.format < MESH_FORMAT_COUNT &&
+			stream.stride == GetMeshFormatSize(static_cast<MESH_FORMAT>(stream.format)) &&
+			stream.size == uint64_t(stream.stride) * header->vertexCount &&
+			isValidSection(stream.offset, stream.size);
+	}
+
+	// Index values are not checked, it would touch every page of the index buffer.
+	// ReadMeshData() checks them when copying.
+	const MESH_SUBMESH* submeshes = reinterpret_cast<const MESH_SUBMESH*>(streams + (valid ? header->streamCount : 0));
+	for (uint32_t i = 0; valid && i < header->submeshCount; ++i)
+	{
+		valid = uint64_t(submeshes[i].firstIndex) + submeshes[i].indexCount <= header->indexCount;
+	}
+
+	if (valid == false)
+	{
+		Close();
+		return false;
+	}
+
+	_header = header;
+	_streams = streams;
+	_submeshes = submeshes;
+	return true;
+}
+
+void MESH_FILE::Close()
+{
+	_file.Close();
+	_header = nullptr;
+	_streams = nullptr;
+	_submeshes = nullptr;
+}
+
+const MESH_STREAM* MESH_FILE::FindStream(MESH_SEMANTIC semantic) const
+{
+	for (uint32_t i = 0; i < _header->streamCount; ++i)
+	{
+		if (_streams[i].semantic == semantic)
+		{
+			return &_streams[i];
+		}
+	}
+	return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary mesh container (.mesh).
+// A header page holds the MESH_HEADER followed by the stream and submesh
+// tables, then every vertex stream and the index buffer start on their own
+// page. Sections are used in place from a mapping of the file, they are read
+// straight into upload memory. Little endian, versioned by MESH_HEADER::version.
+const uint32_t g_meshMagic = 0x4853454D;		// "MESH"
+const uint32_t g_meshVersion = 1;
+const uint64_t g_meshSectionAlignment = 4096;
+
+enum MESH_SEMANTIC : uint32_t
+{
+	MESH_SEMANTIC_POSITION,
+	MESH_SEMANTIC_NORMAL,
+	MESH_SEMANTIC_COLOR,
+	MESH_SEMANTIC_TEXCOORD,
+	MESH_SEMANTIC_COUNT
+};
+
+enum MESH_FORMAT : uint32_t
+{
+	MESH_FORMAT_FLOAT2,
+	MESH_FORMAT_FLOAT3,
+	MESH_FORMAT_FLOAT4,
+	MESH_FORMAT_SNORM16X4,		// Positions relative to MESH_HEADER::bounds, w is 1
+	MESH_FORMAT_UNORM8X4,		// Colors
+	MESH_FORMAT_SNORM16X2,		// Octahedral unit vectors, normals
+	MESH_FORMAT_COUNT
+};
+
+enum MESH_INDEX_FORMAT : uint32_t
+{
+	MESH_INDEX_UINT16,
+	MESH_INDEX_UINT32
+};
+
+uint32_t GetMeshFormatSize(MESH_FORMAT format);
+
+struct MESH_BOUNDS
+{
+	float	min[3];
+	float	max[3];
+};
+
+struct MESH_HEADER
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint64_t	fileSize;
+	uint32_t	streamCount;
+	uint32_t	submeshCount;
+	uint32_t	vertexCount;
+	uint32_t	indexCount;
+	uint32_t	indexFormat;		// MESH_INDEX_FORMAT
+	uint32_t	reserved;
+	uint64_t	indexOffset;		// Index buffer section
+	uint64_t	indexSize;
+	MESH_BOUNDS	bounds;
+};
+
+// One vertex attribute, not interleaved.
+struct MESH_STREAM
+{
+	uint32_t	semantic;		// MESH_SEMANTIC
+	uint32_t	format;			// MESH_FORMAT
+	uint32_t	stride;
+	uint32_t	reserved;
+	uint64_t	offset;
+	uint64_t	size;
+};
+
+struct MESH_SUBMESH
+{
+	uint32_t	firstIndex;
+	uint32_t	indexCount;
+	int32_t		baseVertex;
+	uint32_t	reserved;
+	MESH_BOUNDS	bounds;
+};
+
+// Mesh held in memory, built by importers and written with WriteMeshFile().
+struct MESH_DATA
+{
+	struct STREAM
+	{
+		MESH_SEMANTIC			semantic;
+		MESH_FORMAT				format;
+		std::vector<uint8_t>	data;
+	};
+
+	uint32_t					vertexCount = 0;
+	MESH_BOUNDS					bounds = {};		// Reference of quantized positions
+	std::vector<STREAM>			streams;
+	std::vector<uint32_t>		indices;
+	std::vector<MESH_SUBMESH>	submeshes;
+};
+
+// Recomputes the bounds of the mesh and of every submesh from the vertices they index.
+// The mesh bounds are kept once the positions are quantized against them.
+void ComputeMeshBounds(MESH_DATA& mesh);
+
+// Position of a vertex in any position format, quantized positions are relative to 'bounds'.
+void DecodeMeshPosition(MESH_FORMAT format, const uint8_t* vertex, const MESH_BOUNDS& bounds, float position[3]);
+
+// Stores 16 bits indices when every vertex can be addressed with them, returns false on I/O errors.
+bool WriteMeshFile(const std::string& path, const MESH_DATA& mesh);
+
+class MESH_FILE;
+
+// Copies the sections of an opened file, e.g. to optimize it at load time.
+// Returns false, with 'mesh' cleared, when an index plus the base vertex of its
+// submesh is outside the vertices.
+bool ReadMeshData(const MESH_FILE& file, MESH_DATA& mesh);
+
+// Maps a .mesh file and validates its tables, the sections point into the mapping.
+class MESH_FILE
+{
+public:
+	// Returns false when the file is missing, truncated or of another version.
+	bool Open(const std::string& path);
+	void Close();
+
+	inline const MESH_HEADER& GetHeader() const { return *_header; }
+	inline const MESH_STREAM& GetStream(uint32_t index) const { return _streams[index]; }
+	inline const MESH_SUBMESH& GetSubmesh(uint32_t index) const { return _submeshes[index]; }
+
+	// Stream of the given semantic, nullptr when the mesh has none.
+	const MESH_STREAM* FindStream(MESH_SEMANTIC semantic) const;
+
+	inline const uint8_t* GetStreamData(const MESH_STREAM& stream) const { return _file.GetData() + stream.offset; }
+	inline const uint8_t* GetIndexData() const { return _file.GetData() + _header->indexOffset; }
+
+	inline const MAPPED_FILE& GetMappedFile() const { return _file; }
+
+private:
+	MAPPED_FILE				_file;
+	const MESH_HEADER*		_header = nullptr;
+	const MESH_STREAM*		_streams = nullptr;
+	const MESH_SUBMESH*		_submeshes = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,542 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+// Triangles of every vertex, compressed rows.
+struct VERTEX_ADJACENCY
+{
+	std::vector<uint32_t>	offsets;	// vertexCount + 1
+	std::vector<uint32_t>	triangles;
+
+	VERTEX_ADJACENCY(const uint32_t* indices, size_t indexCount, size_t vertexCount) :
+		offsets(vertexCount + 1, 0),
+		triangles(indexCount)
+	{
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			offsets[indices[i] + 1]++;
+		}
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			offsets[v + 1] += offsets[v];
+		}
+
+		std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+};
+
+VERTEX_CACHE_STATISTICS AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+	VERTEX_CACHE_STATISTICS statistics;
+
+	// A vertex is in the FIFO while fewer than 'cacheSize' vertices were transformed after it.
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t timestamp = cacheSize + 1;
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		uint32_t vertex = indices[i];
+		if (timestamp - timestamps[vertex] > cacheSize)
+		{
+			timestamps[vertex] = timestamp++;
+			statistics.vertexTransforms++;
+		}
+	}
+
+	size_t referencedCount = 0;
+	for (uint32_t vertexTimestamp : timestamps)
+	{
+		referencedCount += vertexTimestamp > 0 ? 1 : 0;
+	}
+
+	if (indexCount >= 3)
+	{
+		statistics.acmr = static_cast<float>(statistics.vertexTransforms) / (indexCount / 3);
+	}
+	if (referencedCount > 0)
+	{
+		statistics.atvr = static_cast<float>(statistics.vertexTransforms) / referencedCount;
+	}
+	return statistics;
+}
+
+VERTEX_FETCH_STATISTICS AnalyzeVertexFetch(const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexSize)
+{
+	// 16 KiB of 64 bytes lines, FIFO replacement like the vertex cache.
+	const uint64_t lineSize = 64;
+	const uint32_t lineCount = 256;
+
+	VERTEX_FETCH_STATISTICS statistics;
+	if (vertexCount == 0 || vertexSize == 0)
+	{
+		return statistics;
+	}
+
+	std::vector<uint32_t> timestamps((vertexCount * vertexSize + lineSize - 1) / lineSize, 0);
+	uint32_t timestamp = lineCount + 1;
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		const uint64_t begin = indices[i] * vertexSize;
+		const uint64_t end = begin + vertexSize;
+		for (uint64_t line = begin / lineSize; line * lineSize < end; ++line)
+		{
+			if (timestamp - timestamps[line] > lineCount)
+			{
+				timestamps[line] = timestamp++;
+				statistics.bytesFetched += lineSize;
+			}
+		}
+	}
+
+	statistics.overfetch = static_cast<float>(statistics.bytesFetched) / (vertexCount * vertexSize);
+	return statistics;
+}
+
+void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+	assert(destination != indices);
+
+	const size_t triangleCount = indexCount / 3;
+	VERTEX_ADJACENCY adjacency(indices, indexCount, vertexCount);
+
+	std::vector<uint32_t> liveTriangles(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+	}
+
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> deadEnds;
+	std::vector<uint32_t> candidates;
+
+	uint32_t timestamp = cacheSize + 1;
+	size_t cursor = 0;		// Next vertex to try when the dead-end stack is empty
+	size_t outputCount = 0;
+
+	int64_t fanning = vertexCount > 0 ? 0 : -1;
+	while (fanning >= 0)
+	{
+		// Emits every live triangle around the fanning vertex.
+		candidates.clear();
+		const uint32_t vertex = static_cast<uint32_t>(fanning);
+		for (uint32_t a = adjacency.offsets[vertex]; a < adjacency.offsets[vertex + 1]; ++a)
+		{
+			const uint32_t triangle = adjacency.triangles[a];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+
+			for (int corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t v = indices[triangle * 3 + corner];
+				destination[outputCount++] = v;
+				deadEnds.push_back(v);
+				candidates.push_back(v);
+				liveTriangles[v]--;
+
+				if (timestamp - timestamps[v] > cacheSize)
+				{
+					timestamps[v] = timestamp++;
+				}
+			}
+			emitted[triangle] = true;
+		}
+
+		// Next fanning vertex: the candidate which stays the longest in the cache
+		// after its remaining triangles are emitted.
+		int64_t next = -1;
+		int64_t bestPriority = -1;
+		for (uint32_t v : candidates)
+		{
+			if (liveTriangles[v] == 0)
+			{
+				continue;
+			}
+
+			const int64_t age = static_cast<int64_t>(timestamp) - timestamps[v];
+			int64_t priority = 0;
+			if (age + 2 * static_cast<int64_t>(liveTriangles[v]) <= cacheSize)
+			{
+				priority = age;
+			}
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = v;
+			}
+		}
+
+		// Dead end: most recent vertex with live triangles, then the next one in order.
+		while (next < 0 && deadEnds.empty() == false)
+		{
+			uint32_t v = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveTriangles[v] > 0)
+			{
+				next = v;
+			}
+		}
+		while (next < 0 && cursor < vertexCount)
+		{
+			if (liveTriangles[cursor] > 0)
+			{
+				next = static_cast<int64_t>(cursor);
+			}
+			++cursor;
+		}
+
+		fanning = next;
+	}
+
+	assert(outputCount == triangleCount * 3);
+}
+
+void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+	const float* positions, size_t positionStride, size_t vertexCount,
+	float threshold, uint32_t cacheSize)
+{
+	assert(destination != indices);
+
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	auto getPosition = [positions, positionStride](uint32_t vertex, float position[3])
+	{
+		memcpy(position, reinterpret_cast<const uint8_t*>(positions) + vertex * positionStride, 3 * sizeof(float));
+	};
+
+	// Hard boundaries: triangles whose three vertices all miss, the cache restarts there.
+	std::vector<uint32_t> clusters;
+	{
+		std::vector<uint32_t> timestamps(vertexCount, 0);
+		uint32_t timestamp = cacheSize + 1;
+		for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+		{
+			uint32_t misses = 0;
+			for (int corner = 0; corner < 3; ++corner)
+			{
+				uint32_t v = indices[triangle * 3 + corner];
+				if (timestamp - timestamps[v] > cacheSize)
+				{
+					timestamps[v] = timestamp++;
+					misses++;
+				}
+			}
+
+			if (triangle == 0 || misses == 3)
+			{
+				clusters.push_back(static_cast<uint32_t>(triangle));
+			}
+		}
+	}
+
+	// Soft boundaries: splits a cluster where restarting the cache costs less than the threshold.
+	const float inputAcmr = AnalyzeVertexCache(indices, indexCount, vertexCount, cacheSize).acmr;
+	std::vector<uint32_t> softClusters;
+	{
+		std::vector<uint32_t> timestamps(vertexCount, 0);
+		uint32_t timestamp = cacheSize + 1;
+		for (size_t c = 0; c < clusters.size(); ++c)
+		{
+			const size_t begin = clusters[c];
+			const size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+			size_t start = begin;
+			uint32_t misses = 0;
+			timestamp += cacheSize + 1;		// Flushes the simulated cache
+			softClusters.push_back(static_cast<uint32_t>(begin));
+
+			for (size_t triangle = begin; triangle < end; ++triangle)
+			{
+				for (int corner = 0; corner < 3; ++corner)
+				{
+					uint32_t v = indices[triangle * 3 + corner];
+					if (timestamp - timestamps[v] > cacheSize)
+					{
+						timestamps[v] = timestamp++;
+						misses++;
+					}
+				}
+
+				const float acmr = static_cast<float>(misses) / (triangle + 1 - start);
+				if (triangle + 1 < end && acmr <= inputAcmr * threshold)
+				{
+					softClusters.push_back(static_cast<uint32_t>(triangle + 1));
+					start = triangle + 1;
+					misses = 0;
+					timestamp += cacheSize + 1;
+				}
+			}
+		}
+	}
+	clusters.swap(softClusters);
+
+	// Mesh centroid, then per cluster area weighted centroid and normal.
+	float meshCentroid[3] = {};
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		float position[3];
+		getPosition(indices[i], position);
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			meshCentroid[axis] += position[axis] / indexCount;
+		}
+	}
+
+	std::vector<std::pair<float, uint32_t>> sortKeys(clusters.size());
+	for (size_t c = 0; c < clusters.size(); ++c)
+	{
+		const size_t begin = clusters[c];
+		const size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+		float centroid[3] = {};
+		float normal[3] = {};
+		float area = 0.0f;
+		for (size_t triangle = begin; triangle < end; ++triangle)
+		{
+			float p0[3], p1[3], p2[3];
+			getPosition(indices[triangle * 3 + 0], p0);
+			getPosition(indices[triangle * 3 + 1], p1);
+			getPosition(indices[triangle * 3 + 2], p2);
+
+			const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			const float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			const float triangleArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				centroid[axis] += (p0[axis] + p1[axis] + p2[axis]) / 3.0f * triangleArea;
+				normal[axis] += n[axis];
+			}
+			area += triangleArea;
+		}
+
+		float key = 0.0f;
+		if (area > 0.0f)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				key += (centroid[axis] / area - meshCentroid[axis]) * normal[axis];
+			}
+			float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			key = normalLength > 0.0f ? key / normalLength : 0.0f;
+		}
+		sortKeys[c] = std::make_pair(key, static_cast<uint32_t>(c));
+	}
+
+	// Outward facing clusters first, they likely occlude the others. Stable for equal keys.
+	std::stable_sort(sortKeys.begin(), sortKeys.end(), [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) { return a.first > b.first; });
+
+	size_t outputCount = 0;
+	for (const std::pair<float, uint32_t>& sortKey : sortKeys)
+	{
+		const size_t c = sortKey.second;
+		const size_t begin = clusters[c];
+		const size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+		memcpy(destination + outputCount, indices + begin * 3, (end - begin) * 3 * sizeof(uint32_t));
+		outputCount += (end - begin) * 3;
+	}
+}
+
+uint32_t OptimizeVertexFetchRemap(uint32_t* remap, const uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+	std::fill(remap, remap + vertexCount, g_unusedVertex);
+
+	uint32_t nextVertex = 0;
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		if (remap[indices[i]] == g_unusedVertex)
+		{
+			remap[indices[i]] = nextVertex++;
+		}
+	}
+	return nextVertex;
+}
+
+uint32_t GenerateDuplicateRemap(std::vector<uint32_t>& remap, const MESH_DATA& mesh)
+{
+	const uint32_t vertexCount = mesh.vertexCount;
+	remap.assign(vertexCount, g_unusedVertex);
+
+	std::vector<uint32_t> strides;
+	for (const MESH_DATA::STREAM& stream : mesh.streams)
+	{
+		strides.push_back(GetMeshFormatSize(stream.format));
+	}
+
+	auto hashVertex = [&](uint32_t vertex)
+	{
+		// FNV-1a over the bytes of every stream.
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t s = 0; s < mesh.streams.size(); ++s)
+		{
+			const uint8_t* bytes = &mesh.streams[s].data[vertex * strides[s]];
+			for (uint32_t b = 0; b < strides[s]; ++b)
+			{
+				hash = (hash ^ bytes[b]) * 1099511628211ull;
+			}
+		}
+		return hash;
+	};
+
+	auto isEqual = [&](uint32_t a, uint32_t b)
+	{
+		for (size_t s = 0; s < mesh.streams.size(); ++s)
+		{
+			if (memcmp(&mesh.streams[s].data[a * strides[s]], &mesh.streams[s].data[b * strides[s]], strides[s]) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// Open addressing table of first occurrences, at most half full.
+	size_t bucketCount = 1;
+	while (bucketCount < vertexCount * 2)
+	{
+		bucketCount *= 2;
+	}
+	std::vector<uint32_t> buckets(bucketCount, g_unusedVertex);
+
+	uint32_t uniqueCount = 0;
+	for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		size_t bucket = static_cast<size_t>(hashVertex(vertex)) & (bucketCount - 1);
+		while (buckets[bucket] != g_unusedVertex && isEqual(buckets[bucket], vertex) == false)
+		{
+			bucket = (bucket + 1) & (bucketCount - 1);
+		}
+
+		if (buckets[bucket] == g_unusedVertex)
+		{
+			buckets[bucket] = vertex;
+			remap[vertex] = uniqueCount++;
+		}
+		else
+		{
+			remap[vertex] = remap[buckets[bucket]];
+		}
+	}
+
+	return uniqueCount;
+}
+
+void RemapMesh(MESH_DATA& mesh, const std::vector<uint32_t>& remap, uint32_t newVertexCount)
+{
+	for (MESH_DATA::STREAM& stream : mesh.streams)
+	{
+		const uint32_t stride = GetMeshFormatSize(stream.format);
+		std::vector<uint8_t> data(static_cast<size_t>(newVertexCount) * stride);
+		for (uint32_t vertex = 0; vertex < mesh.vertexCount; ++vertex)
+		{
+			if (remap[vertex] != g_unusedVertex)
+			{
+				memcpy(&data[remap[vertex] * stride], &stream.data[vertex * stride], stride);
+			}
+		}
+		stream.data.swap(data);
+	}
+
+	for (uint32_t& index : mesh.indices)
+	{
+		index = remap[index];
+	}
+	mesh.vertexCount = newVertexCount;
+}
+
+void OptimizeMesh(MESH_DATA& mesh, float overdrawThreshold)
+{
+	// Indices become absolute, vertices are shared between submeshes after deduplication.
+	for (MESH_SUBMESH& submesh : mesh.submeshes)
+	{
+		for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; ++i)
+		{
+			mesh.indices[i] += submesh.baseVertex;
+		}
+		submesh.baseVertex = 0;
+	}
+
+	std::vector<uint32_t> remap;
+	uint32_t uniqueCount = GenerateDuplicateRemap(remap, mesh);
+	RemapMesh(mesh, remap, uniqueCount);
+
+	const MESH_DATA::STREAM* positionStream = nullptr;
+	for (const MESH_DATA::STREAM& stream : mesh.streams)
+	{
+		if (stream.semantic == MESH_SEMANTIC_POSITION && (stream.format == MESH_FORMAT_FLOAT3 || stream.format == MESH_FORMAT_FLOAT4 || stream.format == MESH_FORMAT_SNORM16X4))
+		{
+			positionStream = &stream;
+		}
+	}
+
+	// Triangles are reordered inside their submesh, on local vertex numbers.
+	std::vector<uint32_t> localToGlobal;
+	std::vector<uint32_t> globalToLocal(mesh.vertexCount, g_unusedVertex);
+	std::vector<uint32_t> localIndices;
+	std::vector<uint32_t> cacheOptimized;
+	std::vector<float> localPositions;
+	for (const MESH_SUBMESH& submesh : mesh.submeshes)
+	{
+		uint32_t* indices = mesh.indices.data() + submesh.firstIndex;
+		const size_t indexCount = submesh.indexCount / 3 * 3;
+
+		localToGlobal.clear();
+		localIndices.resize(indexCount);
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			if (globalToLocal[indices[i]] == g_unusedVertex)
+			{
+				globalToLocal[indices[i]] = static_cast<uint32_t>(localToGlobal.size());
+				localToGlobal.push_back(indices[i]);
+			}
+			localIndices[i] = globalToLocal[indices[i]];
+		}
+
+		cacheOptimized.resize(indexCount);
+		OptimizeVertexCache(cacheOptimized.data(), localIndices.data(), indexCount, localToGlobal.size());
+
+		if (positionStream)
+		{
+			const uint32_t stride = GetMeshFormatSize(positionStream->format);
+			localPositions.resize(localToGlobal.size() * 3);
+			for (size_t v = 0; v < localToGlobal.size(); ++v)
+			{
+				DecodeMeshPosition(positionStream->format, &positionStream->data[localToGlobal[v] * stride], mesh.bounds, &localPositions[v * 3]);
+			}
+			OptimizeOverdraw(localIndices.data(), cacheOptimized.data(), indexCount, localPositions.data(), 3 * sizeof(float), localToGlobal.size(), overdrawThreshold);
+		}
+		else
+		{
+			localIndices.swap(cacheOptimized);
+		}
+
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			indices[i] = localToGlobal[localIndices[i]];
+		}
+		for (uint32_t global : localToGlobal)
+		{
+			globalToLocal[global] = g_unusedVertex;
+		}
+	}
+
+	// Vertices in the order the optimized index buffer reads them.
+	remap.resize(mesh.vertexCount);
+	uint32_t usedCount = OptimizeVertexFetchRemap(remap.data(), mesh.indices.data(), mesh.indices.size(), mesh.vertexCount);
+	RemapMesh(mesh, remap, usedCount);
+
+	ComputeMeshBounds(mesh);
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "MeshFile.h"
+
+#include <cstdint>
+#include <vector>
+
+// Post-transform cache size the optimizations and statistics assume, close to
+// what current GPUs reuse between neighbouring triangles.
+const uint32_t g_vertexCacheSize = 16;
+
+// Vertex remap entry of a vertex no triangle references.
+const uint32_t g_unusedVertex = UINT32_MAX;
+
+struct VERTEX_CACHE_STATISTICS
+{
+	uint32_t	vertexTransforms = 0;	// Cache misses
+	float		acmr = 0.0f;			// Average cache miss ratio, transforms per triangle (0.5 at best, 3 at worst)
+	float		atvr = 0.0f;			// Average transform to vertex ratio, 1 at best
+};
+
+struct VERTEX_FETCH_STATISTICS
+{
+	uint64_t	bytesFetched = 0;		// 64 bytes lines read from the vertex buffer
+	float		overfetch = 0.0f;		// Bytes fetched per byte of vertex buffer, 1 at best
+};
+
+// FIFO cache simulation of the index buffer, runs on the CPU.
+VERTEX_CACHE_STATISTICS AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = g_vertexCacheSize);
+
+// Memory cache simulation of the vertex fetches, 'vertexSize' is the sum of the stream strides.
+VERTEX_FETCH_STATISTICS AnalyzeVertexFetch(const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexSize);
+
+// Tipsify (Sander et al. 2007): reorders the triangles for the post-transform
+// cache in linear time. 'destination' may not alias 'indices'.
+void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = g_vertexCacheSize);
+
+// Reorders clusters of an index buffer optimized by OptimizeVertexCache() so
+// outward facing clusters are drawn first. Clusters are split as long as the
+// ACMR stays within 'threshold' of the input one. 'positions' holds 3 floats
+// per vertex, 'positionStride' bytes apart.
+void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+	const float* positions, size_t positionStride, size_t vertexCount,
+	float threshold = 1.05f, uint32_t cacheSize = g_vertexCacheSize);
+
+// Numbers the vertices in the order the index buffer first references them.
+// Returns the referenced vertex count, 'remap' gets g_unusedVertex for the others.
+uint32_t OptimizeVertexFetchRemap(uint32_t* remap, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+// Maps every vertex to the first vertex with the same bytes in every stream.
+// Returns the unique vertex count, 'remap' is compacted in first occurrence order.
+uint32_t GenerateDuplicateRemap(std::vector<uint32_t>& remap, const MESH_DATA& mesh);
+
+// Applies a vertex remap to the streams and indices of a mesh, several vertices
+// may map to the same one. Indices must be absolute (base vertex 0).
+void RemapMesh(MESH_DATA& mesh, const std::vector<uint32_t>& remap, uint32_t newVertexCount);
+
+// Full pipeline: deduplication, per submesh cache and overdraw ordering,
+// then vertex fetch remapping. Submeshes end up with a base vertex of 0.
+// Run offline by mesh-converter, the tutorial streams the mapped .mesh as written.
+void OptimizeMesh(MESH_DATA& mesh, float overdrawThreshold = 1.05f);
\ No newline at end of file
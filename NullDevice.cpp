@@ -0,0 +1,268 @@
+#include "NullDevice.h"
+
+#include <cassert>
+
+void NULL_COMMAND_LIST::TransitionResource(const void* resource, uint32_t subresourceCount, uint32_t state, uint32_t subresource)
+{
+	assert(_closed == false && "Recording into a closed command list.");
+	_stateTracker->TransitionResource(resource, subresourceCount, state, subresource);
+}
+
+void NULL_COMMAND_LIST::UAVBarrier(const void* resource)
+{
+	assert(_closed == false && "Recording into a closed command list.");
+	_stateTracker->UAVBarrier(resource);
+}
+
+void NULL_COMMAND_LIST::FlushBarriers()
+{
+	if (_stateTracker->HasBarriers())
+	{
+		std::vector<RESOURCE_STATE_TRACKER::BARRIER> barriers;
+		_stateTracker->FlushBarriers(barriers);
+		RecordBarriers(barriers);
+	}
+}
+
+void NULL_COMMAND_LIST::Record(std::function<void()> work)
+{
+	assert(_closed == false && "Recording into a closed command list.");
+	FlushBarriers();
+	_allocator->_commands.push_back(NULL_COMMAND_ALLOCATOR::COMMAND{ 0, std::move(work) });
+}
+
+void NULL_COMMAND_LIST::RecordBarriers(const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& barriers)
+{
+	if (barriers.empty() == false)
+	{
+		_allocator->_commands.push_back(NULL_COMMAND_ALLOCATOR::COMMAND{ barriers.size(), nullptr });
+		_recordedBarriers.insert(_recordedBarriers.end(), barriers.begin(), barriers.end());
+	}
+}
+
+NULL_DEVICE::NULL_DEVICE(std::chrono::microseconds gpuTimePerList)
+{
+	SetGpuTimePerList(gpuTimePerList);
+}
+
+void NULL_DEVICE::RegisterResourceState(const void* resource, uint32_t state, uint32_t subresourceCount, bool decaysToCommon)
+{
+	_globalStates.Add(resource, state, subresourceCount, decaysToCommon);
+}
+
+void NULL_DEVICE::UnregisterResourceState(const void* resource)
+{
+	_globalStates.Remove(resource);
+}
+
+NULL_QUEUE_DEVICE::NULL_QUEUE_DEVICE(NULL_DEVICE* device, NULL_COMMAND_LIST_TYPE type) :
+	_device(device),
+	_type(type)
+{
+	_thread = std::thread(&NULL_QUEUE_DEVICE::ThreadMain, this);
+}
+
+NULL_QUEUE_DEVICE::~NULL_QUEUE_DEVICE()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_condition.notify_one();
+	_thread.join();
+}
+
+NULL_QUEUE_DEVICE::ALLOCATOR NULL_QUEUE_DEVICE::CreateCommandAllocator()
+{
+	return std::make_shared<NULL_COMMAND_ALLOCATOR>();
+}
+
+void NULL_QUEUE_DEVICE::ResetCommandAllocator(const ALLOCATOR& allocator)
+{
+	allocator->_commands.clear();
+	allocator->_resetCount++;
+}
+
+NULL_QUEUE_DEVICE::LIST NULL_QUEUE_DEVICE::CreateCommandList(const ALLOCATOR& allocator)
+{
+	LIST commandList = std::make_shared<NULL_COMMAND_LIST>();
+	commandList->_allocator = allocator;
+	commandList->_firstCommand = allocator->_commands.size();
+
+	return commandList;
+}
+
+void NULL_QUEUE_DEVICE::ResetCommandList(const LIST& commandList, const ALLOCATOR& allocator)
+{
+	assert(commandList->_closed && "Resetting a command list which is still recording.");
+
+	commandList->_allocator = allocator;
+	commandList->_firstCommand = allocator->_commands.size();
+	commandList->_recordedBarriers.clear();
+	commandList->_closed = false;
+}
+
+void NULL_QUEUE_DEVICE::CloseCommandList(const LIST& commandList)
+{
+	commandList->_closed = true;
+}
+
+void NULL_QUEUE_DEVICE::SetListContext(const LIST& commandList, const ALLOCATOR& allocator, void* pool)
+{
+	assert(commandList->_allocator == allocator);
+	(void)allocator;
+	commandList->_pool = pool;
+}
+
+void NULL_QUEUE_DEVICE::GetListContext(const LIST& commandList, ALLOCATOR& allocator, void*& pool) const
+{
+	allocator = commandList->_allocator;
+	pool = commandList->_pool;
+}
+
+void NULL_QUEUE_DEVICE::SetStateTracker(const LIST& commandList, RESOURCE_STATE_TRACKER* tracker)
+{
+	commandList->_stateTracker = tracker;
+}
+
+RESOURCE_STATE_TRACKER* NULL_QUEUE_DEVICE::GetStateTracker(const LIST& commandList) const
+{
+	return commandList->_stateTracker;
+}
+
+void NULL_QUEUE_DEVICE::FlushBarriers(const LIST& commandList)
+{
+	commandList->FlushBarriers();
+}
+
+void NULL_QUEUE_DEVICE::RecordBarriers(const LIST& commandList, const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& barriers)
+{
+	commandList->RecordBarriers(barriers);
+}
+
+void NULL_QUEUE_DEVICE::ExecuteCommandLists(const LIST* commandLists, size_t count)
+{
+	OPERATION operation;
+	operation.commandLists.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const LIST& commandList = commandLists[i];
+		assert(commandList->_closed && "Executing a command list which is still recording.");
+
+		const ALLOCATOR& allocator = commandList->_allocator;
+		operation.commandLists.push_back(SUBMITTED_LIST{ allocator, commandList->_firstCommand, allocator->_commands.size() - commandList->_firstCommand });
+	}
+
+	Push(std::move(operation));
+}
+
+void NULL_QUEUE_DEVICE::Signal(uint64_t value)
+{
+	OPERATION operation;
+	operation.signalValue = value;
+	Push(std::move(operation));
+}
+
+void NULL_QUEUE_DEVICE::Wait(NULL_QUEUE_DEVICE& other, uint64_t value)
+{
+	OPERATION operation;
+	operation.waitFence = &other._fence;
+	operation.waitValue = value;
+	Push(std::move(operation));
+}
+
+uint64_t NULL_QUEUE_DEVICE::GetCompletedValue() const
+{
+	return _fence.GetCompletedValue();
+}
+
+void NULL_QUEUE_DEVICE::WaitForValue(uint64_t value, std::chrono::milliseconds duration)
+{
+	_fence.Wait(value, duration);
+}
+
+NULL_QUEUE_DEVICE::STATISTICS NULL_QUEUE_DEVICE::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _statistics;
+}
+
+void NULL_QUEUE_DEVICE::Push(OPERATION operation)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_operations.push_back(std::move(operation));
+	}
+	_condition.notify_one();
+}
+
+void NULL_QUEUE_DEVICE::Execute(const SUBMITTED_LIST& commandList)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	size_t barrierCount = 0;
+	for (size_t i = 0; i < commandList.commandCount; ++i)
+	{
+		const NULL_COMMAND_ALLOCATOR::COMMAND& command = commandList.allocator->_commands[commandList.firstCommand + i];
+		barrierCount += command.barrierCount;
+		if (command.work)
+		{
+			command.work();
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_statistics.executedLists++;
+		_statistics.executedBarriers += barrierCount;
+	}
+
+	std::this_thread::sleep_until(start + _device->GetGpuTimePerList());
+}
+
+void NULL_QUEUE_DEVICE::ThreadMain()
+{
+	for (;;)
+	{
+		OPERATION operation;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [this]() { return _stop || _operations.empty() == false; });
+			if (_operations.empty())
+			{
+				return;
+			}
+			operation = std::move(_operations.front());
+			_operations.pop_front();
+		}
+
+		if (operation.waitFence)
+		{
+			operation.waitFence->Wait(operation.waitValue, std::chrono::milliseconds::max());
+
+			std::lock_guard<std::mutex> lock(_mutex);
+			_statistics.waits++;
+		}
+
+		if (operation.commandLists.empty() == false)
+		{
+			for (const SUBMITTED_LIST& commandList : operation.commandLists)
+			{
+				Execute(commandList);
+			}
+
+			std::lock_guard<std::mutex> lock(_mutex);
+			_statistics.executeCalls++;
+		}
+
+		if (operation.signalValue != 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_statistics.signals++;
+			}
+			_fence.Signal(operation.signalValue);
+			_completionFence.Signal(operation.signalValue);
+		}
+	}
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "FenceCompletionService.h"
+#include "ResourceStateTracker.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Device of PLATFORM_NULL: command lists record what they would encode and the
+// queues replay them in order on a thread standing in for the GPU, so the
+// submission, synchronization and frame pacing code runs without a GPU.
+
+// Same values as D3D12_COMMAND_LIST_TYPE.
+enum NULL_COMMAND_LIST_TYPE
+{
+	NULL_COMMAND_LIST_TYPE_DIRECT = 0,
+	NULL_COMMAND_LIST_TYPE_COMPUTE = 2,
+	NULL_COMMAND_LIST_TYPE_COPY = 3
+};
+
+// Same layout as D3D12_DRAW_INDEXED_ARGUMENTS, the indirect arguments are packed on every platform.
+struct NULL_DRAW_INDEXED_ARGUMENTS
+{
+	uint32_t	IndexCountPerInstance;
+	uint32_t	InstanceCount;
+	uint32_t	StartIndexLocation;
+	int32_t		BaseVertexLocation;
+	uint32_t	StartInstanceLocation;
+};
+
+// Holds the commands of the lists recorded into it, like a D3D12 allocator, so a list
+// can be reset and recorded again as soon as it is submitted.
+class NULL_COMMAND_ALLOCATOR
+{
+public:
+	inline uint64_t GetResetCount() const { return _resetCount; }
+
+private:
+	friend class NULL_COMMAND_LIST;
+	friend class NULL_QUEUE_DEVICE;
+
+	struct COMMAND
+	{
+		size_t					barrierCount;	// Barriers flushed before the work
+		std::function<void()>	work;
+	};
+
+	std::vector<COMMAND>	_commands;
+	uint64_t				_resetCount = 0;
+};
+
+class NULL_COMMAND_LIST
+{
+public:
+	// Batched and merged until FlushBarriers(), like TransitionResource() on D3D12 lists.
+	// Resources must be registered on the NULL_DEVICE to be transitioned.
+	void TransitionResource(const void* resource, uint32_t subresourceCount, uint32_t state, uint32_t subresource = RESOURCE_STATE::ALL_SUBRESOURCES);
+	void UAVBarrier(const void* resource);
+	void FlushBarriers();
+
+	// Stands in for a draw, dispatch or copy, 'work' runs on the queue thread when the list
+	// executes. The batched barriers are flushed before it.
+	void Record(std::function<void()> work);
+
+	// Every barrier recorded since the last reset, fix-up lists included.
+	inline const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& GetRecordedBarriers() const { return _recordedBarriers; }
+	inline bool IsClosed() const { return _closed; }
+
+private:
+	friend class NULL_QUEUE_DEVICE;
+
+	void RecordBarriers(const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& barriers);
+
+	std::shared_ptr<NULL_COMMAND_ALLOCATOR>		_allocator;
+	size_t										_firstCommand = 0;		// Commands of this list in the allocator
+	void*										_pool = nullptr;		// Context of the recording thread pool
+	RESOURCE_STATE_TRACKER*						_stateTracker = nullptr;
+	std::vector<RESOURCE_STATE_TRACKER::BARRIER>	_recordedBarriers;
+	bool										_closed = false;
+};
+
+// Shared by the queues of a device, holds the resource states and the simulated GPU speed.
+class NULL_DEVICE
+{
+public:
+	// Each executed list keeps its queue busy for at least 'gpuTimePerList'.
+	explicit NULL_DEVICE(std::chrono::microseconds gpuTimePerList = std::chrono::microseconds(0));
+
+	// Resources are opaque keys, buffers and simultaneous access textures decay to COMMON.
+	void RegisterResourceState(const void* resource, uint32_t state, uint32_t subresourceCount = 1, bool decaysToCommon = false);
+	void UnregisterResourceState(const void* resource);
+	inline GLOBAL_RESOURCE_STATES& GetGlobalResourceStates() { return _globalStates; }
+
+	// Applies to the lists executed from now on.
+	inline void SetGpuTimePerList(std::chrono::microseconds gpuTimePerList) { _gpuTimePerList.store(gpuTimePerList.count(), std::memory_order_relaxed); }
+	inline std::chrono::microseconds GetGpuTimePerList() const { return std::chrono::microseconds(_gpuTimePerList.load(std::memory_order_relaxed)); }
+
+private:
+	GLOBAL_RESOURCE_STATES	_globalStates;
+	std::atomic<int64_t>	_gpuTimePerList{ 0 };
+};
+
+// One queue of a NULL_DEVICE, the DEVICE of BASIC_COMMAND_QUEUE.
+class NULL_QUEUE_DEVICE
+{
+public:
+	typedef std::shared_ptr<NULL_COMMAND_ALLOCATOR> ALLOCATOR;
+	typedef std::shared_ptr<NULL_COMMAND_LIST> LIST;
+
+	struct STATISTICS
+	{
+		uint64_t	executeCalls = 0;		// Batches submitted with ExecuteCommandLists()
+		uint64_t	executedLists = 0;
+		uint64_t	executedBarriers = 0;
+		uint64_t	signals = 0;
+		uint64_t	waits = 0;				// GPU side waits on another queue
+	};
+
+	NULL_QUEUE_DEVICE(NULL_DEVICE* device, NULL_COMMAND_LIST_TYPE type);
+	~NULL_QUEUE_DEVICE();
+
+	ALLOCATOR CreateCommandAllocator();
+	void ResetCommandAllocator(const ALLOCATOR& allocator);
+	LIST CreateCommandList(const ALLOCATOR& allocator);
+	void ResetCommandList(const LIST& commandList, const ALLOCATOR& allocator);
+	void CloseCommandList(const LIST& commandList);
+
+	void SetListContext(const LIST& commandList, const ALLOCATOR& allocator, void* pool);
+	void GetListContext(const LIST& commandList, ALLOCATOR& allocator, void*& pool) const;
+
+	void SetStateTracker(const LIST& commandList, RESOURCE_STATE_TRACKER* tracker);
+	RESOURCE_STATE_TRACKER* GetStateTracker(const LIST& commandList) const;
+	void FlushBarriers(const LIST& commandList);
+	void RecordBarriers(const LIST& commandList, const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& barriers);
+
+	inline GLOBAL_RESOURCE_STATES& GetGlobalStates() { return _device->GetGlobalResourceStates(); }
+	inline bool DecaysAllStates() const { return _type == NULL_COMMAND_LIST_TYPE_COPY; }
+
+	void ExecuteCommandLists(const LIST* commandLists, size_t count);
+	void Signal(uint64_t value);
+	void Wait(NULL_QUEUE_DEVICE& other, uint64_t value);
+
+	uint64_t GetCompletedValue() const;
+	void WaitForValue(uint64_t value, std::chrono::milliseconds duration);
+	inline FENCE& GetFence() { return _fence; }
+	inline FENCE& GetCompletionFence() { return _completionFence; }
+
+	inline NULL_COMMAND_LIST_TYPE GetType() const { return _type; }
+	STATISTICS GetStatistics() const;
+
+private:
+	// Commands of a list at the time it was submitted, the allocator is not reset before they ran.
+	struct SUBMITTED_LIST
+	{
+		ALLOCATOR	allocator;
+		size_t		firstCommand;
+		size_t		commandCount;
+	};
+
+	// Operations run in submission order on the queue thread.
+	struct OPERATION
+	{
+		std::vector<SUBMITTED_LIST>	commandLists;
+		SOFTWARE_FENCE*		waitFence = nullptr;	// Waited on until it reaches 'waitValue'
+		uint64_t			waitValue = 0;
+		uint64_t			signalValue = 0;		// Signaled when not zero
+	};
+
+	void Push(OPERATION operation);
+	void Execute(const SUBMITTED_LIST& commandList);
+	void ThreadMain();
+
+	NULL_DEVICE*			_device = nullptr;
+	NULL_COMMAND_LIST_TYPE	_type;
+
+	SOFTWARE_FENCE	_fence;
+	SOFTWARE_FENCE	_completionFence;	// Interrupted by the completion service only
+
+	mutable std::mutex			_mutex;
+	std::condition_variable		_condition;
+	std::deque<OPERATION>		_operations;
+	STATISTICS					_statistics;
+	bool						_stop = false;
+
+	std::thread	_thread;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// Platform COMMAND_QUEUE, APPLICATION and WINDOW are built for, chosen at compile time:
+// PLATFORM_D3D12 on Windows, a Win32 window presenting through a D3D12 device.
+// PLATFORM_NULL elsewhere or when PLATFORM_NULL is defined, a headless window and a
+// null device recording the command lists, so the frame loop runs without a GPU.
+#if defined(_WIN32) && !defined(PLATFORM_NULL)
+#define PLATFORM_D3D12 1
+#define PLATFORM_NULL 0
+#else
+#undef PLATFORM_NULL
+#define PLATFORM_NULL 1
+#define PLATFORM_D3D12 0
+#endif
+
+// The number of swap chain back buffers.
+const uint8_t g_numFrames = 3;
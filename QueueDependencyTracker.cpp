@@ -0,0 +1,109 @@
+#include "QueueDependencyTracker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+const size_t QUEUE_DEPENDENCY_TRACKER::MAX_SIGNALS_PER_QUEUE;
+
+uint32_t QUEUE_DEPENDENCY_TRACKER::AddQueue()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// A removed slot was reset by RemoveQueue().
+	if (_freeQueues.empty() == false)
+	{
+		uint32_t queueIndex = _freeQueues.back();
+		_freeQueues.pop_back();
+		return queueIndex;
+	}
+
+	_queues.emplace_back();
+	for (QUEUE& queue : _queues)
+	{
+		queue.known.resize(_queues.size(), 0);
+	}
+
+	return static_cast<uint32_t>(_queues.size() - 1);
+}
+
+void QUEUE_DEPENDENCY_TRACKER::RemoveQueue(uint32_t queueIndex)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	assert(queueIndex < _queues.size());
+	assert(std::find(_freeQueues.begin(), _freeQueues.end(), queueIndex) == _freeQueues.end() && "Queue removed twice.");
+
+	QUEUE& removed = _queues[queueIndex];
+	std::fill(removed.known.begin(), removed.known.end(), 0);
+	removed.signals.clear();
+
+	// Values of the removed timeline would cover the waits of the next queue in the slot.
+	for (QUEUE& queue : _queues)
+	{
+		queue.known[queueIndex] = 0;
+		for (SIGNAL& signal : queue.signals)
+		{
+			signal.known[queueIndex] = 0;
+		}
+	}
+
+	_freeQueues.push_back(queueIndex);
+}
+
+bool QUEUE_DEPENDENCY_TRACKER::AddWait(uint32_t waitingQueue, uint32_t signalingQueue, uint64_t fenceValue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	assert(waitingQueue < _queues.size() && signalingQueue < _queues.size());
+
+	// Work on a single queue is already ordered.
+	if (waitingQueue == signalingQueue)
+	{
+		return false;
+	}
+
+	QUEUE& waiting = _queues[waitingQueue];
+	if (waiting.known[signalingQueue] >= fenceValue)
+	{
+		return false;
+	}
+	waiting.known[signalingQueue] = fenceValue;
+
+	// Inherit what the signaling queue knew at its latest signal covered by the wait.
+	const std::deque<SIGNAL>& signals = _queues[signalingQueue].signals;
+	auto it = std::upper_bound(signals.begin(), signals.end(), fenceValue,
+		[](uint64_t value, const SIGNAL& signal) { return value < signal.fenceValue; });
+	if (it != signals.begin())
+	{
+		const SIGNAL& signal = *std::prev(it);
+		for (size_t queue = 0; queue < signal.known.size(); ++queue)
+		{
+			waiting.known[queue] = std::max(waiting.known[queue], signal.known[queue]);
+		}
+	}
+
+	return true;
+}
+
+void QUEUE_DEPENDENCY_TRACKER::AddSignal(uint32_t queueIndex, uint64_t fenceValue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	assert(queueIndex < _queues.size());
+
+	QUEUE& queue = _queues[queueIndex];
+	assert((queue.signals.empty() || queue.signals.back().fenceValue < fenceValue) && "Signals must increase.");
+
+	queue.known[queueIndex] = fenceValue;
+	queue.signals.push_back(SIGNAL{ fenceValue, queue.known });
+	if (queue.signals.size() > MAX_SIGNALS_PER_QUEUE)
+	{
+		queue.signals.pop_front();
+	}
+}
+
+uint64_t QUEUE_DEPENDENCY_TRACKER::GetKnownValue(uint32_t waitingQueue, uint32_t signalingQueue) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	assert(waitingQueue < _queues.size() && signalingQueue < _queues.size());
+
+	return _queues[waitingQueue].known[signalingQueue];
+}
\ No newline at end of file
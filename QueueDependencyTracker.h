@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Tracks what each queue timeline is known to have waited on, so GPU side
+// waits between queues are only emitted when they add a dependency.
+// A queue that waited on B reaching 5 and then signaled 10 carries that
+// knowledge: waiting on it reaching 10 also covers B reaching 5.
+// Waits and signals of a queue must be added in submission order.
+class QUEUE_DEPENDENCY_TRACKER
+{
+public:
+	// Signals remembered per queue, dropping old ones only loses transitive knowledge,
+	// some waits are then emitted again.
+	static const size_t MAX_SIGNALS_PER_QUEUE = 64;
+
+	// Slots of removed queues are reused.
+	uint32_t AddQueue();
+	// Forgets the queue and what the other queues knew about it, a queue reusing
+	// the slot starts its own timeline.
+	void RemoveQueue(uint32_t queue);
+
+	// Returns false when 'waitingQueue' already waited, directly or through another
+	// queue, on 'signalingQueue' reaching 'fenceValue'. The wait must then be skipped.
+	bool AddWait(uint32_t waitingQueue, uint32_t signalingQueue, uint64_t fenceValue);
+	void AddSignal(uint32_t queue, uint64_t fenceValue);
+
+	// Highest value of 'signalingQueue' the work submitted next on 'waitingQueue' is ordered after.
+	uint64_t GetKnownValue(uint32_t waitingQueue, uint32_t signalingQueue) const;
+
+private:
+	// Knowledge of a queue when it signaled a value.
+	struct SIGNAL
+	{
+		uint64_t				fenceValue;
+		std::vector<uint64_t>	known;
+	};
+
+	struct QUEUE
+	{
+		std::vector<uint64_t>	known;		// Indexed by queue
+		std::deque<SIGNAL>		signals;	// Increasing values, the oldest are dropped
+	};
+
+	mutable std::mutex		_mutex;
+	std::vector<QUEUE>		_queues;
+	std::vector<uint32_t>	_freeQueues;
+};
\ No newline at end of file
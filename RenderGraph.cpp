@@ -0,0 +1,410 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <queue>
+
+const RENDER_GRAPH::RESOURCE_HANDLE RENDER_GRAPH::INVALID_RESOURCE = UINT32_MAX;
+const uint32_t RENDER_GRAPH::INVALID_INDEX = UINT32_MAX;
+const uint32_t RENDER_GRAPH::UNKNOWN_STATE = UINT32_MAX;
+
+// D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+static const uint32_t STATE_UNORDERED_ACCESS = 0x8;
+
+static inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+void RENDER_GRAPH::Reset()
+{
+	_resources.clear();
+	_passes.clear();
+	_executionOrder.clear();
+	_statistics = STATISTICS();
+}
+
+RENDER_GRAPH::RESOURCE_HANDLE RENDER_GRAPH::CreateTransient(const std::string& name, uint64_t size, uint64_t alignment)
+{
+	RESOURCE resource;
+	resource.name = name;
+	resource.size = size;
+	resource.alignment = std::max<uint64_t>(alignment, 1);
+	_resources.push_back(resource);
+
+	return static_cast<RESOURCE_HANDLE>(_resources.size() - 1);
+}
+
+RENDER_GRAPH::RESOURCE_HANDLE RENDER_GRAPH::ImportResource(const std::string& name, const void* external, uint32_t initialState, uint32_t finalState)
+{
+	RESOURCE resource;
+	resource.name = name;
+	resource.imported = true;
+	resource.external = external;
+	resource.initialState = initialState;
+	resource.finalState = finalState;
+	_resources.push_back(resource);
+
+	return static_cast<RESOURCE_HANDLE>(_resources.size() - 1);
+}
+
+RENDER_GRAPH::PASS_HANDLE RENDER_GRAPH::AddPass(const std::string& name, EXECUTE_CALLBACK execute)
+{
+	PASS pass;
+	pass.name = name;
+	pass.execute = std::move(execute);
+	_passes.push_back(std::move(pass));
+
+	return static_cast<PASS_HANDLE>(_passes.size() - 1);
+}
+
+void RENDER_GRAPH::Read(PASS_HANDLE pass, RESOURCE_HANDLE resource, uint32_t state)
+{
+	assert(pass < _passes.size() && resource < _resources.size());
+	_passes[pass].reads.push_back(ACCESS{ resource, state });
+}
+
+void RENDER_GRAPH::Write(PASS_HANDLE pass, RESOURCE_HANDLE resource, uint32_t state)
+{
+	assert(pass < _passes.size() && resource < _resources.size());
+	_passes[pass].writes.push_back(ACCESS{ resource, state });
+}
+
+void RENDER_GRAPH::SetSideEffect(PASS_HANDLE pass)
+{
+	assert(pass < _passes.size());
+	_passes[pass].sideEffect = true;
+}
+
+void RENDER_GRAPH::Compile()
+{
+	_executionOrder.clear();
+	_statistics = STATISTICS();
+
+	for (PASS& pass : _passes)
+	{
+		pass.culled = false;
+		pass.aliasing.clear();
+		pass.transitions.clear();
+		pass.uavBarriers.clear();
+	}
+
+	for (RESOURCE& resource : _resources)
+	{
+		resource.firstUse = INVALID_INDEX;
+		resource.lastUse = INVALID_INDEX;
+		resource.heapOffset = 0;
+	}
+
+	CullPasses();
+	SortPasses();
+	ComputeLifetimes();
+	PlaceTransients();
+	ComputeTransitions();
+
+	_statistics.passCount = static_cast<uint32_t>(_passes.size());
+	_statistics.culledPassCount = static_cast<uint32_t>(_passes.size() - _executionOrder.size());
+}
+
+void RENDER_GRAPH::CullPasses()
+{
+	// Walks the passes backwards, a pass is kept when a kept pass reads what it writes.
+	// A write overwrites the resource, the passes writing it before are only kept if
+	// something reads it in between.
+	std::vector<bool> needed(_resources.size(), false);
+
+	for (size_t i = _passes.size(); i-- > 0;)
+	{
+		PASS& pass = _passes[i];
+
+		bool alive = pass.sideEffect;
+		for (const ACCESS& write : pass.writes)
+		{
+			alive = alive || _resources[write.resource].imported || needed[write.resource];
+		}
+
+		pass.culled = !alive;
+		if (pass.culled)
+		{
+			continue;
+		}
+
+		for (const ACCESS& write : pass.writes)
+		{
+			needed[write.resource] = false;
+		}
+
+		for (const ACCESS& read : pass.reads)
+		{
+			needed[read.resource] = true;
+		}
+	}
+}
+
+void RENDER_GRAPH::SortPasses()
+{
+	const size_t passCount = _passes.size();
+
+	std::vector<std::vector<PASS_HANDLE>> successors(passCount);
+	std::vector<uint32_t> inDegree(passCount, 0);
+
+	auto addEdge = [&](PASS_HANDLE from, PASS_HANDLE to)
+	{
+		if (from != to)
+		{
+			successors[from].push_back(to);
+			inDegree[to]++;
+		}
+	};
+
+	// Read after write, write after read and write after write hazards, in declaration order.
+	std::vector<PASS_HANDLE> lastWriter(_resources.size(), INVALID_INDEX);
+	std::vector<std::vector<PASS_HANDLE>> readers(_resources.size());
+
+	for (PASS_HANDLE passIndex = 0; passIndex < passCount; ++passIndex)
+	{
+		const PASS& pass = _passes[passIndex];
+		if (pass.culled)
+		{
+			continue;
+		}
+
+		for (const ACCESS& read : pass.reads)
+		{
+			if (lastWriter[read.resource] != INVALID_INDEX)
+			{
+				addEdge(lastWriter[read.resource], passIndex);
+			}
+			readers[read.resource].push_back(passIndex);
+		}
+
+		for (const ACCESS& write : pass.writes)
+		{
+			if (lastWriter[write.resource] != INVALID_INDEX)
+			{
+				addEdge(lastWriter[write.resource], passIndex);
+			}
+			for (PASS_HANDLE reader : readers[write.resource])
+			{
+				addEdge(reader, passIndex);
+			}
+			lastWriter[write.resource] = passIndex;
+			readers[write.resource].clear();
+		}
+	}
+
+	// Kahn's algorithm, ready passes are taken in declaration order so independent passes keep their order.
+	std::priority_queue<PASS_HANDLE, std::vector<PASS_HANDLE>, std::greater<PASS_HANDLE>> ready;
+	for (PASS_HANDLE passIndex = 0; passIndex < passCount; ++passIndex)
+	{
+		if (_passes[passIndex].culled == false && inDegree[passIndex] == 0)
+		{
+			ready.push(passIndex);
+		}
+	}
+
+	while (ready.empty() == false)
+	{
+		PASS_HANDLE passIndex = ready.top();
+		ready.pop();
+		_executionOrder.push_back(passIndex);
+
+		for (PASS_HANDLE successor : successors[passIndex])
+		{
+			if (--inDegree[successor] == 0)
+			{
+				ready.push(successor);
+			}
+		}
+	}
+}
+
+void RENDER_GRAPH::ComputeLifetimes()
+{
+	for (uint32_t executionIndex = 0; executionIndex < _executionOrder.size(); ++executionIndex)
+	{
+		const PASS& pass = _passes[_executionOrder[executionIndex]];
+
+		auto use = [&](const ACCESS& access, bool write)
+		{
+			RESOURCE& resource = _resources[access.resource];
+			if (resource.firstUse == INVALID_INDEX)
+			{
+				// The content of a transient resource is undefined until written.
+				assert((resource.imported || write || std::any_of(pass.writes.begin(), pass.writes.end(),
+					[&](const ACCESS& w) { return w.resource == access.resource; })) && "Transient resource read before being written.");
+				(void)write;
+				resource.firstUse = executionIndex;
+			}
+			resource.lastUse = executionIndex;
+		};
+
+		for (const ACCESS& read : pass.reads)
+		{
+			use(read, false);
+		}
+		for (const ACCESS& write : pass.writes)
+		{
+			use(write, true);
+		}
+	}
+}
+
+void RENDER_GRAPH::PlaceTransients()
+{
+	std::vector<RESOURCE_HANDLE> transients;
+	for (RESOURCE_HANDLE handle = 0; handle < _resources.size(); ++handle)
+	{
+		const RESOURCE& resource = _resources[handle];
+		if (resource.imported == false && resource.firstUse != INVALID_INDEX)
+		{
+			transients.push_back(handle);
+			_statistics.naiveTransientBytes += resource.size;
+		}
+	}
+	_statistics.transientCount = static_cast<uint32_t>(transients.size());
+
+	// Largest first, smaller resources fill the gaps left between them.
+	std::sort(transients.begin(), transients.end(), [&](RESOURCE_HANDLE a, RESOURCE_HANDLE b)
+	{
+		const RESOURCE& ra = _resources[a];
+		const RESOURCE& rb = _resources[b];
+		return ra.size != rb.size ? ra.size > rb.size : ra.firstUse < rb.firstUse;
+	});
+
+	struct RANGE
+	{
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	std::vector<RANGE> busyRanges;
+	for (size_t i = 0; i < transients.size(); ++i)
+	{
+		RESOURCE& resource = _resources[transients[i]];
+
+		// Memory of the placed resources alive at the same time.
+		busyRanges.clear();
+		for (size_t j = 0; j < i; ++j)
+		{
+			const RESOURCE& placed = _resources[transients[j]];
+			if (placed.firstUse <= resource.lastUse && resource.firstUse <= placed.lastUse)
+			{
+				busyRanges.push_back(RANGE{ placed.heapOffset, placed.heapOffset + placed.size });
+			}
+		}
+		std::sort(busyRanges.begin(), busyRanges.end(), [](const RANGE& a, const RANGE& b) { return a.begin < b.begin; });
+
+		// Lowest offset fitting between the busy ranges.
+		uint64_t offset = 0;
+		for (const RANGE& range : busyRanges)
+		{
+			if (offset + resource.size <= range.begin)
+			{
+				break;
+			}
+			offset = std::max(offset, AlignUp(range.end, resource.alignment));
+		}
+
+		resource.heapOffset = offset;
+		_statistics.transientHeapBytes = std::max(_statistics.transientHeapBytes, offset + resource.size);
+	}
+
+	// Resources sharing memory need an aliasing barrier before their first use. The memory
+	// may also have been used later in the previous frame, so every overlap is considered.
+	for (RESOURCE_HANDLE after : transients)
+	{
+		const RESOURCE& resource = _resources[after];
+
+		RESOURCE_HANDLE before = INVALID_RESOURCE;
+		uint32_t overlapCount = 0;
+		for (RESOURCE_HANDLE other : transients)
+		{
+			const RESOURCE& otherResource = _resources[other];
+			if (other != after &&
+				otherResource.heapOffset < resource.heapOffset + resource.size &&
+				resource.heapOffset < otherResource.heapOffset + otherResource.size)
+			{
+				before = other;
+				overlapCount++;
+			}
+		}
+
+		if (overlapCount > 0)
+		{
+			PASS& pass = _passes[_executionOrder[resource.firstUse]];
+			pass.aliasing.push_back(ALIASING{ overlapCount == 1 ? before : INVALID_RESOURCE, after });
+		}
+	}
+}
+
+void RENDER_GRAPH::ComputeTransitions()
+{
+	std::vector<uint32_t> currentStates(_resources.size(), UNKNOWN_STATE);
+	std::vector<bool> lastUseWrites(_resources.size(), false);
+
+	for (RESOURCE_HANDLE handle = 0; handle < _resources.size(); ++handle)
+	{
+		if (_resources[handle].imported)
+		{
+			currentStates[handle] = _resources[handle].initialState;
+		}
+	}
+
+	struct MERGED_ACCESS
+	{
+		RESOURCE_HANDLE	resource;
+		uint32_t		state;
+		bool			write;
+	};
+
+	std::vector<MERGED_ACCESS> accesses;
+	for (PASS_HANDLE passIndex : _executionOrder)
+	{
+		PASS& pass = _passes[passIndex];
+
+		// One state per resource, read states combine and a write state replaces them.
+		accesses.clear();
+		auto merge = [&](const ACCESS& access, bool write)
+		{
+			for (MERGED_ACCESS& merged : accesses)
+			{
+				if (merged.resource == access.resource)
+				{
+					merged.state = write ? access.state : (merged.write ? merged.state : merged.state | access.state);
+					merged.write = merged.write || write;
+					return;
+				}
+			}
+			accesses.push_back(MERGED_ACCESS{ access.resource, access.state, write });
+		};
+
+		for (const ACCESS& read : pass.reads)
+		{
+			merge(read, false);
+		}
+		for (const ACCESS& write : pass.writes)
+		{
+			merge(write, true);
+		}
+
+		for (const MERGED_ACCESS& access : accesses)
+		{
+			uint32_t& currentState = currentStates[access.resource];
+
+			// Transient resources persist across frames, their state is unknown on first use.
+			if (currentState != access.state)
+			{
+				pass.transitions.push_back(ACCESS{ access.resource, access.state });
+			}
+			else if (access.state == STATE_UNORDERED_ACCESS && lastUseWrites[access.resource])
+			{
+				pass.uavBarriers.push_back(access.resource);
+			}
+
+			currentState = access.state;
+			lastUseWrites[access.resource] = access.write;
+		}
+	}
+}
\ No newline at end of file
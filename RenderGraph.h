@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class RENDER_PASS_CONTEXT;
+
+// Frame graph declared every frame: passes declare the resources they read and
+// write with the D3D12_RESOURCE_STATES they need, Compile() orders the passes,
+// culls the ones whose outputs are never used, computes the state transitions
+// and places the transient resources in a shared heap based on their lifetimes.
+// Compilation only works on indices and sizes, it runs without a GPU.
+class RENDER_GRAPH
+{
+public:
+	using RESOURCE_HANDLE = uint32_t;
+	using PASS_HANDLE = uint32_t;
+	using EXECUTE_CALLBACK = std::function<void(RENDER_PASS_CONTEXT&)>;
+
+	static const RESOURCE_HANDLE INVALID_RESOURCE;
+	static const uint32_t INVALID_INDEX;
+	static const uint32_t UNKNOWN_STATE;	// Imported resource whose state is tracked elsewhere
+
+	struct ACCESS
+	{
+		RESOURCE_HANDLE	resource;
+		uint32_t		state;
+	};
+
+	struct RESOURCE
+	{
+		std::string	name;
+		bool		imported = false;
+		const void*	external = nullptr;			// Imported resource
+		uint32_t	initialState = 0;			// Imported resource state when the graph starts
+		uint32_t	finalState = 0;				// Imported resource state when the graph ends
+		uint64_t	size = 0;					// Transient resource placement
+		uint64_t	alignment = 0;
+
+		// Compile() results
+		uint32_t	firstUse = INVALID_INDEX;	// Execution indices, INVALID_INDEX when unused
+		uint32_t	lastUse = INVALID_INDEX;
+		uint64_t	heapOffset = 0;
+	};
+
+	struct ALIASING
+	{
+		RESOURCE_HANDLE	before;		// INVALID_RESOURCE when several resources used the memory
+		RESOURCE_HANDLE	after;
+	};
+
+	struct PASS
+	{
+		std::string				name;
+		EXECUTE_CALLBACK		execute;
+		std::vector<ACCESS>		reads;
+		std::vector<ACCESS>		writes;
+		bool					sideEffect = false;
+
+		// Compile() results, recorded before the pass executes
+		bool					culled = false;
+		std::vector<ALIASING>	aliasing;
+		std::vector<ACCESS>		transitions;	// Every resource the pass uses with the state it needs
+		std::vector<RESOURCE_HANDLE> uavBarriers;
+	};
+
+	struct STATISTICS
+	{
+		uint32_t passCount = 0;
+		uint32_t culledPassCount = 0;
+		uint32_t transientCount = 0;		// Transient resources used by a pass
+		uint64_t naiveTransientBytes = 0;	// Every transient resource in its own allocation
+		uint64_t transientHeapBytes = 0;	// Aliased
+	};
+
+	void Reset();
+
+	// Transient resources only live during the graph, their first use must be a write.
+	RESOURCE_HANDLE CreateTransient(const std::string& name, uint64_t size, uint64_t alignment);
+	RESOURCE_HANDLE ImportResource(const std::string& name, const void* resource, uint32_t initialState, uint32_t finalState);
+
+	// Passes execute in declaration order unless a dependency moves them.
+	PASS_HANDLE AddPass(const std::string& name, EXECUTE_CALLBACK execute);
+	void Read(PASS_HANDLE pass, RESOURCE_HANDLE resource, uint32_t state);
+	void Write(PASS_HANDLE pass, RESOURCE_HANDLE resource, uint32_t state);
+
+	// Passes with side effects, and passes writing imported resources, are never culled.
+	void SetSideEffect(PASS_HANDLE pass);
+
+	void Compile();
+
+	inline const std::vector<PASS_HANDLE>& GetExecutionOrder() const { return _executionOrder; }
+	inline const PASS& GetPass(PASS_HANDLE pass) const { return _passes[pass]; }
+	inline const RESOURCE& GetResource(RESOURCE_HANDLE resource) const { return _resources[resource]; }
+	inline size_t GetPassCount() const { return _passes.size(); }
+	inline size_t GetResourceCount() const { return _resources.size(); }
+	inline uint64_t GetTransientHeapSize() const { return _statistics.transientHeapBytes; }
+	inline const STATISTICS& GetStatistics() const { return _statistics; }
+
+private:
+	void CullPasses();
+	void SortPasses();
+	void ComputeLifetimes();
+	void PlaceTransients();
+	void ComputeTransitions();
+
+	std::vector<RESOURCE>		_resources;
+	std::vector<PASS>			_passes;
+	std::vector<PASS_HANDLE>	_executionOrder;
+	STATISTICS					_statistics;
+};
\ No newline at end of file
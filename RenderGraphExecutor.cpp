@@ -0,0 +1,329 @@
+#include "RenderGraphExecutor.h"
+#include "CommandQueue.h"
+#include "JobSystem.h"
+#include "ResourceBarriers.h"
+
+#include <cstring>
+
+static bool IsSameTexture(const D3D12_RESOURCE_DESC& a, const D3D12_RESOURCE_DESC& b)
+{
+	return a.Dimension == b.Dimension &&
+		a.Width == b.Width &&
+		a.Height == b.Height &&
+		a.DepthOrArraySize == b.DepthOrArraySize &&
+		a.MipLevels == b.MipLevels &&
+		a.Format == b.Format &&
+		a.SampleDesc.Count == b.SampleDesc.Count &&
+		a.SampleDesc.Quality == b.SampleDesc.Quality &&
+		a.Layout == b.Layout &&
+		a.Flags == b.Flags;
+}
+
+ID3D12Resource* RENDER_PASS_CONTEXT::GetResource(RENDER_GRAPH::RESOURCE_HANDLE resource) const
+{
+	return _executor->_resources[resource].Get();
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE RENDER_PASS_CONTEXT::GetRenderTargetView(RENDER_GRAPH::RESOURCE_HANDLE resource) const
+{
+	assert(_executor->_textures[resource].desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+	return _executor->_textures[resource].view.GetCpuHandle();
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE RENDER_PASS_CONTEXT::GetDepthStencilView(RENDER_GRAPH::RESOURCE_HANDLE resource) const
+{
+	assert(_executor->_textures[resource].desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
+	return _executor->_textures[resource].view.GetCpuHandle();
+}
+
+RENDER_GRAPH_EXECUTOR::RENDER_GRAPH_EXECUTOR(ComPtr<ID3D12Device2> device,
+	COMMAND_QUEUE* commandQueue,
+	DESCRIPTOR_ALLOCATOR* rtvAllocator,
+	DESCRIPTOR_ALLOCATOR* dsvAllocator,
+	JOB_SYSTEM* jobSystem) :
+	_device(device),
+	_commandQueue(commandQueue),
+	_rtvAllocator(rtvAllocator),
+	_dsvAllocator(dsvAllocator),
+	_jobSystem(jobSystem)
+{
+}
+
+RENDER_GRAPH_EXECUTOR::~RENDER_GRAPH_EXECUTOR()
+{
+	for (TEXTURE& texture : _textures)
+	{
+		if (texture.resource)
+		{
+			UnregisterResourceState(texture.resource.Get());
+		}
+
+		if (texture.view.IsNull() == false)
+		{
+			DESCRIPTOR_ALLOCATOR* allocator = (texture.desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) ? _rtvAllocator : _dsvAllocator;
+			allocator->Free(texture.view);
+		}
+	}
+}
+
+RENDER_GRAPH& RENDER_GRAPH_EXECUTOR::Begin()
+{
+	_graph.Reset();
+	_resources.clear();
+
+	return _graph;
+}
+
+RENDER_GRAPH::RESOURCE_HANDLE RENDER_GRAPH_EXECUTOR::CreateTexture(const std::string& name,
+	const D3D12_RESOURCE_DESC& desc,
+	const D3D12_CLEAR_VALUE* clearValue)
+{
+	assert((desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) &&
+		"Transient textures must be render targets or depth stencils.");
+
+	D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = _device->GetResourceAllocationInfo(0, 1, &desc);
+	RENDER_GRAPH::RESOURCE_HANDLE handle = _graph.CreateTransient(name, allocationInfo.SizeInBytes, allocationInfo.Alignment);
+	_resources.push_back(nullptr);
+
+	if (_textures.size() <= handle)
+	{
+		_textures.resize(handle + 1);
+	}
+
+	// Recreated when the description changed since the last frame.
+	TEXTURE& texture = _textures[handle];
+	bool sameClearValue = (clearValue != nullptr) == texture.hasClearValue &&
+		(clearValue == nullptr || memcmp(clearValue, &texture.clearValue, sizeof(D3D12_CLEAR_VALUE)) == 0);
+	if (IsSameTexture(texture.desc, desc) == false || sameClearValue == false)
+	{
+		ReleaseTransient(texture);
+		texture.desc = desc;
+		texture.hasClearValue = clearValue != nullptr;
+		texture.clearValue = clearValue ? *clearValue : D3D12_CLEAR_VALUE();
+	}
+
+	return handle;
+}
+
+RENDER_GRAPH::RESOURCE_HANDLE RENDER_GRAPH_EXECUTOR::ImportResource(const std::string& name,
+	ComPtr<ID3D12Resource> resource,
+	D3D12_RESOURCE_STATES finalState)
+{
+	// The resource state tracking knows the current state.
+	RENDER_GRAPH::RESOURCE_HANDLE handle = _graph.ImportResource(name, resource.Get(), RENDER_GRAPH::UNKNOWN_STATE, finalState);
+	_resources.push_back(resource);
+
+	if (handle < _textures.size())
+	{
+		ReleaseTransient(_textures[handle]);
+	}
+
+	return handle;
+}
+
+uint64_t RENDER_GRAPH_EXECUTOR::Execute()
+{
+	_graph.Compile();
+	PrepareTransients();
+
+	// One contiguous range of passes per thread, each recorded on its own list.
+	const std::vector<RENDER_GRAPH::PASS_HANDLE>& executionOrder = _graph.GetExecutionOrder();
+	size_t listCount = 1;
+	if (_jobSystem)
+	{
+		listCount = std::max<size_t>(1, std::min<size_t>(executionOrder.size(), _jobSystem->GetWorkerCount() + 1));
+	}
+
+	std::vector<ComPtr<ID3D12GraphicsCommandList2>> commandLists(listCount);
+	auto recordRange = [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t listIndex = begin; listIndex < end; ++listIndex)
+		{
+			// Lists are taken by the recording thread, each thread owns its allocators.
+			commandLists[listIndex] = _commandQueue->GetCommandList();
+			RecordPasses(commandLists[listIndex],
+				executionOrder.size() * listIndex / listCount,
+				executionOrder.size() * (listIndex + 1) / listCount);
+		}
+	};
+
+	if (listCount > 1)
+	{
+		_jobSystem->ParallelFor(static_cast<uint32_t>(listCount), 1, recordRange);
+	}
+	else
+	{
+		recordRange(0, 1);
+	}
+
+	ComPtr<ID3D12GraphicsCommandList2> commandList = commandLists.back();
+
+	// Imported resources are handed back in the state their owner expects, flushed when the list is executed.
+	for (RENDER_GRAPH::RESOURCE_HANDLE handle = 0; handle < _graph.GetResourceCount(); ++handle)
+	{
+		const RENDER_GRAPH::RESOURCE& resource = _graph.GetResource(handle);
+		if (resource.imported && resource.firstUse != RENDER_GRAPH::INVALID_INDEX)
+		{
+			TransitionResource(commandList, _resources[handle], static_cast<D3D12_RESOURCE_STATES>(resource.finalState));
+		}
+	}
+
+	// States assumed by the lists recorded in parallel are fixed up at submission.
+	return _commandQueue->ExecuteCommandLists(commandLists);
+}
+
+void RENDER_GRAPH_EXECUTOR::PrepareTransients()
+{
+	// Textures cached for handles the graph no longer declares.
+	for (size_t handle = _graph.GetResourceCount(); handle < _textures.size(); ++handle)
+	{
+		ReleaseTransient(_textures[handle]);
+	}
+	_textures.resize(std::max(_textures.size(), _graph.GetResourceCount()));
+
+	uint64_t heapSize = _graph.GetTransientHeapSize();
+	if (heapSize > _transientHeapSize)
+	{
+		// Every placed resource moves to the new heap.
+		for (TEXTURE& texture : _textures)
+		{
+			ReleaseTransient(texture);
+		}
+
+		if (_transientHeap)
+		{
+			ComPtr<ID3D12Heap> heap = _transientHeap;
+			_commandQueue->ReleaseDeferred(_transientHeapSize, [heap]() { ; });
+		}
+
+		uint64_t alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+		for (RENDER_GRAPH::RESOURCE_HANDLE handle = 0; handle < _graph.GetResourceCount(); ++handle)
+		{
+			alignment = std::max(alignment, _graph.GetResource(handle).alignment);
+		}
+
+		_transientHeapSize = (heapSize + alignment - 1) / alignment * alignment;
+
+		CD3DX12_HEAP_DESC heapDesc(_transientHeapSize, D3D12_HEAP_TYPE_DEFAULT, alignment, D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES);
+		ThrowIfFailed(_device->CreateHeap(&heapDesc, IID_PPV_ARGS(&_transientHeap)));
+	}
+
+	for (RENDER_GRAPH::RESOURCE_HANDLE handle = 0; handle < _graph.GetResourceCount(); ++handle)
+	{
+		const RENDER_GRAPH::RESOURCE& resource = _graph.GetResource(handle);
+		if (resource.imported || resource.firstUse == RENDER_GRAPH::INVALID_INDEX)
+		{
+			continue;
+		}
+
+		TEXTURE& texture = _textures[handle];
+		if (texture.resource == nullptr || texture.heapOffset != resource.heapOffset)
+		{
+			ReleaseTransient(texture);
+
+			// Created in the state of its first use, which always declares a transition.
+			const RENDER_GRAPH::PASS& firstPass = _graph.GetPass(_graph.GetExecutionOrder()[resource.firstUse]);
+			D3D12_RESOURCE_STATES initialState = D3D12_RESOURCE_STATE_COMMON;
+			for (const RENDER_GRAPH::ACCESS& transition : firstPass.transitions)
+			{
+				if (transition.resource == handle)
+				{
+					initialState = static_cast<D3D12_RESOURCE_STATES>(transition.state);
+				}
+			}
+
+			CreateTransient(texture, resource.heapOffset, initialState);
+		}
+
+		_resources[handle] = texture.resource;
+	}
+}
+
+void RENDER_GRAPH_EXECUTOR::CreateTransient(TEXTURE& texture, uint64_t heapOffset, D3D12_RESOURCE_STATES initialState)
+{
+	ThrowIfFailed(_device->CreatePlacedResource(
+		_transientHeap.Get(),
+		heapOffset,
+		&texture.desc,
+		initialState,
+		texture.hasClearValue ? &texture.clearValue : nullptr,
+		IID_PPV_ARGS(&texture.resource)));
+
+	texture.heapOffset = heapOffset;
+	RegisterResourceState(texture.resource.Get(), initialState);
+
+	if (texture.desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET)
+	{
+		texture.view = _rtvAllocator->Allocate();
+		_device->CreateRenderTargetView(texture.resource.Get(), nullptr, texture.view.GetCpuHandle());
+	}
+	else
+	{
+		texture.view = _dsvAllocator->Allocate();
+		_device->CreateDepthStencilView(texture.resource.Get(), nullptr, texture.view.GetCpuHandle());
+	}
+}
+
+void RENDER_GRAPH_EXECUTOR::ReleaseTransient(TEXTURE& texture)
+{
+	// Frames in flight may still use the texture and its view.
+	if (texture.resource)
+	{
+		ComPtr<ID3D12Resource> resource = texture.resource;
+		_commandQueue->ReleaseDeferred(0, [resource]() { UnregisterResourceState(resource.Get()); });
+		texture.resource = nullptr;
+	}
+
+	if (texture.view.IsNull() == false)
+	{
+		DESCRIPTOR_ALLOCATOR* allocator = (texture.desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) ? _rtvAllocator : _dsvAllocator;
+		allocator->ReleaseDeferred(_commandQueue, texture.view);
+		texture.view = DESCRIPTOR_ALLOCATION();
+	}
+}
+
+void RENDER_GRAPH_EXECUTOR::RecordPasses(ComPtr<ID3D12GraphicsCommandList2> commandList, size_t begin, size_t end)
+{
+	RENDER_PASS_CONTEXT context(this, commandList);
+
+	const std::vector<RENDER_GRAPH::PASS_HANDLE>& executionOrder = _graph.GetExecutionOrder();
+	for (size_t i = begin; i < end; ++i)
+	{
+		const RENDER_GRAPH::PASS& pass = _graph.GetPass(executionOrder[i]);
+
+		RecordBarriers(commandList, pass);
+		if (pass.execute)
+		{
+			pass.execute(context);
+		}
+	}
+}
+
+void RENDER_GRAPH_EXECUTOR::RecordBarriers(ComPtr<ID3D12GraphicsCommandList2> commandList, const RENDER_GRAPH::PASS& pass)
+{
+	if (pass.aliasing.empty() == false)
+	{
+		// Aliasing barriers go before the transitions of the new resources.
+		FlushResourceBarriers(commandList);
+
+		std::vector<D3D12_RESOURCE_BARRIER> barriers;
+		for (const RENDER_GRAPH::ALIASING& aliasing : pass.aliasing)
+		{
+			ID3D12Resource* before = aliasing.before == RENDER_GRAPH::INVALID_RESOURCE ? nullptr : _resources[aliasing.before].Get();
+			barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(before, _resources[aliasing.after].Get()));
+		}
+		commandList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+	}
+
+	for (const RENDER_GRAPH::ACCESS& transition : pass.transitions)
+	{
+		TransitionResource(commandList, _resources[transition.resource], static_cast<D3D12_RESOURCE_STATES>(transition.state));
+	}
+
+	for (RENDER_GRAPH::RESOURCE_HANDLE resource : pass.uavBarriers)
+	{
+		UAVBarrier(commandList, _resources[resource]);
+	}
+
+	FlushResourceBarriers(commandList);
+}
\ No newline at end of file
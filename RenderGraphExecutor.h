@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Helpers.h"
+#include "RenderGraph.h"
+#include "DescriptorAllocator.h"
+
+#include <string>
+#include <vector>
+
+class COMMAND_QUEUE;
+class JOB_SYSTEM;
+class RENDER_GRAPH_EXECUTOR;
+
+// Handed to the pass callbacks, the barriers the pass declared are already recorded.
+class RENDER_PASS_CONTEXT
+{
+public:
+	RENDER_PASS_CONTEXT(RENDER_GRAPH_EXECUTOR* executor, ComPtr<ID3D12GraphicsCommandList2> commandList) :
+		_executor(executor), _commandList(commandList) { ; }
+
+	inline ComPtr<ID3D12GraphicsCommandList2> GetCommandList() const { return _commandList; }
+
+	ID3D12Resource* GetResource(RENDER_GRAPH::RESOURCE_HANDLE resource) const;
+
+	// Views of the transient textures, created with the resource.
+	D3D12_CPU_DESCRIPTOR_HANDLE GetRenderTargetView(RENDER_GRAPH::RESOURCE_HANDLE resource) const;
+	D3D12_CPU_DESCRIPTOR_HANDLE GetDepthStencilView(RENDER_GRAPH::RESOURCE_HANDLE resource) const;
+
+private:
+	RENDER_GRAPH_EXECUTOR*				_executor;
+	ComPtr<ID3D12GraphicsCommandList2>	_commandList;
+};
+
+// Builds a RENDER_GRAPH every frame and executes it on a queue.
+// With a job system, the passes are split in contiguous ranges recorded in
+// parallel on separate lists, pass callbacks must then be thread safe. The lists
+// are submitted in execution order in a single ExecuteCommandLists call.
+// Transient textures are placed resources in a single heap sized by the graph
+// compiler, they are kept from one frame to the next while their description
+// and placement do not change. Aliased textures start with undefined content,
+// their first write must be a clear, a discard or a full copy.
+class RENDER_GRAPH_EXECUTOR
+{
+public:
+	RENDER_GRAPH_EXECUTOR(ComPtr<ID3D12Device2> device,
+		COMMAND_QUEUE* commandQueue,
+		DESCRIPTOR_ALLOCATOR* rtvAllocator,
+		DESCRIPTOR_ALLOCATOR* dsvAllocator,
+		JOB_SYSTEM* jobSystem = nullptr);
+
+	// The GPU must be done with the transient resources.
+	~RENDER_GRAPH_EXECUTOR();
+
+	// Starts a new graph, the handles of the previous one are invalid.
+	RENDER_GRAPH& Begin();
+
+	// Render target or depth stencil texture living in the transient heap.
+	RENDER_GRAPH::RESOURCE_HANDLE CreateTexture(const std::string& name,
+		const D3D12_RESOURCE_DESC& desc,
+		const D3D12_CLEAR_VALUE* clearValue = nullptr);
+
+	// The resource must be registered with the resource state tracking.
+	RENDER_GRAPH::RESOURCE_HANDLE ImportResource(const std::string& name,
+		ComPtr<ID3D12Resource> resource,
+		D3D12_RESOURCE_STATES finalState);
+
+	// Compiles the graph, records the passes and executes them.
+	// Returns the fence value signaled once the graph completed.
+	uint64_t Execute();
+
+	inline const RENDER_GRAPH& GetGraph() const { return _graph; }
+
+private:
+	friend class RENDER_PASS_CONTEXT;
+
+	struct TEXTURE
+	{
+		D3D12_RESOURCE_DESC		desc = {};
+		D3D12_CLEAR_VALUE		clearValue = {};
+		bool					hasClearValue = false;
+		uint64_t				heapOffset = 0;
+		ComPtr<ID3D12Resource>	resource;		// Kept across frames
+		DESCRIPTOR_ALLOCATION	view;			// RTV or DSV
+	};
+
+	void PrepareTransients();
+	void CreateTransient(TEXTURE& texture, uint64_t heapOffset, D3D12_RESOURCE_STATES initialState);
+	void ReleaseTransient(TEXTURE& texture);
+	void RecordPasses(ComPtr<ID3D12GraphicsCommandList2> commandList, size_t begin, size_t end);
+	void RecordBarriers(ComPtr<ID3D12GraphicsCommandList2> commandList, const RENDER_GRAPH::PASS& pass);
+
+	ComPtr<ID3D12Device2>	_device;
+	COMMAND_QUEUE*			_commandQueue;
+	DESCRIPTOR_ALLOCATOR*	_rtvAllocator;
+	DESCRIPTOR_ALLOCATOR*	_dsvAllocator;
+	JOB_SYSTEM*				_jobSystem;
+
+	RENDER_GRAPH				_graph;
+	std::vector<ComPtr<ID3D12Resource>>	_resources;		// Indexed by resource handle
+	std::vector<TEXTURE>		_textures;					// Indexed by resource handle
+
+	ComPtr<ID3D12Heap>			_transientHeap;
+	uint64_t					_transientHeapSize = 0;
+};
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "ResourceBarriers.h"
+#include "BarrierTranslation.h"
+
+#if defined(D3D12_SDK_VERSION) && (D3D12_SDK_VERSION >= 608)
+#define ENHANCED_BARRIERS_AVAILABLE 1
+
+// The translation mirrors the D3D12 values.
+static_assert(BARRIER_SYNC_ALL_SHADING == static_cast<uint32_t>(D3D12_BARRIER_SYNC_ALL_SHADING), "BARRIER_SYNC mismatch");
+static_assert(BARRIER_SYNC_NON_PIXEL_SHADING == static_cast<uint32_t>(D3D12_BARRIER_SYNC_NON_PIXEL_SHADING), "BARRIER_SYNC mismatch");
+static_assert(BARRIER_ACCESS_SHADER_RESOURCE == static_cast<uint32_t>(D3D12_BARRIER_ACCESS_SHADER_RESOURCE), "BARRIER_ACCESS mismatch");
+static_assert(BARRIER_ACCESS_NO_ACCESS == static_cast<uint32_t>(D3D12_BARRIER_ACCESS_NO_ACCESS), "BARRIER_ACCESS mismatch");
+static_assert(BARRIER_LAYOUT_RESOLVE_DEST == static_cast<uint32_t>(D3D12_BARRIER_LAYOUT_RESOLVE_DEST), "BARRIER_LAYOUT mismatch");
+static_assert(BARRIER_LAYOUT_UNDEFINED == static_cast<uint32_t>(D3D12_BARRIER_LAYOUT_UNDEFINED), "BARRIER_LAYOUT mismatch");
+#else
+#define ENHANCED_BARRIERS_AVAILABLE 0
+#endif
+
+static bool g_enhancedBarriers = false;
+
+// Private data key of the state tracker owned by a command list.
+static const GUID RESOURCE_STATE_TRACKER_GUID = { 0x2d8b7c31, 0x5e4f, 0x4a19, { 0xb6, 0x0d, 0x93, 0x7e, 0x21, 0xc8, 0x4f, 0x15 } };
+
+// Planar formats are only tracked per mip and array slice.
+static uint32_t GetSubresourceCount(const D3D12_RESOURCE_DESC& desc)
+{
+	switch (desc.Dimension)
+	{
+	case D3D12_RESOURCE_DIMENSION_BUFFER:
+		return 1;
+	case D3D12_RESOURCE_DIMENSION_TEXTURE3D:
+		return desc.MipLevels;
+	default:
+		return desc.MipLevels * desc.DepthOrArraySize;
+	}
+}
+
+void InitializeResourceBarriers(ID3D12Device* device, bool allowEnhancedBarriers)
+{
+	g_enhancedBarriers = false;
+
+#if ENHANCED_BARRIERS_AVAILABLE
+	D3D12_FEATURE_DATA_D3D12_OPTIONS12 options12 = {};
+	if (allowEnhancedBarriers &&
+		SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS12, &options12, sizeof(options12))))
+	{
+		g_enhancedBarriers = options12.EnhancedBarriersSupported != FALSE;
+	}
+#endif
+}
+
+bool UsesEnhancedBarriers()
+{
+	return g_enhancedBarriers;
+}
+
+GLOBAL_RESOURCE_STATES& GetGlobalResourceStates()
+{
+	static GLOBAL_RESOURCE_STATES globalStates;
+	return globalStates;
+}
+
+void RegisterResourceState(ID3D12Resource* resource, D3D12_RESOURCE_STATES state)
+{
+	D3D12_RESOURCE_DESC desc = resource->GetDesc();
+	bool decaysToCommon = desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER ||
+		(desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS) != 0;
+
+	GetGlobalResourceStates().Add(resource, state, GetSubresourceCount(desc), decaysToCommon);
+}
+
+void UnregisterResourceState(ID3D12Resource* resource)
+{
+	GetGlobalResourceStates().Remove(resource);
+}
+
+RESOURCE_STATE_TRACKER* GetResourceStateTracker(ID3D12GraphicsCommandList2* commandList)
+{
+	RESOURCE_STATE_TRACKER* tracker = nullptr;
+	UINT dataSize = sizeof(tracker);
+	ThrowIfFailed(commandList->GetPrivateData(RESOURCE_STATE_TRACKER_GUID, &dataSize, &tracker));
+	return tracker;
+}
+
+void SetResourceStateTracker(ID3D12GraphicsCommandList2* commandList, RESOURCE_STATE_TRACKER* tracker)
+{
+	ThrowIfFailed(commandList->SetPrivateData(RESOURCE_STATE_TRACKER_GUID, sizeof(tracker), &tracker));
+}
+
+void TransitionResource(ComPtr<ID3D12GraphicsCommandList2> commandList,
+	ComPtr<ID3D12Resource> resource,
+	D3D12_RESOURCE_STATES state,
+	UINT subresource)
+{
+	D3D12_RESOURCE_DESC desc = resource->GetDesc();
+	GetResourceStateTracker(commandList.Get())->TransitionResource(resource.Get(), GetSubresourceCount(desc), state, subresource);
+}
+
+void UAVBarrier(ComPtr<ID3D12GraphicsCommandList2> commandList, ComPtr<ID3D12Resource> resource)
+{
+	GetResourceStateTracker(commandList.Get())->UAVBarrier(resource.Get());
+}
+
+void FlushResourceBarriers(ComPtr<ID3D12GraphicsCommandList2> commandList)
+{
+	RESOURCE_STATE_TRACKER* tracker = GetResourceStateTracker(commandList.Get());
+	if (tracker->HasBarriers())
+	{
+		std::vector<RESOURCE_STATE_TRACKER::BARRIER> barriers;
+		tracker->FlushBarriers(barriers);
+		RecordResourceBarriers(commandList.Get(), barriers);
+	}
+}
+
+#if ENHANCED_BARRIERS_AVAILABLE
+static void RecordEnhancedBarriers(ID3D12GraphicsCommandList7* commandList, const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& barriers)
+{
+	std::vector<D3D12_BUFFER_BARRIER> bufferBarriers;
+	std::vector<D3D12_TEXTURE_BARRIER> textureBarriers;
+	std::vector<D3D12_GLOBAL_BARRIER> globalBarriers;
+
+	for (const RESOURCE_STATE_TRACKER::BARRIER& barrier : barriers)
+	{
+		ID3D12Resource* resource = static_cast<ID3D12Resource*>(const_cast<void*>(barrier.resource));
+		bool texture = resource && resource->GetDesc().Dimension != D3D12_RESOURCE_DIMENSION_BUFFER;
+
+		ENHANCED_BARRIER enhancedBarrier;
+		if (TranslateBarrier(barrier, texture, enhancedBarrier) == false)
+		{
+			continue;
+		}
+
+		D3D12_BARRIER_SYNC syncBefore = static_cast<D3D12_BARRIER_SYNC>(enhancedBarrier.syncBefore);
+		D3D12_BARRIER_SYNC syncAfter = static_cast<D3D12_BARRIER_SYNC>(enhancedBarrier.syncAfter);
+		D3D12_BARRIER_ACCESS accessBefore = static_cast<D3D12_BARRIER_ACCESS>(enhancedBarrier.accessBefore);
+		D3D12_BARRIER_ACCESS accessAfter = static_cast<D3D12_BARRIER_ACCESS>(enhancedBarrier.accessAfter);
+
+		if (resource == nullptr)
+		{
+			globalBarriers.push_back(CD3DX12_GLOBAL_BARRIER(syncBefore, syncAfter, accessBefore, accessAfter));
+		}
+		else if (texture)
+		{
+			textureBarriers.push_back(CD3DX12_TEXTURE_BARRIER(syncBefore, syncAfter, accessBefore, accessAfter,
+				static_cast<D3D12_BARRIER_LAYOUT>(enhancedBarrier.layoutBefore),
+				static_cast<D3D12_BARRIER_LAYOUT>(enhancedBarrier.layoutAfter),
+				resource,
+				CD3DX12_BARRIER_SUBRESOURCE_RANGE(enhancedBarrier.subresource)));
+		}
+		else
+		{
+			bufferBarriers.push_back(CD3DX12_BUFFER_BARRIER(syncBefore, syncAfter, accessBefore, accessAfter, resource));
+		}
+	}
+
+	std::vector<D3D12_BARRIER_GROUP> groups;
+	if (globalBarriers.empty() == false)
+	{
+		groups.push_back(CD3DX12_BARRIER_GROUP(static_cast<UINT32>(globalBarriers.size()), globalBarriers.data()));
+	}
+	if (bufferBarriers.empty() == false)
+	{
+		groups.push_back(CD3DX12_BARRIER_GROUP(static_cast<UINT32>(bufferBarriers.size()), bufferBarriers.data()));
+	}
+	if (textureBarriers.empty() == false)
+	{
+		groups.push_back(CD3DX12_BARRIER_GROUP(static_cast<UINT32>(textureBarriers.size()), textureBarriers.data()));
+	}
+
+	if (groups.empty() == false)
+	{
+		commandList->Barrier(static_cast<UINT32>(groups.size()), groups.data());
+	}
+}
+#endif
+
+void RecordResourceBarriers(ID3D12GraphicsCommandList2* commandList, const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& barriers)
+{
+	if (barriers.empty())
+	{
+		return;
+	}
+
+#if ENHANCED_BARRIERS_AVAILABLE
+	ComPtr<ID3D12GraphicsCommandList7> commandList7;
+	if (g_enhancedBarriers && SUCCEEDED(commandList->QueryInterface(IID_PPV_ARGS(&commandList7))))
+	{
+		RecordEnhancedBarriers(commandList7.Get(), barriers);
+		return;
+	}
+#endif
+
+	std::vector<D3D12_RESOURCE_BARRIER> d3d12Barriers;
+	d3d12Barriers.reserve(barriers.size());
+
+	for (const RESOURCE_STATE_TRACKER::BARRIER& barrier : barriers)
+	{
+		ID3D12Resource* resource = static_cast<ID3D12Resource*>(const_cast<void*>(barrier.resource));
+		if (barrier.type == RESOURCE_STATE_TRACKER::BARRIER_UAV)
+		{
+			d3d12Barriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV(resource));
+		}
+		else
+		{
+			d3d12Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource,
+				static_cast<D3D12_RESOURCE_STATES>(barrier.before),
+				static_cast<D3D12_RESOURCE_STATES>(barrier.after),
+				barrier.subresource));
+		}
+	}
+
+	commandList->ResourceBarrier(static_cast<UINT>(d3d12Barriers.size()), d3d12Barriers.data());
+}
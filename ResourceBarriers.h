@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Helpers.h"
+#include "ResourceStateTracker.h"
+
+#include <vector>
+
+// Enables the enhanced barrier path when requested and supported by the device (OPTIONS12),
+// legacy barriers are used otherwise.
+void InitializeResourceBarriers(ID3D12Device* device, bool allowEnhancedBarriers);
+bool UsesEnhancedBarriers();
+
+// Resource state tracking for the lists handed out by COMMAND_QUEUE::GetCommandList().
+// Resources must be registered with their initial state to be transitioned.
+GLOBAL_RESOURCE_STATES& GetGlobalResourceStates();
+void RegisterResourceState(ID3D12Resource* resource, D3D12_RESOURCE_STATES state);
+void UnregisterResourceState(ID3D12Resource* resource);
+
+RESOURCE_STATE_TRACKER* GetResourceStateTracker(ID3D12GraphicsCommandList2* commandList);
+void SetResourceStateTracker(ID3D12GraphicsCommandList2* commandList, RESOURCE_STATE_TRACKER* tracker);
+
+// Transitions are batched until the next FlushResourceBarriers(), call it before draws, dispatches and copies.
+void TransitionResource(ComPtr<ID3D12GraphicsCommandList2> commandList,
+	ComPtr<ID3D12Resource> resource,
+	D3D12_RESOURCE_STATES state,
+	UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+void UAVBarrier(ComPtr<ID3D12GraphicsCommandList2> commandList, ComPtr<ID3D12Resource> resource);
+void FlushResourceBarriers(ComPtr<ID3D12GraphicsCommandList2> commandList);
+
+// Records the barriers in a single ResourceBarrier call, or as buffer and texture
+// barrier groups in a single Barrier call on the enhanced path.
+void RecordResourceBarriers(ID3D12GraphicsCommandList2* commandList, const std::vector<RESOURCE_STATE_TRACKER::BARRIER>& barriers);
@@ -0,0 +1,259 @@
+#include "ResourceStateTracker.h"
+
+#include <cassert>
+
+const uint32_t RESOURCE_STATE::ALL_SUBRESOURCES;
+
+uint32_t RESOURCE_STATE::Get(uint32_t subresource) const
+{
+	auto it = subresourceStates.find(subresource);
+	return it != subresourceStates.end() ? it->second : state;
+}
+
+void RESOURCE_STATE::Set(uint32_t subresource, uint32_t newState, uint32_t subresourceCount)
+{
+	if (subresource == ALL_SUBRESOURCES || subresourceCount <= 1)
+	{
+		state = newState;
+		subresourceStates.clear();
+		return;
+	}
+
+	// Only subresources differing from the common state are stored.
+	if (newState == state)
+	{
+		subresourceStates.erase(subresource);
+	}
+	else
+	{
+		subresourceStates[subresource] = newState;
+	}
+
+	// Back to a single state once every subresource agrees.
+	if (subresourceStates.size() == subresourceCount)
+	{
+		for (auto& subresourceState : subresourceStates)
+		{
+			if (subresourceState.second != newState)
+			{
+				return;
+			}
+		}
+
+		state = newState;
+		subresourceStates.clear();
+	}
+}
+
+void GLOBAL_RESOURCE_STATES::Add(const void* resource, uint32_t state, uint32_t subresourceCount, bool decaysToCommon)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	ENTRY& entry = _resources[resource];
+	entry.state = RESOURCE_STATE();
+	entry.state.state = state;
+	entry.subresourceCount = subresourceCount;
+	entry.decaysToCommon = decaysToCommon;
+}
+
+void GLOBAL_RESOURCE_STATES::Remove(const void* resource)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_resources.erase(resource);
+}
+
+bool GLOBAL_RESOURCE_STATES::Get(const void* resource, RESOURCE_STATE& state)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto it = _resources.find(resource);
+	if (it == _resources.end())
+	{
+		return false;
+	}
+
+	state = it->second.state;
+	return true;
+}
+
+void GLOBAL_RESOURCE_STATES::Decay(const std::vector<const void*>& resources)
+{
+	for (const void* resource : resources)
+	{
+		auto it = _resources.find(resource);
+		if (it != _resources.end())
+		{
+			it->second.state = RESOURCE_STATE();
+		}
+	}
+}
+
+RESOURCE_STATE_TRACKER::RESOURCE_STATE_TRACKER(GLOBAL_RESOURCE_STATES* globalStates, bool decayAll) :
+	_globalStates(globalStates),
+	_decayAll(decayAll)
+{
+}
+
+void RESOURCE_STATE_TRACKER::TransitionResource(const void* resource, uint32_t subresourceCount, uint32_t state, uint32_t subresource)
+{
+	if (subresourceCount <= 1)
+	{
+		subresource = RESOURCE_STATE::ALL_SUBRESOURCES;
+	}
+
+	auto it = _finalStates.find(resource);
+	if (it == _finalStates.end())
+	{
+		// First use in this list, start from the global state and check it again on submission.
+		RESOURCE_STATE globalState;
+		if (_globalStates->Get(resource, globalState) == false)
+		{
+			assert(false && "Transitioning a resource which is not tracked.");
+			return;
+		}
+
+		_pending.push_back(PENDING{ resource, subresourceCount, globalState });
+		it = _finalStates.emplace(resource, FINAL_STATE{ globalState, subresourceCount }).first;
+	}
+
+	RESOURCE_STATE& finalState = it->second.state;
+
+	if (subresource == RESOURCE_STATE::ALL_SUBRESOURCES && finalState.IsUniform() == false)
+	{
+		// Subresources in different states are transitioned one by one.
+		for (uint32_t i = 0; i < subresourceCount; ++i)
+		{
+			AddTransition(resource, i, finalState.Get(i), state);
+		}
+	}
+	else
+	{
+		AddTransition(resource, subresource, finalState.Get(subresource), state);
+	}
+
+	finalState.Set(subresource, state, subresourceCount);
+}
+
+void RESOURCE_STATE_TRACKER::AddTransition(const void* resource, uint32_t subresource, uint32_t before, uint32_t after)
+{
+	if (before == after)
+	{
+		return;
+	}
+
+	// Merge with a transition of the same subresource still waiting in the batch,
+	// A -> B followed by B -> C becomes A -> C and A -> B -> A disappears.
+	for (size_t i = _barriers.size(); i-- > 0;)
+	{
+		BARRIER& barrier = _barriers[i];
+		if (barrier.resource != resource)
+		{
+			continue;
+		}
+
+		if (barrier.type == BARRIER_UAV)
+		{
+			break;
+		}
+
+		if (barrier.subresource == subresource)
+		{
+			assert(barrier.after == before);
+			barrier.after = after;
+			if (barrier.before == barrier.after)
+			{
+				_barriers.erase(_barriers.begin() + i);
+			}
+			return;
+		}
+
+		// A whole resource barrier overlaps every subresource, keep the order.
+		if (barrier.subresource == RESOURCE_STATE::ALL_SUBRESOURCES || subresource == RESOURCE_STATE::ALL_SUBRESOURCES)
+		{
+			break;
+		}
+	}
+
+	_barriers.push_back(BARRIER{ BARRIER_TRANSITION, resource, subresource, before, after });
+}
+
+void RESOURCE_STATE_TRACKER::UAVBarrier(const void* resource)
+{
+	// Two UAV barriers in a row on the same resource synchronize nothing more.
+	if (_barriers.empty() == false && _barriers.back().type == BARRIER_UAV && _barriers.back().resource == resource)
+	{
+		return;
+	}
+
+	_barriers.push_back(BARRIER{ BARRIER_UAV, resource, RESOURCE_STATE::ALL_SUBRESOURCES, 0, 0 });
+}
+
+void RESOURCE_STATE_TRACKER::FlushBarriers(std::vector<BARRIER>& barriers)
+{
+	barriers.insert(barriers.end(), _barriers.begin(), _barriers.end());
+	_barriers.clear();
+}
+
+void RESOURCE_STATE_TRACKER::ResolvePendingBarriers(std::vector<BARRIER>& barriers) const
+{
+	for (const PENDING& pending : _pending)
+	{
+		auto it = _globalStates->_resources.find(pending.resource);
+		if (it == _globalStates->_resources.end())
+		{
+			continue;
+		}
+
+		const RESOURCE_STATE& current = it->second.state;
+		const RESOURCE_STATE& expected = pending.expected;
+
+		if (current.IsUniform() && expected.IsUniform())
+		{
+			if (current.state != expected.state)
+			{
+				barriers.push_back(BARRIER{ BARRIER_TRANSITION, pending.resource, RESOURCE_STATE::ALL_SUBRESOURCES, current.state, expected.state });
+			}
+			continue;
+		}
+
+		for (uint32_t i = 0; i < pending.subresourceCount; ++i)
+		{
+			uint32_t before = current.Get(i);
+			uint32_t after = expected.Get(i);
+			if (before != after)
+			{
+				barriers.push_back(BARRIER{ BARRIER_TRANSITION, pending.resource, i, before, after });
+			}
+		}
+	}
+}
+
+void RESOURCE_STATE_TRACKER::CommitFinalStates(std::vector<const void*>& decayed)
+{
+	assert(_barriers.empty() && "Barriers must be flushed before committing.");
+
+	for (auto& finalState : _finalStates)
+	{
+		auto it = _globalStates->_resources.find(finalState.first);
+		if (it == _globalStates->_resources.end())
+		{
+			continue;
+		}
+
+		it->second.state = finalState.second.state;
+		if (_decayAll || it->second.decaysToCommon)
+		{
+			decayed.push_back(finalState.first);
+		}
+	}
+
+	_pending.clear();
+	_finalStates.clear();
+}
+
+void RESOURCE_STATE_TRACKER::Reset()
+{
+	_barriers.clear();
+	_pending.clear();
+	_finalStates.clear();
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// States are D3D12_RESOURCE_STATES bit masks and resources are opaque keys,
+// so the tracking logic runs without a GPU.
+
+// State of every subresource of a resource.
+struct RESOURCE_STATE
+{
+	static const uint32_t ALL_SUBRESOURCES = 0xffffffff;	// D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES
+
+	uint32_t						state = 0;			// State of the subresources missing from 'subresourceStates'
+	std::map<uint32_t, uint32_t>	subresourceStates;
+
+	inline bool IsUniform() const { return subresourceStates.empty(); }
+	uint32_t Get(uint32_t subresource) const;
+	void Set(uint32_t subresource, uint32_t newState, uint32_t subresourceCount);
+};
+
+// States of the resources at the end of the last submitted command list.
+class GLOBAL_RESOURCE_STATES
+{
+public:
+	// Buffers and simultaneous access textures decay to COMMON after each submission.
+	void Add(const void* resource, uint32_t state, uint32_t subresourceCount, bool decaysToCommon);
+	void Remove(const void* resource);
+
+	// Returns false when the resource is not tracked.
+	bool Get(const void* resource, RESOURCE_STATE& state);
+
+	// Held while resolving and committing the states of the submitted lists.
+	inline std::unique_lock<std::mutex> Lock() { return std::unique_lock<std::mutex>(_mutex); }
+
+	// Moves the resources back to COMMON once a whole submission is committed, the lock must be held.
+	void Decay(const std::vector<const void*>& resources);
+
+private:
+	friend class RESOURCE_STATE_TRACKER;
+
+	struct ENTRY
+	{
+		RESOURCE_STATE	state;
+		uint32_t		subresourceCount;
+		bool			decaysToCommon;
+	};
+
+	std::mutex								_mutex;
+	std::unordered_map<const void*, ENTRY>	_resources;
+};
+
+// Per command list state tracking.
+// Transitions are batched and merged until FlushBarriers(), so a resource moved
+// A -> B -> C between two draws costs a single A -> C barrier. The first use of a
+// resource in the list assumes the global state read at record time, the
+// assumption is checked when the list is submitted and fixed up if another
+// list changed the state in between.
+class RESOURCE_STATE_TRACKER
+{
+public:
+	enum BARRIER_TYPE
+	{
+		BARRIER_TRANSITION,
+		BARRIER_UAV
+	};
+
+	struct BARRIER
+	{
+		BARRIER_TYPE	type;
+		const void*		resource;
+		uint32_t		subresource;
+		uint32_t		before;
+		uint32_t		after;
+	};
+
+	// Lists executed on a copy queue decay every resource they touch back to COMMON.
+	RESOURCE_STATE_TRACKER(GLOBAL_RESOURCE_STATES* globalStates, bool decayAll = false);
+
+	// Untracked resources are ignored.
+	void TransitionResource(const void* resource, uint32_t subresourceCount, uint32_t state, uint32_t subresource = RESOURCE_STATE::ALL_SUBRESOURCES);
+	void UAVBarrier(const void* resource);
+
+	// Barriers to record before the next draw, dispatch or copy.
+	void FlushBarriers(std::vector<BARRIER>& barriers);
+	inline bool HasBarriers() const { return _barriers.empty() == false; }
+
+	// Called when submitting, with the global states locked.
+	// Appends the barriers moving the resources from their current global state
+	// to the state this list assumed on first use, does not modify the tracker.
+	void ResolvePendingBarriers(std::vector<BARRIER>& barriers) const;
+	// Publishes the final states of the list, resources that decay are appended to 'decayed'.
+	void CommitFinalStates(std::vector<const void*>& decayed);
+
+	void Reset();
+
+private:
+	void AddTransition(const void* resource, uint32_t subresource, uint32_t before, uint32_t after);
+
+	struct PENDING
+	{
+		const void*		resource;
+		uint32_t		subresourceCount;
+		RESOURCE_STATE	expected;
+	};
+
+	GLOBAL_RESOURCE_STATES*	_globalStates = nullptr;
+	bool					_decayAll = false;
+
+	std::vector<BARRIER>	_barriers;
+	std::vector<PENDING>	_pending;
+
+	struct FINAL_STATE
+	{
+		RESOURCE_STATE	state;
+		uint32_t		subresourceCount;
+	};
+	std::unordered_map<const void*, FINAL_STATE>	_finalStates;
+};
\ No newline at end of file
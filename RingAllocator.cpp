@@ -0,0 +1,93 @@
+#include "RingAllocator.h"
+
+#include <cassert>
+
+const uint64_t RING_ALLOCATOR::INVALID_OFFSET;
+
+static inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+RING_ALLOCATOR::RING_ALLOCATOR(uint64_t capacity) :
+	_capacity(capacity)
+{
+}
+
+uint64_t RING_ALLOCATOR::Allocate(uint64_t size, uint64_t alignment)
+{
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "Alignment must be a power of two.");
+
+	// Restart from the beginning when the ring is empty, keeps big allocations possible.
+	if (_usedSize == 0)
+	{
+		_head = 0;
+		_tail = 0;
+	}
+
+	uint64_t offset = INVALID_OFFSET;
+	bool wrapped = false;
+	uint64_t alignedHead = AlignUp(_head, alignment);
+
+	if (_head >= _tail && _usedSize < _capacity)
+	{
+		// Free space is [head, capacity) followed by [0, tail)
+		if (alignedHead + size <= _capacity)
+		{
+			offset = alignedHead;
+		}
+		else if (size <= _tail)
+		{
+			wrapped = true;
+			offset = 0;
+		}
+	}
+	else if (_head < _tail && alignedHead + size <= _tail)
+	{
+		// Free space is [head, tail)
+		offset = alignedHead;
+	}
+
+	if (offset == INVALID_OFFSET)
+	{
+		_statistics.failedAllocationCount++;
+		return INVALID_OFFSET;
+	}
+
+	uint64_t wrapBytes = wrapped ? _capacity - _head : 0;
+	uint64_t paddingBytes = wrapped ? 0 : alignedHead - _head;
+	uint64_t consumedBytes = wrapBytes + paddingBytes + size;
+
+	_head = offset + size;
+	_usedSize += consumedBytes;
+	_currentFrameSize += consumedBytes;
+
+	_statistics.allocationCount++;
+	_statistics.requestedBytes += size;
+	_statistics.paddingBytes += paddingBytes;
+	_statistics.wrapBytes += wrapBytes;
+
+	return offset;
+}
+
+void RING_ALLOCATOR::FinishFrame(uint64_t fenceValue)
+{
+	if (_currentFrameSize > 0)
+	{
+		_frames.push(FRAME{ fenceValue, _head, _currentFrameSize });
+		_currentFrameSize = 0;
+	}
+}
+
+void RING_ALLOCATOR::Retire(uint64_t completedFenceValue)
+{
+	while (_frames.empty() == false && _frames.front().fenceValue <= completedFenceValue)
+	{
+		const FRAME& frame = _frames.front();
+		assert(_usedSize >= frame.size);
+
+		_tail = frame.head;
+		_usedSize -= frame.size;
+		_frames.pop();
+	}
+}
\ No newline at end of file
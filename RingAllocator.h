@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <queue>
+
+// Bump allocator over a fixed size ring.
+// Allocations made between two FinishFrame() calls are released together
+// once the fence value passed to FinishFrame() completed. Works on offsets
+// only, the memory itself is owned by the caller (e.g. a mapped upload heap).
+class RING_ALLOCATOR
+{
+public:
+	static const uint64_t INVALID_OFFSET = UINT64_MAX;
+
+	struct STATISTICS
+	{
+		uint64_t allocationCount = 0;
+		uint64_t failedAllocationCount = 0;
+		uint64_t requestedBytes = 0;	// Bytes asked by the callers
+		uint64_t paddingBytes = 0;		// Bytes lost to alignment
+		uint64_t wrapBytes = 0;			// Bytes skipped at the end of the ring when wrapping around
+
+		// Part of the consumed ring space which was not handed out to callers.
+		double GetFragmentation() const
+		{
+			uint64_t consumedBytes = requestedBytes + paddingBytes + wrapBytes;
+			return consumedBytes > 0 ? static_cast<double>(paddingBytes + wrapBytes) / consumedBytes : 0.0;
+		}
+	};
+
+	RING_ALLOCATOR(uint64_t capacity);
+
+	// Returns INVALID_OFFSET when the ring is full, alignment must be a power of two.
+	uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+	// Every allocation since the previous call is owned by 'fenceValue'.
+	void FinishFrame(uint64_t fenceValue);
+	// Releases the frames whose fence value completed.
+	void Retire(uint64_t completedFenceValue);
+
+	inline bool HasPendingFrames() const { return _frames.empty() == false; }
+	inline uint64_t GetOldestFenceValue() const { return _frames.empty() ? 0 : _frames.front().fenceValue; }
+
+	inline uint64_t GetCapacity() const { return _capacity; }
+	inline uint64_t GetUsedSize() const { return _usedSize; }
+	inline const STATISTICS& GetStatistics() const { return _statistics; }
+
+private:
+	struct FRAME
+	{
+		uint64_t fenceValue;
+		uint64_t head;	// Head of the ring when the frame finished, becomes the tail once retired
+		uint64_t size;
+	};
+
+	std::queue<FRAME>	_frames;
+
+	uint64_t	_capacity = 0;
+	uint64_t	_head = 0;
+	uint64_t	_tail = 0;
+	uint64_t	_usedSize = 0;
+	uint64_t	_currentFrameSize = 0;
+
+	STATISTICS	_statistics;
+};
\ No newline at end of file
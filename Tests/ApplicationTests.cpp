@@ -0,0 +1,165 @@
+#include "Application.h"
+#include "CommandQueue.h"
+#include "FrameScheduler.h"
+#include "Game.h"
+#include "Window.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+// Resource states, D3D12_RESOURCE_STATES values.
+const uint32_t STATE_PRESENT = 0x0;
+const uint32_t STATE_RENDER_TARGET = 0x4;
+
+// Renders 'frameCount' frames the way TUTORIAL does, then closes its window.
+class HEADLESS_GAME : public GAME
+{
+public:
+	HEADLESS_GAME(uint64_t frameCount) :
+		GAME(L"Headless", 1280, 720, false),
+		_frameCount(frameCount)
+	{
+	}
+
+	virtual bool LoadContent() override
+	{
+		for (int& backBuffer : _backBuffers)
+		{
+			APPLICATION::Instance()->GetDevice()->RegisterResourceState(&backBuffer, STATE_PRESENT);
+		}
+		return true;
+	}
+
+	virtual void UnloadContent() override
+	{
+		for (int& backBuffer : _backBuffers)
+		{
+			APPLICATION::Instance()->GetDevice()->UnregisterResourceState(&backBuffer);
+		}
+	}
+
+	uint64_t			updates = 0;
+	uint64_t			renders = 0;
+	uint64_t			executedFrames = 0;	// Counted on the queue thread
+	uint64_t			maxFramesAhead = 0;	// Frames submitted but not complete when a frame begins
+	uint64_t			retiredFrames = 0;
+	uint64_t			earlyRetires = 0;	// Frames retired before their fence value completed
+	std::vector<uint32_t>	backBufferIndices;
+
+protected:
+	virtual void OnUpdate(UpdateEventArgs&) override
+	{
+		updates++;
+	}
+
+	virtual void OnRender(RenderEventArgs&) override
+	{
+		APPLICATION* application = APPLICATION::Instance();
+		FRAME_SCHEDULER* frameScheduler = application->GetFrameScheduler();
+		COMMAND_QUEUE* commandQueue = application->GetCommandQueue();
+
+		frameScheduler->BeginFrame();
+		maxFramesAhead = std::max(maxFramesAhead, _lastFenceValue - commandQueue->GetCompletedFenceValue());
+
+		int* backBuffer = &_backBuffers[_window->GetCurrentBackBufferIndex()];
+		backBufferIndices.push_back(_window->GetCurrentBackBufferIndex());
+
+		COMMAND_QUEUE::LIST commandList = commandQueue->GetCommandList();
+		commandList->TransitionResource(backBuffer, 1, STATE_RENDER_TARGET);
+		commandList->Record([this]() { executedFrames++; });
+		commandList->TransitionResource(backBuffer, 1, STATE_PRESENT);
+
+		_lastFenceValue = commandQueue->ExecuteCommandList(commandList);
+		_window->Present();
+
+		// Recycles per-frame memory the way TUTORIAL does.
+		uint64_t fenceValue = _lastFenceValue;
+		frameScheduler->OnFrameRetired([this, commandQueue, fenceValue]()
+		{
+			retiredFrames++;
+			if (commandQueue->GetCompletedFenceValue() < fenceValue)
+			{
+				earlyRetires++;
+			}
+		});
+		frameScheduler->EndFrame(_lastFenceValue);
+
+		if (++renders == _frameCount)
+		{
+			_window->Close();
+		}
+	}
+
+private:
+	uint64_t	_frameCount = 0;
+	uint64_t	_lastFenceValue = 0;
+	int			_backBuffers[g_numFrames] = {};
+};
+
+class ApplicationTest : public ::testing::Test
+{
+protected:
+	virtual void SetUp() override
+	{
+		_application = APPLICATION::CreateInstance();
+	}
+
+	virtual void TearDown() override
+	{
+		APPLICATION::DeleteInstance();
+	}
+
+	APPLICATION* _application = nullptr;
+};
+
+TEST_F(ApplicationTest, RunsTheFrameLoopUntilTheWindowCloses)
+{
+	std::shared_ptr<HEADLESS_GAME> game = std::make_shared<HEADLESS_GAME>(10);
+
+	EXPECT_EQ(_application->Run(game), 0);
+
+	EXPECT_EQ(game->updates, 10u);
+	EXPECT_EQ(game->renders, 10u);
+	EXPECT_EQ(game->executedFrames, 10u);
+	EXPECT_TRUE(WINDOW::gs_Windows.empty());
+
+	// Back buffers are used round robin.
+	for (size_t i = 0; i < game->backBufferIndices.size(); ++i)
+	{
+		EXPECT_EQ(game->backBufferIndices[i], i % g_numFrames);
+	}
+
+	// Each frame moves its back buffer to RENDER_TARGET and back to PRESENT.
+	NULL_QUEUE_DEVICE::STATISTICS statistics = _application->GetCommandQueue()->GetDevice().GetStatistics();
+	EXPECT_EQ(statistics.executedLists, 10u);
+	EXPECT_EQ(statistics.executedBarriers, 20u);
+}
+
+class ApplicationFramesInFlightTest : public ApplicationTest, public ::testing::WithParamInterface<uint32_t>
+{
+};
+
+TEST_P(ApplicationFramesInFlightTest, NeverRunsMoreThanTheFramesInFlightAhead)
+{
+	uint32_t framesInFlight = GetParam();
+	_application->SetFramesInFlight(framesInFlight);
+	_application->GetDevice()->SetGpuTimePerList(std::chrono::milliseconds(1));
+
+	std::shared_ptr<HEADLESS_GAME> game = std::make_shared<HEADLESS_GAME>(30);
+	EXPECT_EQ(_application->Run(game), 0);
+
+	// The GPU is slower than the CPU, the scheduler is the only thing holding the CPU back.
+	EXPECT_LE(game->maxFramesAhead, framesInFlight - 1);
+	if (framesInFlight > 1)
+	{
+		EXPECT_GE(game->maxFramesAhead, 1u);
+	}
+	EXPECT_EQ(_application->GetFrameScheduler()->GetStatistics().frameCount, 30u);
+
+	// The flush before unloading retires the frames still in flight.
+	EXPECT_EQ(game->retiredFrames, 30u);
+	EXPECT_EQ(game->earlyRetires, 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P(FramesInFlight, ApplicationFramesInFlightTest, ::testing::Values(1u, 2u, 3u, FRAME_SCHEDULER::MAX_FRAMES_IN_FLIGHT));
@@ -0,0 +1,148 @@
+#include "BarrierTranslation.h"
+
+#include <gtest/gtest.h>
+
+// Resource states, D3D12_RESOURCE_STATES values.
+const uint32_t STATE_COMMON = 0x0;
+const uint32_t STATE_VERTEX_AND_CONSTANT_BUFFER = 0x1;
+const uint32_t STATE_INDEX_BUFFER = 0x2;
+const uint32_t STATE_RENDER_TARGET = 0x4;
+const uint32_t STATE_UNORDERED_ACCESS = 0x8;
+const uint32_t STATE_DEPTH_WRITE = 0x10;
+const uint32_t STATE_NON_PIXEL_SHADER_RESOURCE = 0x40;
+const uint32_t STATE_PIXEL_SHADER_RESOURCE = 0x80;
+const uint32_t STATE_INDIRECT_ARGUMENT = 0x200;
+const uint32_t STATE_COPY_DEST = 0x400;
+const uint32_t STATE_COPY_SOURCE = 0x800;
+const uint32_t STATE_GENERIC_READ = 0xac3;
+
+static RESOURCE_STATE_TRACKER::BARRIER Transition(uint32_t before, uint32_t after)
+{
+	static int resource = 0;
+	return RESOURCE_STATE_TRACKER::BARRIER{ RESOURCE_STATE_TRACKER::BARRIER_TRANSITION, &resource, 0, before, after };
+}
+
+struct ACCESS_CASE
+{
+	uint32_t state;
+	BARRIER_ACCESS_DESC texture;
+};
+
+// One row per single legacy state.
+TEST(BarrierTranslation, SingleStatesMapToTheirScope)
+{
+	const ACCESS_CASE cases[] =
+	{
+		{ STATE_COMMON,						{ BARRIER_SYNC_ALL, BARRIER_ACCESS_COMMON, BARRIER_LAYOUT_COMMON } },
+		{ STATE_VERTEX_AND_CONSTANT_BUFFER,	{ BARRIER_SYNC_ALL_SHADING, BARRIER_ACCESS_VERTEX_BUFFER | BARRIER_ACCESS_CONSTANT_BUFFER, BARRIER_LAYOUT_GENERIC_READ } },
+		{ STATE_RENDER_TARGET,				{ BARRIER_SYNC_RENDER_TARGET, BARRIER_ACCESS_RENDER_TARGET, BARRIER_LAYOUT_RENDER_TARGET } },
+		{ STATE_UNORDERED_ACCESS,			{ BARRIER_SYNC_ALL_SHADING, BARRIER_ACCESS_UNORDERED_ACCESS, BARRIER_LAYOUT_UNORDERED_ACCESS } },
+		{ STATE_DEPTH_WRITE,				{ BARRIER_SYNC_DEPTH_STENCIL, BARRIER_ACCESS_DEPTH_STENCIL_WRITE, BARRIER_LAYOUT_DEPTH_STENCIL_WRITE } },
+		{ STATE_PIXEL_SHADER_RESOURCE,		{ BARRIER_SYNC_PIXEL_SHADING, BARRIER_ACCESS_SHADER_RESOURCE, BARRIER_LAYOUT_SHADER_RESOURCE } },
+		{ STATE_INDIRECT_ARGUMENT,			{ BARRIER_SYNC_EXECUTE_INDIRECT, BARRIER_ACCESS_INDIRECT_ARGUMENT, BARRIER_LAYOUT_GENERIC_READ } },
+		{ STATE_COPY_DEST,					{ BARRIER_SYNC_COPY, BARRIER_ACCESS_COPY_DEST, BARRIER_LAYOUT_COPY_DEST } },
+		{ STATE_COPY_SOURCE,				{ BARRIER_SYNC_COPY, BARRIER_ACCESS_COPY_SOURCE, BARRIER_LAYOUT_COPY_SOURCE } },
+	};
+
+	for (const ACCESS_CASE& accessCase : cases)
+	{
+		SCOPED_TRACE(accessCase.state);
+
+		BARRIER_ACCESS_DESC texture = GetBarrierAccess(accessCase.state, true);
+		EXPECT_EQ(texture.sync, accessCase.texture.sync);
+		EXPECT_EQ(texture.access, accessCase.texture.access);
+		EXPECT_EQ(texture.layout, accessCase.texture.layout);
+
+		// Same scope, buffers have no layout.
+		BARRIER_ACCESS_DESC buffer = GetBarrierAccess(accessCase.state, false);
+		EXPECT_EQ(buffer.sync, accessCase.texture.sync);
+		EXPECT_EQ(buffer.access, accessCase.texture.access);
+		EXPECT_EQ(buffer.layout, static_cast<uint32_t>(BARRIER_LAYOUT_UNDEFINED));
+	}
+}
+
+TEST(BarrierTranslation, CombinedReadStatesUseTheGenericReadLayout)
+{
+	BARRIER_ACCESS_DESC shaderResource = GetBarrierAccess(STATE_NON_PIXEL_SHADER_RESOURCE | STATE_PIXEL_SHADER_RESOURCE, true);
+	EXPECT_EQ(shaderResource.sync, static_cast<uint32_t>(BARRIER_SYNC_ALL_SHADING));
+	EXPECT_EQ(shaderResource.access, static_cast<uint32_t>(BARRIER_ACCESS_SHADER_RESOURCE));
+	EXPECT_EQ(shaderResource.layout, static_cast<uint32_t>(BARRIER_LAYOUT_SHADER_RESOURCE));
+
+	BARRIER_ACCESS_DESC copyAndShader = GetBarrierAccess(STATE_PIXEL_SHADER_RESOURCE | STATE_COPY_SOURCE, true);
+	EXPECT_EQ(copyAndShader.sync, static_cast<uint32_t>(BARRIER_SYNC_PIXEL_SHADING | BARRIER_SYNC_COPY));
+	EXPECT_EQ(copyAndShader.access, static_cast<uint32_t>(BARRIER_ACCESS_SHADER_RESOURCE | BARRIER_ACCESS_COPY_SOURCE));
+	EXPECT_EQ(copyAndShader.layout, static_cast<uint32_t>(BARRIER_LAYOUT_GENERIC_READ));
+
+	BARRIER_ACCESS_DESC genericRead = GetBarrierAccess(STATE_GENERIC_READ, true);
+	EXPECT_EQ(genericRead.access, static_cast<uint32_t>(BARRIER_ACCESS_VERTEX_BUFFER | BARRIER_ACCESS_CONSTANT_BUFFER |
+		BARRIER_ACCESS_INDEX_BUFFER | BARRIER_ACCESS_SHADER_RESOURCE | BARRIER_ACCESS_INDIRECT_ARGUMENT | BARRIER_ACCESS_COPY_SOURCE));
+	EXPECT_EQ(genericRead.layout, static_cast<uint32_t>(BARRIER_LAYOUT_GENERIC_READ));
+	EXPECT_TRUE(genericRead.sync & BARRIER_SYNC_ALL_SHADING);
+	EXPECT_FALSE(genericRead.sync & (BARRIER_SYNC_PIXEL_SHADING | BARRIER_SYNC_NON_PIXEL_SHADING));
+}
+
+TEST(BarrierTranslation, ReadToReadIsElided)
+{
+	ENHANCED_BARRIER enhancedBarrier;
+
+	// Buffers have no layout, any read to read transition is free.
+	EXPECT_FALSE(TranslateBarrier(Transition(STATE_VERTEX_AND_CONSTANT_BUFFER, STATE_INDEX_BUFFER), false, enhancedBarrier));
+	EXPECT_FALSE(TranslateBarrier(Transition(STATE_PIXEL_SHADER_RESOURCE, STATE_GENERIC_READ), false, enhancedBarrier));
+
+	// Textures only when the layout stays.
+	EXPECT_FALSE(TranslateBarrier(Transition(STATE_PIXEL_SHADER_RESOURCE, STATE_NON_PIXEL_SHADER_RESOURCE), true, enhancedBarrier));
+	ASSERT_TRUE(TranslateBarrier(Transition(STATE_PIXEL_SHADER_RESOURCE, STATE_COPY_SOURCE), true, enhancedBarrier));
+	EXPECT_EQ(enhancedBarrier.layoutBefore, static_cast<uint32_t>(BARRIER_LAYOUT_SHADER_RESOURCE));
+	EXPECT_EQ(enhancedBarrier.layoutAfter, static_cast<uint32_t>(BARRIER_LAYOUT_COPY_SOURCE));
+}
+
+TEST(BarrierTranslation, CommonIsNeverElided)
+{
+	ENHANCED_BARRIER enhancedBarrier;
+
+	ASSERT_TRUE(TranslateBarrier(Transition(STATE_COMMON, STATE_COPY_SOURCE), false, enhancedBarrier));
+	EXPECT_EQ(enhancedBarrier.syncBefore, static_cast<uint32_t>(BARRIER_SYNC_ALL));
+	EXPECT_EQ(enhancedBarrier.accessBefore, static_cast<uint32_t>(BARRIER_ACCESS_COMMON));
+	EXPECT_EQ(enhancedBarrier.syncAfter, static_cast<uint32_t>(BARRIER_SYNC_COPY));
+	EXPECT_EQ(enhancedBarrier.layoutBefore, static_cast<uint32_t>(BARRIER_LAYOUT_UNDEFINED));
+
+	ASSERT_TRUE(TranslateBarrier(Transition(STATE_PIXEL_SHADER_RESOURCE, STATE_COMMON), true, enhancedBarrier));
+	EXPECT_EQ(enhancedBarrier.layoutBefore, static_cast<uint32_t>(BARRIER_LAYOUT_SHADER_RESOURCE));
+	EXPECT_EQ(enhancedBarrier.layoutAfter, static_cast<uint32_t>(BARRIER_LAYOUT_COMMON));
+}
+
+TEST(BarrierTranslation, WritesAreAlwaysTranslated)
+{
+	ENHANCED_BARRIER enhancedBarrier;
+
+	ASSERT_TRUE(TranslateBarrier(Transition(STATE_RENDER_TARGET, STATE_PIXEL_SHADER_RESOURCE), true, enhancedBarrier));
+	EXPECT_EQ(enhancedBarrier.syncBefore, static_cast<uint32_t>(BARRIER_SYNC_RENDER_TARGET));
+	EXPECT_EQ(enhancedBarrier.syncAfter, static_cast<uint32_t>(BARRIER_SYNC_PIXEL_SHADING));
+	EXPECT_EQ(enhancedBarrier.accessBefore, static_cast<uint32_t>(BARRIER_ACCESS_RENDER_TARGET));
+	EXPECT_EQ(enhancedBarrier.accessAfter, static_cast<uint32_t>(BARRIER_ACCESS_SHADER_RESOURCE));
+	EXPECT_EQ(enhancedBarrier.layoutBefore, static_cast<uint32_t>(BARRIER_LAYOUT_RENDER_TARGET));
+	EXPECT_EQ(enhancedBarrier.layoutAfter, static_cast<uint32_t>(BARRIER_LAYOUT_SHADER_RESOURCE));
+	EXPECT_TRUE(enhancedBarrier.texture);
+
+	EXPECT_TRUE(TranslateBarrier(Transition(STATE_COPY_DEST, STATE_VERTEX_AND_CONSTANT_BUFFER), false, enhancedBarrier));
+}
+
+TEST(BarrierTranslation, UAVBarriersKeepTheLayout)
+{
+	static int resource = 0;
+	RESOURCE_STATE_TRACKER::BARRIER barrier = { RESOURCE_STATE_TRACKER::BARRIER_UAV, &resource, RESOURCE_STATE::ALL_SUBRESOURCES, 0, 0 };
+
+	ENHANCED_BARRIER enhancedBarrier;
+	ASSERT_TRUE(TranslateBarrier(barrier, true, enhancedBarrier));
+	EXPECT_EQ(enhancedBarrier.resource, &resource);
+	EXPECT_EQ(enhancedBarrier.subresource, RESOURCE_STATE::ALL_SUBRESOURCES);
+	EXPECT_EQ(enhancedBarrier.syncBefore, static_cast<uint32_t>(BARRIER_SYNC_ALL_SHADING));
+	EXPECT_EQ(enhancedBarrier.syncAfter, static_cast<uint32_t>(BARRIER_SYNC_ALL_SHADING));
+	EXPECT_EQ(enhancedBarrier.accessBefore, static_cast<uint32_t>(BARRIER_ACCESS_UNORDERED_ACCESS));
+	EXPECT_EQ(enhancedBarrier.accessAfter, static_cast<uint32_t>(BARRIER_ACCESS_UNORDERED_ACCESS));
+	EXPECT_EQ(enhancedBarrier.layoutBefore, static_cast<uint32_t>(BARRIER_LAYOUT_UNORDERED_ACCESS));
+	EXPECT_EQ(enhancedBarrier.layoutAfter, static_cast<uint32_t>(BARRIER_LAYOUT_UNORDERED_ACCESS));
+
+	ASSERT_TRUE(TranslateBarrier(barrier, false, enhancedBarrier));
+	EXPECT_EQ(enhancedBarrier.layoutBefore, static_cast<uint32_t>(BARRIER_LAYOUT_UNDEFINED));
+}
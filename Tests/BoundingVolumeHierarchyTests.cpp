@@ -0,0 +1,159 @@
+#include "BoundingVolumeHierarchy.h"
+#include "JobSystem.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace VectorMath;
+
+// Above the parallel build threshold, so the job system builds subtrees.
+const uint32_t g_volumeCount = 20000;
+const uint32_t g_rayCount = 256;
+
+// Random boxes around the camera, 'moved' holds them a step further.
+static void CreateVolumes(BOUNDING_VOLUMES& volumes, BOUNDING_VOLUMES& moved)
+{
+	std::mt19937 random(17);
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> size(0.2f, 3.0f);
+	std::uniform_real_distribution<float> step(-5.0f, 5.0f);
+
+	volumes.Resize(g_volumeCount);
+	moved.Resize(g_volumeCount);
+	for (uint32_t i = 0; i < g_volumeCount; ++i)
+	{
+		float center[3] = { position(random), position(random), position(random) };
+		float extent[3] = { size(random), size(random), size(random) };
+		float radius = std::sqrt(extent[0] * extent[0] + extent[1] * extent[1] + extent[2] * extent[2]);
+		volumes.Set(i, center, extent, radius);
+
+		float movedCenter[3] = { center[0] + step(random), center[1] + step(random), center[2] + step(random) };
+		moved.Set(i, movedCenter, extent, radius);
+	}
+}
+
+static FRUSTUM CreateFrustum()
+{
+	MATRIX view = MatrixLookAtLH(VectorSet(0.0f, 0.0f, 0.0f, 1.0f), VectorSet(0.0f, 0.0f, 1.0f, 1.0f), VectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	MATRIX projection = MatrixPerspectiveFovLH(ConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+	return ExtractFrustum(MatrixMultiply(view, projection));
+}
+
+// Slab test of one box, entry distance or FLT_MAX when missed within [0, maxDistance].
+static float IntersectVolume(const BOUNDING_VOLUMES& volumes, uint32_t v, const float origin[3], const float direction[3], float maxDistance)
+{
+	const float center[3] = { volumes.centerX[v], volumes.centerY[v], volumes.centerZ[v] };
+	const float extent[3] = { volumes.extentX[v], volumes.extentY[v], volumes.extentZ[v] };
+
+	float entry = 0.0f;
+	float exit = maxDistance;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float inverseDirection = 1.0f / direction[axis];
+		float t0 = (center[axis] - extent[axis] - origin[axis]) * inverseDirection;
+		float t1 = (center[axis] + extent[axis] - origin[axis]) * inverseDirection;
+		entry = std::max(entry, std::min(t0, t1));
+		exit = std::min(exit, std::max(t0, t1));
+	}
+
+	return entry <= exit ? entry : FLT_MAX;
+}
+
+static void ExpectMatchesBruteForce(const BOUNDING_VOLUME_HIERARCHY& hierarchy, const BOUNDING_VOLUMES& volumes)
+{
+	ASSERT_EQ(hierarchy.GetPrimitiveCount(), volumes.count);
+
+	// Frustum query against the flat culling.
+	FRUSTUM frustum = CreateFrustum();
+
+	std::vector<uint32_t> expected(volumes.GetPaddedCount());
+	expected.resize(CullBoundingVolumes(frustum, volumes, 0, volumes.count, expected.data(), CULLING_ISA_SCALAR));
+	ASSERT_GT(expected.size(), 0u);
+
+	std::vector<uint32_t> visible(volumes.count);
+	visible.resize(hierarchy.QueryFrustum(frustum, visible.data()));
+	std::sort(visible.begin(), visible.end());
+	EXPECT_EQ(visible, expected);
+
+	// Rays against every box, the closest box may not be unique when the origin is inside several.
+	std::mt19937 random(19);
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+	uint32_t hitCount = 0;
+	for (uint32_t r = 0; r < g_rayCount; ++r)
+	{
+		const float origin[3] = { position(random), position(random), position(random) };
+		const float rayDirection[3] = { direction(random), direction(random), direction(random) };
+		const float maxDistance = r % 2 == 0 ? FLT_MAX : 20.0f;
+
+		float closest = FLT_MAX;
+		for (uint32_t v = 0; v < volumes.count; ++v)
+		{
+			closest = std::min(closest, IntersectVolume(volumes, v, origin, rayDirection, maxDistance));
+		}
+
+		RAY_HIT hit;
+		bool hasHit = hierarchy.Raycast(origin, rayDirection, maxDistance, hit);
+		ASSERT_EQ(hasHit, closest != FLT_MAX) << "ray " << r;
+		if (hasHit)
+		{
+			hitCount++;
+			EXPECT_EQ(hit.distance, closest) << "ray " << r;
+			ASSERT_LT(hit.primitive, volumes.count);
+			EXPECT_EQ(IntersectVolume(volumes, hit.primitive, origin, rayDirection, maxDistance), closest) << "ray " << r;
+		}
+	}
+
+	// Both hits and misses were tested.
+	EXPECT_GT(hitCount, 0u);
+	EXPECT_LT(hitCount, g_rayCount);
+}
+
+TEST(BoundingVolumeHierarchy, MatchesBruteForce)
+{
+	BOUNDING_VOLUMES volumes, moved;
+	CreateVolumes(volumes, moved);
+
+	BOUNDING_VOLUME_HIERARCHY hierarchy;
+	hierarchy.Build(volumes);
+	ExpectMatchesBruteForce(hierarchy, volumes);
+
+	hierarchy.Refit(moved);
+	ExpectMatchesBruteForce(hierarchy, moved);
+}
+
+TEST(BoundingVolumeHierarchy, ParallelBuildMatchesBruteForce)
+{
+	BOUNDING_VOLUMES volumes, moved;
+	CreateVolumes(volumes, moved);
+
+	JOB_SYSTEM jobSystem(3);
+	BOUNDING_VOLUME_HIERARCHY hierarchy;
+	hierarchy.Build(volumes, &jobSystem);
+	ExpectMatchesBruteForce(hierarchy, volumes);
+
+	hierarchy.Refit(moved);
+	ExpectMatchesBruteForce(hierarchy, moved);
+}
+
+TEST(BoundingVolumeHierarchy, EmptyHierarchyFindsNothing)
+{
+	BOUNDING_VOLUME_HIERARCHY hierarchy;
+	BOUNDING_VOLUMES volumes;
+	volumes.Resize(0);
+	hierarchy.Build(volumes);
+
+	uint32_t visible[1];
+	EXPECT_EQ(hierarchy.QueryFrustum(CreateFrustum(), visible), 0u);
+
+	const float origin[3] = { 0.0f, 0.0f, 0.0f };
+	const float direction[3] = { 0.0f, 0.0f, 1.0f };
+	RAY_HIT hit;
+	EXPECT_FALSE(hierarchy.Raycast(origin, direction, FLT_MAX, hit));
+}
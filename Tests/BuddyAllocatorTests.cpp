@@ -0,0 +1,111 @@
+#include "BuddyAllocator.h"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <map>
+#include <random>
+
+TEST(BuddyAllocator, SplitsAndCoalescesBuddies)
+{
+	BUDDY_ALLOCATOR allocator(1024, 64);
+
+	uint64_t a = allocator.Allocate(100, 1);
+	uint64_t b = allocator.Allocate(64, 1);
+	EXPECT_EQ(a, 0u);
+	EXPECT_EQ(allocator.GetAllocationSize(a), 128u);
+	EXPECT_EQ(b, 128u);
+	EXPECT_EQ(allocator.GetUsedSize(), 192u);
+
+	allocator.Free(a);
+	allocator.Free(b);
+	EXPECT_TRUE(allocator.IsEmpty());
+	EXPECT_EQ(allocator.GetStatistics().largestFreeBlock, 1024u);
+}
+
+TEST(BuddyAllocator, FailsWhenNoBlockIsLargeEnough)
+{
+	BUDDY_ALLOCATOR allocator(1024, 64);
+
+	EXPECT_EQ(allocator.Allocate(2048, 1), BUDDY_ALLOCATOR::INVALID_OFFSET);
+	EXPECT_EQ(allocator.Allocate(512, 1), 0u);
+	EXPECT_EQ(allocator.Allocate(512, 1), 512u);
+	EXPECT_EQ(allocator.Allocate(1, 1), BUDDY_ALLOCATOR::INVALID_OFFSET);
+}
+
+// Random allocations and frees with random alignments: every block is aligned, no two
+// live blocks overlap, and freeing everything coalesces back into the single level 0 block.
+TEST(BuddyAllocator, RandomAllocationsCoalesceBackToOneBlock)
+{
+	const uint64_t size = 1 << 20;
+	const uint64_t minBlockSize = 256;
+
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<uint64_t> sizes(1, size / 16);
+	std::uniform_int_distribution<int> alignmentShifts(0, 16);
+
+	for (int round = 0; round < 8; ++round)
+	{
+		BUDDY_ALLOCATOR allocator(size, minBlockSize);
+
+		// Offset to block size of the live allocations.
+		std::map<uint64_t, uint64_t> live;
+
+		for (int step = 0; step < 2000; ++step)
+		{
+			if (live.empty() == false && random() % 3 == 0)
+			{
+				auto it = live.begin();
+				std::advance(it, random() % live.size());
+				allocator.Free(it->first);
+				live.erase(it);
+				continue;
+			}
+
+			uint64_t requestedSize = sizes(random);
+			uint64_t alignment = 1ull << alignmentShifts(random);
+			uint64_t offset = allocator.Allocate(requestedSize, alignment);
+			if (offset == BUDDY_ALLOCATOR::INVALID_OFFSET)
+			{
+				continue;
+			}
+
+			uint64_t blockSize = allocator.GetAllocationSize(offset);
+			ASSERT_GE(blockSize, requestedSize);
+			ASSERT_GE(blockSize, minBlockSize);
+			ASSERT_EQ(offset % alignment, 0u);
+			ASSERT_EQ(offset % blockSize, 0u);
+			ASSERT_LE(offset + blockSize, size);
+
+			// The neighbours in offset order are the only ones which could overlap.
+			auto next = live.lower_bound(offset);
+			if (next != live.end())
+			{
+				ASSERT_LE(offset + blockSize, next->first);
+			}
+			if (next != live.begin())
+			{
+				auto previous = std::prev(next);
+				ASSERT_LE(previous->first + previous->second, offset);
+			}
+			live[offset] = blockSize;
+		}
+
+		uint64_t liveBytes = 0;
+		for (const auto& entry : live)
+		{
+			liveBytes += entry.second;
+		}
+		EXPECT_EQ(allocator.GetUsedSize(), liveBytes);
+
+		for (const auto& entry : live)
+		{
+			allocator.Free(entry.first);
+		}
+
+		EXPECT_TRUE(allocator.IsEmpty());
+		EXPECT_EQ(allocator.GetUsedSize(), 0u);
+		EXPECT_EQ(allocator.GetStatistics().largestFreeBlock, size);
+		EXPECT_EQ(allocator.Allocate(size, size), 0u);
+	}
+}
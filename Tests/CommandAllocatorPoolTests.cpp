@@ -0,0 +1,160 @@
+#include "CommandAllocatorPool.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+// Fence timeline of a queue without a GPU, Submit() hands out the next value and
+// Retire() plays the GPU reaching it.
+class SIMULATED_FENCE
+{
+public:
+	uint64_t Submit() { return ++_nextValue; }
+	void Retire(uint64_t value) { _completedValue = value; }
+	void RetireAll() { _completedValue = _nextValue; }
+
+	inline uint64_t GetCompletedValue() const { return _completedValue; }
+
+private:
+	uint64_t _nextValue = 0;
+	uint64_t _completedValue = 0;
+};
+
+// Allocators are move only, like a ComPtr the pool must not copy them.
+typedef std::unique_ptr<int> ALLOCATOR;
+typedef COMMAND_ALLOCATOR_POOL<ALLOCATOR> POOL;
+
+TEST(CommandAllocatorPool, CreatesUntilAnAllocatorRetired)
+{
+	SIMULATED_FENCE fence;
+	POOL pool(4);
+
+	ALLOCATOR allocator;
+	EXPECT_EQ(pool.Acquire(fence.GetCompletedValue(), allocator), POOL::ACQUIRE_CREATE);
+	pool.Release(std::make_unique<int>(0), fence.Submit());
+
+	// Still in flight.
+	EXPECT_EQ(pool.Acquire(fence.GetCompletedValue(), allocator), POOL::ACQUIRE_CREATE);
+	pool.Release(std::make_unique<int>(1), fence.Submit());
+
+	fence.Retire(1);
+	ASSERT_EQ(pool.Acquire(fence.GetCompletedValue(), allocator), POOL::ACQUIRE_REUSED);
+	EXPECT_EQ(*allocator, 0);
+
+	POOL::STATISTICS statistics = pool.GetStatistics();
+	EXPECT_EQ(statistics.allocations, 2u);
+	EXPECT_EQ(statistics.reuses, 1u);
+	EXPECT_EQ(statistics.stalls, 0u);
+	EXPECT_EQ(pool.GetAllocatorCount(), 2u);
+}
+
+TEST(CommandAllocatorPool, RecyclesInSubmissionOrder)
+{
+	SIMULATED_FENCE fence;
+	POOL pool(3);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		ALLOCATOR allocator;
+		ASSERT_EQ(pool.Acquire(fence.GetCompletedValue(), allocator), POOL::ACQUIRE_CREATE);
+		pool.Release(std::make_unique<int>(i), fence.Submit());
+	}
+	fence.RetireAll();
+
+	for (int i = 0; i < 3; ++i)
+	{
+		ALLOCATOR allocator;
+		ASSERT_EQ(pool.Acquire(fence.GetCompletedValue(), allocator), POOL::ACQUIRE_REUSED);
+		EXPECT_EQ(*allocator, i);
+	}
+}
+
+TEST(CommandAllocatorPool, StallsOnTheOldestFenceValueWhenFull)
+{
+	SIMULATED_FENCE fence;
+	POOL pool(2);
+
+	for (int i = 0; i < 2; ++i)
+	{
+		ALLOCATOR allocator;
+		ASSERT_EQ(pool.Acquire(fence.GetCompletedValue(), allocator), POOL::ACQUIRE_CREATE);
+		pool.Release(std::make_unique<int>(i), fence.Submit());
+	}
+
+	ALLOCATOR allocator;
+	EXPECT_EQ(pool.Acquire(fence.GetCompletedValue(), allocator), POOL::ACQUIRE_STALL);
+	EXPECT_EQ(pool.GetOldestFenceValue(), 1u);
+
+	// What the queue does on a stall: wait for the oldest value, then acquire again.
+	fence.Retire(pool.GetOldestFenceValue());
+	ASSERT_EQ(pool.Acquire(fence.GetCompletedValue(), allocator), POOL::ACQUIRE_REUSED);
+	EXPECT_EQ(*allocator, 0);
+	EXPECT_EQ(pool.GetOldestFenceValue(), 2u);
+
+	POOL::STATISTICS statistics = pool.GetStatistics();
+	EXPECT_EQ(statistics.allocations, 2u);
+	EXPECT_EQ(statistics.reuses, 1u);
+	EXPECT_EQ(statistics.stalls, 1u);
+	EXPECT_EQ(pool.GetAllocatorCount(), pool.GetMaxSize());
+}
+
+TEST(CommandAllocatorPool, ExceedsTheLimitRatherThanDeadlocking)
+{
+	SIMULATED_FENCE fence;
+	POOL pool(1);
+
+	// Every allocator is still being recorded, none was released to wait on.
+	std::vector<ALLOCATOR> recording(3);
+	for (ALLOCATOR& allocator : recording)
+	{
+		EXPECT_EQ(pool.Acquire(fence.GetCompletedValue(), allocator), POOL::ACQUIRE_CREATE);
+	}
+	EXPECT_EQ(pool.GetAllocatorCount(), 3u);
+	EXPECT_EQ(pool.GetOldestFenceValue(), 0u);
+	EXPECT_EQ(pool.GetStatistics().stalls, 0u);
+}
+
+TEST(CommandAllocatorPool, NeverHandsOutAnAllocatorInFlight)
+{
+	SIMULATED_FENCE fence;
+	POOL pool(4);
+
+	// Each frame records one list, the GPU runs three frames behind.
+	std::vector<uint64_t> submittedValues;
+	for (int frame = 0; frame < 64; ++frame)
+	{
+		if (frame >= 3)
+		{
+			fence.Retire(submittedValues[frame - 3]);
+		}
+
+		ALLOCATOR allocator;
+		POOL::ACQUIRE_RESULT result = pool.Acquire(fence.GetCompletedValue(), allocator);
+		while (result == POOL::ACQUIRE_STALL)
+		{
+			fence.Retire(pool.GetOldestFenceValue());
+			result = pool.Acquire(fence.GetCompletedValue(), allocator);
+		}
+
+		if (result == POOL::ACQUIRE_REUSED)
+		{
+			// The allocator remembers the fence value of its last submission.
+			EXPECT_LE(static_cast<uint64_t>(*allocator), fence.GetCompletedValue());
+		}
+		else
+		{
+			allocator = std::make_unique<int>(0);
+		}
+
+		uint64_t fenceValue = fence.Submit();
+		*allocator = static_cast<int>(fenceValue);
+		pool.Release(std::move(allocator), fenceValue);
+		submittedValues.push_back(fenceValue);
+	}
+
+	POOL::STATISTICS statistics = pool.GetStatistics();
+	EXPECT_EQ(statistics.allocations, 3u);
+	EXPECT_EQ(statistics.reuses, 61u);
+	EXPECT_EQ(statistics.stalls, 0u);
+}
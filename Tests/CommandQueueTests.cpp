@@ -0,0 +1,327 @@
+#include "CommandQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Holds the queue thread inside a command list until Open(), so the queue can be observed
+// while the GPU is busy.
+class GPU_GATE
+{
+public:
+	void Wait()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_condition.wait(lock, [this]() { return _open; });
+	}
+
+	void Open()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_open = true;
+		}
+		_condition.notify_all();
+	}
+
+private:
+	std::mutex				_mutex;
+	std::condition_variable	_condition;
+	bool					_open = false;
+};
+
+// Resource states, D3D12_RESOURCE_STATES values.
+const uint32_t STATE_COMMON = 0x0;
+const uint32_t STATE_RENDER_TARGET = 0x4;
+const uint32_t STATE_COPY_DEST = 0x400;
+
+TEST(CommandQueue, ExecutesListsInSubmissionOrder)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT);
+
+	std::vector<int> executed;
+	for (int i = 0; i < 8; ++i)
+	{
+		COMMAND_QUEUE::LIST commandList = queue.GetCommandList();
+		commandList->Record([&executed, i]() { executed.push_back(i); });
+
+		EXPECT_EQ(queue.ExecuteCommandList(commandList), static_cast<uint64_t>(i + 1));
+	}
+	queue.Flush();
+
+	EXPECT_EQ(executed, std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+}
+
+TEST(CommandQueue, BatchesListsInASingleSubmission)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT);
+
+	std::vector<COMMAND_QUEUE::LIST> commandLists;
+	for (int i = 0; i < 4; ++i)
+	{
+		commandLists.push_back(queue.GetCommandList());
+	}
+
+	uint64_t fenceValue = queue.ExecuteCommandLists(commandLists);
+	queue.WaitForFenceValue(fenceValue);
+
+	NULL_QUEUE_DEVICE::STATISTICS statistics = queue.GetDevice().GetStatistics();
+	EXPECT_EQ(fenceValue, 1u);
+	EXPECT_EQ(statistics.executeCalls, 1u);
+	EXPECT_EQ(statistics.executedLists, 4u);
+	EXPECT_EQ(statistics.signals, 1u);
+}
+
+TEST(CommandQueue, FenceCompletesOnceTheQueueRanTheList)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT);
+
+	GPU_GATE gate;
+	COMMAND_QUEUE::LIST commandList = queue.GetCommandList();
+	commandList->Record([&gate]() { gate.Wait(); });
+	uint64_t fenceValue = queue.ExecuteCommandList(commandList);
+
+	EXPECT_FALSE(queue.IsFenceComplete(fenceValue));
+	EXPECT_FALSE(static_cast<SOFTWARE_FENCE&>(queue.GetFence()).Wait(fenceValue, std::chrono::milliseconds(10)));
+
+	gate.Open();
+	queue.WaitForFenceValue(fenceValue);
+
+	EXPECT_TRUE(queue.IsFenceComplete(fenceValue));
+	EXPECT_EQ(queue.GetCompletedFenceValue(), fenceValue);
+}
+
+TEST(CommandQueue, RecyclesAllocatorsOnceRetired)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT, 2);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		queue.WaitForFenceValue(queue.ExecuteCommandList(queue.GetCommandList()));
+	}
+
+	COMMAND_QUEUE::ALLOCATOR_POOL::STATISTICS statistics = queue.GetAllocatorStatistics();
+	EXPECT_EQ(statistics.allocations, 1u);
+	EXPECT_EQ(statistics.reuses, 9u);
+	EXPECT_EQ(statistics.stalls, 0u);
+}
+
+TEST(CommandQueue, DiscardedListsAreRecycledWithoutSubmission)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT, 2);
+
+	bool executed = false;
+	COMMAND_QUEUE::LIST commandList = queue.GetCommandList();
+	commandList->Record([&executed]() { executed = true; });
+	queue.DiscardCommandList(commandList);
+
+	EXPECT_EQ(queue.GetLastSignaledFenceValue(), 0u);
+
+	// The allocator is free again right away, nothing was submitted with it.
+	queue.WaitForFenceValue(queue.ExecuteCommandList(queue.GetCommandList()));
+
+	EXPECT_FALSE(executed);
+	EXPECT_EQ(queue.GetDevice().GetStatistics().executedLists, 1u);
+
+	COMMAND_QUEUE::ALLOCATOR_POOL::STATISTICS statistics = queue.GetAllocatorStatistics();
+	EXPECT_EQ(statistics.allocations, 1u);
+	EXPECT_EQ(statistics.reuses, 1u);
+	EXPECT_EQ(statistics.stalls, 0u);
+}
+
+TEST(CommandQueue, StallsOnTheOldestAllocatorWhenThePoolIsFull)
+{
+	NULL_DEVICE device(std::chrono::milliseconds(10));
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT, 2);
+
+	uint64_t fenceValue = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		fenceValue = queue.ExecuteCommandList(queue.GetCommandList());
+	}
+	queue.WaitForFenceValue(fenceValue);
+
+	COMMAND_QUEUE::ALLOCATOR_POOL::STATISTICS statistics = queue.GetAllocatorStatistics();
+	EXPECT_EQ(statistics.allocations, 2u);
+	EXPECT_EQ(statistics.reuses, 2u);
+	EXPECT_GE(statistics.stalls, 1u);
+}
+
+TEST(CommandQueue, DeferredReleasesRunOnceTheWorkCompleted)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT);
+
+	GPU_GATE gate;
+	COMMAND_QUEUE::LIST commandList = queue.GetCommandList();
+	commandList->Record([&gate]() { gate.Wait(); });
+	queue.ExecuteCommandList(commandList);
+
+	bool released = false;
+	queue.ReleaseDeferred(256, [&released]() { released = true; });
+	queue.CollectDeferredReleases();
+	EXPECT_FALSE(released);
+	EXPECT_EQ(queue.GetDeferredReleaseStatistics().pendingBytes, 256u);
+
+	gate.Open();
+	queue.Flush();
+
+	EXPECT_TRUE(released);
+	EXPECT_EQ(queue.GetDeferredReleaseStatistics().pendingBytes, 0u);
+}
+
+TEST(CommandQueue, CompletionCallbacksAndFutures)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT);
+
+	GPU_GATE gate;
+	COMMAND_QUEUE::LIST commandList = queue.GetCommandList();
+	commandList->Record([&gate]() { gate.Wait(); });
+	uint64_t fenceValue = queue.ExecuteCommandList(commandList);
+
+	std::atomic<bool> called{ false };
+	queue.OnFenceCompletion(fenceValue, [&called]() { called = true; });
+	std::future<void> future = queue.GetFenceFuture(fenceValue);
+
+	EXPECT_EQ(future.wait_for(std::chrono::milliseconds(10)), std::future_status::timeout);
+
+	gate.Open();
+	future.wait();
+	queue.Flush();
+
+	EXPECT_TRUE(called);
+}
+
+TEST(CommandQueue, WaitOrdersWorkAcrossQueues)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE directQueue(&device, NULL_COMMAND_LIST_TYPE_DIRECT);
+	COMMAND_QUEUE computeQueue(&device, NULL_COMMAND_LIST_TYPE_COMPUTE);
+
+	GPU_GATE gate;
+	std::atomic<bool> computeDone{ false };
+	COMMAND_QUEUE::LIST computeList = computeQueue.GetCommandList();
+	computeList->Record([&gate, &computeDone]() { gate.Wait(); computeDone = true; });
+	uint64_t computeValue = computeQueue.ExecuteCommandList(computeList);
+
+	directQueue.Wait(computeQueue, computeValue);
+
+	// Already covered by the previous wait.
+	directQueue.Wait(computeQueue, computeValue);
+
+	bool sawComputeDone = false;
+	COMMAND_QUEUE::LIST directList = directQueue.GetCommandList();
+	directList->Record([&computeDone, &sawComputeDone]() { sawComputeDone = computeDone; });
+	uint64_t directValue = directQueue.ExecuteCommandList(directList);
+
+	EXPECT_FALSE(static_cast<SOFTWARE_FENCE&>(directQueue.GetFence()).Wait(directValue, std::chrono::milliseconds(10)));
+
+	gate.Open();
+	directQueue.Flush();
+
+	EXPECT_TRUE(sawComputeDone);
+	EXPECT_EQ(directQueue.GetDevice().GetStatistics().waits, 1u);
+
+	// Completed values are never waited on the GPU.
+	directQueue.Wait(computeQueue, computeValue);
+	directQueue.Flush();
+	EXPECT_EQ(directQueue.GetDevice().GetStatistics().waits, 1u);
+}
+
+TEST(CommandQueue, StaleStatesGetAFixUpList)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT);
+
+	int texture = 0;
+	device.RegisterResourceState(&texture, STATE_COMMON);
+
+	// Both lists are recorded against COMMON, the second one submitted sees COPY_DEST.
+	COMMAND_QUEUE::LIST renderList = queue.GetCommandList();
+	renderList->TransitionResource(&texture, 1, STATE_RENDER_TARGET);
+	renderList->Record(nullptr);
+
+	COMMAND_QUEUE::LIST copyList = queue.GetCommandList();
+	copyList->TransitionResource(&texture, 1, STATE_COPY_DEST);
+	copyList->Record(nullptr);
+
+	queue.ExecuteCommandList(copyList);
+	queue.ExecuteCommandList(renderList);
+	queue.Flush();
+
+	NULL_QUEUE_DEVICE::STATISTICS statistics = queue.GetDevice().GetStatistics();
+	EXPECT_EQ(statistics.executedLists, 3u);
+	EXPECT_EQ(statistics.executedBarriers, 3u);
+
+	RESOURCE_STATE state;
+	ASSERT_TRUE(device.GetGlobalResourceStates().Get(&texture, state));
+	EXPECT_EQ(state.state, STATE_RENDER_TARGET);
+
+	device.UnregisterResourceState(&texture);
+}
+
+TEST(CommandQueue, CopyQueuesDecayStatesToCommon)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE copyQueue(&device, NULL_COMMAND_LIST_TYPE_COPY);
+
+	int buffer = 0;
+	device.RegisterResourceState(&buffer, STATE_COMMON);
+
+	COMMAND_QUEUE::LIST commandList = copyQueue.GetCommandList();
+	commandList->TransitionResource(&buffer, 1, STATE_COPY_DEST);
+	commandList->Record(nullptr);
+
+	EXPECT_EQ(commandList->GetRecordedBarriers().size(), 1u);
+
+	copyQueue.ExecuteCommandList(commandList);
+	copyQueue.Flush();
+
+	RESOURCE_STATE state;
+	ASSERT_TRUE(device.GetGlobalResourceStates().Get(&buffer, state));
+	EXPECT_EQ(state.state, STATE_COMMON);
+
+	device.UnregisterResourceState(&buffer);
+}
+
+TEST(CommandQueue, RecordsFromSeveralThreads)
+{
+	NULL_DEVICE device;
+	COMMAND_QUEUE queue(&device, NULL_COMMAND_LIST_TYPE_DIRECT);
+
+	const int threadCount = 4;
+	const int listsPerThread = 32;
+
+	std::atomic<int> executed{ 0 };
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&queue, &executed]()
+		{
+			for (int i = 0; i < listsPerThread; ++i)
+			{
+				COMMAND_QUEUE::LIST commandList = queue.GetCommandList();
+				commandList->Record([&executed]() { executed++; });
+				queue.ExecuteCommandList(commandList);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	queue.Flush();
+
+	EXPECT_EQ(executed, threadCount * listsPerThread);
+	EXPECT_EQ(queue.GetCompletedFenceValue(), static_cast<uint64_t>(threadCount * listsPerThread + 1));
+}
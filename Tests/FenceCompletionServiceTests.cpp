@@ -0,0 +1,124 @@
+#include "FenceCompletionService.h"
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(SoftwareFence, TimedWaitTimesOutBeforeTheValue)
+{
+	SOFTWARE_FENCE fence;
+	fence.Signal(1);
+
+	EXPECT_TRUE(fence.Wait(1, std::chrono::milliseconds(0)));
+	EXPECT_FALSE(fence.Wait(2, std::chrono::milliseconds(10)));
+}
+
+TEST(SoftwareFence, TimedWaitReturnsOnceSignaled)
+{
+	SOFTWARE_FENCE fence;
+
+	std::thread signaler([&fence]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		fence.Signal(3);
+	});
+
+	EXPECT_TRUE(fence.Wait(3, std::chrono::milliseconds::max()));
+	EXPECT_EQ(fence.GetCompletedValue(), 3u);
+
+	signaler.join();
+}
+
+TEST(SoftwareFence, TimedWaitIsNotInterruptible)
+{
+	SOFTWARE_FENCE fence;
+	fence.Interrupt();
+
+	EXPECT_FALSE(fence.Wait(1, std::chrono::milliseconds(10)));
+
+	// The interrupt is still pending for the interruptible wait.
+	fence.Wait(1);
+	EXPECT_EQ(fence.GetCompletedValue(), 0u);
+}
+
+TEST(FenceCompletionService, RetiresOutOfOrderRegistrationsInFenceOrder)
+{
+	SOFTWARE_FENCE fence;
+	FENCE_COMPLETION_SERVICE service(&fence);
+
+	std::mutex mutex;
+	std::vector<uint64_t> retired;
+	std::vector<std::thread::id> threads;
+	auto record = [&](uint64_t value)
+	{
+		return [&, value]()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			retired.push_back(value);
+			threads.push_back(std::this_thread::get_id());
+		};
+	};
+
+	service.OnCompletion(5, record(5));
+	// Give the service time to block on 5, the older values below must interrupt it.
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	service.OnCompletion(2, record(2));
+	service.OnCompletion(3, record(3));
+	service.OnCompletion(2, record(2));
+
+	std::future<void> second = service.GetFuture(2);
+	fence.Signal(2);
+	ASSERT_EQ(second.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		EXPECT_EQ(retired, (std::vector<uint64_t>{ 2, 2 }));
+	}
+
+	std::future<void> fifth = service.GetFuture(5);
+	fence.Signal(5);
+	ASSERT_EQ(fifth.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	EXPECT_EQ(retired, (std::vector<uint64_t>{ 2, 2, 3, 5 }));
+	for (std::thread::id thread : threads)
+	{
+		EXPECT_NE(thread, std::this_thread::get_id());
+		EXPECT_EQ(thread, threads.front());
+	}
+	EXPECT_EQ(service.GetPendingCount(), 0u);
+}
+
+TEST(FenceCompletionService, ResolvesFuturesOfCompletedValues)
+{
+	SOFTWARE_FENCE fence;
+	fence.Signal(4);
+
+	FENCE_COMPLETION_SERVICE service(&fence);
+
+	std::future<void> past = service.GetFuture(3);
+	std::future<void> current = service.GetFuture(4);
+
+	EXPECT_EQ(past.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+	EXPECT_EQ(current.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+}
+
+TEST(FenceCompletionService, ShutsDownWithPendingCallbacks)
+{
+	SOFTWARE_FENCE fence;
+	bool called = false;
+	std::future<void> future;
+	{
+		FENCE_COMPLETION_SERVICE service(&fence);
+		service.OnCompletion(10, [&called]() { called = true; });
+		future = service.GetFuture(10);
+
+		EXPECT_EQ(service.GetPendingCount(), 2u);
+	}
+
+	// Never signalled: the callbacks are dropped and the promise is broken.
+	EXPECT_FALSE(called);
+	ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+	EXPECT_THROW(future.get(), std::future_error);
+}
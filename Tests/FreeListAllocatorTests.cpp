@@ -0,0 +1,121 @@
+#include "FreeListAllocator.h"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <map>
+#include <random>
+
+TEST(FreeListAllocator, AllocatesFromTheSmallestRangeLargeEnough)
+{
+	FREE_LIST_ALLOCATOR allocator(100);
+
+	// Leaves free ranges of 10 at 0, 5 at 20 and 65 at 35.
+	EXPECT_EQ(allocator.Allocate(10), 0u);
+	EXPECT_EQ(allocator.Allocate(10), 10u);
+	EXPECT_EQ(allocator.Allocate(5), 20u);
+	EXPECT_EQ(allocator.Allocate(10), 25u);
+	allocator.Free(0, 10);
+	allocator.Free(20, 5);
+	EXPECT_EQ(allocator.GetFreeRangeCount(), 3u);
+
+	// Best fit, not the first range which fits.
+	EXPECT_EQ(allocator.Allocate(4), 20u);
+	EXPECT_EQ(allocator.Allocate(8), 0u);
+	EXPECT_EQ(allocator.Allocate(20), 35u);
+	EXPECT_EQ(allocator.GetLargestFreeRange(), 45u);
+}
+
+TEST(FreeListAllocator, MergesAdjacentRangesOnFree)
+{
+	FREE_LIST_ALLOCATOR allocator(30);
+
+	EXPECT_EQ(allocator.Allocate(10), 0u);
+	EXPECT_EQ(allocator.Allocate(10), 10u);
+	EXPECT_EQ(allocator.Allocate(10), 20u);
+	EXPECT_EQ(allocator.GetFreeCount(), 0u);
+
+	allocator.Free(0, 10);
+	allocator.Free(20, 10);
+	EXPECT_EQ(allocator.GetFreeRangeCount(), 2u);
+
+	// Merges with both neighbours.
+	allocator.Free(10, 10);
+	EXPECT_EQ(allocator.GetFreeRangeCount(), 1u);
+	EXPECT_EQ(allocator.GetLargestFreeRange(), 30u);
+}
+
+TEST(FreeListAllocator, FailsWhenNoRangeIsLargeEnough)
+{
+	FREE_LIST_ALLOCATOR allocator(16);
+
+	EXPECT_EQ(allocator.Allocate(0), FREE_LIST_ALLOCATOR::INVALID_OFFSET);
+	EXPECT_EQ(allocator.Allocate(17), FREE_LIST_ALLOCATOR::INVALID_OFFSET);
+	EXPECT_EQ(allocator.Allocate(8), 0u);
+	EXPECT_EQ(allocator.Allocate(4), 8u);
+	allocator.Free(0, 8);
+
+	// 12 descriptors are free, but not contiguous.
+	EXPECT_EQ(allocator.GetFreeCount(), 12u);
+	EXPECT_EQ(allocator.Allocate(10), FREE_LIST_ALLOCATOR::INVALID_OFFSET);
+}
+
+// Random allocations and frees: live ranges never overlap and freeing everything
+// merges back into a single range.
+TEST(FreeListAllocator, RandomAllocationsMergeBackToOneRange)
+{
+	const uint32_t capacity = 4096;
+
+	FREE_LIST_ALLOCATOR allocator(capacity);
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<uint32_t> counts(1, 64);
+
+	// Offset to count of the live allocations.
+	std::map<uint32_t, uint32_t> live;
+	uint32_t liveCount = 0;
+
+	for (int step = 0; step < 20000; ++step)
+	{
+		if (live.empty() == false && random() % 2 == 0)
+		{
+			auto it = live.begin();
+			std::advance(it, random() % live.size());
+			allocator.Free(it->first, it->second);
+			liveCount -= it->second;
+			live.erase(it);
+			continue;
+		}
+
+		uint32_t count = counts(random);
+		uint32_t offset = allocator.Allocate(count);
+		if (offset == FREE_LIST_ALLOCATOR::INVALID_OFFSET)
+		{
+			ASSERT_LT(allocator.GetLargestFreeRange(), count);
+			continue;
+		}
+
+		ASSERT_LE(offset + count, capacity);
+		auto next = live.lower_bound(offset);
+		if (next != live.end())
+		{
+			ASSERT_LE(offset + count, next->first);
+		}
+		if (next != live.begin())
+		{
+			auto previous = std::prev(next);
+			ASSERT_LE(previous->first + previous->second, offset);
+		}
+		live[offset] = count;
+		liveCount += count;
+
+		ASSERT_EQ(allocator.GetFreeCount(), capacity - liveCount);
+	}
+
+	for (const auto& entry : live)
+	{
+		allocator.Free(entry.first, entry.second);
+	}
+	EXPECT_EQ(allocator.GetFreeRangeCount(), 1u);
+	EXPECT_EQ(allocator.GetFreeCount(), capacity);
+	EXPECT_EQ(allocator.GetLargestFreeRange(), capacity);
+}
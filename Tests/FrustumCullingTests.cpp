@@ -0,0 +1,116 @@
+#include "FrustumCulling.h"
+#include "JobSystem.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace VectorMath;
+
+// Not a multiple of the padding nor of the job chunks.
+const uint32_t g_volumeCount = 2 * 16384 + 13;
+
+// AVX2 is only run when the CPU has it, SSE2 everywhere on x86.
+static bool IsCullingIsaSupported(CULLING_ISA isa)
+{
+	CULLING_ISA best = GetBestCullingIsa();
+	return isa == CULLING_ISA_SCALAR || (best != CULLING_ISA_SCALAR && isa <= best);
+}
+
+static FRUSTUM CreateFrustum()
+{
+	MATRIX view = MatrixLookAtLH(VectorSet(0.0f, 0.0f, 0.0f, 1.0f), VectorSet(0.0f, 0.0f, 1.0f, 1.0f), VectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	MATRIX projection = MatrixPerspectiveFovLH(ConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+	return ExtractFrustum(MatrixMultiply(view, projection));
+}
+
+// Random boxes around the camera, many of them straddle a plane.
+static void CreateVolumes(uint32_t count, BOUNDING_VOLUMES& volumes)
+{
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+	std::uniform_real_distribution<float> size(0.1f, 8.0f);
+
+	volumes.Resize(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		float center[3] = { position(random), position(random), position(random) };
+		float extent[3] = { size(random), size(random), size(random) };
+		float radius = std::sqrt(extent[0] * extent[0] + extent[1] * extent[1] + extent[2] * extent[2]);
+		volumes.Set(i, center, extent, radius);
+	}
+}
+
+static std::vector<uint32_t> Cull(const FRUSTUM& frustum, const BOUNDING_VOLUMES& volumes, CULLING_ISA isa)
+{
+	std::vector<uint32_t> visible(volumes.GetPaddedCount());
+	visible.resize(CullBoundingVolumes(frustum, volumes, 0, volumes.count, visible.data(), isa));
+	return visible;
+}
+
+TEST(FrustumCulling, KeepsVolumesInsideAndCullsVolumesOutside)
+{
+	BOUNDING_VOLUMES volumes;
+	volumes.Resize(3);
+
+	const float extent[3] = { 1.0f, 1.0f, 1.0f };
+	const float inFront[3] = { 0.0f, 0.0f, 10.0f };
+	const float behind[3] = { 0.0f, 0.0f, -10.0f };
+	const float straddling[3] = { 0.0f, 0.0f, 100.5f };
+	volumes.Set(0, inFront, extent, 1.7320508f);
+	volumes.Set(1, behind, extent, 1.7320508f);
+	volumes.Set(2, straddling, extent, 1.7320508f);
+
+	FRUSTUM frustum = CreateFrustum();
+	for (CULLING_ISA isa : { CULLING_ISA_SCALAR, CULLING_ISA_SSE2, CULLING_ISA_AVX2 })
+	{
+		if (IsCullingIsaSupported(isa))
+		{
+			EXPECT_EQ(Cull(frustum, volumes, isa), (std::vector<uint32_t>{ 0, 2 })) << GetCullingIsaName(isa);
+		}
+	}
+}
+
+TEST(FrustumCulling, InstructionSetsMatchScalar)
+{
+	BOUNDING_VOLUMES volumes;
+	CreateVolumes(g_volumeCount, volumes);
+	FRUSTUM frustum = CreateFrustum();
+
+	std::vector<uint32_t> expected = Cull(frustum, volumes, CULLING_ISA_SCALAR);
+	ASSERT_GT(expected.size(), 0u);
+	ASSERT_LT(expected.size(), g_volumeCount);
+	EXPECT_LT(expected.back(), g_volumeCount);
+
+	for (CULLING_ISA isa : { CULLING_ISA_SSE2, CULLING_ISA_AVX2 })
+	{
+		if (IsCullingIsaSupported(isa))
+		{
+			EXPECT_EQ(Cull(frustum, volumes, isa), expected) << GetCullingIsaName(isa);
+		}
+	}
+}
+
+TEST(FrustumCulling, JobSystemMatchesSingleThreaded)
+{
+	BOUNDING_VOLUMES volumes;
+	CreateVolumes(g_volumeCount, volumes);
+	FRUSTUM frustum = CreateFrustum();
+
+	std::vector<uint32_t> expected = Cull(frustum, volumes, CULLING_ISA_SCALAR);
+
+	JOB_SYSTEM jobSystem(3);
+	for (CULLING_ISA isa : { CULLING_ISA_SCALAR, CULLING_ISA_SSE2, CULLING_ISA_AVX2 })
+	{
+		if (IsCullingIsaSupported(isa) == false)
+		{
+			continue;
+		}
+
+		std::vector<uint32_t> visible(volumes.GetPaddedCount());
+		visible.resize(CullBoundingVolumes(frustum, volumes, visible.data(), &jobSystem, isa));
+		EXPECT_EQ(visible, expected) << GetCullingIsaName(isa);
+	}
+}
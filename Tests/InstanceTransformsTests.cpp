@@ -0,0 +1,150 @@
+#include "InstanceTransforms.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace VectorMath;
+
+const FLOAT3 g_axis = { 0.48f, 0.6f, 0.64f };
+const float g_time = 1.75f;
+const float g_angularSpeed = 0.9f;
+
+// Matrices past the written ones, must be left untouched.
+const uint32_t g_guardCount = 4;
+const uint32_t g_guardBits = 0x7fc0dead;
+
+static MATRIX CreateBaseTransform()
+{
+	return MatrixMultiply(MatrixMultiply(MatrixScaling(1.5f, 0.75f, 2.0f), MatrixRotationQuaternion(QuaternionRotationAxis(VectorSet(1.0f, 2.0f, -0.5f, 0.0f), 0.7f))),
+		MatrixTranslation(3.0f, -2.0f, 10.0f));
+}
+
+// Grid positions with varied phases, 'count' not a multiple of 4.
+static void CreateInstances(INSTANCE_SET& instances, uint32_t count)
+{
+	instances.Resize(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		instances.positionX[i] = static_cast<float>(i % 3) * 2.5f - 1.0f;
+		instances.positionY[i] = static_cast<float>(i / 3) * -1.5f;
+		instances.positionZ[i] = static_cast<float>(i) * 0.25f;
+		instances.phase[i] = static_cast<float>(i) * 0.9f - 2.0f;
+	}
+}
+
+// base * rotation(axis, phase + time * speed) * translation(position).
+static MATRIX ComputeReferenceTransform(const INSTANCE_SET& instances, uint32_t instance, const MATRIX& baseTransform)
+{
+	float angle = instances.phase[instance] + g_time * g_angularSpeed;
+	MATRIX rotation = MatrixRotationQuaternion(QuaternionRotationAxis(LoadFloat3(&g_axis), angle));
+	MATRIX translation = MatrixTranslation(instances.positionX[instance], instances.positionY[instance], instances.positionZ[instance]);
+	return MatrixMultiply(baseTransform, MatrixMultiply(rotation, translation));
+}
+
+static std::vector<FLOAT4X4> CreateDestination(uint32_t count)
+{
+	std::vector<FLOAT4X4> destination(count + g_guardCount);
+	for (FLOAT4X4& matrix : destination)
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			memcpy(&matrix.m[i / 4][i % 4], &g_guardBits, sizeof(float));
+		}
+	}
+	return destination;
+}
+
+static void ExpectTransform(const FLOAT4X4& matrix, const MATRIX& expected, uint32_t index)
+{
+	FLOAT4X4 expectedElements;
+	StoreFloat4x4(&expectedElements, expected);
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int column = 0; column < 4; ++column)
+		{
+			EXPECT_NEAR(matrix.m[row][column], expectedElements.m[row][column], 1e-4f * (1.0f + std::fabs(expectedElements.m[row][column])))
+				<< "matrix " << index << " [" << row << "][" << column << "]";
+		}
+	}
+}
+
+static void ExpectGuardsIntact(const std::vector<FLOAT4X4>& destination, uint32_t count)
+{
+	for (uint32_t i = count; i < destination.size(); ++i)
+	{
+		for (int element = 0; element < 16; ++element)
+		{
+			uint32_t bits;
+			memcpy(&bits, &destination[i].m[element / 4][element % 4], sizeof(bits));
+			ASSERT_EQ(bits, g_guardBits) << "written past the end at matrix " << i;
+		}
+	}
+}
+
+TEST(InstanceTransforms, MatchesMatrixProduct)
+{
+	const MATRIX baseTransform = CreateBaseTransform();
+
+	for (uint32_t count : { 1u, 5u, 7u })
+	{
+		INSTANCE_SET instances;
+		CreateInstances(instances, count);
+
+		std::vector<FLOAT4X4> destination = CreateDestination(count);
+		BuildInstanceTransforms(destination.data(), instances, 0, instances.GetGroupCount(), baseTransform, g_axis, g_time, g_angularSpeed);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			ExpectTransform(destination[i], ComputeReferenceTransform(instances, i, baseTransform), i);
+		}
+		ExpectGuardsIntact(destination, count);
+	}
+}
+
+TEST(InstanceTransforms, GatheredMatchesMatrixProduct)
+{
+	const MATRIX baseTransform = CreateBaseTransform();
+
+	INSTANCE_SET instances;
+	CreateInstances(instances, 11);
+	const uint32_t allIndices[] = { 9, 2, 7, 0, 10, 4, 5 };
+
+	for (uint32_t count : { 1u, 5u, 7u })
+	{
+		std::vector<uint32_t> indices(allIndices, allIndices + count);
+		uint32_t groupCount = (count + 3) / 4;
+
+		std::vector<FLOAT4X4> destination = CreateDestination(count);
+		BuildInstanceTransforms(destination.data(), instances, indices.data(), count, 0, groupCount, baseTransform, g_axis, g_time, g_angularSpeed);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			ExpectTransform(destination[i], ComputeReferenceTransform(instances, indices[i], baseTransform), i);
+		}
+		ExpectGuardsIntact(destination, count);
+	}
+}
+
+TEST(InstanceTransforms, GroupRangesWriteTheirInstancesOnly)
+{
+	const MATRIX baseTransform = CreateBaseTransform();
+
+	INSTANCE_SET instances;
+	CreateInstances(instances, 7);
+
+	// Only the second group, instances 4 to 6.
+	std::vector<FLOAT4X4> destination = CreateDestination(7);
+	BuildInstanceTransforms(destination.data(), instances, 1, 2, baseTransform, g_axis, g_time, g_angularSpeed);
+
+	for (uint32_t i = 4; i < 7; ++i)
+	{
+		ExpectTransform(destination[i], ComputeReferenceTransform(instances, i, baseTransform), i);
+	}
+	uint32_t bits;
+	memcpy(&bits, &destination[3].m[0][0], sizeof(bits));
+	EXPECT_EQ(bits, g_guardBits);
+	ExpectGuardsIntact(destination, 7);
+}
@@ -0,0 +1,123 @@
+#include "JobSystem.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(JobSystem, ParallelForVisitsEveryIndexOnce)
+{
+	JOB_SYSTEM jobSystem(3);
+
+	const uint32_t counts[] = { 0, 1, 7, 1000, 1023 };
+	const uint32_t grainSizes[] = { 1, 7, 64 };
+
+	for (uint32_t count : counts)
+	{
+		for (uint32_t grainSize : grainSizes)
+		{
+			std::vector<std::atomic<uint32_t>> visits(count);
+			std::atomic<bool> rangeTooLarge{ false };
+
+			jobSystem.ParallelFor(count, grainSize, [&](uint32_t begin, uint32_t end)
+			{
+				if (end - begin > grainSize || end > count)
+				{
+					rangeTooLarge = true;
+				}
+				for (uint32_t i = begin; i < end && i < count; ++i)
+				{
+					visits[i]++;
+				}
+			});
+
+			EXPECT_FALSE(rangeTooLarge) << count << " / " << grainSize;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				ASSERT_EQ(visits[i], 1u) << "index " << i << " of " << count << " / " << grainSize;
+			}
+		}
+	}
+}
+
+TEST(JobSystem, NestedWaitOnSingleWorkerDoesNotDeadlock)
+{
+	JOB_SYSTEM jobSystem(1);
+
+	std::atomic<uint32_t> innerJobs{ 0 };
+	std::atomic<int> outerWorker{ -2 };
+
+	JOB_COUNTER outer;
+	jobSystem.Run([&]()
+	{
+		outerWorker = jobSystem.GetCurrentWorkerIndex();
+
+		JOB_COUNTER inner;
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			jobSystem.Run([&]() { innerJobs++; }, &inner);
+		}
+		jobSystem.Wait(inner);
+
+		jobSystem.ParallelFor(64, 4, [&](uint32_t begin, uint32_t end) { innerJobs += end - begin; });
+	}, &outer);
+
+	// Polled instead of Wait() so the calling thread never helps: the only worker must
+	// run the nested jobs itself while it waits on them.
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (outer.IsDone() == false && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_TRUE(outer.IsDone());
+	EXPECT_EQ(outerWorker, 0);
+	EXPECT_EQ(innerJobs, 16u + 64u);
+}
+
+TEST(JobSystem, DestructorDrainsQueuedJobs)
+{
+	std::atomic<uint32_t> executed{ 0 };
+	{
+		JOB_SYSTEM jobSystem(1);
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			jobSystem.Run([&]()
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(10));
+				executed++;
+			});
+		}
+	}
+
+	EXPECT_EQ(executed, 256u);
+}
+
+TEST(JobSystem, WorkerIndexIsOnlyValidOnOwnWorkers)
+{
+	JOB_SYSTEM jobSystem(2);
+	JOB_SYSTEM otherSystem(1);
+
+	EXPECT_EQ(jobSystem.GetCurrentWorkerIndex(), -1);
+
+	std::atomic<int> ownIndex{ -2 };
+	std::atomic<int> otherIndex{ -2 };
+
+	JOB_COUNTER counter;
+	otherSystem.Run([&]()
+	{
+		ownIndex = otherSystem.GetCurrentWorkerIndex();
+		otherIndex = jobSystem.GetCurrentWorkerIndex();
+	}, &counter);
+
+	// Polled so the job runs on the worker and not on this thread.
+	while (counter.IsDone() == false)
+	{
+		std::this_thread::yield();
+	}
+
+	EXPECT_EQ(ownIndex, 0);
+	EXPECT_EQ(otherIndex, -1);
+}
@@ -0,0 +1,225 @@
+#include "MeshFile.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Quad and triangle drawn from one vertex buffer, the triangle through a base vertex.
+static MESH_DATA CreateMesh()
+{
+	const float positions[] = {
+		0.0f, 0.0f, 0.0f,
+		1.0f, 0.0f, 0.0f,
+		1.0f, 1.0f, 0.0f,
+		0.0f, 1.0f, 0.0f,
+		2.0f, 0.0f, 1.0f,
+		3.0f, 0.0f, 1.0f,
+		2.0f, 1.0f, 1.0f,
+	};
+	const uint8_t colors[] = {
+		255, 0, 0, 255,		0, 255, 0, 255,		0, 0, 255, 255,		255, 255, 0, 255,
+		0, 255, 255, 255,	255, 0, 255, 255,	255, 255, 255, 255,
+	};
+
+	MESH_DATA mesh;
+	mesh.vertexCount = 7;
+	mesh.streams.push_back({ MESH_SEMANTIC_POSITION, MESH_FORMAT_FLOAT3, std::vector<uint8_t>(reinterpret_cast<const uint8_t*>(positions), reinterpret_cast<const uint8_t*>(positions) + sizeof(positions)) });
+	mesh.streams.push_back({ MESH_SEMANTIC_COLOR, MESH_FORMAT_UNORM8X4, std::vector<uint8_t>(colors, colors + sizeof(colors)) });
+	mesh.indices = { 0, 1, 2, 0, 2, 3, 0, 1, 2 };
+
+	MESH_SUBMESH quad = {};
+	quad.firstIndex = 0;
+	quad.indexCount = 6;
+	MESH_SUBMESH triangle = {};
+	triangle.firstIndex = 6;
+	triangle.indexCount = 3;
+	triangle.baseVertex = 4;
+	mesh.submeshes = { quad, triangle };
+
+	ComputeMeshBounds(mesh);
+	return mesh;
+}
+
+class MeshFileTest : public ::testing::Test
+{
+protected:
+	virtual void SetUp() override
+	{
+		_path = ::testing::TempDir() + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".mesh";
+	}
+
+	virtual void TearDown() override
+	{
+		std::remove(_path.c_str());
+	}
+
+	std::vector<uint8_t> ReadBytes() const
+	{
+		std::ifstream file(_path, std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void WriteBytes(const std::vector<uint8_t>& bytes) const
+	{
+		std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	}
+
+	template<typename T>
+	void Patch(uint64_t offset, T value) const
+	{
+		std::vector<uint8_t> bytes = ReadBytes();
+		ASSERT_LE(offset + sizeof(T), bytes.size());
+		memcpy(&bytes[offset], &value, sizeof(T));
+		WriteBytes(bytes);
+	}
+
+	std::string	_path;
+};
+
+TEST_F(MeshFileTest, RoundTrips)
+{
+	const MESH_DATA mesh = CreateMesh();
+	ASSERT_TRUE(WriteMeshFile(_path, mesh));
+
+	MESH_FILE file;
+	ASSERT_TRUE(file.Open(_path));
+
+	const MESH_HEADER& header = file.GetHeader();
+	EXPECT_EQ(header.vertexCount, 7u);
+	EXPECT_EQ(header.indexCount, 9u);
+	EXPECT_EQ(header.indexFormat, static_cast<uint32_t>(MESH_INDEX_UINT16));
+	EXPECT_EQ(header.indexOffset % g_meshSectionAlignment, 0u);
+	EXPECT_EQ(header.fileSize, file.GetMappedFile().GetSize());
+	EXPECT_EQ(memcmp(&header.bounds, &mesh.bounds, sizeof(MESH_BOUNDS)), 0);
+
+	const MESH_STREAM* colors = file.FindStream(MESH_SEMANTIC_COLOR);
+	ASSERT_NE(colors, nullptr);
+	EXPECT_EQ(colors->stride, 4u);
+	EXPECT_EQ(colors->offset % g_meshSectionAlignment, 0u);
+	EXPECT_EQ(memcmp(file.GetStreamData(*colors), mesh.streams[1].data.data(), mesh.streams[1].data.size()), 0);
+	EXPECT_EQ(file.FindStream(MESH_SEMANTIC_NORMAL), nullptr);
+
+	MESH_DATA read;
+	ASSERT_TRUE(ReadMeshData(file, read));
+	EXPECT_EQ(read.vertexCount, mesh.vertexCount);
+	EXPECT_EQ(read.indices, mesh.indices);
+	ASSERT_EQ(read.streams.size(), mesh.streams.size());
+	for (size_t i = 0; i < mesh.streams.size(); ++i)
+	{
+		EXPECT_EQ(read.streams[i].semantic, mesh.streams[i].semantic);
+		EXPECT_EQ(read.streams[i].format, mesh.streams[i].format);
+		EXPECT_EQ(read.streams[i].data, mesh.streams[i].data);
+	}
+	ASSERT_EQ(read.submeshes.size(), mesh.submeshes.size());
+	EXPECT_EQ(memcmp(read.submeshes.data(), mesh.submeshes.data(), mesh.submeshes.size() * sizeof(MESH_SUBMESH)), 0);
+}
+
+TEST_F(MeshFileTest, RoundTrips32BitIndices)
+{
+	MESH_DATA mesh;
+	mesh.vertexCount = UINT16_MAX + 2u;
+	mesh.streams.push_back({ MESH_SEMANTIC_POSITION, MESH_FORMAT_FLOAT3, std::vector<uint8_t>(mesh.vertexCount * 3 * sizeof(float)) });
+	mesh.indices = { 0, UINT16_MAX + 1u, 1 };
+	ASSERT_TRUE(WriteMeshFile(_path, mesh));
+
+	MESH_FILE file;
+	ASSERT_TRUE(file.Open(_path));
+	EXPECT_EQ(file.GetHeader().indexFormat, static_cast<uint32_t>(MESH_INDEX_UINT32));
+
+	MESH_DATA read;
+	ASSERT_TRUE(ReadMeshData(file, read));
+	EXPECT_EQ(read.indices, mesh.indices);
+}
+
+TEST_F(MeshFileTest, RejectsTruncatedFiles)
+{
+	ASSERT_TRUE(WriteMeshFile(_path, CreateMesh()));
+	std::vector<uint8_t> bytes = ReadBytes();
+
+	MESH_FILE file;
+	for (size_t size : { bytes.size() - g_meshSectionAlignment, bytes.size() - 1, sizeof(MESH_HEADER) - 1 })
+	{
+		WriteBytes(std::vector<uint8_t>(bytes.begin(), bytes.begin() + size));
+		EXPECT_FALSE(file.Open(_path)) << size << " bytes";
+	}
+}
+
+TEST_F(MeshFileTest, RejectsOtherVersions)
+{
+	ASSERT_TRUE(WriteMeshFile(_path, CreateMesh()));
+	Patch<uint32_t>(offsetof(MESH_HEADER, version), g_meshVersion + 1);
+
+	MESH_FILE file;
+	EXPECT_FALSE(file.Open(_path));
+}
+
+TEST_F(MeshFileTest, RejectsMisalignedSections)
+{
+	ASSERT_TRUE(WriteMeshFile(_path, CreateMesh()));
+
+	MESH_FILE file;
+	ASSERT_TRUE(file.Open(_path));
+	const uint64_t streamOffset = file.GetStream(0).offset;
+	const uint64_t indexOffset = file.GetHeader().indexOffset;
+	file.Close();
+
+	Patch<uint64_t>(sizeof(MESH_HEADER) + offsetof(MESH_STREAM, offset), streamOffset + 4);
+	EXPECT_FALSE(file.Open(_path));
+
+	Patch<uint64_t>(sizeof(MESH_HEADER) + offsetof(MESH_STREAM, offset), streamOffset);
+	Patch<uint64_t>(offsetof(MESH_HEADER, indexOffset), indexOffset + 2);
+	EXPECT_FALSE(file.Open(_path));
+}
+
+TEST_F(MeshFileTest, RejectsSubmeshesPastTheIndices)
+{
+	ASSERT_TRUE(WriteMeshFile(_path, CreateMesh()));
+
+	// Second submesh of the table after the two streams.
+	const uint64_t submeshOffset = sizeof(MESH_HEADER) + 2 * sizeof(MESH_STREAM) + sizeof(MESH_SUBMESH);
+	Patch<uint32_t>(submeshOffset + offsetof(MESH_SUBMESH, indexCount), 4);
+
+	MESH_FILE file;
+	EXPECT_FALSE(file.Open(_path));
+}
+
+TEST_F(MeshFileTest, RejectsIndicesPastTheVertices)
+{
+	MESH_FILE file;
+	MESH_DATA read;
+
+	// The triangle's base vertex moves its last index past the 7 vertices.
+	MESH_DATA mesh = CreateMesh();
+	mesh.submeshes[1].baseVertex = 5;
+	ASSERT_TRUE(WriteMeshFile(_path, mesh));
+	ASSERT_TRUE(file.Open(_path));
+	EXPECT_FALSE(ReadMeshData(file, read));
+	EXPECT_TRUE(read.indices.empty());
+	file.Close();
+
+	mesh.submeshes[1].baseVertex = -1;
+	ASSERT_TRUE(WriteMeshFile(_path, mesh));
+	ASSERT_TRUE(file.Open(_path));
+	EXPECT_FALSE(ReadMeshData(file, read));
+	file.Close();
+
+	mesh = CreateMesh();
+	mesh.indices[4] = 7;
+	ASSERT_TRUE(WriteMeshFile(_path, mesh));
+	ASSERT_TRUE(file.Open(_path));
+	EXPECT_FALSE(ReadMeshData(file, read));
+	file.Close();
+
+	// Without submeshes the index buffer is drawn as a whole.
+	mesh.submeshes.clear();
+	ASSERT_TRUE(WriteMeshFile(_path, mesh));
+	ASSERT_TRUE(file.Open(_path));
+	EXPECT_FALSE(ReadMeshData(file, read));
+}
@@ -0,0 +1,228 @@
+#include "MeshOptimizer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+const uint32_t g_gridSize = 16;		// Quads per side
+
+typedef std::array<uint32_t, 3> TRIANGLE;
+typedef std::array<float, 9> TRIANGLE_POSITIONS;
+
+// Indexed grid of g_gridSize x g_gridSize quads in the z = 0 plane, triangles shuffled.
+static std::vector<uint32_t> CreateShuffledGrid()
+{
+	std::vector<TRIANGLE> triangles;
+	for (uint32_t y = 0; y < g_gridSize; ++y)
+	{
+		for (uint32_t x = 0; x < g_gridSize; ++x)
+		{
+			uint32_t v = y * (g_gridSize + 1) + x;
+			triangles.push_back({ v, v + g_gridSize + 1, v + 1 });
+			triangles.push_back({ v + 1, v + g_gridSize + 1, v + g_gridSize + 2 });
+		}
+	}
+
+	std::mt19937 random(29);
+	std::shuffle(triangles.begin(), triangles.end(), random);
+
+	std::vector<uint32_t> indices;
+	for (const TRIANGLE& triangle : triangles)
+	{
+		indices.insert(indices.end(), triangle.begin(), triangle.end());
+	}
+	return indices;
+}
+
+static float GetGridPosition(uint32_t vertex, int axis)
+{
+	return axis == 0 ? static_cast<float>(vertex % (g_gridSize + 1)) : axis == 1 ? static_cast<float>(vertex / (g_gridSize + 1)) : 0.0f;
+}
+
+// Triangles rotated to start with their smallest index, winding kept, then sorted.
+static std::vector<TRIANGLE> GetTriangleMultiset(const std::vector<uint32_t>& indices)
+{
+	std::vector<TRIANGLE> triangles;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		TRIANGLE triangle = { indices[i], indices[i + 1], indices[i + 2] };
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+// Same, by vertex positions, for meshes whose vertices were renumbered.
+static std::vector<TRIANGLE_POSITIONS> GetTriangleMultiset(const MESH_DATA& mesh)
+{
+	const std::vector<uint8_t>& positions = mesh.streams[0].data;
+
+	std::vector<TRIANGLE_POSITIONS> triangles;
+	for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+	{
+		std::array<std::array<float, 3>, 3> corners;
+		for (int corner = 0; corner < 3; ++corner)
+		{
+			memcpy(corners[corner].data(), &positions[mesh.indices[i + corner] * 3 * sizeof(float)], 3 * sizeof(float));
+		}
+		std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+
+		TRIANGLE_POSITIONS triangle;
+		for (int corner = 0; corner < 3; ++corner)
+		{
+			std::copy(corners[corner].begin(), corners[corner].end(), triangle.begin() + corner * 3);
+		}
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+static MESH_DATA::STREAM CreateStream(MESH_SEMANTIC semantic, MESH_FORMAT format, const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	return MESH_DATA::STREAM{ semantic, format, std::vector<uint8_t>(bytes, bytes + size) };
+}
+
+TEST(MeshOptimizer, AnalyzesHandComputedStatistics)
+{
+	// Fan around vertex 0, vertex 5 is never referenced.
+	const uint32_t indices[] = { 0, 1, 2, 0, 2, 3, 0, 3, 4 };
+
+	// Cache of 3: 0 1 2 miss, 0 2 hit, 3 miss and evicts 0, 0 miss, 3 hit, 4 miss.
+	VERTEX_CACHE_STATISTICS small = AnalyzeVertexCache(indices, 9, 6, 3);
+	EXPECT_EQ(small.vertexTransforms, 6u);
+	EXPECT_FLOAT_EQ(small.acmr, 2.0f);
+	EXPECT_FLOAT_EQ(small.atvr, 1.2f);
+
+	VERTEX_CACHE_STATISTICS large = AnalyzeVertexCache(indices, 9, 6);
+	EXPECT_EQ(large.vertexTransforms, 5u);
+	EXPECT_FLOAT_EQ(large.acmr, 5.0f / 3.0f);
+	EXPECT_FLOAT_EQ(large.atvr, 1.0f);
+
+	// Strip: every vertex transformed once, even with a cache of 3.
+	const uint32_t strip[] = { 0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5 };
+	VERTEX_CACHE_STATISTICS stripStatistics = AnalyzeVertexCache(strip, 12, 6, 3);
+	EXPECT_EQ(stripStatistics.vertexTransforms, 6u);
+	EXPECT_FLOAT_EQ(stripStatistics.acmr, 1.5f);
+	EXPECT_FLOAT_EQ(stripStatistics.atvr, 1.0f);
+}
+
+TEST(MeshOptimizer, VertexCacheKeepsTrianglesAndLowersAcmr)
+{
+	std::vector<uint32_t> indices = CreateShuffledGrid();
+	const size_t vertexCount = (g_gridSize + 1) * (g_gridSize + 1);
+
+	std::vector<uint32_t> optimized(indices.size());
+	OptimizeVertexCache(optimized.data(), indices.data(), indices.size(), vertexCount);
+	EXPECT_EQ(GetTriangleMultiset(optimized), GetTriangleMultiset(indices));
+
+	VERTEX_CACHE_STATISTICS before = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+	VERTEX_CACHE_STATISTICS after = AnalyzeVertexCache(optimized.data(), optimized.size(), vertexCount);
+	EXPECT_GT(before.acmr, 2.0f);
+	EXPECT_LT(after.acmr, 1.0f);
+
+	// Overdraw ordering moves whole clusters, the triangles and most of the gain stay.
+	std::vector<float> positions(vertexCount * 3);
+	for (uint32_t v = 0; v < vertexCount; ++v)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			positions[v * 3 + axis] = GetGridPosition(v, axis);
+		}
+	}
+	std::vector<uint32_t> overdraw(indices.size());
+	OptimizeOverdraw(overdraw.data(), optimized.data(), optimized.size(), positions.data(), 3 * sizeof(float), vertexCount);
+	EXPECT_EQ(GetTriangleMultiset(overdraw), GetTriangleMultiset(indices));
+	EXPECT_LE(AnalyzeVertexCache(overdraw.data(), overdraw.size(), vertexCount).acmr, after.acmr * 1.05f + 1e-6f);
+}
+
+TEST(MeshOptimizer, FetchRemapFollowsFirstUse)
+{
+	const uint32_t indices[] = { 4, 2, 4, 0, 2, 5 };
+	uint32_t remap[7];
+
+	EXPECT_EQ(OptimizeVertexFetchRemap(remap, indices, 6, 7), 4u);
+	EXPECT_EQ(remap[4], 0u);
+	EXPECT_EQ(remap[2], 1u);
+	EXPECT_EQ(remap[0], 2u);
+	EXPECT_EQ(remap[5], 3u);
+	EXPECT_EQ(remap[1], g_unusedVertex);
+	EXPECT_EQ(remap[3], g_unusedVertex);
+	EXPECT_EQ(remap[6], g_unusedVertex);
+}
+
+TEST(MeshOptimizer, DuplicateRemapCollapsesIdenticalBytes)
+{
+	// 3 and 4 copy 0 and 1, 5 has the position of 0 with another color, 6 has -0.
+	const float positions[] = {
+		0.0f, 0.0f, 0.0f,
+		1.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f,
+		1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f,
+		-0.0f, 0.0f, 0.0f,
+	};
+	const uint8_t colors[] = {
+		255, 0, 0, 255,		0, 255, 0, 255,		0, 0, 255, 255,
+		255, 0, 0, 255,		0, 255, 0, 255,		255, 0, 1, 255,		255, 0, 0, 255,
+	};
+
+	MESH_DATA mesh;
+	mesh.vertexCount = 7;
+	mesh.streams.push_back(CreateStream(MESH_SEMANTIC_POSITION, MESH_FORMAT_FLOAT3, positions, sizeof(positions)));
+	mesh.streams.push_back(CreateStream(MESH_SEMANTIC_COLOR, MESH_FORMAT_UNORM8X4, colors, sizeof(colors)));
+
+	std::vector<uint32_t> remap;
+	EXPECT_EQ(GenerateDuplicateRemap(remap, mesh), 5u);
+	EXPECT_EQ(remap, (std::vector<uint32_t>{ 0, 1, 2, 0, 1, 3, 4 }));
+}
+
+TEST(MeshOptimizer, OptimizeMeshKeepsTriangles)
+{
+	// Unindexed shuffled grid, every triangle has its own 3 vertices.
+	std::vector<uint32_t> gridIndices = CreateShuffledGrid();
+
+	MESH_DATA mesh;
+	mesh.vertexCount = static_cast<uint32_t>(gridIndices.size());
+	std::vector<float> positions;
+	for (uint32_t gridVertex : gridIndices)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			positions.push_back(GetGridPosition(gridVertex, axis));
+		}
+		mesh.indices.push_back(static_cast<uint32_t>(mesh.indices.size()));
+	}
+	mesh.streams.push_back(CreateStream(MESH_SEMANTIC_POSITION, MESH_FORMAT_FLOAT3, positions.data(), positions.size() * sizeof(float)));
+
+	MESH_SUBMESH submesh = {};
+	submesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+	mesh.submeshes.push_back(submesh);
+	ComputeMeshBounds(mesh);
+
+	const std::vector<TRIANGLE_POSITIONS> triangles = GetTriangleMultiset(mesh);
+	const float acmrBefore = AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertexCount).acmr;
+
+	OptimizeMesh(mesh);
+
+	EXPECT_EQ(mesh.vertexCount, (g_gridSize + 1) * (g_gridSize + 1));
+	EXPECT_EQ(mesh.streams[0].data.size(), mesh.vertexCount * 3 * sizeof(float));
+	EXPECT_EQ(GetTriangleMultiset(mesh), triangles);
+	EXPECT_LT(AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertexCount).acmr, acmrBefore / 2.0f);
+
+	// Vertices are numbered in first use order.
+	uint32_t nextVertex = 0;
+	for (uint32_t index : mesh.indices)
+	{
+		ASSERT_LE(index, nextVertex);
+		nextVertex = std::max(nextVertex, index + 1);
+	}
+	EXPECT_EQ(nextVertex, mesh.vertexCount);
+}
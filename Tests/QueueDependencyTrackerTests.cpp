@@ -0,0 +1,207 @@
+#include "QueueDependencyTracker.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+TEST(QueueDependencyTracker, SameQueueWaitsAreSkipped)
+{
+	QUEUE_DEPENDENCY_TRACKER tracker;
+	uint32_t direct = tracker.AddQueue();
+
+	tracker.AddSignal(direct, 1);
+	EXPECT_FALSE(tracker.AddWait(direct, direct, 1));
+}
+
+TEST(QueueDependencyTracker, SkipsWaitsAlreadyCovered)
+{
+	QUEUE_DEPENDENCY_TRACKER tracker;
+	uint32_t direct = tracker.AddQueue();
+	uint32_t compute = tracker.AddQueue();
+
+	for (uint64_t value = 1; value <= 6; ++value)
+	{
+		tracker.AddSignal(compute, value);
+	}
+
+	EXPECT_TRUE(tracker.AddWait(direct, compute, 5));
+	EXPECT_FALSE(tracker.AddWait(direct, compute, 3));
+	EXPECT_FALSE(tracker.AddWait(direct, compute, 5));
+	EXPECT_TRUE(tracker.AddWait(direct, compute, 6));
+	EXPECT_EQ(tracker.GetKnownValue(direct, compute), 6u);
+
+	// Knowledge is not symmetric.
+	EXPECT_EQ(tracker.GetKnownValue(compute, direct), 0u);
+}
+
+TEST(QueueDependencyTracker, WaitsInheritTheKnowledgeOfTheSignalingQueue)
+{
+	QUEUE_DEPENDENCY_TRACKER tracker;
+	uint32_t direct = tracker.AddQueue();
+	uint32_t compute = tracker.AddQueue();
+	uint32_t copy = tracker.AddQueue();
+
+	// Compute signals 1 before waiting on the copy queue, 2 after.
+	tracker.AddSignal(copy, 5);
+	tracker.AddSignal(compute, 1);
+	EXPECT_TRUE(tracker.AddWait(compute, copy, 5));
+	tracker.AddSignal(compute, 2);
+
+	// Compute reaching 1 says nothing about the copy queue.
+	EXPECT_TRUE(tracker.AddWait(direct, compute, 1));
+	EXPECT_EQ(tracker.GetKnownValue(direct, copy), 0u);
+
+	// Compute reaching 2 implies the copy queue reached 5.
+	EXPECT_TRUE(tracker.AddWait(direct, compute, 2));
+	EXPECT_EQ(tracker.GetKnownValue(direct, copy), 5u);
+	EXPECT_FALSE(tracker.AddWait(direct, copy, 5));
+	EXPECT_FALSE(tracker.AddWait(direct, copy, 4));
+}
+
+TEST(QueueDependencyTracker, RemovedSlotsAreReusedWithoutTheirKnowledge)
+{
+	QUEUE_DEPENDENCY_TRACKER tracker;
+	uint32_t direct = tracker.AddQueue();
+	uint32_t compute = tracker.AddQueue();
+	uint32_t copy = tracker.AddQueue();
+	uint32_t video = tracker.AddQueue();
+
+	tracker.AddSignal(direct, 2);
+	EXPECT_TRUE(tracker.AddWait(copy, direct, 2));
+	for (uint64_t value = 1; value <= 5; ++value)
+	{
+		tracker.AddSignal(copy, value);
+	}
+	EXPECT_TRUE(tracker.AddWait(compute, copy, 5));
+	tracker.AddSignal(compute, 1);
+	EXPECT_TRUE(tracker.AddWait(direct, compute, 1));
+	EXPECT_EQ(tracker.GetKnownValue(direct, copy), 5u);
+
+	tracker.RemoveQueue(copy);
+	uint32_t newCopy = tracker.AddQueue();
+	EXPECT_EQ(newCopy, copy);
+
+	// The new timeline starts over, nothing known about the old one covers it.
+	EXPECT_EQ(tracker.GetKnownValue(newCopy, direct), 0u);
+	EXPECT_EQ(tracker.GetKnownValue(direct, newCopy), 0u);
+	EXPECT_EQ(tracker.GetKnownValue(compute, newCopy), 0u);
+	tracker.AddSignal(newCopy, 1);
+	EXPECT_TRUE(tracker.AddWait(direct, newCopy, 1));
+
+	// Neither does what the remembered signals of the other queues knew.
+	EXPECT_TRUE(tracker.AddWait(video, compute, 1));
+	EXPECT_EQ(tracker.GetKnownValue(video, newCopy), 0u);
+	EXPECT_TRUE(tracker.AddWait(video, newCopy, 1));
+
+	// Slots are only added when none is free.
+	EXPECT_EQ(tracker.AddQueue(), video + 1);
+}
+
+TEST(QueueDependencyTracker, EvictedSignalsOnlyLoseKnowledge)
+{
+	QUEUE_DEPENDENCY_TRACKER tracker;
+	uint32_t direct = tracker.AddQueue();
+	uint32_t compute = tracker.AddQueue();
+	uint32_t copy = tracker.AddQueue();
+
+	tracker.AddSignal(copy, 5);
+	EXPECT_TRUE(tracker.AddWait(compute, copy, 5));
+	for (uint64_t value = 1; value <= QUEUE_DEPENDENCY_TRACKER::MAX_SIGNALS_PER_QUEUE + 1; ++value)
+	{
+		tracker.AddSignal(compute, value);
+	}
+
+	// The signal of value 1 was dropped, the wait on the copy queue is emitted again.
+	EXPECT_TRUE(tracker.AddWait(direct, compute, 1));
+	EXPECT_EQ(tracker.GetKnownValue(direct, copy), 0u);
+	EXPECT_TRUE(tracker.AddWait(direct, copy, 5));
+
+	// The retained signals still carry it.
+	uint32_t present = tracker.AddQueue();
+	EXPECT_TRUE(tracker.AddWait(present, compute, QUEUE_DEPENDENCY_TRACKER::MAX_SIGNALS_PER_QUEUE + 1));
+	EXPECT_EQ(tracker.GetKnownValue(present, copy), 5u);
+}
+
+// Random signals and waits over four queues against a model remembering every signal.
+// The tracker never knows more than the model, so it never skips a needed wait, and
+// only knows less once signals were evicted.
+TEST(QueueDependencyTracker, NeverSkipsAWaitTheModelDoesNotCover)
+{
+	const uint32_t queueCount = 4;
+
+	struct MODEL_QUEUE
+	{
+		std::vector<uint64_t>						known;
+		std::map<uint64_t, std::vector<uint64_t>>	signals;
+		uint64_t									lastValue = 0;
+	};
+
+	for (size_t signalCount : { size_t(8), QUEUE_DEPENDENCY_TRACKER::MAX_SIGNALS_PER_QUEUE * 8 })
+	{
+		QUEUE_DEPENDENCY_TRACKER tracker;
+		std::vector<MODEL_QUEUE> model(queueCount);
+		for (MODEL_QUEUE& queue : model)
+		{
+			tracker.AddQueue();
+			queue.known.resize(queueCount, 0);
+		}
+
+		std::mt19937 random(1234);
+		bool evicted = false;
+		for (size_t step = 0; step < signalCount * queueCount * 2; ++step)
+		{
+			uint32_t queueIndex = random() % queueCount;
+			MODEL_QUEUE& queue = model[queueIndex];
+
+			if (random() % 2 == 0)
+			{
+				queue.lastValue++;
+				queue.known[queueIndex] = queue.lastValue;
+				queue.signals[queue.lastValue] = queue.known;
+				tracker.AddSignal(queueIndex, queue.lastValue);
+				evicted = evicted || queue.signals.size() > QUEUE_DEPENDENCY_TRACKER::MAX_SIGNALS_PER_QUEUE;
+				continue;
+			}
+
+			uint32_t signalingIndex = random() % queueCount;
+			MODEL_QUEUE& signaling = model[signalingIndex];
+			if (signaling.lastValue == 0)
+			{
+				continue;
+			}
+			uint64_t fenceValue = 1 + random() % signaling.lastValue;
+
+			bool covered = signalingIndex == queueIndex || queue.known[signalingIndex] >= fenceValue;
+			bool emitted = tracker.AddWait(queueIndex, signalingIndex, fenceValue);
+			ASSERT_TRUE(emitted || covered);
+			if (evicted == false)
+			{
+				ASSERT_NE(emitted, covered);
+			}
+
+			if (signalingIndex != queueIndex)
+			{
+				queue.known[signalingIndex] = std::max(queue.known[signalingIndex], fenceValue);
+				const std::vector<uint64_t>& inherited = std::prev(signaling.signals.upper_bound(fenceValue))->second;
+				for (uint32_t i = 0; i < queueCount; ++i)
+				{
+					queue.known[i] = std::max(queue.known[i], inherited[i]);
+				}
+			}
+
+			for (uint32_t i = 0; i < queueCount; ++i)
+			{
+				ASSERT_LE(tracker.GetKnownValue(queueIndex, i), queue.known[i]);
+				if (evicted == false)
+				{
+					ASSERT_EQ(tracker.GetKnownValue(queueIndex, i), queue.known[i]);
+				}
+			}
+		}
+		EXPECT_EQ(evicted, signalCount > QUEUE_DEPENDENCY_TRACKER::MAX_SIGNALS_PER_QUEUE);
+	}
+}
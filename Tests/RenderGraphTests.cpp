@@ -0,0 +1,186 @@
+#include "RenderGraph.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// Resource states, D3D12_RESOURCE_STATES values.
+const uint32_t STATE_PRESENT = 0x0;
+const uint32_t STATE_RENDER_TARGET = 0x4;
+const uint32_t STATE_UNORDERED_ACCESS = 0x8;
+const uint32_t STATE_PIXEL_SHADER_RESOURCE = 0x80;
+
+typedef RENDER_GRAPH::RESOURCE_HANDLE RESOURCE_HANDLE;
+typedef RENDER_GRAPH::PASS_HANDLE PASS_HANDLE;
+
+class RenderGraphTest : public ::testing::Test
+{
+protected:
+	virtual void SetUp() override
+	{
+		_backBuffer = _graph.ImportResource("BackBuffer", &_backBufferResource, STATE_PRESENT, STATE_PRESENT);
+	}
+
+	PASS_HANDLE AddPass(const char* name)
+	{
+		return _graph.AddPass(name, [](RENDER_PASS_CONTEXT&) { ; });
+	}
+
+	RENDER_GRAPH		_graph;
+	int					_backBufferResource = 0;
+	RESOURCE_HANDLE		_backBuffer = RENDER_GRAPH::INVALID_RESOURCE;
+};
+
+TEST_F(RenderGraphTest, CullsDeadPassChains)
+{
+	RESOURCE_HANDLE first = _graph.CreateTransient("First", 256, 256);
+	RESOURCE_HANDLE second = _graph.CreateTransient("Second", 256, 256);
+
+	PASS_HANDLE producer = AddPass("Producer");
+	_graph.Write(producer, first, STATE_RENDER_TARGET);
+
+	PASS_HANDLE consumer = AddPass("Consumer");
+	_graph.Read(consumer, first, STATE_PIXEL_SHADER_RESOURCE);
+	_graph.Write(consumer, second, STATE_RENDER_TARGET);
+
+	PASS_HANDLE present = AddPass("Present");
+	_graph.Write(present, _backBuffer, STATE_RENDER_TARGET);
+
+	_graph.Compile();
+
+	// Nothing reads Second, so Consumer and then Producer are dead.
+	EXPECT_TRUE(_graph.GetPass(producer).culled);
+	EXPECT_TRUE(_graph.GetPass(consumer).culled);
+	EXPECT_FALSE(_graph.GetPass(present).culled);
+	EXPECT_EQ(_graph.GetExecutionOrder(), std::vector<PASS_HANDLE>{ present });
+	EXPECT_EQ(_graph.GetStatistics().culledPassCount, 2u);
+	EXPECT_EQ(_graph.GetStatistics().transientCount, 0u);
+	EXPECT_EQ(_graph.GetTransientHeapSize(), 0u);
+}
+
+TEST_F(RenderGraphTest, KeepsSideEffectAndImportedWrites)
+{
+	RESOURCE_HANDLE input = _graph.CreateTransient("Input", 256, 256);
+	RESOURCE_HANDLE unread = _graph.CreateTransient("Unread", 256, 256);
+
+	PASS_HANDLE producer = AddPass("Producer");
+	_graph.Write(producer, input, STATE_RENDER_TARGET);
+
+	PASS_HANDLE readback = AddPass("Readback");
+	_graph.Write(readback, unread, STATE_UNORDERED_ACCESS);
+	_graph.SetSideEffect(readback);
+
+	PASS_HANDLE present = AddPass("Present");
+	_graph.Read(present, input, STATE_PIXEL_SHADER_RESOURCE);
+	_graph.Write(present, _backBuffer, STATE_RENDER_TARGET);
+
+	_graph.Compile();
+
+	EXPECT_EQ(_graph.GetExecutionOrder(), (std::vector<PASS_HANDLE>{ producer, readback, present }));
+	EXPECT_EQ(_graph.GetStatistics().culledPassCount, 0u);
+}
+
+TEST_F(RenderGraphTest, OrdersWriteAfterReadAndWriteAfterWrite)
+{
+	int historyResource = 0;
+	RESOURCE_HANDLE history = _graph.ImportResource("History", &historyResource, STATE_PIXEL_SHADER_RESOURCE, STATE_PIXEL_SHADER_RESOURCE);
+
+	PASS_HANDLE clear = AddPass("Clear");
+	_graph.Write(clear, _backBuffer, STATE_RENDER_TARGET);
+
+	PASS_HANDLE resolve = AddPass("Resolve");
+	_graph.Read(resolve, history, STATE_PIXEL_SHADER_RESOURCE);
+	_graph.Write(resolve, _backBuffer, STATE_RENDER_TARGET);
+
+	PASS_HANDLE update = AddPass("Update");
+	_graph.Write(update, history, STATE_RENDER_TARGET);
+
+	_graph.Compile();
+
+	// Resolve overwrites Clear (WAW) and Update overwrites what Resolve read (WAR).
+	EXPECT_EQ(_graph.GetExecutionOrder(), (std::vector<PASS_HANDLE>{ clear, resolve, update }));
+
+	// Both passes keep the back buffer as a render target, History changes state once.
+	EXPECT_EQ(_graph.GetPass(clear).transitions.size(), 1u);
+	EXPECT_TRUE(_graph.GetPass(resolve).transitions.empty());
+	ASSERT_EQ(_graph.GetPass(update).transitions.size(), 1u);
+	EXPECT_EQ(_graph.GetPass(update).transitions[0].resource, history);
+	EXPECT_EQ(_graph.GetPass(update).transitions[0].state, STATE_RENDER_TARGET);
+}
+
+TEST_F(RenderGraphTest, AliasesDisjointTransientsOnly)
+{
+	RESOURCE_HANDLE first = _graph.CreateTransient("First", 256, 256);
+	RESOURCE_HANDLE second = _graph.CreateTransient("Second", 256, 256);
+	RESOURCE_HANDLE third = _graph.CreateTransient("Third", 256, 256);
+
+	// Lifetimes: First [0, 1], Second [1, 2], Third [2, 3].
+	PASS_HANDLE pass0 = AddPass("Pass0");
+	_graph.Write(pass0, first, STATE_RENDER_TARGET);
+
+	PASS_HANDLE pass1 = AddPass("Pass1");
+	_graph.Read(pass1, first, STATE_PIXEL_SHADER_RESOURCE);
+	_graph.Write(pass1, second, STATE_RENDER_TARGET);
+
+	PASS_HANDLE pass2 = AddPass("Pass2");
+	_graph.Read(pass2, second, STATE_PIXEL_SHADER_RESOURCE);
+	_graph.Write(pass2, third, STATE_RENDER_TARGET);
+
+	PASS_HANDLE pass3 = AddPass("Pass3");
+	_graph.Read(pass3, third, STATE_PIXEL_SHADER_RESOURCE);
+	_graph.Write(pass3, _backBuffer, STATE_RENDER_TARGET);
+
+	_graph.Compile();
+
+	EXPECT_EQ(_graph.GetResource(first).firstUse, 0u);
+	EXPECT_EQ(_graph.GetResource(first).lastUse, 1u);
+	EXPECT_EQ(_graph.GetResource(third).firstUse, 2u);
+
+	EXPECT_EQ(_graph.GetResource(first).heapOffset, _graph.GetResource(third).heapOffset);
+	EXPECT_NE(_graph.GetResource(first).heapOffset, _graph.GetResource(second).heapOffset);
+	EXPECT_NE(_graph.GetResource(second).heapOffset, _graph.GetResource(third).heapOffset);
+	EXPECT_EQ(_graph.GetTransientHeapSize(), 512u);
+	EXPECT_EQ(_graph.GetStatistics().naiveTransientBytes, 768u);
+
+	// The aliasing barrier lands on the pass first using the new resource.
+	const std::vector<RENDER_GRAPH::ALIASING>& aliasing = _graph.GetPass(pass2).aliasing;
+	ASSERT_EQ(aliasing.size(), 1u);
+	EXPECT_EQ(aliasing[0].before, first);
+	EXPECT_EQ(aliasing[0].after, third);
+
+	EXPECT_TRUE(_graph.GetPass(pass1).aliasing.empty());
+	EXPECT_TRUE(_graph.GetPass(pass3).aliasing.empty());
+
+	// The memory of First was used by Third in the previous frame.
+	ASSERT_EQ(_graph.GetPass(pass0).aliasing.size(), 1u);
+	EXPECT_EQ(_graph.GetPass(pass0).aliasing[0].before, third);
+	EXPECT_EQ(_graph.GetPass(pass0).aliasing[0].after, first);
+}
+
+TEST_F(RenderGraphTest, RepeatedUnorderedAccessWritesNeedUavBarriers)
+{
+	RESOURCE_HANDLE buffer = _graph.CreateTransient("Buffer", 1024, 256);
+
+	PASS_HANDLE clear = AddPass("Clear");
+	_graph.Write(clear, buffer, STATE_UNORDERED_ACCESS);
+
+	PASS_HANDLE accumulate = AddPass("Accumulate");
+	_graph.Read(accumulate, buffer, STATE_UNORDERED_ACCESS);
+	_graph.Write(accumulate, buffer, STATE_UNORDERED_ACCESS);
+
+	PASS_HANDLE present = AddPass("Present");
+	_graph.Read(present, buffer, STATE_PIXEL_SHADER_RESOURCE);
+	_graph.Write(present, _backBuffer, STATE_RENDER_TARGET);
+
+	_graph.Compile();
+
+	ASSERT_EQ(_graph.GetPass(clear).transitions.size(), 1u);
+	EXPECT_EQ(_graph.GetPass(clear).transitions[0].state, STATE_UNORDERED_ACCESS);
+	EXPECT_TRUE(_graph.GetPass(clear).uavBarriers.empty());
+
+	EXPECT_TRUE(_graph.GetPass(accumulate).transitions.empty());
+	EXPECT_EQ(_graph.GetPass(accumulate).uavBarriers, std::vector<RESOURCE_HANDLE>{ buffer });
+
+	EXPECT_TRUE(_graph.GetPass(present).uavBarriers.empty());
+	EXPECT_EQ(_graph.GetPass(present).transitions.size(), 2u);
+}
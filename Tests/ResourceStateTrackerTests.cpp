@@ -0,0 +1,200 @@
+#include "ResourceStateTracker.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// Resource states, D3D12_RESOURCE_STATES values.
+const uint32_t STATE_COMMON = 0x0;
+const uint32_t STATE_RENDER_TARGET = 0x4;
+const uint32_t STATE_UNORDERED_ACCESS = 0x8;
+const uint32_t STATE_PIXEL_SHADER_RESOURCE = 0x80;
+const uint32_t STATE_COPY_DEST = 0x400;
+
+typedef RESOURCE_STATE_TRACKER::BARRIER BARRIER;
+
+static void ExpectTransition(const BARRIER& barrier, const void* resource, uint32_t subresource, uint32_t before, uint32_t after)
+{
+	EXPECT_EQ(barrier.type, RESOURCE_STATE_TRACKER::BARRIER_TRANSITION);
+	EXPECT_EQ(barrier.resource, resource);
+	EXPECT_EQ(barrier.subresource, subresource);
+	EXPECT_EQ(barrier.before, before);
+	EXPECT_EQ(barrier.after, after);
+}
+
+class ResourceStateTrackerTest : public ::testing::Test
+{
+protected:
+	virtual void SetUp() override
+	{
+		_globalStates.Add(&_texture, STATE_COMMON, 4, false);
+		_globalStates.Add(&_buffer, STATE_COMMON, 1, true);
+	}
+
+	// What COMMAND_QUEUE does on submission, returns the fix-up barriers.
+	std::vector<BARRIER> Submit(RESOURCE_STATE_TRACKER& tracker)
+	{
+		std::vector<BARRIER> fixUps;
+		std::vector<const void*> decayed;
+
+		auto lock = _globalStates.Lock();
+		tracker.ResolvePendingBarriers(fixUps);
+		tracker.CommitFinalStates(decayed);
+		_globalStates.Decay(decayed);
+		return fixUps;
+	}
+
+	uint32_t GetGlobalState(const void* resource, uint32_t subresource = 0)
+	{
+		RESOURCE_STATE state;
+		EXPECT_TRUE(_globalStates.Get(resource, state));
+		return state.Get(subresource);
+	}
+
+	GLOBAL_RESOURCE_STATES	_globalStates;
+	int						_texture = 0;
+	int						_buffer = 0;
+};
+
+TEST_F(ResourceStateTrackerTest, MergesTransitionsWithinABatch)
+{
+	RESOURCE_STATE_TRACKER tracker(&_globalStates);
+	tracker.TransitionResource(&_texture, 4, STATE_COPY_DEST);
+	tracker.TransitionResource(&_texture, 4, STATE_RENDER_TARGET);
+	tracker.TransitionResource(&_texture, 4, STATE_PIXEL_SHADER_RESOURCE);
+
+	std::vector<BARRIER> barriers;
+	tracker.FlushBarriers(barriers);
+	ASSERT_EQ(barriers.size(), 1u);
+	ExpectTransition(barriers[0], &_texture, RESOURCE_STATE::ALL_SUBRESOURCES, STATE_COMMON, STATE_PIXEL_SHADER_RESOURCE);
+	EXPECT_FALSE(tracker.HasBarriers());
+}
+
+TEST_F(ResourceStateTrackerTest, CancelsARoundTrip)
+{
+	RESOURCE_STATE_TRACKER tracker(&_globalStates);
+	tracker.TransitionResource(&_texture, 4, STATE_RENDER_TARGET);
+	tracker.TransitionResource(&_texture, 4, STATE_COMMON);
+
+	// Already in the requested state.
+	tracker.TransitionResource(&_texture, 4, STATE_COMMON);
+
+	EXPECT_FALSE(tracker.HasBarriers());
+}
+
+TEST_F(ResourceStateTrackerTest, FlushEndsTheBatch)
+{
+	RESOURCE_STATE_TRACKER tracker(&_globalStates);
+	std::vector<BARRIER> barriers;
+
+	tracker.TransitionResource(&_texture, 4, STATE_RENDER_TARGET);
+	tracker.FlushBarriers(barriers);
+	tracker.TransitionResource(&_texture, 4, STATE_COMMON);
+	tracker.FlushBarriers(barriers);
+
+	ASSERT_EQ(barriers.size(), 2u);
+	ExpectTransition(barriers[0], &_texture, RESOURCE_STATE::ALL_SUBRESOURCES, STATE_COMMON, STATE_RENDER_TARGET);
+	ExpectTransition(barriers[1], &_texture, RESOURCE_STATE::ALL_SUBRESOURCES, STATE_RENDER_TARGET, STATE_COMMON);
+}
+
+TEST_F(ResourceStateTrackerTest, UAVBarriersAreNotMergedAcross)
+{
+	RESOURCE_STATE_TRACKER tracker(&_globalStates);
+	tracker.TransitionResource(&_texture, 4, STATE_UNORDERED_ACCESS);
+	tracker.UAVBarrier(&_texture);
+	tracker.UAVBarrier(&_texture);
+	tracker.TransitionResource(&_texture, 4, STATE_COMMON);
+
+	std::vector<BARRIER> barriers;
+	tracker.FlushBarriers(barriers);
+	ASSERT_EQ(barriers.size(), 3u);
+	ExpectTransition(barriers[0], &_texture, RESOURCE_STATE::ALL_SUBRESOURCES, STATE_COMMON, STATE_UNORDERED_ACCESS);
+	EXPECT_EQ(barriers[1].type, RESOURCE_STATE_TRACKER::BARRIER_UAV);
+	EXPECT_EQ(barriers[1].resource, &_texture);
+	ExpectTransition(barriers[2], &_texture, RESOURCE_STATE::ALL_SUBRESOURCES, STATE_UNORDERED_ACCESS, STATE_COMMON);
+}
+
+TEST_F(ResourceStateTrackerTest, TracksSubresourcesSeparately)
+{
+	RESOURCE_STATE_TRACKER tracker(&_globalStates);
+	tracker.TransitionResource(&_texture, 4, STATE_RENDER_TARGET, 1);
+	tracker.TransitionResource(&_texture, 4, STATE_PIXEL_SHADER_RESOURCE);
+
+	// The whole resource transition is split, the one of subresource 1 merged.
+	std::vector<BARRIER> barriers;
+	tracker.FlushBarriers(barriers);
+	ASSERT_EQ(barriers.size(), 4u);
+	for (const BARRIER& barrier : barriers)
+	{
+		EXPECT_NE(barrier.subresource, RESOURCE_STATE::ALL_SUBRESOURCES);
+		EXPECT_EQ(barrier.before, STATE_COMMON);
+		EXPECT_EQ(barrier.after, STATE_PIXEL_SHADER_RESOURCE);
+	}
+
+	Submit(tracker);
+
+	RESOURCE_STATE state;
+	ASSERT_TRUE(_globalStates.Get(&_texture, state));
+	EXPECT_TRUE(state.IsUniform());
+	EXPECT_EQ(state.state, STATE_PIXEL_SHADER_RESOURCE);
+}
+
+TEST_F(ResourceStateTrackerTest, ResolvesStaleStatesWithAFixUpList)
+{
+	// Both lists are recorded against COMMON.
+	RESOURCE_STATE_TRACKER copyTracker(&_globalStates);
+	copyTracker.TransitionResource(&_texture, 4, STATE_COPY_DEST);
+	copyTracker.TransitionResource(&_texture, 4, STATE_RENDER_TARGET, 2);
+
+	RESOURCE_STATE_TRACKER renderTracker(&_globalStates);
+	renderTracker.TransitionResource(&_texture, 4, STATE_PIXEL_SHADER_RESOURCE);
+
+	std::vector<BARRIER> barriers;
+	copyTracker.FlushBarriers(barriers);
+	renderTracker.FlushBarriers(barriers);
+
+	EXPECT_TRUE(Submit(copyTracker).empty());
+	EXPECT_EQ(GetGlobalState(&_texture, 0), STATE_COPY_DEST);
+	EXPECT_EQ(GetGlobalState(&_texture, 2), STATE_RENDER_TARGET);
+
+	// Every subresource goes back to the COMMON state the second list assumed.
+	std::vector<BARRIER> fixUps = Submit(renderTracker);
+	ASSERT_EQ(fixUps.size(), 4u);
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		ExpectTransition(fixUps[i], &_texture, i, i == 2 ? STATE_RENDER_TARGET : STATE_COPY_DEST, STATE_COMMON);
+	}
+	EXPECT_EQ(GetGlobalState(&_texture), STATE_PIXEL_SHADER_RESOURCE);
+
+	// Nothing to fix up once the states agree.
+	RESOURCE_STATE_TRACKER nextTracker(&_globalStates);
+	nextTracker.TransitionResource(&_texture, 4, STATE_RENDER_TARGET);
+	nextTracker.FlushBarriers(barriers);
+	EXPECT_TRUE(Submit(nextTracker).empty());
+}
+
+TEST_F(ResourceStateTrackerTest, BuffersDecayToCommonAfterSubmission)
+{
+	RESOURCE_STATE_TRACKER tracker(&_globalStates);
+	tracker.TransitionResource(&_buffer, 1, STATE_COPY_DEST);
+	tracker.TransitionResource(&_texture, 4, STATE_RENDER_TARGET);
+
+	std::vector<BARRIER> barriers;
+	tracker.FlushBarriers(barriers);
+	Submit(tracker);
+
+	EXPECT_EQ(GetGlobalState(&_buffer), STATE_COMMON);
+	EXPECT_EQ(GetGlobalState(&_texture), STATE_RENDER_TARGET);
+}
+
+TEST_F(ResourceStateTrackerTest, CopyQueueListsDecayEveryResource)
+{
+	RESOURCE_STATE_TRACKER tracker(&_globalStates, true);
+	tracker.TransitionResource(&_texture, 4, STATE_COPY_DEST);
+
+	std::vector<BARRIER> barriers;
+	tracker.FlushBarriers(barriers);
+	Submit(tracker);
+
+	EXPECT_EQ(GetGlobalState(&_texture), STATE_COMMON);
+}
@@ -0,0 +1,155 @@
+#include "RingAllocator.h"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+#include <utility>
+#include <vector>
+
+TEST(RingAllocator, AllocatesContiguouslyWithAlignment)
+{
+	RING_ALLOCATOR ring(1024);
+
+	EXPECT_EQ(ring.Allocate(10, 1), 0u);
+	EXPECT_EQ(ring.Allocate(16, 16), 16u);
+	EXPECT_EQ(ring.Allocate(4, 4), 32u);
+	EXPECT_EQ(ring.GetUsedSize(), 36u);
+
+	const RING_ALLOCATOR::STATISTICS& statistics = ring.GetStatistics();
+	EXPECT_EQ(statistics.allocationCount, 3u);
+	EXPECT_EQ(statistics.requestedBytes, 30u);
+	EXPECT_EQ(statistics.paddingBytes, 6u);
+	EXPECT_EQ(statistics.wrapBytes, 0u);
+	EXPECT_DOUBLE_EQ(statistics.GetFragmentation(), 6.0 / 36.0);
+}
+
+TEST(RingAllocator, FailsWhenFullUntilAFrameRetired)
+{
+	RING_ALLOCATOR ring(256);
+
+	EXPECT_EQ(ring.Allocate(128, 1), 0u);
+	ring.FinishFrame(1);
+	EXPECT_EQ(ring.Allocate(128, 1), 128u);
+	ring.FinishFrame(2);
+
+	EXPECT_EQ(ring.Allocate(1, 1), RING_ALLOCATOR::INVALID_OFFSET);
+	EXPECT_EQ(ring.GetStatistics().failedAllocationCount, 1u);
+	EXPECT_EQ(ring.GetOldestFenceValue(), 1u);
+
+	// Not complete yet.
+	ring.Retire(0);
+	EXPECT_EQ(ring.Allocate(1, 1), RING_ALLOCATOR::INVALID_OFFSET);
+
+	ring.Retire(1);
+	EXPECT_EQ(ring.GetUsedSize(), 128u);
+	EXPECT_EQ(ring.Allocate(128, 1), 0u);
+}
+
+TEST(RingAllocator, WrapsAroundSkippingTheEndOfTheRing)
+{
+	RING_ALLOCATOR ring(100);
+
+	EXPECT_EQ(ring.Allocate(60, 1), 0u);
+	ring.FinishFrame(1);
+	EXPECT_EQ(ring.Allocate(30, 1), 60u);
+	ring.FinishFrame(2);
+	ring.Retire(1);
+
+	// 10 bytes left at the end, too small, the allocation restarts at 0.
+	EXPECT_EQ(ring.Allocate(20, 1), 0u);
+	EXPECT_EQ(ring.GetStatistics().wrapBytes, 10u);
+	EXPECT_EQ(ring.GetUsedSize(), 60u);
+
+	// Free space is now [20, 60), the live frame starts at 60.
+	EXPECT_EQ(ring.Allocate(50, 1), RING_ALLOCATOR::INVALID_OFFSET);
+	EXPECT_EQ(ring.Allocate(40, 1), 20u);
+	ring.FinishFrame(3);
+
+	// The wrapped bytes are released with the frame which skipped them.
+	ring.Retire(3);
+	EXPECT_EQ(ring.GetUsedSize(), 0u);
+	EXPECT_FALSE(ring.HasPendingFrames());
+}
+
+TEST(RingAllocator, RestartsFromTheBeginningWhenEmpty)
+{
+	RING_ALLOCATOR ring(256);
+
+	EXPECT_EQ(ring.Allocate(200, 1), 0u);
+	ring.FinishFrame(1);
+	ring.Retire(1);
+
+	// Would not fit behind the previous head.
+	EXPECT_EQ(ring.Allocate(256, 1), 0u);
+	EXPECT_EQ(ring.GetStatistics().wrapBytes, 0u);
+}
+
+TEST(RingAllocator, EmptyFramesAreNotTracked)
+{
+	RING_ALLOCATOR ring(256);
+
+	ring.FinishFrame(1);
+	EXPECT_FALSE(ring.HasPendingFrames());
+}
+
+// Frames of random allocations retired a few frames late, no two live allocations overlap
+// and the used size matches what the frames consumed.
+TEST(RingAllocator, LiveAllocationsNeverOverlap)
+{
+	const uint64_t capacity = 4096;
+	const uint64_t framesInFlight = 3;
+
+	RING_ALLOCATOR ring(capacity);
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<uint64_t> sizes(1, 300);
+	std::uniform_int_distribution<int> alignmentShifts(0, 8);
+
+	typedef std::pair<uint64_t, uint64_t> RANGE;
+	std::deque<std::vector<RANGE>> liveFrames;
+
+	for (uint64_t frame = 1; frame <= 500; ++frame)
+	{
+		if (frame > framesInFlight)
+		{
+			ring.Retire(frame - framesInFlight);
+			liveFrames.pop_front();
+		}
+
+		std::vector<RANGE> ranges;
+		for (int i = 0; i < 8; ++i)
+		{
+			uint64_t size = sizes(random);
+			uint64_t alignment = 1ull << alignmentShifts(random);
+			uint64_t offset = ring.Allocate(size, alignment);
+			if (offset == RING_ALLOCATOR::INVALID_OFFSET)
+			{
+				continue;
+			}
+
+			ASSERT_EQ(offset % alignment, 0u);
+			ASSERT_LE(offset + size, capacity);
+			for (const std::vector<RANGE>& liveRanges : liveFrames)
+			{
+				for (const RANGE& range : liveRanges)
+				{
+					ASSERT_TRUE(offset + size <= range.first || range.second <= offset);
+				}
+			}
+			for (const RANGE& range : ranges)
+			{
+				ASSERT_TRUE(offset + size <= range.first || range.second <= offset);
+			}
+			ranges.push_back(RANGE(offset, offset + size));
+		}
+
+		ring.FinishFrame(frame);
+		liveFrames.push_back(ranges);
+		ASSERT_LE(ring.GetUsedSize(), capacity);
+	}
+
+	ring.Retire(UINT64_MAX);
+	EXPECT_EQ(ring.GetUsedSize(), 0u);
+	EXPECT_GT(ring.GetStatistics().wrapBytes, 0u);
+	EXPECT_GT(ring.GetStatistics().failedAllocationCount, 0u);
+}
@@ -0,0 +1,174 @@
+#include "TransformHierarchy.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace VectorMath;
+
+typedef TRANSFORM_HIERARCHY::HANDLE HANDLE;
+
+// Random forest mirrored by a recursive reference, local transforms are kept per handle.
+class TransformHierarchyTest : public ::testing::Test
+{
+protected:
+	HANDLE Add(HANDLE parent)
+	{
+		HANDLE handle = _hierarchy.Add(parent);
+		EXPECT_EQ(handle, _parents.size());
+		_parents.push_back(parent);
+		_locals.push_back(MatrixIdentity());
+		return handle;
+	}
+
+	// Deep chains mixed with wide levels and new roots.
+	void AddRandomNodes(uint32_t count)
+	{
+		std::uniform_int_distribution<uint32_t> choice(0, 9);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			uint32_t existing = static_cast<uint32_t>(_parents.size());
+			uint32_t kind = choice(_random);
+			HANDLE parent = TRANSFORM_HIERARCHY::INVALID_HANDLE;
+			if (existing > 0 && kind < 5)
+			{
+				parent = existing - 1;
+			}
+			else if (existing > 0 && kind < 9)
+			{
+				parent = std::uniform_int_distribution<uint32_t>(0, existing - 1)(_random);
+			}
+			SetRandomLocal(Add(parent));
+		}
+	}
+
+	void SetRandomLocal(HANDLE node)
+	{
+		std::uniform_real_distribution<float> position(-5.0f, 5.0f);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> scale(0.8f, 1.25f);
+
+		FLOAT3 localPosition = { position(_random), position(_random), position(_random) };
+		VECTOR axis = VectorSet(unit(_random), unit(_random), unit(_random) + 2.0f, 0.0f);
+		FLOAT4 rotation;
+		StoreFloat4(&rotation, QuaternionRotationAxis(axis, unit(_random) * 3.0f));
+		FLOAT3 localScale = { scale(_random), scale(_random), scale(_random) };
+
+		_hierarchy.SetLocal(node, localPosition, rotation, localScale);
+
+		// Scale, then rotation, then translation.
+		_locals[node] = MatrixMultiply(MatrixMultiply(MatrixScaling(localScale.x, localScale.y, localScale.z), MatrixRotationQuaternion(LoadFloat4(&rotation))),
+			MatrixTranslation(localPosition.x, localPosition.y, localPosition.z));
+	}
+
+	MATRIX ComputeReferenceWorld(HANDLE node) const
+	{
+		HANDLE parent = _parents[node];
+		return parent == TRANSFORM_HIERARCHY::INVALID_HANDLE ? _locals[node] : MatrixMultiply(_locals[node], ComputeReferenceWorld(parent));
+	}
+
+	uint32_t CountSubtree(HANDLE node) const
+	{
+		uint32_t count = 1;
+		for (HANDLE child = node + 1; child < _parents.size(); ++child)
+		{
+			if (_parents[child] == node)
+			{
+				count += CountSubtree(child);
+			}
+		}
+		return count;
+	}
+
+	void ExpectWorldsMatchReference() const
+	{
+		for (HANDLE node = 0; node < _parents.size(); ++node)
+		{
+			FLOAT4X4 world, expected;
+			StoreFloat4x4(&world, _hierarchy.GetWorld(node));
+			StoreFloat4x4(&expected, ComputeReferenceWorld(node));
+			for (int row = 0; row < 4; ++row)
+			{
+				for (int column = 0; column < 4; ++column)
+				{
+					float tolerance = 1e-4f * (1.0f + std::fabs(expected.m[row][column]));
+					ASSERT_NEAR(world.m[row][column], expected.m[row][column], tolerance) << "node " << node << " [" << row << "][" << column << "]";
+				}
+			}
+
+			// Parents are stored before their children.
+			if (_parents[node] != TRANSFORM_HIERARCHY::INVALID_HANDLE)
+			{
+				ASSERT_LT(_hierarchy.GetStorageIndex(_parents[node]), _hierarchy.GetStorageIndex(node));
+			}
+		}
+	}
+
+	TRANSFORM_HIERARCHY		_hierarchy;
+	std::vector<HANDLE>		_parents;
+	std::vector<MATRIX>		_locals;
+	std::mt19937			_random{ 23 };
+};
+
+TEST_F(TransformHierarchyTest, MatchesRecursiveReference)
+{
+	AddRandomNodes(2000);
+	_hierarchy.Update();
+
+	EXPECT_EQ(_hierarchy.GetCount(), 2000u);
+	EXPECT_EQ(_hierarchy.GetUpdatedCount(), 2000u);
+	ExpectWorldsMatchReference();
+
+	_hierarchy.Update();
+	EXPECT_EQ(_hierarchy.GetUpdatedCount(), 0u);
+}
+
+TEST_F(TransformHierarchyTest, UpdatesOnlyTheChangedSubtree)
+{
+	AddRandomNodes(2000);
+	_hierarchy.Update();
+
+	std::uniform_int_distribution<uint32_t> node(0, 1999);
+	for (int i = 0; i < 20; ++i)
+	{
+		HANDLE changed = node(_random);
+		SetRandomLocal(changed);
+		_hierarchy.Update();
+
+		EXPECT_EQ(_hierarchy.GetUpdatedCount(), CountSubtree(changed)) << "node " << changed;
+		ExpectWorldsMatchReference();
+	}
+}
+
+TEST_F(TransformHierarchyTest, HandlesSurviveDepthSort)
+{
+	AddRandomNodes(500);
+	_hierarchy.Update();
+
+	// New roots and shallow children appended after deep nodes reorder the storage.
+	std::vector<uint32_t> storageBefore;
+	for (HANDLE node = 0; node < 500; ++node)
+	{
+		storageBefore.push_back(_hierarchy.GetStorageIndex(node));
+	}
+	AddRandomNodes(500);
+	HANDLE root = Add(TRANSFORM_HIERARCHY::INVALID_HANDLE);
+	SetRandomLocal(root);
+	_hierarchy.Update();
+
+	bool moved = false;
+	for (HANDLE node = 0; node < 500; ++node)
+	{
+		moved = moved || _hierarchy.GetStorageIndex(node) != storageBefore[node];
+	}
+	EXPECT_TRUE(moved);
+	ExpectWorldsMatchReference();
+
+	// Old handles still address the same nodes.
+	SetRandomLocal(3);
+	_hierarchy.Update();
+	EXPECT_EQ(_hierarchy.GetUpdatedCount(), CountSubtree(3));
+	ExpectWorldsMatchReference();
+}
@@ -0,0 +1,318 @@
+#include "VectorMath.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+// DirectXMath comes with the Windows SDK, elsewhere CMake adds it when installed or fetched
+// with DIRECTX12_TUTORIAL_FETCH_DIRECTXMATH.
+#if defined(__has_include)
+#if __has_include(<DirectXMath.h>)
+#define VECTOR_MATH_TESTS_DIRECTXMATH 1
+#include <DirectXMath.h>
+#endif
+#endif
+
+using namespace VectorMath;
+
+// Floats compared as bits, -0.0f differs from 0.0f.
+static void ExpectBits(const float* actual, const uint32_t* expectedBits, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		uint32_t actualBits;
+		memcpy(&actualBits, &actual[i], sizeof(actualBits));
+		EXPECT_EQ(actualBits, expectedBits[i]) << "element " << i << ": " << actual[i];
+	}
+}
+
+static void ExpectSameBits(const float* actual, const float* expected, size_t count)
+{
+	std::vector<uint32_t> expectedBits(count);
+	memcpy(expectedBits.data(), expected, count * sizeof(float));
+	ExpectBits(actual, expectedBits.data(), count);
+}
+
+static void RandomizeMatrix(FLOAT4X4& matrix, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> element(-10.0f, 10.0f);
+	for (auto& row : matrix.m)
+	{
+		for (float& value : row)
+		{
+			value = element(random);
+		}
+	}
+}
+
+// The matrix the tutorial uploads for its cube: scaled, spun about (0, 1, 1) by 'angle'
+// degrees and moved, seen by its camera, transposed for the shader.
+static FLOAT4X4 GetCubeMvp(float angle)
+{
+	MATRIX model = MatrixMultiply(MatrixScaling(0.5f, 0.5f, 0.5f), MatrixRotationQuaternion(QuaternionRotationAxis(VectorSet(0.0f, 1.0f, 1.0f, 0.0f), ConvertToRadians(angle))));
+	model = MatrixMultiply(model, MatrixTranslation(1.0f, 2.0f, 3.0f));
+	MATRIX view = MatrixLookAtLH(VectorSet(0.0f, 0.0f, -10.0f, 1.0f), VectorSet(0.0f, 0.0f, 0.0f, 1.0f), VectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	MATRIX projection = MatrixPerspectiveFovLH(ConvertToRadians(45.0f), 1280.0f / 720.0f, 0.1f, 100.0f);
+
+	FLOAT4X4 mvp;
+	StoreFloat4x4(&mvp, MatrixTranspose(MatrixMultiply(MatrixMultiply(model, view), projection)));
+	return mvp;
+}
+
+static const float g_cubeAngles[] = { 0.0f, 37.0f, 90.0f, 200.0f, -500.0f };
+
+// Recorded from the SSE2 backend on x64, which the DirectXMath tests check. Every backend
+// must produce the same bits, the scalar one is built as directx12-tutorial-scalar-tests.
+static const uint32_t g_cubeMvpBits[][16] =
+{
+	{ 0x3f2dd2c8, 0x00000000, 0x00000000, 0x3fadd2c8, 0x00000000, 0x3f9a8279, 0x00000000, 0x409a8279,
+	  0x00000000, 0x00000000, 0x3f0020cd, 0x414e9b4a, 0x00000000, 0x00000000, 0x3f000000, 0x41500000 },
+	{ 0x3f0ad24e, 0xbe93f0b0, 0x3e93f0b0, 0x3fadd2c8, 0x3f03809c, 0x3f8af40a, 0x3df8e6eb, 0x409a8279,
+	  0xbe5a1930, 0x3d4e6753, 0x3ee674af, 0x414e9b4a, 0xbe59e15b, 0x3d4e327c, 0x3ee639b0, 0x41500000 },
+	{ 0x33add2c8, 0xbef5d2c5, 0x3ef5d2c5, 0x3fadd2c8, 0x3f5a8276, 0x3f1a827a, 0x3f1a8278, 0x409a8279,
+	  0xbeb53354, 0x3e8020cc, 0x3e8020ce, 0x414e9b4a, 0xbeb504f1, 0x3e7ffffe, 0x3e800001, 0x41500000 },
+	{ 0xbf23572c, 0x3e28272c, 0xbe28272c, 0x3fadd2c8, 0xbe957827, 0x3d1516e7, 0x3f95d9c2, 0x409a8279,
+	  0x3df7e597, 0x3ef88778, 0x3c77444d, 0x414e9b4a, 0x3df7a621, 0x3ef847d8, 0x3c770500, 0x41500000 },
+	{ 0xbf052809, 0x3e9e031e, 0xbe9e031e, 0x3fadd2c8, 0xbf0c748d, 0x3e1097fc, 0x3f886f7a, 0x409a8279,
+	  0x3e68f266, 0x3ee247aa, 0x3d6fcf7c, 0x414e9b4a, 0x3e68b6c4, 0x3ee20dbd, 0x3d6f9218, 0x41500000 },
+};
+
+// Dense operands, unlike the cube the order of every sum shows in the result.
+static const FLOAT4X4 g_left = { { { 0.1f, 1.7f, -2.3f, 3.9f }, { -4.1f, 0.25f, 5.5f, -0.7f }, { 2.2f, -3.3f, 0.01f, 1.9f }, { 7.5f, 0.6f, -1.2f, 1.0f } } };
+static const FLOAT4X4 g_right = { { { 0.3f, -0.9f, 2.7f, 0.05f }, { 1.1f, 4.4f, -0.6f, 3.3f }, { -2.9f, 0.8f, 1.3f, -1.7f }, { 0.45f, -6.1f, 0.2f, 1.0f } } };
+static const FLOAT4 g_angles = { 0.3f, -2.0f, 4.5f, 100.0f };
+
+static const uint32_t g_productBits[16] =
+{
+	0x41253334, 0xc191eb86, 0xc03d70a3, 0x4156cccd, 0xc189c290, 0x41575c29, 0xc086b852, 0xc116e148,
+	0xc009374c, 0xc1e0a7f0, 0x4105020c, 0xc10e5a1c, 0x40dae149, 0xc132b852, 0x41943d71, 0x40aca3d8
+};
+
+static const uint32_t g_sinCosBits[2][4] =
+{
+	{ 0x3e974e6d, 0xbf68c7b9, 0xbf7a3f69, 0xbf01a156 },
+	{ 0x3f7490ef, 0xbed51130, 0xbe57dae0, 0x3f5cc0d6 },
+};
+
+TEST(VectorMath, CubeMvpMatchesTheRecordedBits)
+{
+	const size_t angleCount = sizeof(g_cubeAngles) / sizeof(g_cubeAngles[0]);
+	static_assert(sizeof(g_cubeMvpBits) / sizeof(g_cubeMvpBits[0]) == angleCount, "One matrix per angle");
+
+	for (size_t i = 0; i < angleCount; ++i)
+	{
+		SCOPED_TRACE(g_cubeAngles[i]);
+
+		FLOAT4X4 mvp = GetCubeMvp(g_cubeAngles[i]);
+		ExpectBits(&mvp.m[0][0], g_cubeMvpBits[i], 16);
+	}
+}
+
+TEST(VectorMath, ProductAndSinCosMatchTheRecordedBits)
+{
+	FLOAT4X4 product;
+	StoreFloat4x4(&product, MatrixMultiply(LoadFloat4x4(&g_left), LoadFloat4x4(&g_right)));
+	ExpectBits(&product.m[0][0], g_productBits, 16);
+
+	VECTOR sine, cosine;
+	VectorSinCos(&sine, &cosine, LoadFloat4(&g_angles));
+	FLOAT4 sineStorage, cosineStorage;
+	StoreFloat4(&sineStorage, sine);
+	StoreFloat4(&cosineStorage, cosine);
+	ExpectBits(&sineStorage.x, g_sinCosBits[0], 4);
+	ExpectBits(&cosineStorage.x, g_sinCosBits[1], 4);
+}
+
+TEST(VectorMath, BatchedMultiplyMatchesMatrixMultiply)
+{
+	std::mt19937 random(3);
+	FLOAT4X4 transformStorage;
+	RandomizeMatrix(transformStorage, random);
+	const MATRIX transform = LoadFloat4x4(&transformStorage);
+
+	// Not a multiple of any batch width.
+	std::vector<FLOAT4X4> source(67);
+	std::vector<FLOAT4X4> expected(source.size());
+	for (size_t i = 0; i < source.size(); ++i)
+	{
+		RandomizeMatrix(source[i], random);
+		StoreFloat4x4(&expected[i], MatrixMultiply(LoadFloat4x4(&source[i]), transform));
+	}
+
+	std::vector<MATH_ISA> isas = { MATH_ISA_SCALAR, GetBestMathIsa() };
+	if (GetBestMathIsa() == MATH_ISA_AVX2)
+	{
+		isas.push_back(MATH_ISA_SSE2);
+	}
+
+	for (MATH_ISA isa : isas)
+	{
+		SCOPED_TRACE(GetMathIsaName(isa));
+
+		std::vector<FLOAT4X4> destination(source.size());
+		MultiplyMatrices(destination.data(), source.data(), static_cast<uint32_t>(source.size()), transform, isa);
+		ExpectSameBits(&destination[0].m[0][0], &expected[0].m[0][0], expected.size() * 16);
+
+		// In place.
+		destination = source;
+		MultiplyMatrices(destination.data(), destination.data(), static_cast<uint32_t>(destination.size()), transform, isa);
+		ExpectSameBits(&destination[0].m[0][0], &expected[0].m[0][0], expected.size() * 16);
+	}
+}
+
+#if VECTOR_MATH_TESTS_DIRECTXMATH
+
+static void ExpectSameBits(const MATRIX& actual, DirectX::FXMMATRIX expected)
+{
+	FLOAT4X4 actualStorage;
+	DirectX::XMFLOAT4X4 expectedStorage;
+	StoreFloat4x4(&actualStorage, actual);
+	DirectX::XMStoreFloat4x4(&expectedStorage, expected);
+	ExpectSameBits(&actualStorage.m[0][0], &expectedStorage.m[0][0], 16);
+}
+
+static void ExpectSameBits(VECTOR actual, DirectX::FXMVECTOR expected)
+{
+	FLOAT4 actualStorage;
+	DirectX::XMFLOAT4 expectedStorage;
+	StoreFloat4(&actualStorage, actual);
+	DirectX::XMStoreFloat4(&expectedStorage, expected);
+	ExpectSameBits(&actualStorage.x, &expectedStorage.x, 4);
+}
+
+// Random inputs, each loaded both ways.
+class VectorMathDirectXMathTest : public ::testing::Test
+{
+protected:
+	static const int ITERATIONS = 1000;
+
+	void NextVector(VECTOR& v, DirectX::XMVECTOR& xm, float range)
+	{
+		std::uniform_real_distribution<float> component(-range, range);
+		FLOAT4 storage = { component(_random), component(_random), component(_random), component(_random) };
+		DirectX::XMFLOAT4 xmStorage(&storage.x);
+		v = LoadFloat4(&storage);
+		xm = DirectX::XMLoadFloat4(&xmStorage);
+	}
+
+	void NextMatrix(MATRIX& m, DirectX::XMMATRIX& xm)
+	{
+		FLOAT4X4 storage;
+		RandomizeMatrix(storage, _random);
+		DirectX::XMFLOAT4X4 xmStorage(&storage.m[0][0]);
+		m = LoadFloat4x4(&storage);
+		xm = DirectX::XMLoadFloat4x4(&xmStorage);
+	}
+
+	float NextFloat(float min, float max)
+	{
+		return std::uniform_real_distribution<float>(min, max)(_random);
+	}
+
+	std::mt19937 _random{ 5 };
+};
+
+TEST_F(VectorMathDirectXMathTest, CubeMvp)
+{
+	using namespace DirectX;
+
+	for (float angle : g_cubeAngles)
+	{
+		SCOPED_TRACE(angle);
+
+		XMMATRIX model = XMMatrixMultiply(XMMatrixScaling(0.5f, 0.5f, 0.5f), XMMatrixRotationQuaternion(XMQuaternionRotationAxis(XMVectorSet(0.0f, 1.0f, 1.0f, 0.0f), XMConvertToRadians(angle))));
+		model = XMMatrixMultiply(model, XMMatrixTranslation(1.0f, 2.0f, 3.0f));
+		XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, -10.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMMATRIX projection = XMMatrixPerspectiveFovLH(XMConvertToRadians(45.0f), 1280.0f / 720.0f, 0.1f, 100.0f);
+
+		XMFLOAT4X4 expected;
+		XMStoreFloat4x4(&expected, XMMatrixTranspose(XMMatrixMultiply(XMMatrixMultiply(model, view), projection)));
+
+		FLOAT4X4 mvp = GetCubeMvp(angle);
+		ExpectSameBits(&mvp.m[0][0], &expected.m[0][0], 16);
+	}
+}
+
+TEST_F(VectorMathDirectXMathTest, Matrices)
+{
+	for (int i = 0; i < ITERATIONS; ++i)
+	{
+		MATRIX a, b;
+		DirectX::XMMATRIX xmA, xmB;
+		NextMatrix(a, xmA);
+		NextMatrix(b, xmB);
+		ExpectSameBits(MatrixMultiply(a, b), DirectX::XMMatrixMultiply(xmA, xmB));
+		ExpectSameBits(MatrixTranspose(a), DirectX::XMMatrixTranspose(xmA));
+
+		float x = NextFloat(-10.0f, 10.0f), y = NextFloat(-10.0f, 10.0f), z = NextFloat(-10.0f, 10.0f);
+		ExpectSameBits(MatrixScaling(x, y, z), DirectX::XMMatrixScaling(x, y, z));
+		ExpectSameBits(MatrixTranslation(x, y, z), DirectX::XMMatrixTranslation(x, y, z));
+	}
+}
+
+TEST_F(VectorMathDirectXMathTest, Rotations)
+{
+	for (int i = 0; i < ITERATIONS; ++i)
+	{
+		VECTOR axis;
+		DirectX::XMVECTOR xmAxis;
+		NextVector(axis, xmAxis, 1.0f);
+		float angle = NextFloat(-20.0f, 20.0f);
+
+		VECTOR quaternion = QuaternionRotationAxis(axis, angle);
+		DirectX::XMVECTOR xmQuaternion = DirectX::XMQuaternionRotationAxis(xmAxis, angle);
+		ExpectSameBits(quaternion, xmQuaternion);
+		ExpectSameBits(MatrixRotationQuaternion(quaternion), DirectX::XMMatrixRotationQuaternion(xmQuaternion));
+	}
+}
+
+TEST_F(VectorMathDirectXMathTest, Cameras)
+{
+	for (int i = 0; i < ITERATIONS; ++i)
+	{
+		VECTOR eye, focus;
+		DirectX::XMVECTOR xmEye, xmFocus;
+		NextVector(eye, xmEye, 100.0f);
+		NextVector(focus, xmFocus, 100.0f);
+		ExpectSameBits(MatrixLookAtLH(eye, focus, VectorSet(0.0f, 1.0f, 0.0f, 0.0f)), DirectX::XMMatrixLookAtLH(xmEye, xmFocus, DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)));
+
+		float fov = NextFloat(0.1f, 3.0f), aspectRatio = NextFloat(0.5f, 3.0f), nearZ = NextFloat(0.01f, 1.0f), farZ = NextFloat(10.0f, 10000.0f);
+		ExpectSameBits(MatrixPerspectiveFovLH(fov, aspectRatio, nearZ, farZ), DirectX::XMMatrixPerspectiveFovLH(fov, aspectRatio, nearZ, farZ));
+	}
+}
+
+TEST_F(VectorMathDirectXMathTest, Vectors)
+{
+	for (int i = 0; i < ITERATIONS; ++i)
+	{
+		VECTOR v;
+		DirectX::XMVECTOR xmV;
+		NextVector(v, xmV, 100.0f);
+		MATRIX m;
+		DirectX::XMMATRIX xmM;
+		NextMatrix(m, xmM);
+
+		ExpectSameBits(Vector3Dot(v, v), DirectX::XMVector3Dot(xmV, xmV));
+		ExpectSameBits(Vector3Normalize(v), DirectX::XMVector3Normalize(xmV));
+		ExpectSameBits(PlaneNormalize(v), DirectX::XMPlaneNormalize(xmV));
+		ExpectSameBits(Vector3TransformCoord(v, m), DirectX::XMVector3TransformCoord(xmV, xmM));
+
+		VECTOR sine, cosine;
+		DirectX::XMVECTOR xmSine, xmCosine;
+		VectorSinCos(&sine, &cosine, v);
+		DirectX::XMVectorSinCos(&xmSine, &xmCosine, xmV);
+		ExpectSameBits(sine, xmSine);
+		ExpectSameBits(cosine, xmCosine);
+
+		float angle = NextFloat(-100.0f, 100.0f);
+		float scalarSine, scalarCosine, xmScalarSine, xmScalarCosine;
+		ScalarSinCos(&scalarSine, &scalarCosine, angle);
+		DirectX::XMScalarSinCos(&xmScalarSine, &xmScalarCosine, angle);
+		ExpectSameBits(&scalarSine, &xmScalarSine, 1);
+		ExpectSameBits(&scalarCosine, &xmScalarCosine, 1);
+	}
+}
+
+#endif
@@ -0,0 +1,220 @@
+#include "VertexQuantization.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Not a multiple of the 4 vertices the SSE2 encoders process at once.
+const uint32_t g_vertexCount = 1027;
+
+// Portable generator, the recorded bytes must not depend on the standard library.
+class RANDOM
+{
+public:
+	// In [minimum, maximum).
+	float Next(float minimum, float maximum)
+	{
+		_state = _state * 6364136223846793005ull + 1442695040888963407ull;
+		return minimum + (maximum - minimum) * static_cast<float>(_state >> 40) * (1.0f / 16777216.0f);
+	}
+
+private:
+	uint64_t _state = 31;
+};
+
+// FNV-1a of the encoded bytes.
+static uint64_t HashBytes(const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+// Positions in [-3, 5) x [-1, 1) x [0, 100), with w, and their bounds.
+static std::vector<float> CreatePositions(RANDOM& random, MESH_BOUNDS& bounds)
+{
+	const float minimum[3] = { -3.0f, -1.0f, 0.0f };
+	const float maximum[3] = { 5.0f, 1.0f, 100.0f };
+
+	std::vector<float> positions(g_vertexCount * 4);
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		bounds.min[axis] = maximum[axis];
+		bounds.max[axis] = minimum[axis];
+	}
+	for (uint32_t vertex = 0; vertex < g_vertexCount; ++vertex)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float p = random.Next(minimum[axis], maximum[axis]);
+			positions[vertex * 4 + axis] = p;
+			bounds.min[axis] = std::min(bounds.min[axis], p);
+			bounds.max[axis] = std::max(bounds.max[axis], p);
+		}
+		positions[vertex * 4 + 3] = 1.0f;
+	}
+	return positions;
+}
+
+// Random directions of random lengths, some on the axes and one zero vector.
+static std::vector<float> CreateNormals(RANDOM& random)
+{
+	std::vector<float> normals(g_vertexCount * 3);
+	for (float& n : normals)
+	{
+		n = random.Next(-2.0f, 2.0f);
+	}
+
+	const float special[][3] = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { -0.5f, 0.5f, 0.0f } };
+	for (size_t i = 0; i < sizeof(special) / sizeof(special[0]); ++i)
+	{
+		memcpy(&normals[(i * 7 + 1) * 3], special[i], sizeof(special[i]));
+	}
+	return normals;
+}
+
+static std::vector<float> CreateColors(RANDOM& random)
+{
+	std::vector<float> colors(g_vertexCount * 4);
+	for (float& c : colors)
+	{
+		// Out of range values are clamped.
+		c = random.Next(-0.1f, 1.1f);
+	}
+	return colors;
+}
+
+// Both test binaries, SSE2 and VERTEX_QUANTIZATION_NO_INTRINSICS, must write these bytes.
+TEST(VertexQuantization, MatchesRecordedBytes)
+{
+	RANDOM random;
+	MESH_BOUNDS bounds;
+	const std::vector<float> positions = CreatePositions(random, bounds);
+	const std::vector<float> normals = CreateNormals(random);
+	const std::vector<float> colors = CreateColors(random);
+
+	std::vector<int16_t> encodedPositions(g_vertexCount * 4);
+	EncodePositionsSnorm16(encodedPositions.data(), positions.data(), 4, g_vertexCount, bounds);
+	EXPECT_EQ(HashBytes(encodedPositions.data(), encodedPositions.size() * sizeof(int16_t)), 12438857715001449861ull);
+
+	// Packed xyz, and a count leaving a tail of 1.
+	std::vector<float> positions3;
+	for (uint32_t vertex = 0; vertex < g_vertexCount; ++vertex)
+	{
+		positions3.insert(positions3.end(), &positions[vertex * 4], &positions[vertex * 4 + 3]);
+	}
+	encodedPositions.assign(encodedPositions.size(), 0);
+	EncodePositionsSnorm16(encodedPositions.data(), positions3.data(), 3, g_vertexCount - 2, bounds);
+	EXPECT_EQ(HashBytes(encodedPositions.data(), encodedPositions.size() * sizeof(int16_t)), 13913188658975769483ull);
+
+	std::vector<int16_t> encodedNormals(g_vertexCount * 2);
+	EncodeNormalsOctahedral(encodedNormals.data(), normals.data(), g_vertexCount);
+	EXPECT_EQ(HashBytes(encodedNormals.data(), encodedNormals.size() * sizeof(int16_t)), 15687551104834416379ull);
+
+	std::vector<uint8_t> encodedColors(g_vertexCount * 4);
+	EncodeColorsUnorm8(encodedColors.data(), colors.data(), 4, g_vertexCount);
+	EXPECT_EQ(HashBytes(encodedColors.data(), encodedColors.size()), 2369403530101923532ull);
+
+	EncodeColorsUnorm8(encodedColors.data(), colors.data(), 3, g_vertexCount);
+	EXPECT_EQ(HashBytes(encodedColors.data(), encodedColors.size()), 10875920435279674761ull);
+}
+
+// The SSE2 encoders leave the last vertices to the scalar loop, encoding one vertex
+// at a time only runs the scalar code.
+TEST(VertexQuantization, VerticesEncodeAloneAsInBatches)
+{
+	RANDOM random;
+	MESH_BOUNDS bounds;
+	const std::vector<float> positions = CreatePositions(random, bounds);
+	const std::vector<float> normals = CreateNormals(random);
+
+	std::vector<int16_t> batch(g_vertexCount * 4);
+	std::vector<int16_t> alone(g_vertexCount * 4);
+	EncodePositionsSnorm16(batch.data(), positions.data(), 4, g_vertexCount, bounds);
+	for (uint32_t vertex = 0; vertex < g_vertexCount; ++vertex)
+	{
+		EncodePositionsSnorm16(&alone[vertex * 4], &positions[vertex * 4], 4, 1, bounds);
+	}
+	EXPECT_EQ(batch, alone);
+
+	batch.resize(g_vertexCount * 2);
+	alone.resize(g_vertexCount * 2);
+	EncodeNormalsOctahedral(batch.data(), normals.data(), g_vertexCount);
+	for (uint32_t vertex = 0; vertex < g_vertexCount; ++vertex)
+	{
+		EncodeNormalsOctahedral(&alone[vertex * 2], &normals[vertex * 3], 1);
+	}
+	EXPECT_EQ(batch, alone);
+}
+
+TEST(VertexQuantization, ErrorsStayWithinBounds)
+{
+	RANDOM random;
+	MESH_BOUNDS bounds;
+	std::vector<float> positions = CreatePositions(random, bounds);
+	const std::vector<float> normals = CreateNormals(random);
+	const std::vector<float> colors = CreateColors(random);
+
+	MESH_DATA mesh;
+	mesh.vertexCount = g_vertexCount;
+	auto addStream = [&mesh](MESH_SEMANTIC semantic, MESH_FORMAT format, const std::vector<float>& values)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+		mesh.streams.push_back(MESH_DATA::STREAM{ semantic, format, std::vector<uint8_t>(bytes, bytes + values.size() * sizeof(float)) });
+	};
+	addStream(MESH_SEMANTIC_POSITION, MESH_FORMAT_FLOAT4, positions);
+	addStream(MESH_SEMANTIC_NORMAL, MESH_FORMAT_FLOAT3, normals);
+	addStream(MESH_SEMANTIC_COLOR, MESH_FORMAT_FLOAT4, colors);
+	ComputeMeshBounds(mesh);
+
+	VERTEX_QUANTIZATION_STATISTICS statistics = QuantizeMesh(mesh);
+	EXPECT_EQ(statistics.sourceBytes, g_vertexCount * (16u + 12u + 16u));
+	EXPECT_EQ(statistics.quantizedBytes, g_vertexCount * (8u + 4u + 4u));
+
+	// Half a step of the largest axis, a half extent of 50 over 32767 steps, plus float rounding.
+	EXPECT_GT(statistics.positionError, 0.0f);
+	EXPECT_LE(statistics.positionError, statistics.positionErrorBound);
+	EXPECT_LT(statistics.positionErrorBound, 50.0f / 32767.0f * 0.5f * 1.05f);
+
+	// Measured independently of the statistics.
+	const MESH_DATA::STREAM& encodedPositions = mesh.streams[0];
+	ASSERT_EQ(encodedPositions.format, MESH_FORMAT_SNORM16X4);
+	for (uint32_t vertex = 0; vertex < g_vertexCount; ++vertex)
+	{
+		float decoded[3];
+		DecodeMeshPosition(MESH_FORMAT_SNORM16X4, &encodedPositions.data[vertex * 8], mesh.bounds, decoded);
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			ASSERT_LE(std::fabs(decoded[axis] - positions[vertex * 4 + axis]), statistics.positionErrorBound) << "vertex " << vertex;
+		}
+	}
+
+	// A 16 bits octahedral step is about 1e-4 radians at worst.
+	const MESH_DATA::STREAM& encodedNormals = mesh.streams[1];
+	ASSERT_EQ(encodedNormals.format, MESH_FORMAT_SNORM16X2);
+	EXPECT_GT(statistics.normalError, 0.0f);
+	EXPECT_LT(statistics.normalError, 1e-4f);
+	for (uint32_t vertex = 0; vertex < g_vertexCount; ++vertex)
+	{
+		const float* n = &normals[vertex * 3];
+		float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+		int16_t encoded[2];
+		memcpy(encoded, &encodedNormals.data[vertex * 4], sizeof(encoded));
+		float decoded[3];
+		DecodeNormalOctahedral(encoded, decoded);
+
+		// Zero vectors decode as +Z.
+		float cosine = length > 0.0f ? (decoded[0] * n[0] + decoded[1] * n[1] + decoded[2] * n[2]) / length : decoded[2];
+		ASSERT_GT(cosine, std::cos(1e-4f) - 1e-6f) << "vertex " << vertex;
+	}
+
+	EXPECT_LE(statistics.colorError, 0.5f / 255.0f + 1e-6f);
+	EXPECT_EQ(mesh.streams[2].format, MESH_FORMAT_UNORM8X4);
+}
@@ -0,0 +1,351 @@
+#include "GltfImporter.h"
+#include "Json.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+static const uint32_t g_glbMagic = 0x46546C67;		// "glTF"
+static const uint32_t g_glbJsonChunk = 0x4E4F534A;	// "JSON"
+static const uint32_t g_glbBinaryChunk = 0x004E4942;	// "BIN\0"
+
+static const int g_modeTriangles = 4;
+
+static bool ReadFile(const std::string& path, std::vector<uint8_t>& data)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (file.is_open() == false)
+	{
+		return false;
+	}
+
+	data.resize(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+	return file.good();
+}
+
+static bool DecodeBase64(const char* text, std::vector<uint8_t>& data)
+{
+	static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	uint32_t bits = 0;
+	int bitCount = 0;
+	for (; *text && *text != '='; ++text)
+	{
+		const char* digit = strchr(alphabet, *text);
+		if (digit == nullptr)
+		{
+			return false;
+		}
+
+		bits = (bits << 6) | static_cast<uint32_t>(digit - alphabet);
+		bitCount += 6;
+		if (bitCount >= 8)
+		{
+			bitCount -= 8;
+			data.push_back(static_cast<uint8_t>(bits >> bitCount));
+		}
+	}
+	return true;
+}
+
+static bool LoadBuffers(const JSON_VALUE& document, const std::string& directory, std::vector<uint8_t>& glbBinary,
+	std::vector<std::vector<uint8_t>>& buffers, std::string& error)
+{
+	const JSON_VALUE& bufferArray = document["buffers"];
+	buffers.resize(bufferArray.GetSize());
+
+	for (size_t i = 0; i < buffers.size(); ++i)
+	{
+		const JSON_VALUE& buffer = bufferArray[i];
+		const size_t byteLength = static_cast<size_t>(buffer["byteLength"].GetNumber());
+
+		if (buffer.HasMember("uri") == false)
+		{
+			// The first buffer of a .glb is its binary chunk.
+			buffers[i] = std::move(glbBinary);
+		}
+		else
+		{
+			const std::string& uri = buffer["uri"].GetString();
+			const size_t comma = uri.find(',');
+			if (uri.compare(0, 5, "data:") == 0 && comma != std::string::npos)
+			{
+				if (DecodeBase64(uri.c_str() + comma + 1, buffers[i]) == false)
+				{
+					error = "Invalid data URI in buffer " + std::to_string(i);
+					return false;
+				}
+			}
+			else if (ReadFile(directory + uri, buffers[i]) == false)
+			{
+				error = "Cannot read buffer " + directory + uri;
+				return false;
+			}
+		}
+
+		if (buffers[i].size() < byteLength)
+		{
+			error = "Buffer " + std::to_string(i) + " is truncated";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static uint32_t GetComponentCount(const std::string& type)
+{
+	if (type == "SCALAR") return 1;
+	if (type == "VEC2") return 2;
+	if (type == "VEC3") return 3;
+	if (type == "VEC4") return 4;
+	return 0;
+}
+
+static uint32_t GetComponentSize(int componentType)
+{
+	switch (componentType)
+	{
+	case 5120: case 5121: return 1;		// BYTE, UNSIGNED_BYTE
+	case 5122: case 5123: return 2;		// SHORT, UNSIGNED_SHORT
+	case 5125: case 5126: return 4;		// UNSIGNED_INT, FLOAT
+	default: return 0;
+	}
+}
+
+static double ReadComponent(const uint8_t* data, int componentType, bool normalized)
+{
+	switch (componentType)
+	{
+	case 5120: { int8_t v; memcpy(&v, data, 1); return normalized ? std::max(v / 127.0, -1.0) : v; }
+	case 5121: { uint8_t v; memcpy(&v, data, 1); return normalized ? v / 255.0 : v; }
+	case 5122: { int16_t v; memcpy(&v, data, 2); return normalized ? std::max(v / 32767.0, -1.0) : v; }
+	case 5123: { uint16_t v; memcpy(&v, data, 2); return normalized ? v / 65535.0 : v; }
+	case 5125: { uint32_t v; memcpy(&v, data, 4); return v; }
+	case 5126: { float v; memcpy(&v, data, 4); return v; }
+	default: return 0.0;
+	}
+}
+
+// Reads an accessor as 'componentCount' wide rows, narrower accessors are zero extended and wider ones truncated.
+// Doubles keep 32 bits indices exact.
+static bool ReadAccessor(const JSON_VALUE& document, const std::vector<std::vector<uint8_t>>& buffers, size_t accessorIndex,
+	uint32_t componentCount, std::vector<double>& values, std::string& error)
+{
+	const JSON_VALUE& accessor = document["accessors"][accessorIndex];
+	const size_t count = static_cast<size_t>(accessor["count"].GetNumber());
+	const int componentType = static_cast<int>(accessor["componentType"].GetNumber());
+	const bool normalized = accessor["normalized"].GetBool();
+	const uint32_t accessorComponents = GetComponentCount(accessor["type"].GetString());
+	const uint32_t componentSize = GetComponentSize(componentType);
+
+	values.assign(count * componentCount, 0.0);
+
+	// Sparse accessors and accessors without a view are not supported, they read as zeros.
+	if (accessor.HasMember("bufferView") == false)
+	{
+		return true;
+	}
+
+	const JSON_VALUE& view = document["bufferViews"][static_cast<size_t>(accessor["bufferView"].GetNumber())];
+	const size_t bufferIndex = static_cast<size_t>(view["buffer"].GetNumber());
+	const size_t offset = static_cast<size_t>(view["byteOffset"].GetNumber() + accessor["byteOffset"].GetNumber());
+	const size_t elementSize = accessorComponents * componentSize;
+	const size_t stride = view.HasMember("byteStride") ? static_cast<size_t>(view["byteStride"].GetNumber()) : elementSize;
+
+	if (accessorComponents == 0 || componentSize == 0 || bufferIndex >= buffers.size() ||
+		(count > 0 && offset + (count - 1) * stride + elementSize > buffers[bufferIndex].size()))
+	{
+		error = "Invalid accessor " + std::to_string(accessorIndex);
+		return false;
+	}
+
+	const uint8_t* data = buffers[bufferIndex].data() + offset;
+	const uint32_t readComponents = std::min(componentCount, accessorComponents);
+	for (size_t element = 0; element < count; ++element)
+	{
+		for (uint32_t component = 0; component < readComponents; ++component)
+		{
+			values[element * componentCount + component] = ReadComponent(data + element * stride + component * componentSize, componentType, normalized);
+		}
+	}
+	return true;
+}
+
+bool ImportGltf(const std::string& path, MESH_DATA& mesh, std::string& error)
+{
+	std::vector<uint8_t> file;
+	if (ReadFile(path, file) == false)
+	{
+		error = "Cannot open " + path;
+		return false;
+	}
+
+	// A .glb holds the JSON chunk followed by an optional binary chunk.
+	const char* json = reinterpret_cast<const char*>(file.data());
+	size_t jsonLength = file.size();
+	std::vector<uint8_t> glbBinary;
+
+	uint32_t magic = 0;
+	if (file.size() >= 4)
+	{
+		memcpy(&magic, file.data(), 4);
+	}
+	if (magic == g_glbMagic)
+	{
+		size_t offset = 12;
+		jsonLength = 0;
+		while (offset + 8 <= file.size())
+		{
+			uint32_t chunk[2];
+			memcpy(chunk, file.data() + offset, sizeof(chunk));
+			offset += 8;
+			if (offset + chunk[0] > file.size())
+			{
+				break;
+			}
+
+			if (chunk[1] == g_glbJsonChunk)
+			{
+				json = reinterpret_cast<const char*>(file.data() + offset);
+				jsonLength = chunk[0];
+			}
+			else if (chunk[1] == g_glbBinaryChunk)
+			{
+				glbBinary.assign(file.data() + offset, file.data() + offset + chunk[0]);
+			}
+			offset += chunk[0];
+		}
+	}
+
+	JSON_VALUE document;
+	if (JSON_VALUE::Parse(json, jsonLength, document, error) == false)
+	{
+		error = path + ": " + error;
+		return false;
+	}
+
+	const size_t separator = path.find_last_of("/\\");
+	const std::string directory = separator == std::string::npos ? std::string() : path.substr(0, separator + 1);
+
+	std::vector<std::vector<uint8_t>> buffers;
+	if (LoadBuffers(document, directory, glbBinary, buffers, error) == false)
+	{
+		return false;
+	}
+
+	// Attributes gathered as doubles over every primitive, then narrowed to float streams.
+	struct ATTRIBUTE
+	{
+		const char*			name;
+		MESH_SEMANTIC		semantic;
+		MESH_FORMAT			format;
+		uint32_t			componentCount;
+		bool				present;
+		std::vector<double>	values;
+	};
+
+	ATTRIBUTE attributes[] =
+	{
+		{ "POSITION", MESH_SEMANTIC_POSITION, MESH_FORMAT_FLOAT3, 3, false, {} },
+		{ "NORMAL", MESH_SEMANTIC_NORMAL, MESH_FORMAT_FLOAT3, 3, false, {} },
+		{ "COLOR_0", MESH_SEMANTIC_COLOR, MESH_FORMAT_FLOAT3, 3, false, {} },
+		{ "TEXCOORD_0", MESH_SEMANTIC_TEXCOORD, MESH_FORMAT_FLOAT2, 2, false, {} },
+	};
+
+	mesh = MESH_DATA();
+	std::vector<double> values;
+
+	const JSON_VALUE& meshes = document["meshes"];
+	for (size_t meshIndex = 0; meshIndex < meshes.GetSize(); ++meshIndex)
+	{
+		const JSON_VALUE& primitives = meshes[meshIndex]["primitives"];
+		for (size_t primitiveIndex = 0; primitiveIndex < primitives.GetSize(); ++primitiveIndex)
+		{
+			const JSON_VALUE& primitive = primitives[primitiveIndex];
+			const JSON_VALUE& primitiveAttributes = primitive["attributes"];
+			if (static_cast<int>(primitive["mode"].GetNumber(g_modeTriangles)) != g_modeTriangles || primitiveAttributes.HasMember("POSITION") == false)
+			{
+				continue;
+			}
+
+			const size_t vertexCount = static_cast<size_t>(document["accessors"][static_cast<size_t>(primitiveAttributes["POSITION"].GetNumber())]["count"].GetNumber());
+			for (ATTRIBUTE& attribute : attributes)
+			{
+				if (primitiveAttributes.HasMember(attribute.name))
+				{
+					if (ReadAccessor(document, buffers, static_cast<size_t>(primitiveAttributes[attribute.name].GetNumber()), attribute.componentCount, values, error) == false)
+					{
+						return false;
+					}
+					values.resize(vertexCount * attribute.componentCount);
+					attribute.present = true;
+				}
+				else
+				{
+					values.assign(vertexCount * attribute.componentCount, 0.0);
+				}
+				attribute.values.insert(attribute.values.end(), values.begin(), values.end());
+			}
+
+			MESH_SUBMESH submesh = {};
+			submesh.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+			submesh.baseVertex = static_cast<int32_t>(mesh.vertexCount);
+
+			if (primitive.HasMember("indices"))
+			{
+				if (ReadAccessor(document, buffers, static_cast<size_t>(primitive["indices"].GetNumber()), 1, values, error) == false)
+				{
+					return false;
+				}
+				for (double index : values)
+				{
+					if (index >= vertexCount)
+					{
+						error = "Index out of range in mesh " + std::to_string(meshIndex);
+						return false;
+					}
+					mesh.indices.push_back(static_cast<uint32_t>(index));
+				}
+			}
+			else
+			{
+				for (uint32_t index = 0; index < vertexCount; ++index)
+				{
+					mesh.indices.push_back(index);
+				}
+			}
+
+			submesh.indexCount = static_cast<uint32_t>(mesh.indices.size()) - submesh.firstIndex;
+			mesh.submeshes.push_back(submesh);
+			mesh.vertexCount += static_cast<uint32_t>(vertexCount);
+		}
+	}
+
+	if (mesh.indices.empty())
+	{
+		error = path + ": no triangle primitives";
+		return false;
+	}
+
+	for (const ATTRIBUTE& attribute : attributes)
+	{
+		if (attribute.present == false)
+		{
+			continue;
+		}
+
+		MESH_DATA::STREAM stream = { attribute.semantic, attribute.format, {} };
+		stream.data.resize(attribute.values.size() * sizeof(float));
+		for (size_t i = 0; i < attribute.values.size(); ++i)
+		{
+			float value = static_cast<float>(attribute.values[i]);
+			memcpy(&stream.data[i * sizeof(float)], &value, sizeof(float));
+		}
+		mesh.streams.push_back(std::move(stream));
+	}
+
+	return true;
+}
\ No newline at end of file
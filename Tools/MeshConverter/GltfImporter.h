@@ -0,0 +1,11 @@
+#pragma once
+
+#include "MeshFile.h"
+
+#include <string>
+
+// glTF 2.0, text (.gltf with external or data URI buffers) or binary (.glb).
+// Every triangle list primitive of every mesh becomes a submesh, node
+// transforms are not applied. POSITION, NORMAL, COLOR_0 and TEXCOORD_0 are
+// read, attributes missing from some primitives are zero.
+bool ImportGltf(const std::string& path, MESH_DATA& mesh, std::string& error);
\ No newline at end of file
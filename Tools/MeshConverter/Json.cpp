@@ -0,0 +1,217 @@
+#include "Json.h"
+
+#include <cstdlib>
+#include <cstring>
+
+static const JSON_VALUE g_null;
+
+class JSON_PARSER
+{
+public:
+	JSON_PARSER(const char* text, size_t length) : _text(text), _end(text + length), _cursor(text) { ; }
+
+	bool ParseDocument(JSON_VALUE& value, std::string& error)
+	{
+		bool succeeded = ParseValue(value, 0) && (SkipSpaces(), _cursor == _end);
+		if (succeeded == false)
+		{
+			error = "Invalid JSON at offset " + std::to_string(_cursor - _text);
+		}
+		return succeeded;
+	}
+
+private:
+	// glTF documents are shallow, the limit only guards the stack.
+	static const int MAX_DEPTH = 128;
+
+	void SkipSpaces()
+	{
+		while (_cursor < _end && (*_cursor == ' ' || *_cursor == '\t' || *_cursor == '\n' || *_cursor == '\r'))
+		{
+			++_cursor;
+		}
+	}
+
+	bool Consume(const char* token)
+	{
+		size_t length = strlen(token);
+		if (static_cast<size_t>(_end - _cursor) < length || memcmp(_cursor, token, length) != 0)
+		{
+			return false;
+		}
+		_cursor += length;
+		return true;
+	}
+
+	bool ParseValue(JSON_VALUE& value, int depth)
+	{
+		SkipSpaces();
+		if (_cursor == _end || depth > MAX_DEPTH)
+		{
+			return false;
+		}
+
+		switch (*_cursor)
+		{
+		case '{': return ParseObject(value, depth);
+		case '[': return ParseArray(value, depth);
+		case '"': value._type = JSON_VALUE::JSON_STRING; return ParseString(value._string);
+		case 't': value._type = JSON_VALUE::JSON_BOOL; value._bool = true; return Consume("true");
+		case 'f': value._type = JSON_VALUE::JSON_BOOL; value._bool = false; return Consume("false");
+		case 'n': value._type = JSON_VALUE::JSON_NULL; return Consume("null");
+		default: return ParseNumber(value);
+		}
+	}
+
+	bool ParseNumber(JSON_VALUE& value)
+	{
+		// strtod() stops at the first character which is not part of the number.
+		std::string number;
+		while (_cursor < _end && strchr("+-0123456789.eE", *_cursor))
+		{
+			number += *_cursor++;
+		}
+
+		char* numberEnd = nullptr;
+		value._type = JSON_VALUE::JSON_NUMBER;
+		value._number = strtod(number.c_str(), &numberEnd);
+		return number.empty() == false && *numberEnd == '\0';
+	}
+
+	bool ParseString(std::string& string)
+	{
+		++_cursor;
+		while (_cursor < _end && *_cursor != '"')
+		{
+			char c = *_cursor++;
+			if (c != '\\')
+			{
+				string += c;
+				continue;
+			}
+
+			if (_cursor == _end)
+			{
+				return false;
+			}
+
+			c = *_cursor++;
+			switch (c)
+			{
+			case 'b': string += '\b'; break;
+			case 'f': string += '\f'; break;
+			case 'n': string += '\n'; break;
+			case 'r': string += '\r'; break;
+			case 't': string += '\t'; break;
+			case 'u':
+			{
+				if (_end - _cursor < 4)
+				{
+					return false;
+				}
+				unsigned long code = strtoul(std::string(_cursor, 4).c_str(), nullptr, 16);
+				_cursor += 4;
+
+				// UTF-8 encoding, surrogate pairs are kept as two code points.
+				if (code < 0x80)
+				{
+					string += static_cast<char>(code);
+				}
+				else if (code < 0x800)
+				{
+					string += static_cast<char>(0xC0 | (code >> 6));
+					string += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				else
+				{
+					string += static_cast<char>(0xE0 | (code >> 12));
+					string += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					string += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				break;
+			}
+			default: string += c; break;
+			}
+		}
+
+		return Consume("\"");
+	}
+
+	bool ParseArray(JSON_VALUE& value, int depth)
+	{
+		value._type = JSON_VALUE::JSON_ARRAY;
+		++_cursor;
+
+		SkipSpaces();
+		if (Consume("]"))
+		{
+			return true;
+		}
+
+		do
+		{
+			value._array.emplace_back();
+			if (ParseValue(value._array.back(), depth + 1) == false)
+			{
+				return false;
+			}
+			SkipSpaces();
+		} while (Consume(","));
+
+		return Consume("]");
+	}
+
+	bool ParseObject(JSON_VALUE& value, int depth)
+	{
+		value._type = JSON_VALUE::JSON_OBJECT;
+		++_cursor;
+
+		SkipSpaces();
+		if (Consume("}"))
+		{
+			return true;
+		}
+
+		do
+		{
+			SkipSpaces();
+			std::string key;
+			if (_cursor == _end || *_cursor != '"' || ParseString(key) == false)
+			{
+				return false;
+			}
+
+			SkipSpaces();
+			if (Consume(":") == false || ParseValue(value._object[key], depth + 1) == false)
+			{
+				return false;
+			}
+			SkipSpaces();
+		} while (Consume(","));
+
+		return Consume("}");
+	}
+
+	const char*	_text;
+	const char*	_end;
+	const char*	_cursor;
+};
+
+bool JSON_VALUE::Parse(const char* text, size_t length, JSON_VALUE& value, std::string& error)
+{
+	value = JSON_VALUE();
+
+	JSON_PARSER parser(text, length);
+	return parser.ParseDocument(value, error);
+}
+
+const JSON_VALUE& JSON_VALUE::operator[](size_t index) const
+{
+	return _type == JSON_ARRAY && index < _array.size() ? _array[index] : g_null;
+}
+
+const JSON_VALUE& JSON_VALUE::operator[](const std::string& key) const
+{
+	auto it = _object.find(key);
+	return it != _object.end() ? it->second : g_null;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Minimal JSON document, enough to read glTF files.
+class JSON_VALUE
+{
+public:
+	enum TYPE
+	{
+		JSON_NULL,
+		JSON_BOOL,
+		JSON_NUMBER,
+		JSON_STRING,
+		JSON_ARRAY,
+		JSON_OBJECT
+	};
+
+	// Returns false and an error message with the offset on malformed input.
+	static bool Parse(const char* text, size_t length, JSON_VALUE& value, std::string& error);
+
+	inline TYPE GetType() const { return _type; }
+	inline bool IsNull() const { return _type == JSON_NULL; }
+
+	// Accessors of the wrong type return the fallback, a missing member is a null value.
+	double GetNumber(double fallback = 0.0) const { return _type == JSON_NUMBER ? _number : fallback; }
+	bool GetBool(bool fallback = false) const { return _type == JSON_BOOL ? _bool : fallback; }
+	const std::string& GetString() const { return _string; }
+
+	size_t GetSize() const { return _type == JSON_ARRAY ? _array.size() : 0; }
+	const JSON_VALUE& operator[](size_t index) const;
+	const JSON_VALUE& operator[](const std::string& key) const;
+	bool HasMember(const std::string& key) const { return _object.find(key) != _object.end(); }
+
+private:
+	friend class JSON_PARSER;
+
+	TYPE							_type = JSON_NULL;
+	bool							_bool = false;
+	double							_number = 0.0;
+	std::string						_string;
+	std::vector<JSON_VALUE>			_array;
+	std::map<std::string, JSON_VALUE>	_object;
+};
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "GltfImporter.h"
+#include "ObjImporter.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "VertexQuantization.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+
+// Offline converter to the .mesh container loaded by the samples.
+// Usage: MeshConverter [--no-optimize] [--quantize] <input.obj|input.gltf|input.glb> <output.mesh>
+//        MeshConverter --analyze <input.obj|input.gltf|input.glb|input.mesh>
+// Meshes are optimized for the vertex cache, overdraw and vertex fetch unless
+// --no-optimize is given. --quantize stores 16 bits positions and normals and
+// 8 bits colors. --analyze prints the cache and fetch statistics.
+
+static const char* g_usage = "Usage: MeshConverter [--no-optimize] [--quantize] <input.obj|input.gltf|input.glb> <output.mesh>\n"
+	"       MeshConverter --analyze <input.obj|input.gltf|input.glb|input.mesh>";
+
+static std::string GetExtension(const std::string& path)
+{
+	size_t dot = path.find_last_of('.');
+	std::string extension = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(tolower(c)); });
+	return extension;
+}
+
+// The samples shade with vertex colors, meshes without them get their position in the bounds as color.
+static void AddPositionColors(MESH_DATA& mesh, const MESH_BOUNDS& bounds)
+{
+	const MESH_DATA::STREAM* positions = nullptr;
+	for (const MESH_DATA::STREAM& stream : mesh.streams)
+	{
+		if (stream.semantic == MESH_SEMANTIC_COLOR)
+		{
+			return;
+		}
+		if (stream.semantic == MESH_SEMANTIC_POSITION)
+		{
+			positions = &stream;
+		}
+	}
+
+	MESH_DATA::STREAM colors = { MESH_SEMANTIC_COLOR, MESH_FORMAT_FLOAT3, {} };
+	colors.data.resize(mesh.vertexCount * 3 * sizeof(float));
+
+	const uint32_t stride = GetMeshFormatSize(positions->format);
+	for (uint32_t vertex = 0; vertex < mesh.vertexCount; ++vertex)
+	{
+		float position[3];
+		float color[3];
+		memcpy(position, &positions->data[vertex * stride], sizeof(position));
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float extent = bounds.max[axis] - bounds.min[axis];
+			color[axis] = extent > 0.0f ? (position[axis] - bounds.min[axis]) / extent : 1.0f;
+		}
+		memcpy(&colors.data[vertex * sizeof(color)], color, sizeof(color));
+	}
+
+	mesh.streams.push_back(std::move(colors));
+}
+
+static void PrintStatistics(const char* label, const MESH_DATA& mesh)
+{
+	// Statistics over the whole index buffer, as drawn.
+	std::vector<uint32_t> indices(mesh.indices);
+	for (const MESH_SUBMESH& submesh : mesh.submeshes)
+	{
+		for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; ++i)
+		{
+			indices[i] += submesh.baseVertex;
+		}
+	}
+
+	size_t vertexSize = 0;
+	for (const MESH_DATA::STREAM& stream : mesh.streams)
+	{
+		vertexSize += GetMeshFormatSize(stream.format);
+	}
+
+	VERTEX_CACHE_STATISTICS cache = AnalyzeVertexCache(indices.data(), indices.size(), mesh.vertexCount);
+	VERTEX_FETCH_STATISTICS fetch = AnalyzeVertexFetch(indices.data(), indices.size(), mesh.vertexCount, vertexSize);
+
+	std::cout << label << ": " << mesh.vertexCount << " vertices, " << indices.size() / 3 << " triangles, ACMR " << cache.acmr
+		<< ", ATVR " << cache.atvr << ", overfetch " << fetch.overfetch << " (cache of " << g_vertexCacheSize << ")" << std::endl;
+}
+
+static bool LoadMesh(const std::string& input, MESH_DATA& mesh, std::string& error)
+{
+	const std::string extension = GetExtension(input);
+	if (extension == "obj")
+	{
+		return ImportObj(input, mesh, error);
+	}
+	if (extension == "gltf" || extension == "glb")
+	{
+		return ImportGltf(input, mesh, error);
+	}
+	if (extension == "mesh")
+	{
+		MESH_FILE file;
+		if (file.Open(input) == false)
+		{
+			error = "Cannot open " + input;
+			return false;
+		}
+		if (ReadMeshData(file, mesh) == false)
+		{
+			error = input + " indexes vertices past its vertex count";
+			return false;
+		}
+		return true;
+	}
+
+	error = "Unsupported input format ." + extension;
+	return false;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string> arguments(argv + 1, argv + argc);
+
+	bool analyze = false;
+	bool optimize = true;
+	bool quantize = false;
+	std::vector<std::string> paths;
+	for (const std::string& argument : arguments)
+	{
+		if (argument == "--analyze")
+		{
+			analyze = true;
+		}
+		else if (argument == "--no-optimize")
+		{
+			optimize = false;
+		}
+		else if (argument == "--quantize")
+		{
+			quantize = true;
+		}
+		else
+		{
+			paths.push_back(argument);
+		}
+	}
+
+	if (paths.size() != (analyze ? 1u : 2u))
+	{
+		std::cerr << g_usage << std::endl;
+		return 1;
+	}
+
+	const std::string& input = paths[0];
+
+	MESH_DATA mesh;
+	std::string error;
+	if (LoadMesh(input, mesh, error) == false)
+	{
+		std::cerr << error << std::endl;
+		return 1;
+	}
+
+	if (analyze)
+	{
+		PrintStatistics(input.c_str(), mesh);
+		if (GetExtension(input) != "mesh")
+		{
+			OptimizeMesh(mesh);
+			PrintStatistics("optimized", mesh);
+		}
+		return 0;
+	}
+
+	const std::string& output = paths[1];
+	if (GetExtension(input) == "mesh")
+	{
+		std::cerr << "Input is already a .mesh file" << std::endl;
+		return 1;
+	}
+
+	if (optimize)
+	{
+		PrintStatistics(input.c_str(), mesh);
+		OptimizeMesh(mesh);
+		PrintStatistics("optimized", mesh);
+	}
+
+	ComputeMeshBounds(mesh);
+
+	AddPositionColors(mesh, mesh.bounds);
+
+	if (quantize)
+	{
+		VERTEX_QUANTIZATION_STATISTICS statistics = QuantizeMesh(mesh);
+		std::cout << "quantized: " << statistics.sourceBytes << " -> " << statistics.quantizedBytes << " vertex bytes, position error "
+			<< statistics.positionError << " (bound " << statistics.positionErrorBound << "), normal error "
+			<< statistics.normalError * 180.0f / 3.14159265f << " degrees, color error " << statistics.colorError << std::endl;
+	}
+
+	if (WriteMeshFile(output, mesh) == false)
+	{
+		std::cerr << "Cannot write " << output << std::endl;
+		return 1;
+	}
+
+	std::cout << output << ": " << mesh.vertexCount << " vertices, " << mesh.indices.size() / 3 << " triangles, "
+		<< mesh.submeshes.size() << " submeshes, " << mesh.streams.size() << " streams" << std::endl;
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "ObjImporter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+struct OBJ_VERTEX_KEY
+{
+	int	position;
+	int	texcoord;
+	int	normal;
+
+	bool operator==(const OBJ_VERTEX_KEY& other) const
+	{
+		return position == other.position && texcoord == other.texcoord && normal == other.normal;
+	}
+};
+
+struct OBJ_VERTEX_HASH
+{
+	size_t operator()(const OBJ_VERTEX_KEY& key) const
+	{
+		return static_cast<size_t>(key.position) * 73856093u ^ static_cast<size_t>(key.texcoord) * 19349663u ^ static_cast<size_t>(key.normal) * 83492791u;
+	}
+};
+
+// Resolves a 1-based or negative (relative) OBJ index, -1 when absent or out of range.
+static int ResolveIndex(const char* text, size_t count)
+{
+	if (*text == '\0')
+	{
+		return -1;
+	}
+
+	long index = strtol(text, nullptr, 10);
+	if (index < 0)
+	{
+		index += static_cast<long>(count);
+	}
+	else
+	{
+		index -= 1;
+	}
+	return index >= 0 && static_cast<size_t>(index) < count ? static_cast<int>(index) : -1;
+}
+
+// Parses up to 'maxCount' whitespace separated floats, returns how many were read.
+static int ParseFloats(const char* text, float* values, int maxCount)
+{
+	int count = 0;
+	while (count < maxCount)
+	{
+		char* end = nullptr;
+		float value = strtof(text, &end);
+		if (end == text)
+		{
+			break;
+		}
+		values[count++] = value;
+		text = end;
+	}
+	return count;
+}
+
+static void AppendFloats(std::vector<uint8_t>& data, const float* values, size_t count)
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values);
+	data.insert(data.end(), bytes, bytes + count * sizeof(float));
+}
+
+bool ImportObj(const std::string& path, MESH_DATA& mesh, std::string& error)
+{
+	std::ifstream file(path);
+	if (file.is_open() == false)
+	{
+		error = "Cannot open " + path;
+		return false;
+	}
+
+	std::vector<float> positions;		// xyz
+	std::vector<float> colors;			// rgb, one per position when present
+	std::vector<float> normals;
+	std::vector<float> texcoords;
+
+	std::vector<OBJ_VERTEX_KEY> vertices;
+	std::unordered_map<OBJ_VERTEX_KEY, uint32_t, OBJ_VERTEX_HASH> vertexMap;
+
+	mesh = MESH_DATA();
+	auto startSubmesh = [&mesh]()
+	{
+		if (mesh.submeshes.empty() || mesh.submeshes.back().indexCount > 0)
+		{
+			MESH_SUBMESH submesh = {};
+			submesh.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+			mesh.submeshes.push_back(submesh);
+		}
+	};
+	startSubmesh();
+
+	std::string line;
+	size_t lineNumber = 0;
+	std::vector<uint32_t> polygon;
+	while (std::getline(file, line))
+	{
+		++lineNumber;
+		const char* cursor = line.c_str();
+		while (*cursor == ' ' || *cursor == '\t')
+		{
+			++cursor;
+		}
+
+		if (strncmp(cursor, "v ", 2) == 0)
+		{
+			float values[6] = {};
+			int count = ParseFloats(cursor + 2, values, 6);
+			if (count < 3)
+			{
+				error = path + "(" + std::to_string(lineNumber) + "): invalid position";
+				return false;
+			}
+			positions.insert(positions.end(), values, values + 3);
+
+			// Colors are kept only when every position has one.
+			if (count == 6 && colors.size() == positions.size() - 3)
+			{
+				colors.insert(colors.end(), values + 3, values + 6);
+			}
+		}
+		else if (strncmp(cursor, "vn ", 3) == 0)
+		{
+			float values[3] = {};
+			ParseFloats(cursor + 3, values, 3);
+			normals.insert(normals.end(), values, values + 3);
+		}
+		else if (strncmp(cursor, "vt ", 3) == 0)
+		{
+			float values[2] = {};
+			ParseFloats(cursor + 3, values, 2);
+			texcoords.insert(texcoords.end(), values, values + 2);
+		}
+		else if (strncmp(cursor, "o ", 2) == 0 || strncmp(cursor, "g ", 2) == 0 || strncmp(cursor, "usemtl ", 7) == 0)
+		{
+			startSubmesh();
+		}
+		else if (strncmp(cursor, "f ", 2) == 0)
+		{
+			polygon.clear();
+
+			// Corners are "v", "v/vt", "v//vn" or "v/vt/vn".
+			const char* corner = cursor + 2;
+			while (*corner)
+			{
+				while (*corner == ' ' || *corner == '\t')
+				{
+					++corner;
+				}
+				if (*corner == '\0' || *corner == '\r')
+				{
+					break;
+				}
+
+				std::string token;
+				while (*corner && *corner != ' ' && *corner != '\t' && *corner != '\r')
+				{
+					token += *corner++;
+				}
+
+				std::string fields[3];
+				size_t field = 0;
+				for (char c : token)
+				{
+					if (c == '/')
+					{
+						field = std::min<size_t>(field + 1, 2);
+					}
+					else
+					{
+						fields[field] += c;
+					}
+				}
+
+				OBJ_VERTEX_KEY key;
+				key.position = ResolveIndex(fields[0].c_str(), positions.size() / 3);
+				key.texcoord = ResolveIndex(fields[1].c_str(), texcoords.size() / 2);
+				key.normal = ResolveIndex(fields[2].c_str(), normals.size() / 3);
+				if (key.position < 0)
+				{
+					error = path + "(" + std::to_string(lineNumber) + "): invalid face index";
+					return false;
+				}
+
+				auto inserted = vertexMap.insert(std::make_pair(key, static_cast<uint32_t>(vertices.size())));
+				if (inserted.second)
+				{
+					vertices.push_back(key);
+				}
+				polygon.push_back(inserted.first->second);
+			}
+
+			for (size_t i = 2; i < polygon.size(); ++i)
+			{
+				mesh.indices.push_back(polygon[0]);
+				mesh.indices.push_back(polygon[i - 1]);
+				mesh.indices.push_back(polygon[i]);
+				mesh.submeshes.back().indexCount += 3;
+			}
+		}
+	}
+
+	if (mesh.submeshes.back().indexCount == 0)
+	{
+		mesh.submeshes.pop_back();
+	}
+
+	if (mesh.indices.empty())
+	{
+		error = path + ": no faces";
+		return false;
+	}
+
+	// One stream per attribute, missing normals and texture coordinates are zero.
+	const bool hasColors = colors.size() == positions.size();
+	const bool hasNormals = normals.empty() == false;
+	const bool hasTexcoords = texcoords.empty() == false;
+	const float zeros[3] = {};
+
+	MESH_DATA::STREAM positionStream = { MESH_SEMANTIC_POSITION, MESH_FORMAT_FLOAT3, {} };
+	MESH_DATA::STREAM colorStream = { MESH_SEMANTIC_COLOR, MESH_FORMAT_FLOAT3, {} };
+	MESH_DATA::STREAM normalStream = { MESH_SEMANTIC_NORMAL, MESH_FORMAT_FLOAT3, {} };
+	MESH_DATA::STREAM texcoordStream = { MESH_SEMANTIC_TEXCOORD, MESH_FORMAT_FLOAT2, {} };
+	for (const OBJ_VERTEX_KEY& vertex : vertices)
+	{
+		AppendFloats(positionStream.data, &positions[vertex.position * 3], 3);
+		if (hasColors)
+		{
+			AppendFloats(colorStream.data, &colors[vertex.position * 3], 3);
+		}
+		if (hasNormals)
+		{
+			AppendFloats(normalStream.data, vertex.normal >= 0 ? &normals[vertex.normal * 3] : zeros, 3);
+		}
+		if (hasTexcoords)
+		{
+			AppendFloats(texcoordStream.data, vertex.texcoord >= 0 ? &texcoords[vertex.texcoord * 2] : zeros, 2);
+		}
+	}
+
+	mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+	mesh.streams.push_back(std::move(positionStream));
+	if (hasNormals)
+	{
+		mesh.streams.push_back(std::move(normalStream));
+	}
+	if (hasColors)
+	{
+		mesh.streams.push_back(std::move(colorStream));
+	}
+	if (hasTexcoords)
+	{
+		mesh.streams.push_back(std::move(texcoordStream));
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "MeshFile.h"
+
+#include <string>
+
+// Wavefront OBJ: positions with optional vertex colors ("v x y z r g b"),
+// normals and texture coordinates. Polygons are triangulated as fans, every
+// object, group or material change starts a new submesh. Vertices sharing
+// the same position, normal and texture coordinate indices are merged.
+bool ImportObj(const std::string& path, MESH_DATA& mesh, std::string& error);
\ No newline at end of file
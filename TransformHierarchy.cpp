@@ -0,0 +1,210 @@
+#include "TransformHierarchy.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace VectorMath;
+
+// Nodes per job, smaller levels are updated on the calling thread.
+static const uint32_t g_transformsPerJob = 8192;
+
+TRANSFORM_HIERARCHY::HANDLE TRANSFORM_HIERARCHY::Add(HANDLE parent)
+{
+	uint32_t parentIndex = parent == INVALID_HANDLE ? INVALID_HANDLE : _handleToIndex[parent];
+	uint32_t depth = parentIndex == INVALID_HANDLE ? 0 : _depths[parentIndex] + 1;
+
+	// Appending a shallower node breaks the depth order.
+	if (_depths.empty() == false && depth < _depths.back())
+	{
+		_sorted = false;
+	}
+
+	HANDLE handle = static_cast<HANDLE>(_handleToIndex.size());
+	_handleToIndex.push_back(static_cast<uint32_t>(_parents.size()));
+
+	FLOAT4X4 identity;
+	StoreFloat4x4(&identity, MatrixIdentity());
+
+	_parents.push_back(parentIndex);
+	_depths.push_back(depth);
+	_positions.push_back(FLOAT3{ 0.0f, 0.0f, 0.0f });
+	_rotations.push_back(FLOAT4{ 0.0f, 0.0f, 0.0f, 1.0f });
+	_scales.push_back(FLOAT3{ 1.0f, 1.0f, 1.0f });
+	_worlds.push_back(identity);
+	_dirty.push_back(1);
+	_changed.push_back(0);
+	_indexToHandle.push_back(handle);
+
+	return handle;
+}
+
+void TRANSFORM_HIERARCHY::Clear()
+{
+	_parents.clear();
+	_depths.clear();
+	_positions.clear();
+	_rotations.clear();
+	_scales.clear();
+	_worlds.clear();
+	_dirty.clear();
+	_changed.clear();
+	_indexToHandle.clear();
+	_handleToIndex.clear();
+	_levelStarts.clear();
+	_sorted = true;
+	_updatedCount = 0;
+}
+
+void TRANSFORM_HIERARCHY::SetLocal(HANDLE node, const FLOAT3& position, const FLOAT4& rotation, const FLOAT3& scale)
+{
+	uint32_t index = _handleToIndex[node];
+	_positions[index] = position;
+	_rotations[index] = rotation;
+	_scales[index] = scale;
+	_dirty[index] = 1;
+}
+
+void TRANSFORM_HIERARCHY::SetLocalRotation(HANDLE node, const FLOAT4& rotation)
+{
+	uint32_t index = _handleToIndex[node];
+	_rotations[index] = rotation;
+	_dirty[index] = 1;
+}
+
+MATRIX TRANSFORM_HIERARCHY::GetWorld(HANDLE node) const
+{
+	return LoadFloat4x4(&_worlds[_handleToIndex[node]]);
+}
+
+void TRANSFORM_HIERARCHY::SortByDepth()
+{
+	uint32_t count = GetCount();
+
+	std::vector<uint32_t> order(count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return _depths[a] < _depths[b]; });
+
+	std::vector<uint32_t> newIndices(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		newIndices[order[i]] = i;
+	}
+
+	auto reorder = [&order](auto& values)
+	{
+		typename std::decay<decltype(values)>::type sorted(values.size());
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			sorted[i] = values[order[i]];
+		}
+		values.swap(sorted);
+	};
+	reorder(_parents);
+	reorder(_depths);
+	reorder(_positions);
+	reorder(_rotations);
+	reorder(_scales);
+	reorder(_worlds);
+	reorder(_dirty);
+	reorder(_changed);
+	reorder(_indexToHandle);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (_parents[i] != INVALID_HANDLE)
+		{
+			_parents[i] = newIndices[_parents[i]];
+		}
+		_handleToIndex[_indexToHandle[i]] = i;
+	}
+
+	_sorted = true;
+}
+
+void TRANSFORM_HIERARCHY::UpdateRange(uint32_t begin, uint32_t end)
+{
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		uint32_t parent = _parents[i];
+		bool parentChanged = parent != INVALID_HANDLE && _changed[parent];
+		if (_dirty[i] == 0 && parentChanged == false)
+		{
+			_changed[i] = 0;
+			continue;
+		}
+
+		// Scaled rotation rows, then the translation row.
+		MATRIX local = MatrixRotationQuaternion(LoadFloat4(&_rotations[i]));
+		VECTOR scale = LoadFloat3(&_scales[i]);
+		local.r[0] = VectorScale(local.r[0], VectorGetX(scale));
+		local.r[1] = VectorScale(local.r[1], VectorGetY(scale));
+		local.r[2] = VectorScale(local.r[2], VectorGetZ(scale));
+		local.r[3] = VectorSetW(LoadFloat3(&_positions[i]), 1.0f);
+
+		MATRIX world = parent == INVALID_HANDLE ? local : MatrixMultiply(local, LoadFloat4x4(&_worlds[parent]));
+		StoreFloat4x4(&_worlds[i], world);
+
+		_dirty[i] = 0;
+		_changed[i] = 1;
+	}
+}
+
+void TRANSFORM_HIERARCHY::Update(JOB_SYSTEM* jobSystem)
+{
+	uint32_t count = GetCount();
+
+	if (_sorted == false)
+	{
+		SortByDepth();
+	}
+	if (_levelStarts.empty() || _levelStarts.back() != count)
+	{
+		_levelStarts.clear();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (i == 0 || _depths[i] != _depths[i - 1])
+			{
+				_levelStarts.push_back(i);
+			}
+		}
+		_levelStarts.push_back(count);
+	}
+
+	// A level only reads the flags and matrices of the previous ones.
+	for (size_t level = 0; level + 1 < _levelStarts.size(); ++level)
+	{
+		uint32_t begin = _levelStarts[level];
+		uint32_t end = _levelStarts[level + 1];
+
+		if (jobSystem && end - begin > g_transformsPerJob)
+		{
+			jobSystem->ParallelFor(end - begin, g_transformsPerJob, [this, begin](uint32_t rangeBegin, uint32_t rangeEnd)
+			{
+				UpdateRange(begin + rangeBegin, begin + rangeEnd);
+			});
+		}
+		else
+		{
+			UpdateRange(begin, end);
+		}
+	}
+
+	_updatedCount = static_cast<uint32_t>(std::count(_changed.begin(), _changed.end(), 1));
+}
+
+void TRANSFORM_HIERARCHY::ComputeWorldViewProjection(const MATRIX& viewProjection, FLOAT4X4* destination, JOB_SYSTEM* jobSystem) const
+{
+	uint32_t count = GetCount();
+	if (jobSystem && count > g_transformsPerJob)
+	{
+		jobSystem->ParallelFor(count, g_transformsPerJob, [this, &viewProjection, destination](uint32_t begin, uint32_t end)
+		{
+			MultiplyMatrices(destination + begin, _worlds.data() + begin, end - begin, viewProjection);
+		});
+	}
+	else
+	{
+		MultiplyMatrices(destination, _worlds.data(), count, viewProjection);
+	}
+}
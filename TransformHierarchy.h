@@ -0,0 +1,64 @@
+#pragma once
+
+#include "VectorMath.h"
+
+#include <cstdint>
+#include <vector>
+
+class JOB_SYSTEM;
+
+// Scene transforms stored as contiguous arrays sorted by depth in the hierarchy,
+// every parent comes before its children and the nodes of a depth level are
+// contiguous, so a level is updated in parallel once the previous one is done.
+// Changing a local transform marks it dirty, Update() only recomputes the world
+// matrices of dirty nodes and of the subtrees below them. Nodes are referred to
+// by handles, the storage order changes when nodes are added.
+class TRANSFORM_HIERARCHY
+{
+public:
+	typedef uint32_t HANDLE;
+	static const HANDLE INVALID_HANDLE = UINT32_MAX;
+
+	// The parent must already exist, nodes start at the identity.
+	HANDLE Add(HANDLE parent = INVALID_HANDLE);
+	void Clear();
+
+	// Scale, then rotation (a normalized quaternion), then translation, relative to the parent.
+	void SetLocal(HANDLE node, const VectorMath::FLOAT3& position, const VectorMath::FLOAT4& rotation, const VectorMath::FLOAT3& scale);
+	void SetLocalRotation(HANDLE node, const VectorMath::FLOAT4& rotation);
+
+	void Update(JOB_SYSTEM* jobSystem = nullptr);
+
+	// World matrix as of the last Update().
+	VectorMath::MATRIX GetWorld(HANDLE node) const;
+
+	// destination[i] = world[i] * viewProjection in storage order, see GetStorageIndex().
+	void ComputeWorldViewProjection(const VectorMath::MATRIX& viewProjection, VectorMath::FLOAT4X4* destination, JOB_SYSTEM* jobSystem = nullptr) const;
+
+	// Valid until nodes are added or the next Update() reorders them.
+	inline uint32_t GetStorageIndex(HANDLE node) const { return _handleToIndex[node]; }
+	inline uint32_t GetCount() const { return static_cast<uint32_t>(_parents.size()); }
+	// World matrices recomputed by the last Update().
+	inline uint32_t GetUpdatedCount() const { return _updatedCount; }
+
+private:
+	// Restores the depth order after nodes were added.
+	void SortByDepth();
+	void UpdateRange(uint32_t begin, uint32_t end);
+
+	// Per node, in storage order
+	std::vector<uint32_t>				_parents;		// Storage index, INVALID_HANDLE for roots
+	std::vector<uint32_t>				_depths;
+	std::vector<VectorMath::FLOAT3>		_positions;
+	std::vector<VectorMath::FLOAT4>		_rotations;
+	std::vector<VectorMath::FLOAT3>		_scales;
+	std::vector<VectorMath::FLOAT4X4>	_worlds;
+	std::vector<uint8_t>				_dirty;			// Local transform changed, cleared by Update()
+	std::vector<uint8_t>				_changed;		// World recomputed by the current Update()
+	std::vector<HANDLE>					_indexToHandle;
+
+	std::vector<uint32_t>				_handleToIndex;
+	std::vector<uint32_t>				_levelStarts;	// First storage index of each depth, plus the count
+	bool								_sorted = true;
+	uint32_t							_updatedCount = 0;
+};
@@ -1,10 +1,17 @@
 #include "Tutorial.h"
 
 #include "../Application.h"
+#include "../AssetStreamer.h"
 #include "../CommandQueue.h"
+#include "../FrameScheduler.h"
+#include "../JobSystem.h"
+#include "../ResourceBarriers.h"
+#include "../VertexQuantization.h"
 #include "../Window.h"
 
-using namespace DirectX;
+#include <cmath>
+
+using namespace VectorMath;
 
 // Clamp a value between a min and max range.
 template<typename T>
@@ -13,12 +20,6 @@ constexpr const T& clamp(const T& val, const T& min, const T& max)
     return val < min ? min : val > max ? max : val;
 }
 
-struct VERTEX_POS_COLOR
-{
-    XMFLOAT3 Position;
-    XMFLOAT3 Color;
-};
-
 struct PIPELINE_STREAM_STATE
 {
     CD3DX12_PIPELINE_STATE_STREAM_ROOT_SIGNATURE rootSignature;
@@ -30,27 +31,57 @@ struct PIPELINE_STREAM_STATE
     CD3DX12_PIPELINE_STATE_STREAM_RENDER_TARGET_FORMATS renderTargetFormats;
 };
 
-static VERTEX_POS_COLOR g_Vertices[8] = {
-    { XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(0.0f, 0.0f, 0.0f) }, // 0
-    { XMFLOAT3(-1.0f,  1.0f, -1.0f), XMFLOAT3(0.0f, 1.0f, 0.0f) }, // 1
-    { XMFLOAT3(1.0f,  1.0f, -1.0f), XMFLOAT3(1.0f, 1.0f, 0.0f) }, // 2
-    { XMFLOAT3(1.0f, -1.0f, -1.0f), XMFLOAT3(1.0f, 0.0f, 0.0f) }, // 3
-    { XMFLOAT3(-1.0f, -1.0f,  1.0f), XMFLOAT3(0.0f, 0.0f, 1.0f) }, // 4
-    { XMFLOAT3(-1.0f,  1.0f,  1.0f), XMFLOAT3(0.0f, 1.0f, 1.0f) }, // 5
-    { XMFLOAT3(1.0f,  1.0f,  1.0f), XMFLOAT3(1.0f, 1.0f, 1.0f) }, // 6
-    { XMFLOAT3(1.0f, -1.0f,  1.0f), XMFLOAT3(1.0f, 0.0f, 1.0f) }  // 7
+// Binary mesh produced by Tools/MeshConverter, next to the compiled shaders.
+static const char* g_meshPath = "Cube.mesh";
+
+// Every cube spins around the same axis, the stress scene with its own phase.
+static const FLOAT3 g_rotationAxis = { 0.0f, 0.70710678f, 0.70710678f };
+static const float g_rotationSpeed = ConvertToRadians(90.0f);	// Per second
+static const float g_stressInstanceSpacing = 4.0f;
+
+// Groups of 4 instances per job of the instance data build.
+static const uint32_t g_instanceGroupsPerJob = 1024;
+
+static const char* g_cullingModeNames[TUTORIAL::CULLING_MODE_COUNT] = { "none", "flat", "hierarchy" };
+
+// Draws per job of the indirect argument packing.
+static const uint32_t g_indirectDrawsPerJob = 16384;
+
+// Root parameters, the draw constant is written by the command signature.
+enum ROOT_PARAMETER
+{
+    ROOT_PARAMETER_VIEW_PROJECTION,
+    ROOT_PARAMETER_INSTANCES,
+    ROOT_PARAMETER_DRAW,
+    ROOT_PARAMETER_COUNT
 };
 
-static WORD g_Indices[36] =
+// Vertex streams read by the vertex shader, one input slot each.
+struct VERTEX_STREAM_DESC
 {
-    0, 1, 2, 0, 2, 3,
-    4, 6, 5, 4, 7, 6,
-    4, 5, 1, 4, 1, 0,
-    3, 2, 6, 3, 6, 7,
-    1, 5, 6, 1, 6, 2,
-    4, 0, 3, 4, 3, 7
+    MESH_SEMANTIC semantic;
+    const char* semanticName;
+};
+
+static const VERTEX_STREAM_DESC g_vertexStreams[TUTORIAL::VERTEX_STREAM_COUNT] = {
+    { MESH_SEMANTIC_POSITION, "POSITION" },
+    { MESH_SEMANTIC_COLOR, "COLOR" }
 };
 
+static DXGI_FORMAT GetVertexFormat(MESH_FORMAT format)
+{
+    switch (format)
+    {
+    case MESH_FORMAT_FLOAT2: return DXGI_FORMAT_R32G32_FLOAT;
+    case MESH_FORMAT_FLOAT3: return DXGI_FORMAT_R32G32B32_FLOAT;
+    case MESH_FORMAT_FLOAT4: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+    case MESH_FORMAT_SNORM16X4: return DXGI_FORMAT_R16G16B16A16_SNORM;
+    case MESH_FORMAT_UNORM8X4: return DXGI_FORMAT_R8G8B8A8_UNORM;
+    case MESH_FORMAT_SNORM16X2: return DXGI_FORMAT_R16G16_SNORM;
+    default: return DXGI_FORMAT_UNKNOWN;
+    }
+}
+
 TUTORIAL::TUTORIAL(const wstring& name, int width, int height, bool vSync):
     super(name, width, height, vSync),
     _scissorRect(CD3DX12_RECT(0, 0, LONG_MAX, LONG_MAX)),
@@ -59,15 +90,6 @@ TUTORIAL::TUTORIAL(const wstring& name, int width, int height, bool vSync):
 
 }
 
-void TUTORIAL::TransitionResource(ComPtr<ID3D12GraphicsCommandList2> commandList,
-    ComPtr<ID3D12Resource> resource,
-    D3D12_RESOURCE_STATES previousState,
-    D3D12_RESOURCE_STATES afterState)
-{
-    CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(resource.Get(), previousState, afterState);
-    commandList.Get()->ResourceBarrier(1, &barrier);
-}
-
 void TUTORIAL::ClearRTV(ComPtr<ID3D12GraphicsCommandList2> commandList,
     D3D12_CPU_DESCRIPTOR_HANDLE rtv,
     FLOAT* clearColor)
@@ -82,90 +104,296 @@ void TUTORIAL::ClearDepth(ComPtr<ID3D12GraphicsCommandList2> commandList,
     commandList.Get()->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, depth, 0, 0, nullptr);
 }
 
-void TUTORIAL::UpdateBufferResource(ComPtr<ID3D12GraphicsCommandList2> commandList,
-    ID3D12Resource** pDestinationResource,
-    ID3D12Resource** pIntermediateResource,
-    size_t numElements,
-    size_t elementSize,
+void TUTORIAL::StreamBufferResource(HEAP_ALLOCATOR::ALLOCATION** pDestinationResource,
+    size_t bufferSize,
     const void* pBufferData,
     D3D12_RESOURCE_FLAGS flags)
 {
-    ComPtr<ID3D12Device2> device = APPLICATION::Instance()->GetDevice();
-    size_t bufferSize = numElements * elementSize;
+    HEAP_ALLOCATOR* heapAllocator = APPLICATION::Instance()->GetHeapAllocator();
 
-    CD3DX12_HEAP_PROPERTIES heapProp(D3D12_HEAP_TYPE_DEFAULT);
     CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(bufferSize, flags);
-    ThrowIfFailed(device->CreateCommittedResource(
-        &heapProp,
-        D3D12_HEAP_FLAG_NONE,
-        &resourceDesc,
-        D3D12_RESOURCE_STATE_COMMON,
-        nullptr,
-        IID_PPV_ARGS(pDestinationResource)));
+    *pDestinationResource = heapAllocator->CreateResource(
+        D3D12_HEAP_TYPE_DEFAULT,
+        resourceDesc,
+        D3D12_RESOURCE_STATE_COMMON);
 
     if (pBufferData)
     {
-        CD3DX12_HEAP_PROPERTIES heapProp(D3D12_HEAP_TYPE_UPLOAD);
-        CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(bufferSize, flags);
-        ThrowIfFailed(device->CreateCommittedResource(
-            &heapProp,
-            D3D12_HEAP_FLAG_NONE,
-            &resourceDesc,
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(pIntermediateResource)));
-
-        D3D12_SUBRESOURCE_DATA subresourceData = {};
-        subresourceData.pData = pBufferData;
-        subresourceData.RowPitch = bufferSize;
-        subresourceData.SlicePitch = subresourceData.RowPitch;
-
-        ::UpdateSubresources(commandList.Get(), *pDestinationResource, *pIntermediateResource, 0, 0, 1, &subresourceData);
-    }    
+        // Copied on the copy queue by the streamer thread, the draw is skipped until it completed.
+        STREAM_REQUEST request;
+        request.destination = (*pDestinationResource)->resource.Get();
+        request.size = bufferSize;
+        request.read = [pBufferData](void* staging, uint64_t sourceOffset, uint64_t size)
+        {
+            memcpy(staging, static_cast<const uint8_t*>(pBufferData) + sourceOffset, size);
+            return true;
+        };
+        request.completion = [this](STREAM_STATUS status)
+        {
+            // Recorded before the count drops, the draw never sees a failed buffer as ready.
+            if (status != STREAM_COMPLETED)
+            {
+                _uploadFailed = true;
+                OutputDebugStringA(status == STREAM_CANCELLED ? "Buffer upload cancelled, the scene is not drawn.\n" : "Buffer upload failed, the scene is not drawn.\n");
+            }
+            _pendingUploads--;
+        };
+
+        _pendingUploads++;
+        APPLICATION::Instance()->GetAssetStreamer()->Request(std::move(request));
+    }
+}
+
+void TUTORIAL::DefragmentBuffers()
+{
+    // Buffers still streaming are written by the copy queue, move them once they landed.
+    if (_contentLoaded == false || _pendingUploads.load() > 0)
+    {
+        return;
+    }
+
+    COMMAND_QUEUE* graphicsQueue = APPLICATION::Instance()->GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    COMMAND_QUEUE* copyQueue = APPLICATION::Instance()->GetCommandQueue(D3D12_COMMAND_LIST_TYPE_COPY);
+
+    uint64_t fenceValue = APPLICATION::Instance()->GetHeapAllocator()->Defragment(copyQueue, graphicsQueue);
+    if (fenceValue == 0)
+    {
+        return;
+    }
+
+    // Frames recorded from now on read the moved buffers, once the copies completed.
+    graphicsQueue->Wait(*copyQueue, fenceValue);
+
+    for (uint32_t slot = 0; slot < VERTEX_STREAM_COUNT; ++slot)
+    {
+        _vertexBufferViews[slot].BufferLocation = _vertexBuffers[slot]->resource->GetGPUVirtualAddress();
+    }
+    _indexBufferView.BufferLocation = _indexBuffer->resource->GetGPUVirtualAddress();
+
+    char buffer[256];
+    sprintf_s(buffer, "Defragmented the mesh heaps, copies complete at %llu\n", static_cast<unsigned long long>(fenceValue));
+    OutputDebugStringA(buffer);
+}
+
+uint32_t TUTORIAL::CullInstances()
+{
+    if (_cullingMode == CULLING_NONE)
+    {
+        return GetInstanceCount();
+    }
+
+    _cullingClock.Tick();
+
+    // The hierarchy lists the visible instances in leaf order, the instance build takes any order.
+    FRUSTUM frustum = ExtractFrustum(MatrixMultiply(_viewMatrix, _projectionMatrix));
+    uint32_t visibleCount = _cullingMode == CULLING_HIERARCHY ?
+        GetInstanceHierarchy().QueryFrustum(frustum, _visibleInstances.data()) :
+        CullBoundingVolumes(frustum, GetInstanceBounds(), _visibleInstances.data(), APPLICATION::Instance()->GetJobSystem());
+
+    _cullingClock.Tick();
+    _cullingMilliseconds += _cullingClock.GetDeltaMilliseconds();
+    _cullingCount++;
+    _lastVisibleCount = visibleCount;
+
+    return visibleCount;
+}
+
+void TUTORIAL::BuildInstanceData(const UPLOAD_BUFFER::ALLOCATION& allocation, uint32_t visibleCount)
+{
+    FLOAT4X4* destination = static_cast<FLOAT4X4*>(allocation.cpu);
+
+    if (_instancing == false)
+    {
+        StoreFloat4x4(destination, _sceneTransforms.GetWorld(_meshTransform));
+        return;
+    }
+
+    _instanceBuildClock.Tick();
+
+    // Groups of 4 instances across the job system, written straight into the upload heap.
+    float time = static_cast<float>(_totalTime);
+    const uint32_t* visibleInstances = _cullingMode != CULLING_NONE ? _visibleInstances.data() : nullptr;
+    APPLICATION::Instance()->GetJobSystem()->ParallelFor((visibleCount + 3) / 4, g_instanceGroupsPerJob,
+        [this, destination, visibleInstances, visibleCount, time](uint32_t begin, uint32_t end)
+        {
+            if (visibleInstances)
+            {
+                BuildInstanceTransforms(destination, _stressInstances, visibleInstances, visibleCount, begin, end, _dequantizationMatrix, g_rotationAxis, time, g_rotationSpeed);
+            }
+            else
+            {
+                BuildInstanceTransforms(destination, _stressInstances, begin, end, _dequantizationMatrix, g_rotationAxis, time, g_rotationSpeed);
+            }
+        });
+
+    _instanceBuildClock.Tick();
+    _instanceBuildMilliseconds += _instanceBuildClock.GetDeltaMilliseconds();
+    _instanceBuildCount++;
+}
+
+void TUTORIAL::UpdateDraws()
+{
+    // Per object, every instance is a separate draw as distinct meshes would be.
+    uint32_t submeshCount = _mesh.GetHeader().submeshCount;
+    uint32_t instanceCount = GetInstanceCount();
+    uint32_t drawsPerSubmesh = _drawPerObject ? instanceCount : 1;
+
+    _draws.resize(static_cast<size_t>(submeshCount) * drawsPerSubmesh);
+
+    size_t drawIndex = 0;
+    for (uint32_t i = 0; i < drawsPerSubmesh; ++i)
+    {
+        for (uint32_t submesh = 0; submesh < submeshCount; ++submesh)
+        {
+            INDIRECT_DRAW& draw = _draws[drawIndex++];
+            draw.submesh = submesh;
+            draw.firstInstance = _drawPerObject ? i : 0;
+            draw.instanceCount = _drawPerObject ? 1 : instanceCount;
+        }
+    }
+}
+
+uint32_t TUTORIAL::PrepareDraws(uint32_t visibleCount)
+{
+    // The per object list is ordered by instance, its start covers the visible ones.
+    if (_drawPerObject)
+    {
+        return visibleCount * _mesh.GetHeader().submeshCount;
+    }
+
+    for (INDIRECT_DRAW& draw : _draws)
+    {
+        draw.instanceCount = visibleCount;
+    }
+    return static_cast<uint32_t>(_draws.size());
+}
+
+void TUTORIAL::BuildIndirectArguments(const UPLOAD_BUFFER::ALLOCATION& allocation, const INDIRECT_DRAW_BUFFER_LAYOUT& layout)
+{
+    uint8_t* arguments = static_cast<uint8_t*>(allocation.cpu);
+    INDIRECT_DRAW_COMMAND* commands = reinterpret_cast<INDIRECT_DRAW_COMMAND*>(arguments + layout.commandsOffset);
+    const MESH_SUBMESH* submeshes = &_mesh.GetSubmesh(0);
+    const INDIRECT_DRAW* draws = _draws.data();
+
+    _indirectPackClock.Tick();
+
+    APPLICATION::Instance()->GetJobSystem()->ParallelFor(layout.maxCommands, g_indirectDrawsPerJob,
+        [commands, draws, submeshes](uint32_t begin, uint32_t end)
+        {
+            PackIndirectDraws(commands, draws, begin, end, submeshes);
+        });
+
+    uint32_t commandCount = layout.maxCommands;
+    memcpy(arguments + layout.countOffset, &commandCount, sizeof(commandCount));
+
+    _indirectPackClock.Tick();
+    _indirectPackMilliseconds += _indirectPackClock.GetDeltaMilliseconds();
+    _indirectPackCount++;
 }
 
 bool TUTORIAL::LoadContent()
 {
     ComPtr<ID3D12Device2> device = APPLICATION::Instance()->GetDevice();
-    COMMAND_QUEUE* commandQueue = APPLICATION::Instance()->GetCommandQueue(D3D12_COMMAND_LIST_TYPE_COPY);
-    ComPtr<ID3D12GraphicsCommandList2> commandList = commandQueue->GetCommandList();
 
-    // Upload vertex buffer
-    ComPtr<ID3D12Resource> intermediateVertexBuffer;
-    UpdateBufferResource(commandList.Get(), &_vertexBuffer, &intermediateVertexBuffer, _countof(g_Vertices), sizeof(VERTEX_POS_COLOR), g_Vertices);
+    // The sections are read from the mapping straight into the staging memory, the file stays open until unloaded.
+    if (_mesh.Open(g_meshPath) == false)
+    {
+        ThrowIfFailed(E_FAIL);
+    }
+    const MESH_HEADER& meshHeader = _mesh.GetHeader();
+    _mesh.GetMappedFile().Prefetch(0, meshHeader.fileSize);
+
+    // Upload vertex streams
+    D3D12_INPUT_ELEMENT_DESC inputLayout[VERTEX_STREAM_COUNT] = {};
+    for (uint32_t slot = 0; slot < VERTEX_STREAM_COUNT; ++slot)
+    {
+        const MESH_STREAM* stream = _mesh.FindStream(g_vertexStreams[slot].semantic);
+        if (stream == nullptr)
+        {
+            ThrowIfFailed(E_FAIL);
+        }
+
+        StreamBufferResource(&_vertexBuffers[slot], stream->size, _mesh.GetStreamData(*stream));
 
-    // Create vertex buffer view
-    _vertexBufferView.BufferLocation = _vertexBuffer->GetGPUVirtualAddress();
-    _vertexBufferView.SizeInBytes = sizeof(g_Vertices);
-    _vertexBufferView.StrideInBytes = sizeof(VERTEX_POS_COLOR);
+        // Create vertex buffer view
+        _vertexBufferViews[slot].BufferLocation = _vertexBuffers[slot]->resource->GetGPUVirtualAddress();
+        _vertexBufferViews[slot].SizeInBytes = static_cast<UINT>(stream->size);
+        _vertexBufferViews[slot].StrideInBytes = stream->stride;
+
+        inputLayout[slot] = { g_vertexStreams[slot].semanticName, 0, GetVertexFormat(static_cast<MESH_FORMAT>(stream->format)), slot, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+    }
+
+    // The input assembler decodes quantized positions to [-1, 1], the bounds are applied by the model matrix.
+    _dequantizationMatrix = MatrixIdentity();
+    _sceneTransforms.Clear();
+    _cubeTransform = _sceneTransforms.Add();
+    _meshTransform = _sceneTransforms.Add(_cubeTransform);
+    if (_mesh.FindStream(MESH_SEMANTIC_POSITION)->format == MESH_FORMAT_SNORM16X4)
+    {
+        float scale[3];
+        float offset[3];
+        GetPositionDequantization(meshHeader.bounds, scale, offset);
+        _dequantizationMatrix = MatrixMultiply(MatrixScaling(scale[0], scale[1], scale[2]), MatrixTranslation(offset[0], offset[1], offset[2]));
+        _sceneTransforms.SetLocal(_meshTransform, FLOAT3{ offset[0], offset[1], offset[2] }, FLOAT4{ 0.0f, 0.0f, 0.0f, 1.0f }, FLOAT3{ scale[0], scale[1], scale[2] });
+    }
 
     // Upload index buffer
-    ComPtr<ID3D12Resource> intermediateIndexBuffer;
-    UpdateBufferResource(commandList.Get(), &_indexBuffer, &intermediateIndexBuffer, _countof(g_Indices), sizeof(WORD), g_Indices);
+    StreamBufferResource(&_indexBuffer, meshHeader.indexSize, _mesh.GetIndexData());
 
     // Create index buffer view
-    _indexBufferView.BufferLocation = _indexBuffer->GetGPUVirtualAddress();
-    _indexBufferView.Format = DXGI_FORMAT_R16_UINT;
-    _indexBufferView.SizeInBytes = sizeof(g_Indices);
-
-    // Create Descriptor Heap for depth RT
-    D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
-    dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-    dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-    dsvHeapDesc.NodeMask = 0;
-    dsvHeapDesc.NumDescriptors = 1;
-    device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&_dsvHeap));
+    _indexBufferView.BufferLocation = _indexBuffer->resource->GetGPUVirtualAddress();
+    _indexBufferView.Format = meshHeader.indexFormat == MESH_INDEX_UINT16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+    _indexBufferView.SizeInBytes = static_cast<UINT>(meshHeader.indexSize);
+
+    _stressSceneRadius = CreateInstanceGrid(_stressInstances, STRESS_INSTANCE_COUNT, g_stressInstanceSpacing);
+
+    // The sphere around the pivot enclosing the mesh bounds, and the box enclosing the sphere.
+    float meshRadius = 0.0f;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float extent = std::max(std::fabs(meshHeader.bounds.min[axis]), std::fabs(meshHeader.bounds.max[axis]));
+        meshRadius += extent * extent;
+    }
+    meshRadius = std::sqrt(meshRadius);
+    const float meshExtent[3] = { meshRadius, meshRadius, meshRadius };
+
+    const float origin[3] = { 0.0f, 0.0f, 0.0f };
+    _singleBounds.Resize(1);
+    _singleBounds.Set(0, origin, meshExtent, meshRadius);
+
+    _stressBounds.Resize(_stressInstances.count);
+    for (uint32_t i = 0; i < _stressInstances.count; ++i)
+    {
+        const float center[3] = { _stressInstances.positionX[i], _stressInstances.positionY[i], _stressInstances.positionZ[i] };
+        _stressBounds.Set(i, center, meshExtent, meshRadius);
+    }
+    _visibleInstances.resize(_stressBounds.GetPaddedCount());
+
+    // The instances do not move, their bounds hold for any rotation: built once, never refitted.
+    _singleHierarchy.Build(_singleBounds);
+    _stressHierarchy.Build(_stressBounds, APPLICATION::Instance()->GetJobSystem());
+
+    INDIRECT_DRAW_BUFFER_LAYOUT maxArgumentLayout = GetIndirectDrawBufferLayout(STRESS_INSTANCE_COUNT * meshHeader.submeshCount);
+    uint64_t frameUploadSize = D3DX12Align<uint64_t>(static_cast<uint64_t>(STRESS_INSTANCE_COUNT) * sizeof(FLOAT4X4), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT) +
+        D3DX12Align<uint64_t>(maxArgumentLayout.size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+    // Room for the stress scene of every frame in flight and the one being recorded, drawn per object.
+    // Sized from the --frames count, not g_numFrames: up to MAX_FRAMES_IN_FLIGHT frames can hold upload memory.
+    _uploadBuffer = std::make_unique<UPLOAD_BUFFER>(device,
+        APPLICATION::Instance()->GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT),
+        (APPLICATION::Instance()->GetFramesInFlight() + 1) * frameUploadSize);
+    _instanceView = APPLICATION::Instance()->AllocateDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+    _renderGraph = std::make_unique<RENDER_GRAPH_EXECUTOR>(device,
+        APPLICATION::Instance()->GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT),
+        APPLICATION::Instance()->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_RTV),
+        APPLICATION::Instance()->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_DSV),
+        APPLICATION::Instance()->GetJobSystem());
 
     // Load vertex and pixel shader from compiled binary
     ComPtr<ID3DBlob> vertexShaderBlob, pixelShaderBlob;
     ThrowIfFailed(D3DReadFileToBlob(L"VertexShader.cso", &vertexShaderBlob));
     ThrowIfFailed(D3DReadFileToBlob(L"PixelShader.cso", &pixelShaderBlob));
 
-    // Input layout for vertex shader
-    D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
-        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"COLOR", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}};
-
     // Check for root signature version
     D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
     featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_2;
@@ -186,8 +414,11 @@ bool TUTORIAL::LoadContent()
         D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS |
         D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS;
 
-    CD3DX12_ROOT_PARAMETER1 rootParameters[1] = {};
-    rootParameters[0].InitAsConstants(sizeof(XMMATRIX) / 4, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX); // number of 32 bits elements ==> '16' floats (size of MMATRIX / 4)
+    CD3DX12_ROOT_PARAMETER1 rootParameters[ROOT_PARAMETER_COUNT] = {};
+    rootParameters[ROOT_PARAMETER_VIEW_PROJECTION].InitAsConstants(sizeof(MATRIX) / 4, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX); // number of 32 bits elements ==> '16' floats (size of MMATRIX / 4)
+    CD3DX12_DESCRIPTOR_RANGE1 instanceRange(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE);
+    rootParameters[ROOT_PARAMETER_INSTANCES].InitAsDescriptorTable(1, &instanceRange, D3D12_SHADER_VISIBILITY_VERTEX); // Instance world matrices
+    rootParameters[ROOT_PARAMETER_DRAW].InitAsConstants(1, 1, 0, D3D12_SHADER_VISIBILITY_VERTEX); // First instance of the draw
 
     CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDescription = {};
     CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC::Init_1_2(rootSignatureDescription, _countof(rootParameters), rootParameters, 0, nullptr, rootSignatureFlags);
@@ -197,6 +428,9 @@ bool TUTORIAL::LoadContent()
     ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDescription, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
     ThrowIfFailed(device->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&_rootSignature)));
 
+    _commandSignature = CreateIndirectDrawSignature(device, _rootSignature.Get(), ROOT_PARAMETER_DRAW);
+    UpdateDraws();
+
     // Pipeline State Object
     D3D12_RT_FORMAT_ARRAY rtFormatArrays = {};
     rtFormatArrays.NumRenderTargets = 1;
@@ -216,56 +450,35 @@ bool TUTORIAL::LoadContent()
     psoDesc.SizeInBytes = sizeof(PIPELINE_STREAM_STATE);
     ThrowIfFailed(device->CreatePipelineState(&psoDesc, IID_PPV_ARGS(&_pipelineState)));
 
-    uint64_t fenceValue = commandQueue->ExecuteCommandList(commandList);
-    commandQueue->WaitForFenceValue(fenceValue);
-
     _contentLoaded = true;
 
-    ResizeDepthBuffer(GetClientWidth(), GetClientHeight());
-
     return true;
 }
 
 void TUTORIAL::UnloadContent()
 {
-    _contentLoaded = false;
-}
+    // The application flushed every queue before unloading, uploads may still be streamed.
+    APPLICATION::Instance()->GetAssetStreamer()->WaitForIdle();
 
-void TUTORIAL::ResizeDepthBuffer(int width, int height)
-{
-    if (_contentLoaded)
+    HEAP_ALLOCATOR* heapAllocator = APPLICATION::Instance()->GetHeapAllocator();
+    for (HEAP_ALLOCATOR::ALLOCATION*& vertexBuffer : _vertexBuffers)
     {
-        APPLICATION::Instance()->Flush();
-
-        width = std::max(1, width);
-        height = std::max(1, height);
-
-        ComPtr<ID3D12Device2> device = APPLICATION::Instance()->GetDevice();
-
-        D3D12_CLEAR_VALUE optimizedClearValue = {};
-        optimizedClearValue.Format = DXGI_FORMAT_D32_FLOAT;
-        optimizedClearValue.DepthStencil = { 1.0f, 0 };
-
-        CD3DX12_HEAP_PROPERTIES heapProp(D3D12_HEAP_TYPE_DEFAULT);
-        CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_D32_FLOAT, width, height, 1, 0, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
+        heapAllocator->Free(vertexBuffer);
+        vertexBuffer = nullptr;
+    }
+    heapAllocator->Free(_indexBuffer);
+    _indexBuffer = nullptr;
 
-        ThrowIfFailed(device->CreateCommittedResource(
-            &heapProp,
-            D3D12_HEAP_FLAG_NONE,
-            &resourceDesc,
-            D3D12_RESOURCE_STATE_DEPTH_WRITE,
-            &optimizedClearValue,
-            IID_PPV_ARGS(&_depthBuffer))
-        );
+    _mesh.Close();
 
-        D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
-        dsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
-        dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
-        dsvDesc.Texture2D.MipSlice = 0;
-        dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
+    APPLICATION::Instance()->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)->Free(_instanceView);
+    _instanceView = DESCRIPTOR_ALLOCATION();
+    _uploadBuffer.reset();
+    _commandSignature.Reset();
+    _draws.clear();
+    _renderGraph.reset();
 
-        device->CreateDepthStencilView(_depthBuffer.Get(), &dsvDesc, _dsvHeap->GetCPUDescriptorHandleForHeapStart());
-    }
+    _contentLoaded = false;
 }
 
 void TUTORIAL::OnUpdate(UpdateEventArgs& e)
@@ -287,67 +500,164 @@ void TUTORIAL::OnUpdate(UpdateEventArgs& e)
         sprintf_s(buffer, "FPS : %f\n", fps);
         OutputDebugStringA(buffer);
 
+        if (_instanceBuildCount > 0)
+        {
+            sprintf_s(buffer, "Instance data : %u instances in %f ms\n", _stressInstances.count, _instanceBuildMilliseconds / _instanceBuildCount);
+            OutputDebugStringA(buffer);
+
+            _instanceBuildMilliseconds = 0.0;
+            _instanceBuildCount = 0;
+        }
+
+        if (_cullingCount > 0)
+        {
+            sprintf_s(buffer, "Culling (%s, %s) : %u / %u visible in %f ms\n", g_cullingModeNames[_cullingMode], GetCullingIsaName(GetBestCullingIsa()),
+                _lastVisibleCount, GetInstanceBounds().count, _cullingMilliseconds / _cullingCount);
+            OutputDebugStringA(buffer);
+
+            _cullingMilliseconds = 0.0;
+            _cullingCount = 0;
+        }
+
+        if (_indirectPackCount > 0)
+        {
+            sprintf_s(buffer, "Indirect arguments : %zu draws in %f ms\n", _draws.size(), _indirectPackMilliseconds / _indirectPackCount);
+            OutputDebugStringA(buffer);
+
+            _indirectPackMilliseconds = 0.0;
+            _indirectPackCount = 0;
+        }
+
         frameCount = 0;
         totalTime = 0.0;
     }
 
-    float angle = static_cast<float>(e.TotalTime * 90.0);
-    const XMVECTOR rotationAxis = XMVectorSet(0, 1, 1, 0);
-    _modelMatrix = XMMatrixRotationAxis(rotationAxis, XMConvertToRadians(angle));
+    _totalTime = e.TotalTime;
 
-    const XMVECTOR eyePosition = XMVectorSet(0,0,-10,1);
-    const XMVECTOR focusPoint = XMVectorSet(0,0,0,1);
-    const XMVECTOR upDirection = XMVectorSet(0,1,0,0);
-    _viewMatrix = XMMatrixLookAtLH(eyePosition, focusPoint, upDirection);
+    float angle = static_cast<float>(e.TotalTime * 90.0);
+    const VECTOR rotationAxis = VectorSet(0, 1, 1, 0);
+    FLOAT4 cubeRotation;
+    StoreFloat4(&cubeRotation, QuaternionRotationAxis(rotationAxis, ConvertToRadians(angle)));
+    _sceneTransforms.SetLocalRotation(_cubeTransform, cubeRotation);
+    _sceneTransforms.Update(APPLICATION::Instance()->GetJobSystem());
+
+    // Backs away from the stress scene so the whole grid is in view.
+    const float sceneRadius = _instancing ? _stressSceneRadius : 0.0f;
+    const float eyeDistance = 10.0f + sceneRadius * 2.0f;
+    const float farPlane = std::max(100.0f, eyeDistance + sceneRadius * 2.0f);
+
+    const VECTOR eyePosition = VectorSet(0, 0, -eyeDistance, 1);
+    const VECTOR focusPoint = VectorSet(0,0,0,1);
+    const VECTOR upDirection = VectorSet(0,1,0,0);
+    _viewMatrix = MatrixLookAtLH(eyePosition, focusPoint, upDirection);
 
     float aspectRatio = GetClientWidth() / static_cast<float>(GetClientHeight());
-    _projectionMatrix = XMMatrixPerspectiveFovLH(XMConvertToRadians(_fov), aspectRatio, 0.1f, 100.0f);
+    _projectionMatrix = MatrixPerspectiveFovLH(ConvertToRadians(_fov), aspectRatio, 0.1f, farPlane);
 }
 
 void TUTORIAL::OnRender(RenderEventArgs& e)
 {
     super::OnRender(e);
 
-    ComPtr<ID3D12Device2> device = APPLICATION::Instance()->GetDevice();
-    COMMAND_QUEUE* commandQueue = APPLICATION::Instance()->GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT);
-    auto commandList = commandQueue->GetCommandList();
-    
-    UINT currentBackBufferIndex = _window->GetCurrentBackBufferIndex();
-    auto backBuffer = _window->GetCurrentBackBuffer();
-    auto rtv = _window->GetCurrentRenderTargetView();
-    auto dsv = _dsvHeap->GetCPUDescriptorHandleForHeapStart();
+    FRAME_SCHEDULER* frameScheduler = APPLICATION::Instance()->GetFrameScheduler();
+    GPU_DESCRIPTOR_HEAP* gpuDescriptorHeap = APPLICATION::Instance()->GetGpuDescriptorHeap();
+
+    // Blocks until the GPU is no more than the configured number of frames behind.
+    frameScheduler->BeginFrame();
+
+    // Recycled when the scheduler retires the frame, like the descriptor tables.
+    uint32_t visibleCount = CullInstances();
+    UPLOAD_BUFFER::ALLOCATION instanceData = _uploadBuffer->Allocate(std::max(1u, visibleCount) * sizeof(FLOAT4X4));
+    BuildInstanceData(instanceData, visibleCount);
+
+    // The view is staged on the CPU and copied into this frame's table, the staging slot can be rewritten right away.
+    D3D12_SHADER_RESOURCE_VIEW_DESC instanceViewDesc = {};
+    instanceViewDesc.Format = DXGI_FORMAT_UNKNOWN;
+    instanceViewDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+    instanceViewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    instanceViewDesc.Buffer.FirstElement = instanceData.offset / sizeof(FLOAT4X4);
+    instanceViewDesc.Buffer.NumElements = std::max(1u, visibleCount);
+    instanceViewDesc.Buffer.StructureByteStride = sizeof(FLOAT4X4);
+    APPLICATION::Instance()->GetDevice()->CreateShaderResourceView(instanceData.resource, &instanceViewDesc, _instanceView.cpu);
+    D3D12_GPU_DESCRIPTOR_HANDLE instanceTable = gpuDescriptorHeap->CopyDescriptors(&_instanceView.cpu, 1);
+
+    INDIRECT_DRAW_BUFFER_LAYOUT argumentLayout = GetIndirectDrawBufferLayout(PrepareDraws(visibleCount));
+    UPLOAD_BUFFER::ALLOCATION argumentData = _uploadBuffer->Allocate(argumentLayout.size);
+    BuildIndirectArguments(argumentData, argumentLayout);
+
+    RENDER_GRAPH& graph = _renderGraph->Begin();
+
+    RENDER_GRAPH::RESOURCE_HANDLE backBuffer = _renderGraph->ImportResource("BackBuffer", _window->GetCurrentBackBuffer(), D3D12_RESOURCE_STATE_PRESENT);
 
-    // Clear back and depth
+    D3D12_CLEAR_VALUE optimizedClearValue = {};
+    optimizedClearValue.Format = DXGI_FORMAT_D32_FLOAT;
+    optimizedClearValue.DepthStencil = { 1.0f, 0 };
+
+    CD3DX12_RESOURCE_DESC depthDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_D32_FLOAT,
+        std::max(1, GetClientWidth()), std::max(1, GetClientHeight()), 1, 0, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
+    RENDER_GRAPH::RESOURCE_HANDLE depthBuffer = _renderGraph->CreateTexture("DepthBuffer", depthDesc, &optimizedClearValue);
+
+    D3D12_CPU_DESCRIPTOR_HANDLE rtv = _window->GetCurrentRenderTargetView();
+
+    RENDER_GRAPH::PASS_HANDLE scenePass = graph.AddPass("Scene", [this, rtv, depthBuffer, gpuDescriptorHeap, instanceTable, argumentData, argumentLayout](RENDER_PASS_CONTEXT& context)
     {
-        TransitionResource(commandList, backBuffer, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        ComPtr<ID3D12GraphicsCommandList2> commandList = context.GetCommandList();
+        D3D12_CPU_DESCRIPTOR_HANDLE dsv = context.GetDepthStencilView(depthBuffer);
+
+        // Clear back and depth, the depth buffer may alias other transient memory.
         FLOAT clearColor[] = { 0.4f, 0.6f, 0.9f, 1.0f };
         ClearRTV(commandList, rtv, clearColor);
-        ClearDepth(commandQueue->GetCommandList(), dsv);
-    }
+        ClearDepth(commandList, dsv);
 
-    commandList->SetPipelineState(_pipelineState.Get());
-    commandList->SetGraphicsRootSignature(_rootSignature.Get());
+        // Geometry still streaming in, or missing.
+        if (_pendingUploads.load() > 0 || _uploadFailed.load())
+        {
+            return;
+        }
+
+        commandList->SetPipelineState(_pipelineState.Get());
+        commandList->SetGraphicsRootSignature(_rootSignature.Get());
 
-    commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    commandList->IASetVertexBuffers(0, 1, &_vertexBufferView);
-    commandList->IASetIndexBuffer(&_indexBufferView);
+        ID3D12DescriptorHeap* descriptorHeaps[] = { gpuDescriptorHeap->GetHeap() };
+        commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
-    commandList->RSSetViewports(1, &_viewport);
-    commandList->RSSetScissorRects(1, &_scissorRect);
+        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        commandList->IASetVertexBuffers(0, VERTEX_STREAM_COUNT, _vertexBufferViews);
+        commandList->IASetIndexBuffer(&_indexBufferView);
 
-    commandList->OMSetRenderTargets(1, &rtv, false, &dsv);
+        commandList->RSSetViewports(1, &_viewport);
+        commandList->RSSetScissorRects(1, &_scissorRect);
 
-    XMMATRIX mvpMatrix = XMMatrixMultiply(_modelMatrix, _viewMatrix);
-    mvpMatrix = XMMatrixMultiply(mvpMatrix, _projectionMatrix);
-    commandList->SetGraphicsRoot32BitConstants(0, sizeof(XMMATRIX) / 4, &mvpMatrix, 0);
+        commandList->OMSetRenderTargets(1, &rtv, false, &dsv);
 
-    commandList->DrawIndexedInstanced(_countof(g_Indices), 1, 0, 0, 0);
+        // The model matrices, with the dequantization, come from the instance buffer.
+        MATRIX viewProjectionMatrix = MatrixMultiply(_viewMatrix, _projectionMatrix);
+        commandList->SetGraphicsRoot32BitConstants(ROOT_PARAMETER_VIEW_PROJECTION, sizeof(MATRIX) / 4, &viewProjectionMatrix, 0);
+        commandList->SetGraphicsRootDescriptorTable(ROOT_PARAMETER_INSTANCES, instanceTable);
+
+        // Upload heaps stay in GENERIC_READ, which covers INDIRECT_ARGUMENT.
+        commandList->ExecuteIndirect(_commandSignature.Get(), argumentLayout.maxCommands,
+            argumentData.resource, argumentData.offset + argumentLayout.commandsOffset,
+            argumentData.resource, argumentData.offset + argumentLayout.countOffset);
+    });
+    graph.Write(scenePass, backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    graph.Write(scenePass, depthBuffer, D3D12_RESOURCE_STATE_DEPTH_WRITE);
 
     {
-        TransitionResource(commandList, backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
-        _fenceValues[currentBackBufferIndex] = commandQueue->ExecuteCommandList(commandList);
-        currentBackBufferIndex = _window->Present();
-        commandQueue->WaitForFenceValue(_fenceValues[currentBackBufferIndex]);
+        // The back buffer is transitioned to PRESENT at the end of the graph.
+        uint64_t fenceValue = _renderGraph->Execute();
+        _window->Present();
+
+        // The frame's upload memory and descriptor tables are recycled when the scheduler retires it.
+        _uploadBuffer->Commit(fenceValue);
+        gpuDescriptorHeap->Commit(fenceValue);
+        frameScheduler->OnFrameRetired([this, gpuDescriptorHeap, fenceValue]()
+        {
+            _uploadBuffer->Retire(fenceValue);
+            gpuDescriptorHeap->Retire(fenceValue);
+        });
+
+        frameScheduler->EndFrame(fenceValue);
     }
 }
 
@@ -370,9 +680,57 @@ void TUTORIAL::OnKeyPressed(KeyEventArgs& e)
     case KeyCode::V:
         _window->SwitchVSync();
         break;
+    case KeyCode::I:
+        _instancing = !_instancing;
+        UpdateDraws();
+        break;
+    case KeyCode::O:
+        _drawPerObject = !_drawPerObject;
+        UpdateDraws();
+        break;
+    case KeyCode::C:
+        _cullingMode = static_cast<CULLING_MODE>((_cullingMode + 1) % CULLING_MODE_COUNT);
+        break;
+    case KeyCode::D:
+        DefragmentBuffers();
+        break;
     }
 }
 
+void TUTORIAL::OnMouseButtonPressed(MouseButtonEventArgs& e)
+{
+    super::OnMouseButtonPressed(e);
+
+    if (e.Button != MouseButtonEventArgs::Left || _contentLoaded == false)
+    {
+        return;
+    }
+
+    // Ray from the near to the far plane through the cursor, in world space.
+    float x = 2.0f * e.X / std::max(1, GetClientWidth()) - 1.0f;
+    float y = 1.0f - 2.0f * e.Y / std::max(1, GetClientHeight());
+    MATRIX clipToWorld = MatrixInverse(MatrixMultiply(_viewMatrix, _projectionMatrix));
+    VECTOR nearPoint = Vector3TransformCoord(VectorSet(x, y, 0.0f, 1.0f), clipToWorld);
+    VECTOR farPoint = Vector3TransformCoord(VectorSet(x, y, 1.0f, 1.0f), clipToWorld);
+
+    FLOAT3 origin, direction;
+    StoreFloat3(&origin, nearPoint);
+    StoreFloat3(&direction, VectorSubtract(farPoint, nearPoint));
+
+    // The direction spans the frustum, a hit lies within one length of it.
+    RAY_HIT hit;
+    char buffer[256];
+    if (GetInstanceHierarchy().Raycast(&origin.x, &direction.x, 1.0f, hit))
+    {
+        sprintf_s(buffer, "Picked instance %u at %f\n", hit.primitive, hit.distance * VectorGetX(Vector3Length(VectorSubtract(farPoint, nearPoint))));
+    }
+    else
+    {
+        sprintf_s(buffer, "Picked nothing\n");
+    }
+    OutputDebugStringA(buffer);
+}
+
 void TUTORIAL::OnMouseWheel(MouseWheelEventArgs& e)
 {
     _fov -= e.WheelDelta;
@@ -389,8 +747,7 @@ void TUTORIAL::OnResize(ResizeEventArgs& e)
     {
         super::OnResize(e);
 
+        // The render graph recreates the depth buffer at the new size.
         _viewport = CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float>(e.Width), static_cast<float>(e.Height));
-
-        ResizeDepthBuffer(e.Width, e.Height);
     }
 }
\ No newline at end of file
@@ -2,14 +2,40 @@
 
 #include "../Game.h"
 #include "../Window.h"
-
-#include <DirectXMath.h>
+#include "../BoundingVolumeHierarchy.h"
+#include "../FrustumCulling.h"
+#include "../HeapAllocator.h"
+#include "../HighResolutionClock.h"
+#include "../IndirectDraw.h"
+#include "../InstanceTransforms.h"
+#include "../MeshFile.h"
+#include "../RenderGraphExecutor.h"
+#include "../TransformHierarchy.h"
+#include "../UploadBuffer.h"
+#include "../VectorMath.h"
+
+#include <atomic>
+#include <vector>
 
 class TUTORIAL : public GAME
 {
 public:
 	using super = GAME;
 
+	// Input slots of the vertex streams: POSITION, COLOR
+	static const uint32_t VERTEX_STREAM_COUNT = 2;
+
+	// Cubes of the instancing stress scene, toggled with I
+	static const uint32_t STRESS_INSTANCE_COUNT = 100000;
+
+	enum CULLING_MODE
+	{
+		CULLING_NONE,
+		CULLING_FLAT,			// SIMD test of every instance
+		CULLING_HIERARCHY,		// Bounding volume hierarchy traversal
+		CULLING_MODE_COUNT
+	};
+
 	TUTORIAL(const wstring& name, int width, int height, bool vSync);
 
 	virtual bool LoadContent() override;
@@ -19,15 +45,11 @@ protected:
 	virtual void OnUpdate(UpdateEventArgs& e) override;
 	virtual void OnRender(RenderEventArgs& e) override;
 	virtual void OnKeyPressed(KeyEventArgs& e) override;
+	virtual void OnMouseButtonPressed(MouseButtonEventArgs& e) override;
 	virtual void OnMouseWheel(MouseWheelEventArgs& e) override;
 	virtual void OnResize(ResizeEventArgs& e) override;
 
 private:
-	void TransitionResource(ComPtr<ID3D12GraphicsCommandList2> commandList,
-		ComPtr<ID3D12Resource> resource,
-		D3D12_RESOURCE_STATES previousState,
-		D3D12_RESOURCE_STATES afterState);
-
 	void ClearRTV(ComPtr<ID3D12GraphicsCommandList2> commandList,
 		D3D12_CPU_DESCRIPTOR_HANDLE rtv, 
 		FLOAT* clearColor);
@@ -36,25 +58,81 @@ private:
 		D3D12_CPU_DESCRIPTOR_HANDLE dsv,
 		FLOAT depth = 1.0f);
 
-	void UpdateBufferResource(ComPtr<ID3D12GraphicsCommandList2> commandList,
-		ID3D12Resource** pDestinationResource, 
-		ID3D12Resource** pIntermediateResource,
-		size_t numElements,
-		size_t elementSize,
+	// Creates the buffer and streams the data into it on the copy queue.
+	void StreamBufferResource(HEAP_ALLOCATOR::ALLOCATION** pDestinationResource,
+		size_t bufferSize,
 		const void* pBufferData,
 		D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE);
-
-	void ResizeDepthBuffer(int width, int height);
-
-	uint64_t _fenceValues[g_numFrames] = {0};
-
-	ComPtr<ID3D12Resource> _vertexBuffer;
-	ComPtr<ID3D12Resource> _indexBuffer;
-	D3D12_VERTEX_BUFFER_VIEW _vertexBufferView;
+	// Compacts the DEFAULT heaps, the mesh buffers may move.
+	void DefragmentBuffers();
+
+	inline uint32_t GetInstanceCount() const { return _instancing ? _stressInstances.count : 1; }
+	inline const BOUNDING_VOLUMES& GetInstanceBounds() const { return _instancing ? _stressBounds : _singleBounds; }
+	inline const BOUNDING_VOLUME_HIERARCHY& GetInstanceHierarchy() const { return _instancing ? _stressHierarchy : _singleHierarchy; }
+
+	// Fills _visibleInstances against the camera frustum, returns their count.
+	uint32_t CullInstances();
+	// Writes the world matrices of the visible instances, compacted.
+	void BuildInstanceData(const UPLOAD_BUFFER::ALLOCATION& allocation, uint32_t visibleCount);
+
+	// Rebuilds the draw list after the scene or the submission mode changed.
+	void UpdateDraws();
+	// Number of draws of the list submitted for the visible instances.
+	uint32_t PrepareDraws(uint32_t visibleCount);
+	// Packs the draw list into the indirect arguments of this frame.
+	void BuildIndirectArguments(const UPLOAD_BUFFER::ALLOCATION& allocation, const INDIRECT_DRAW_BUFFER_LAYOUT& layout);
+
+	// Streamed buffers not uploaded yet, written by the streamer thread
+	std::atomic<uint32_t> _pendingUploads{ 0 };
+	// A streamed buffer was cancelled or failed, its content is undefined
+	std::atomic<bool> _uploadFailed{ false };
+
+	// Placed resources owned by the application heap allocator
+	HEAP_ALLOCATOR::ALLOCATION* _vertexBuffers[VERTEX_STREAM_COUNT] = {};
+	HEAP_ALLOCATOR::ALLOCATION* _indexBuffer = nullptr;
+	D3D12_VERTEX_BUFFER_VIEW _vertexBufferViews[VERTEX_STREAM_COUNT] = {};
 	D3D12_INDEX_BUFFER_VIEW _indexBufferView;
 
-	ComPtr<ID3D12Resource> _depthBuffer;
-	ComPtr<ID3D12DescriptorHeap> _dsvHeap;
+	// Mapped while the buffers are streamed from it
+	MESH_FILE _mesh;
+
+	// Per-instance world matrices and indirect arguments, rewritten every frame
+	std::unique_ptr<UPLOAD_BUFFER> _uploadBuffer;
+	// Staged view of this frame's instance matrices, copied into a descriptor table of the shader visible heap
+	DESCRIPTOR_ALLOCATION _instanceView;
+	INSTANCE_SET _stressInstances;
+	float _stressSceneRadius = 0.0f;
+	bool _instancing = false;
+
+	// Instance bounds around the rotation pivot, they hold for any rotation. C cycles the culling modes
+	BOUNDING_VOLUMES _singleBounds;
+	BOUNDING_VOLUMES _stressBounds;
+	BOUNDING_VOLUME_HIERARCHY _singleHierarchy;
+	BOUNDING_VOLUME_HIERARCHY _stressHierarchy;
+	std::vector<uint32_t> _visibleInstances;
+	CULLING_MODE _cullingMode = CULLING_HIERARCHY;
+
+	HighResolutionClock _cullingClock;
+	double _cullingMilliseconds = 0.0;
+	uint64_t _cullingCount = 0;
+	uint32_t _lastVisibleCount = 0;
+
+	// CPU time spent building the instance data, reported with the FPS
+	HighResolutionClock _instanceBuildClock;
+	double _instanceBuildMilliseconds = 0.0;
+	uint64_t _instanceBuildCount = 0;
+
+	// Draws submitted with ExecuteIndirect, one per submesh, or per submesh and instance with _drawPerObject (O)
+	ComPtr<ID3D12CommandSignature> _commandSignature;
+	std::vector<INDIRECT_DRAW> _draws;
+	bool _drawPerObject = false;
+
+	HighResolutionClock _indirectPackClock;
+	double _indirectPackMilliseconds = 0.0;
+	uint64_t _indirectPackCount = 0;
+
+	// Frame graph, owns the depth buffer
+	std::unique_ptr<RENDER_GRAPH_EXECUTOR> _renderGraph;
 
 	ComPtr<ID3D12RootSignature> _rootSignature;
 	ComPtr<ID3D12PipelineState> _pipelineState;
@@ -62,10 +140,16 @@ private:
 	D3D12_VIEWPORT _viewport;
 	D3D12_RECT _scissorRect;
 
+	// The rotating cube, and its mesh below it with the dequantization as local transform
+	TRANSFORM_HIERARCHY _sceneTransforms;
+	TRANSFORM_HIERARCHY::HANDLE _cubeTransform = TRANSFORM_HIERARCHY::INVALID_HANDLE;
+	TRANSFORM_HIERARCHY::HANDLE _meshTransform = TRANSFORM_HIERARCHY::INVALID_HANDLE;
+
 	FLOAT _fov = 45.0f;
-	DirectX::XMMATRIX _modelMatrix = DirectX::XMMatrixIdentity();
-	DirectX::XMMATRIX _viewMatrix = DirectX::XMMatrixIdentity();;
-	DirectX::XMMATRIX _projectionMatrix = DirectX::XMMatrixIdentity();;
+	double _totalTime = 0.0;
+	VectorMath::MATRIX _dequantizationMatrix = VectorMath::MatrixIdentity();	// Quantized mesh positions to mesh space
+	VectorMath::MATRIX _viewMatrix = VectorMath::MatrixIdentity();;
+	VectorMath::MATRIX _projectionMatrix = VectorMath::MatrixIdentity();;
 
 	bool _contentLoaded = false;
 };
\ No newline at end of file
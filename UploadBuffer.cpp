@@ -0,0 +1,81 @@
+#include "UploadBuffer.h"
+#include "CommandQueue.h"
+
+UPLOAD_BUFFER::UPLOAD_BUFFER(ComPtr<ID3D12Device2> device, COMMAND_QUEUE* commandQueue, uint64_t size) :
+	_commandQueue(commandQueue),
+	_ring(size)
+{
+	CD3DX12_HEAP_PROPERTIES heapProp(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+	ThrowIfFailed(device->CreateCommittedResource(
+		&heapProp,
+		D3D12_HEAP_FLAG_NONE,
+		&resourceDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&_resource)));
+
+	// Upload heaps can stay mapped for the lifetime of the resource.
+	CD3DX12_RANGE readRange(0, 0);
+	ThrowIfFailed(_resource->Map(0, &readRange, reinterpret_cast<void**>(&_cpuBase)));
+	_gpuBase = _resource->GetGPUVirtualAddress();
+}
+
+UPLOAD_BUFFER::~UPLOAD_BUFFER()
+{
+	_resource->Unmap(0, nullptr);
+}
+
+UPLOAD_BUFFER::ALLOCATION UPLOAD_BUFFER::Allocate(uint64_t size, uint64_t alignment)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (size > _ring.GetCapacity())
+	{
+		ThrowIfFailed(E_OUTOFMEMORY);
+	}
+
+	_ring.Retire(_commandQueue->GetCompletedFenceValue());
+
+	uint64_t offset = _ring.Allocate(size, alignment);
+	while (offset == RING_ALLOCATOR::INVALID_OFFSET)
+	{
+		// Everything in use belongs to the frame being recorded, waiting would never end.
+		if (_ring.HasPendingFrames() == false)
+		{
+			ThrowIfFailed(E_OUTOFMEMORY);
+		}
+
+		_commandQueue->WaitForFenceValue(_ring.GetOldestFenceValue());
+		_ring.Retire(_commandQueue->GetCompletedFenceValue());
+
+		offset = _ring.Allocate(size, alignment);
+	}
+
+	ALLOCATION allocation;
+	allocation.cpu = _cpuBase + offset;
+	allocation.gpu = _gpuBase + offset;
+	allocation.resource = _resource.Get();
+	allocation.offset = offset;
+	allocation.size = size;
+
+	return allocation;
+}
+
+void UPLOAD_BUFFER::Commit(uint64_t fenceValue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_ring.FinishFrame(fenceValue);
+}
+
+void UPLOAD_BUFFER::Retire(uint64_t completedFenceValue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_ring.Retire(completedFenceValue);
+}
+
+RING_ALLOCATOR::STATISTICS UPLOAD_BUFFER::GetStatistics()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _ring.GetStatistics();
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Helpers.h"
+#include "RingAllocator.h"
+
+#include <mutex>
+
+class COMMAND_QUEUE;
+
+// Persistently mapped UPLOAD heap buffer sub-allocated as a ring.
+// Used for per-frame dynamic data (vertices, indices, constants) and as
+// staging memory for copies into DEFAULT heap resources. Space is recycled
+// once the fence value passed to Commit() completed on the owning queue.
+class UPLOAD_BUFFER
+{
+public:
+	struct ALLOCATION
+	{
+		void*						cpu = nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS	gpu = 0;
+		ID3D12Resource*				resource = nullptr;
+		uint64_t					offset = 0;
+		uint64_t					size = 0;
+	};
+
+	UPLOAD_BUFFER(ComPtr<ID3D12Device2> device, COMMAND_QUEUE* commandQueue, uint64_t size);
+	~UPLOAD_BUFFER();
+
+	// Waits on the owning queue when the ring is full.
+	ALLOCATION Allocate(uint64_t size, uint64_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	// Allocations made since the previous commit are released once 'fenceValue' completed.
+	void Commit(uint64_t fenceValue);
+	// Recycles the committed allocations whose fence value is at most 'completedFenceValue'.
+	void Retire(uint64_t completedFenceValue);
+
+	inline ComPtr<ID3D12Resource> GetResource() const { return _resource; }
+	inline uint64_t GetSize() const { return _ring.GetCapacity(); }
+	RING_ALLOCATOR::STATISTICS GetStatistics();
+
+private:
+	COMMAND_QUEUE*			_commandQueue = nullptr;
+	ComPtr<ID3D12Resource>	_resource;
+	uint8_t*				_cpuBase = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS	_gpuBase = 0;
+
+	std::mutex		_mutex;
+	RING_ALLOCATOR	_ring;
+};
\ No newline at end of file
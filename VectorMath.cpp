@@ -0,0 +1,168 @@
+#include "VectorMath.h"
+
+#if VECTOR_MATH_SSE2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define VECTOR_MATH_AVX2_TARGET
+#else
+#define VECTOR_MATH_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace VectorMath
+{
+	MATRIX MatrixInverse(const MATRIX& m)
+	{
+		FLOAT4X4 source;
+		StoreFloat4x4(&source, m);
+		const float* a = &source.m[0][0];
+
+		// Adjugate, then divided by the determinant expanded along the first row.
+		float inverse[16];
+		inverse[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+		inverse[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+		inverse[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+		inverse[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+		inverse[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+		inverse[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+		inverse[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+		inverse[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+		inverse[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+		inverse[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+		inverse[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+		inverse[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+		inverse[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+		inverse[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+		inverse[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+		inverse[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+		float determinant = a[0] * inverse[0] + a[1] * inverse[4] + a[2] * inverse[8] + a[3] * inverse[12];
+		VECTOR scale = VectorReplicate(1.0f / determinant);
+
+		return MatrixSet(VectorMultiply(VectorLoad(&inverse[0]), scale),
+			VectorMultiply(VectorLoad(&inverse[4]), scale),
+			VectorMultiply(VectorLoad(&inverse[8]), scale),
+			VectorMultiply(VectorLoad(&inverse[12]), scale));
+	}
+
+	MATH_ISA GetBestMathIsa()
+	{
+#if VECTOR_MATH_SSE2
+		static const MATH_ISA isa = []()
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			// AVX2 needs the OS to save the YMM registers.
+			int info[4];
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			bool ymmState = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+			__cpuidex(info, 7, 0);
+			bool avx2 = (info[1] & (1 << 5)) != 0;
+			return avx && ymmState && avx2 ? MATH_ISA_AVX2 : MATH_ISA_SSE2;
+#else
+			return __builtin_cpu_supports("avx2") ? MATH_ISA_AVX2 : MATH_ISA_SSE2;
+#endif
+		}();
+		return isa;
+#elif VECTOR_MATH_NEON
+		return MATH_ISA_NEON;
+#else
+		return MATH_ISA_SCALAR;
+#endif
+	}
+
+	const char* GetMathIsaName(MATH_ISA isa)
+	{
+		switch (isa)
+		{
+		case MATH_ISA_SSE2: return "SSE2";
+		case MATH_ISA_AVX2: return "AVX2";
+		case MATH_ISA_NEON: return "NEON";
+		default: return "scalar";
+		}
+	}
+
+	// Plain floats, in the order of MatrixMultiply().
+	static void MultiplyMatricesScalar(FLOAT4X4* destination, const FLOAT4X4* source, uint32_t count, const FLOAT4X4& transform)
+	{
+		for (uint32_t n = 0; n < count; ++n)
+		{
+			FLOAT4X4 result;
+			for (int i = 0; i < 4; ++i)
+			{
+				const float* row = source[n].m[i];
+				for (int j = 0; j < 4; ++j)
+				{
+					float x = row[0] * transform.m[0][j];
+					float y = row[1] * transform.m[1][j];
+					float z = row[2] * transform.m[2][j];
+					float w = row[3] * transform.m[3][j];
+					result.m[i][j] = (x + z) + (y + w);
+				}
+			}
+			destination[n] = result;
+		}
+	}
+
+#if VECTOR_MATH_SSE2 || VECTOR_MATH_NEON
+	// The compiled backend, 4 floats per operation.
+	static void MultiplyMatricesVector(FLOAT4X4* destination, const FLOAT4X4* source, uint32_t count, const MATRIX& transform)
+	{
+		for (uint32_t n = 0; n < count; ++n)
+		{
+			StoreFloat4x4(&destination[n], MatrixMultiply(LoadFloat4x4(&source[n]), transform));
+		}
+	}
+#endif
+
+#if VECTOR_MATH_SSE2
+	// Rows 0 and 1, then 2 and 3 side by side in 256 bit registers, no fused multiply-add.
+	VECTOR_MATH_AVX2_TARGET
+	static void MultiplyMatricesAvx2(FLOAT4X4* destination, const FLOAT4X4* source, uint32_t count, const MATRIX& transform)
+	{
+		const __m256 b0 = _mm256_broadcast_ps(&transform.r[0]);
+		const __m256 b1 = _mm256_broadcast_ps(&transform.r[1]);
+		const __m256 b2 = _mm256_broadcast_ps(&transform.r[2]);
+		const __m256 b3 = _mm256_broadcast_ps(&transform.r[3]);
+
+		for (uint32_t n = 0; n < count; ++n)
+		{
+			__m256 rows[2] = { _mm256_loadu_ps(source[n].m[0]), _mm256_loadu_ps(source[n].m[2]) };
+			for (int half = 0; half < 2; ++half)
+			{
+				__m256 x = _mm256_mul_ps(_mm256_permute_ps(rows[half], _MM_SHUFFLE(0, 0, 0, 0)), b0);
+				__m256 y = _mm256_mul_ps(_mm256_permute_ps(rows[half], _MM_SHUFFLE(1, 1, 1, 1)), b1);
+				__m256 z = _mm256_mul_ps(_mm256_permute_ps(rows[half], _MM_SHUFFLE(2, 2, 2, 2)), b2);
+				__m256 w = _mm256_mul_ps(_mm256_permute_ps(rows[half], _MM_SHUFFLE(3, 3, 3, 3)), b3);
+				rows[half] = _mm256_add_ps(_mm256_add_ps(x, z), _mm256_add_ps(y, w));
+			}
+			_mm256_storeu_ps(destination[n].m[0], rows[0]);
+			_mm256_storeu_ps(destination[n].m[2], rows[1]);
+		}
+	}
+#endif
+
+	void MultiplyMatrices(FLOAT4X4* destination,
+		const FLOAT4X4* source,
+		uint32_t count,
+		const MATRIX& transform,
+		MATH_ISA isa)
+	{
+		switch (isa)
+		{
+#if VECTOR_MATH_SSE2
+		case MATH_ISA_AVX2: MultiplyMatricesAvx2(destination, source, count, transform); return;
+		case MATH_ISA_SSE2: MultiplyMatricesVector(destination, source, count, transform); return;
+#elif VECTOR_MATH_NEON
+		case MATH_ISA_NEON: MultiplyMatricesVector(destination, source, count, transform); return;
+#endif
+		default: break;
+		}
+
+		FLOAT4X4 transformElements;
+		StoreFloat4x4(&transformElements, transform);
+		MultiplyMatricesScalar(destination, source, count, transformElements);
+	}
+}
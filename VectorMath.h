@@ -0,0 +1,579 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Backend chosen at compile time: SSE2 on x86, NEON on ARM64, plain C++ elsewhere or
+// when VECTOR_MATH_NO_INTRINSICS is defined. The batched functions also dispatch to
+// AVX2 at run time.
+#if defined(VECTOR_MATH_NO_INTRINSICS)
+#define VECTOR_MATH_SCALAR 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VECTOR_MATH_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VECTOR_MATH_SSE2 1
+#include <emmintrin.h>
+#else
+#define VECTOR_MATH_SCALAR 1
+#endif
+
+// Vector, matrix, plane and quaternion math with the DirectXMath conventions: row
+// vectors transformed as p * M, matrices stored row-major, left handed cameras.
+// Every function performs the IEEE operations of the DirectXMath SSE2 path in the same
+// order, with separate multiplies and adds, so the results are bit-identical to
+// DirectXMath on x64 whichever backend is compiled. The compiler must not fuse them
+// either: -ffp-contract=off with GCC and Clang, no /fp:contract with MSVC.
+namespace VectorMath
+{
+	const float PI = 3.141592654f;
+	const float TWO_PI = 6.283185307f;
+	const float ONE_DIV_TWO_PI = 0.159154943f;
+	const float HALF_PI = 1.570796327f;
+
+#if VECTOR_MATH_SSE2
+	typedef __m128 VECTOR;
+#elif VECTOR_MATH_NEON
+	typedef float32x4_t VECTOR;
+#else
+	struct alignas(16) VECTOR
+	{
+		float	v[4];
+	};
+#endif
+
+	struct alignas(16) MATRIX
+	{
+		VECTOR	r[4];
+	};
+
+	// Storage types, the matrices have the layout shaders read.
+	struct FLOAT3
+	{
+		float	x, y, z;
+	};
+
+	struct alignas(16) FLOAT4
+	{
+		float	x, y, z, w;
+	};
+
+	struct alignas(16) FLOAT4X4
+	{
+		float	m[4][4];
+	};
+
+	//
+	// Backend primitives, one IEEE operation per lane
+	//
+
+#if VECTOR_MATH_SSE2
+
+	inline VECTOR VectorSet(float x, float y, float z, float w) { return _mm_set_ps(w, z, y, x); }
+	inline VECTOR VectorReplicate(float value) { return _mm_set_ps1(value); }
+	inline VECTOR VectorZero() { return _mm_setzero_ps(); }
+
+	inline VECTOR VectorLoad(const float* source) { return _mm_loadu_ps(source); }
+	inline void VectorStore(float* destination, VECTOR v) { _mm_storeu_ps(destination, v); }
+
+	inline VECTOR VectorSplatX(VECTOR v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)); }
+	inline VECTOR VectorSplatY(VECTOR v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)); }
+	inline VECTOR VectorSplatZ(VECTOR v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)); }
+	inline VECTOR VectorSplatW(VECTOR v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+
+	inline float VectorGetX(VECTOR v) { return _mm_cvtss_f32(v); }
+	inline float VectorGetY(VECTOR v) { return _mm_cvtss_f32(VectorSplatY(v)); }
+	inline float VectorGetZ(VECTOR v) { return _mm_cvtss_f32(VectorSplatZ(v)); }
+	inline float VectorGetW(VECTOR v) { return _mm_cvtss_f32(VectorSplatW(v)); }
+
+	inline VECTOR VectorSetW(VECTOR v, float w)
+	{
+		VECTOR result = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 2, 1, 3));
+		result = _mm_move_ss(result, _mm_set_ss(w));
+		return _mm_shuffle_ps(result, result, _MM_SHUFFLE(0, 2, 1, 3));
+	}
+
+	inline VECTOR VectorAdd(VECTOR a, VECTOR b) { return _mm_add_ps(a, b); }
+	inline VECTOR VectorSubtract(VECTOR a, VECTOR b) { return _mm_sub_ps(a, b); }
+	inline VECTOR VectorMultiply(VECTOR a, VECTOR b) { return _mm_mul_ps(a, b); }
+	inline VECTOR VectorDivide(VECTOR a, VECTOR b) { return _mm_div_ps(a, b); }
+	inline VECTOR VectorSqrt(VECTOR v) { return _mm_sqrt_ps(v); }
+	inline VECTOR VectorAbs(VECTOR v) { return _mm_andnot_ps(_mm_set_ps1(-0.0f), v); }
+
+	// Comparisons return all bits set in the lanes where they hold.
+	inline VECTOR VectorEqual(VECTOR a, VECTOR b) { return _mm_cmpeq_ps(a, b); }
+	inline VECTOR VectorLess(VECTOR a, VECTOR b) { return _mm_cmplt_ps(a, b); }
+	inline VECTOR VectorLessOrEqual(VECTOR a, VECTOR b) { return _mm_cmple_ps(a, b); }
+	// Lanes of 'b' where 'control' is set, of 'a' elsewhere.
+	inline VECTOR VectorSelect(VECTOR a, VECTOR b, VECTOR control) { return _mm_or_ps(_mm_andnot_ps(control, a), _mm_and_ps(b, control)); }
+
+	inline void MatrixTransposeRows(VECTOR& r0, VECTOR& r1, VECTOR& r2, VECTOR& r3)
+	{
+		VECTOR t0 = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(1, 0, 1, 0));
+		VECTOR t1 = _mm_shuffle_ps(r2, r3, _MM_SHUFFLE(1, 0, 1, 0));
+		VECTOR t2 = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(3, 2, 3, 2));
+		VECTOR t3 = _mm_shuffle_ps(r2, r3, _MM_SHUFFLE(3, 2, 3, 2));
+		r0 = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+		r1 = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 1, 3, 1));
+		r2 = _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(2, 0, 2, 0));
+		r3 = _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 1, 3, 1));
+	}
+
+#elif VECTOR_MATH_NEON
+
+	inline VECTOR VectorSet(float x, float y, float z, float w)
+	{
+		const float values[4] = { x, y, z, w };
+		return vld1q_f32(values);
+	}
+	inline VECTOR VectorReplicate(float value) { return vdupq_n_f32(value); }
+	inline VECTOR VectorZero() { return vdupq_n_f32(0.0f); }
+
+	inline VECTOR VectorLoad(const float* source) { return vld1q_f32(source); }
+	inline void VectorStore(float* destination, VECTOR v) { vst1q_f32(destination, v); }
+
+	inline VECTOR VectorSplatX(VECTOR v) { return vdupq_laneq_f32(v, 0); }
+	inline VECTOR VectorSplatY(VECTOR v) { return vdupq_laneq_f32(v, 1); }
+	inline VECTOR VectorSplatZ(VECTOR v) { return vdupq_laneq_f32(v, 2); }
+	inline VECTOR VectorSplatW(VECTOR v) { return vdupq_laneq_f32(v, 3); }
+
+	inline float VectorGetX(VECTOR v) { return vgetq_lane_f32(v, 0); }
+	inline float VectorGetY(VECTOR v) { return vgetq_lane_f32(v, 1); }
+	inline float VectorGetZ(VECTOR v) { return vgetq_lane_f32(v, 2); }
+	inline float VectorGetW(VECTOR v) { return vgetq_lane_f32(v, 3); }
+
+	inline VECTOR VectorSetW(VECTOR v, float w) { return vsetq_lane_f32(w, v, 3); }
+
+	inline VECTOR VectorAdd(VECTOR a, VECTOR b) { return vaddq_f32(a, b); }
+	inline VECTOR VectorSubtract(VECTOR a, VECTOR b) { return vsubq_f32(a, b); }
+	inline VECTOR VectorMultiply(VECTOR a, VECTOR b) { return vmulq_f32(a, b); }
+	inline VECTOR VectorDivide(VECTOR a, VECTOR b) { return vdivq_f32(a, b); }
+	inline VECTOR VectorSqrt(VECTOR v) { return vsqrtq_f32(v); }
+	inline VECTOR VectorAbs(VECTOR v) { return vabsq_f32(v); }
+
+	inline VECTOR VectorEqual(VECTOR a, VECTOR b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+	inline VECTOR VectorLess(VECTOR a, VECTOR b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+	inline VECTOR VectorLessOrEqual(VECTOR a, VECTOR b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+	inline VECTOR VectorSelect(VECTOR a, VECTOR b, VECTOR control) { return vbslq_f32(vreinterpretq_u32_f32(control), b, a); }
+
+	inline void MatrixTransposeRows(VECTOR& r0, VECTOR& r1, VECTOR& r2, VECTOR& r3)
+	{
+		VECTOR t0 = vzip1q_f32(r0, r2);
+		VECTOR t1 = vzip1q_f32(r1, r3);
+		VECTOR t2 = vzip2q_f32(r0, r2);
+		VECTOR t3 = vzip2q_f32(r1, r3);
+		r0 = vzip1q_f32(t0, t1);
+		r1 = vzip2q_f32(t0, t1);
+		r2 = vzip1q_f32(t2, t3);
+		r3 = vzip2q_f32(t2, t3);
+	}
+
+#else
+
+	inline VECTOR VectorSet(float x, float y, float z, float w) { return VECTOR{ { x, y, z, w } }; }
+	inline VECTOR VectorReplicate(float value) { return VECTOR{ { value, value, value, value } }; }
+	inline VECTOR VectorZero() { return VectorReplicate(0.0f); }
+
+	inline VECTOR VectorLoad(const float* source) { return VECTOR{ { source[0], source[1], source[2], source[3] } }; }
+	inline void VectorStore(float* destination, VECTOR v) { std::memcpy(destination, v.v, sizeof(v.v)); }
+
+	inline VECTOR VectorSplatX(VECTOR v) { return VectorReplicate(v.v[0]); }
+	inline VECTOR VectorSplatY(VECTOR v) { return VectorReplicate(v.v[1]); }
+	inline VECTOR VectorSplatZ(VECTOR v) { return VectorReplicate(v.v[2]); }
+	inline VECTOR VectorSplatW(VECTOR v) { return VectorReplicate(v.v[3]); }
+
+	inline float VectorGetX(VECTOR v) { return v.v[0]; }
+	inline float VectorGetY(VECTOR v) { return v.v[1]; }
+	inline float VectorGetZ(VECTOR v) { return v.v[2]; }
+	inline float VectorGetW(VECTOR v) { return v.v[3]; }
+
+	inline VECTOR VectorSetW(VECTOR v, float w) { v.v[3] = w; return v; }
+
+	inline VECTOR VectorAdd(VECTOR a, VECTOR b) { return VECTOR{ { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+	inline VECTOR VectorSubtract(VECTOR a, VECTOR b) { return VECTOR{ { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+	inline VECTOR VectorMultiply(VECTOR a, VECTOR b) { return VECTOR{ { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+	inline VECTOR VectorDivide(VECTOR a, VECTOR b) { return VECTOR{ { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } }; }
+	inline VECTOR VectorSqrt(VECTOR v) { return VECTOR{ { std::sqrt(v.v[0]), std::sqrt(v.v[1]), std::sqrt(v.v[2]), std::sqrt(v.v[3]) } }; }
+	inline VECTOR VectorAbs(VECTOR v) { return VECTOR{ { std::fabs(v.v[0]), std::fabs(v.v[1]), std::fabs(v.v[2]), std::fabs(v.v[3]) } }; }
+
+	// The masks are float lanes holding the bits of an integer, only moved with memcpy.
+	inline VECTOR VectorMask(bool x, bool y, bool z, bool w)
+	{
+		const uint32_t bits[4] = { x ? UINT32_MAX : 0u, y ? UINT32_MAX : 0u, z ? UINT32_MAX : 0u, w ? UINT32_MAX : 0u };
+		VECTOR mask;
+		std::memcpy(mask.v, bits, sizeof(bits));
+		return mask;
+	}
+	inline VECTOR VectorEqual(VECTOR a, VECTOR b) { return VectorMask(a.v[0] == b.v[0], a.v[1] == b.v[1], a.v[2] == b.v[2], a.v[3] == b.v[3]); }
+	inline VECTOR VectorLess(VECTOR a, VECTOR b) { return VectorMask(a.v[0] < b.v[0], a.v[1] < b.v[1], a.v[2] < b.v[2], a.v[3] < b.v[3]); }
+	inline VECTOR VectorLessOrEqual(VECTOR a, VECTOR b) { return VectorMask(a.v[0] <= b.v[0], a.v[1] <= b.v[1], a.v[2] <= b.v[2], a.v[3] <= b.v[3]); }
+	inline VECTOR VectorSelect(VECTOR a, VECTOR b, VECTOR control)
+	{
+		uint32_t bitsA[4], bitsB[4], bitsControl[4];
+		std::memcpy(bitsA, a.v, sizeof(bitsA));
+		std::memcpy(bitsB, b.v, sizeof(bitsB));
+		std::memcpy(bitsControl, control.v, sizeof(bitsControl));
+		for (int i = 0; i < 4; ++i)
+		{
+			bitsA[i] = (bitsA[i] & ~bitsControl[i]) | (bitsB[i] & bitsControl[i]);
+		}
+		VECTOR result;
+		std::memcpy(result.v, bitsA, sizeof(bitsA));
+		return result;
+	}
+
+	inline void MatrixTransposeRows(VECTOR& r0, VECTOR& r1, VECTOR& r2, VECTOR& r3)
+	{
+		VECTOR t0 = VectorSet(r0.v[0], r1.v[0], r2.v[0], r3.v[0]);
+		VECTOR t1 = VectorSet(r0.v[1], r1.v[1], r2.v[1], r3.v[1]);
+		VECTOR t2 = VectorSet(r0.v[2], r1.v[2], r2.v[2], r3.v[2]);
+		VECTOR t3 = VectorSet(r0.v[3], r1.v[3], r2.v[3], r3.v[3]);
+		r0 = t0;
+		r1 = t1;
+		r2 = t2;
+		r3 = t3;
+	}
+
+#endif
+
+	//
+	// Vectors, written once over the primitives
+	//
+
+	inline VECTOR VectorSplatOne() { return VectorReplicate(1.0f); }
+	inline VECTOR VectorNegate(VECTOR v) { return VectorSubtract(VectorZero(), v); }
+	inline VECTOR VectorScale(VECTOR v, float scale) { return VectorMultiply(VectorReplicate(scale), v); }
+	// a * b + c, rounded after the multiply.
+	inline VECTOR VectorMultiplyAdd(VECTOR a, VECTOR b, VECTOR c) { return VectorAdd(VectorMultiply(a, b), c); }
+
+	inline VECTOR LoadFloat3(const FLOAT3* source) { return VectorSet(source->x, source->y, source->z, 0.0f); }
+	inline VECTOR LoadFloat4(const FLOAT4* source) { return VectorLoad(&source->x); }
+	inline void StoreFloat3(FLOAT3* destination, VECTOR v)
+	{
+		alignas(16) float values[4];
+		VectorStore(values, v);
+		destination->x = values[0];
+		destination->y = values[1];
+		destination->z = values[2];
+	}
+	inline void StoreFloat4(FLOAT4* destination, VECTOR v) { VectorStore(&destination->x, v); }
+
+	// Rounds half to even, like the SSE2 conversion.
+	inline VECTOR VectorRound(VECTOR v)
+	{
+		const VECTOR noFraction = VectorReplicate(8388608.0f);
+		VECTOR magic = VectorSelect(noFraction, VectorNegate(noFraction), VectorLess(v, VectorZero()));
+		VECTOR rounded = VectorSubtract(VectorAdd(v, magic), magic);
+		return VectorSelect(v, rounded, VectorLessOrEqual(VectorAbs(v), noFraction));
+	}
+
+	// Angles brought in [-pi, pi].
+	inline VECTOR VectorModAngles(VECTOR angles)
+	{
+		VECTOR turns = VectorRound(VectorMultiply(angles, VectorReplicate(ONE_DIV_TWO_PI)));
+		return VectorSubtract(angles, VectorMultiply(turns, VectorReplicate(TWO_PI)));
+	}
+
+	// 11 and 10 degree minimax polynomials.
+	inline void VectorSinCos(VECTOR* sine, VECTOR* cosine, VECTOR angles)
+	{
+		// Reflected in [-pi/2, pi/2] with sin(x) unchanged and the sign of cos(x) kept apart.
+		VECTOR x = VectorModAngles(angles);
+		VECTOR reflectionCenter = VectorSelect(VectorReplicate(PI), VectorReplicate(-PI), VectorLess(x, VectorZero()));
+		VECTOR inRange = VectorLessOrEqual(VectorAbs(x), VectorReplicate(HALF_PI));
+		x = VectorSelect(VectorSubtract(reflectionCenter, x), x, inRange);
+		VECTOR sign = VectorSelect(VectorReplicate(-1.0f), VectorSplatOne(), inRange);
+		VECTOR x2 = VectorMultiply(x, x);
+
+		VECTOR result = VectorMultiplyAdd(VectorReplicate(-2.3889859e-08f), x2, VectorReplicate(2.7525562e-06f));
+		result = VectorMultiplyAdd(result, x2, VectorReplicate(-0.00019840874f));
+		result = VectorMultiplyAdd(result, x2, VectorReplicate(0.0083333310f));
+		result = VectorMultiplyAdd(result, x2, VectorReplicate(-0.16666667f));
+		result = VectorMultiplyAdd(result, x2, VectorSplatOne());
+		*sine = VectorMultiply(result, x);
+
+		result = VectorMultiplyAdd(VectorReplicate(-2.6051615e-07f), x2, VectorReplicate(2.4760495e-05f));
+		result = VectorMultiplyAdd(result, x2, VectorReplicate(-0.0013888378f));
+		result = VectorMultiplyAdd(result, x2, VectorReplicate(0.041666638f));
+		result = VectorMultiplyAdd(result, x2, VectorReplicate(-0.5f));
+		result = VectorMultiplyAdd(result, x2, VectorSplatOne());
+		*cosine = VectorMultiply(result, sign);
+	}
+
+	// Same polynomials, the angle is wrapped by truncation rather than rounding.
+	inline void ScalarSinCos(float* sine, float* cosine, float angle)
+	{
+		float quotient = ONE_DIV_TWO_PI * angle;
+		quotient = static_cast<float>(static_cast<int>(angle >= 0.0f ? quotient + 0.5f : quotient - 0.5f));
+		float y = angle - TWO_PI * quotient;
+
+		float sign = 1.0f;
+		if (y > HALF_PI)
+		{
+			y = PI - y;
+			sign = -1.0f;
+		}
+		else if (y < -HALF_PI)
+		{
+			y = -PI - y;
+			sign = -1.0f;
+		}
+
+		float y2 = y * y;
+		*sine = (((((-2.3889859e-08f * y2 + 2.7525562e-06f) * y2 - 0.00019840874f) * y2 + 0.0083333310f) * y2 - 0.16666667f) * y2 + 1.0f) * y;
+		float p = ((((-2.6051615e-07f * y2 + 2.4760495e-05f) * y2 - 0.0013888378f) * y2 + 0.041666638f) * y2 - 0.5f) * y2 + 1.0f;
+		*cosine = sign * p;
+	}
+
+	inline float ConvertToRadians(float degrees) { return degrees * (PI / 180.0f); }
+
+	// (x * x + y * y) + z * z, replicated.
+	inline VECTOR Vector3Dot(VECTOR a, VECTOR b)
+	{
+		VECTOR products = VectorMultiply(a, b);
+		return VectorAdd(VectorAdd(VectorSplatX(products), VectorSplatY(products)), VectorSplatZ(products));
+	}
+
+	inline VECTOR Vector3Length(VECTOR v) { return VectorSqrt(Vector3Dot(v, v)); }
+
+	// w is 0.
+	inline VECTOR Vector3Cross(VECTOR a, VECTOR b)
+	{
+		alignas(16) float u[4];
+		alignas(16) float v[4];
+		VectorStore(u, a);
+		VectorStore(v, b);
+		VECTOR result = VectorMultiply(VectorSet(u[1], u[2], u[0], 0.0f), VectorSet(v[2], v[0], v[1], 0.0f));
+		return VectorSubtract(result, VectorMultiply(VectorSet(u[2], u[0], u[1], 0.0f), VectorSet(v[1], v[2], v[0], 0.0f)));
+	}
+
+	// All four lanes are divided by the length of xyz. A zero vector stays zero, an infinite one becomes NaN.
+	inline VECTOR Vector3Normalize(VECTOR v)
+	{
+		VECTOR lengthSquared = Vector3Dot(v, v);
+		VECTOR length = VectorSqrt(lengthSquared);
+		VECTOR result = VectorDivide(v, length);
+		result = VectorSelect(result, VectorZero(), VectorEqual(length, VectorZero()));
+		return VectorSelect(result, VectorReplicate(NAN), VectorEqual(lengthSquared, VectorReplicate(INFINITY)));
+	}
+
+	// Divided by the length of its normal, planes of infinite normal become zero.
+	inline VECTOR PlaneNormalize(VECTOR plane)
+	{
+		VECTOR lengthSquared = Vector3Dot(plane, plane);
+		VECTOR result = VectorDivide(plane, VectorSqrt(lengthSquared));
+		return VectorSelect(result, VectorZero(), VectorEqual(lengthSquared, VectorReplicate(INFINITY)));
+	}
+
+	// Point transform with w = 1, divided by the resulting w.
+	inline VECTOR Vector3TransformCoord(VECTOR v, const MATRIX& m)
+	{
+		VECTOR result = VectorMultiplyAdd(VectorSplatZ(v), m.r[2], m.r[3]);
+		result = VectorMultiplyAdd(VectorSplatY(v), m.r[1], result);
+		result = VectorMultiplyAdd(VectorSplatX(v), m.r[0], result);
+		return VectorDivide(result, VectorSplatW(result));
+	}
+
+	//
+	// Matrices
+	//
+
+	inline MATRIX MatrixSet(VECTOR r0, VECTOR r1, VECTOR r2, VECTOR r3)
+	{
+		MATRIX m;
+		m.r[0] = r0;
+		m.r[1] = r1;
+		m.r[2] = r2;
+		m.r[3] = r3;
+		return m;
+	}
+
+	inline MATRIX LoadFloat4x4(const FLOAT4X4* source)
+	{
+		return MatrixSet(VectorLoad(source->m[0]), VectorLoad(source->m[1]), VectorLoad(source->m[2]), VectorLoad(source->m[3]));
+	}
+
+	inline void StoreFloat4x4(FLOAT4X4* destination, const MATRIX& m)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			VectorStore(destination->m[i], m.r[i]);
+		}
+	}
+
+	inline MATRIX MatrixIdentity()
+	{
+		return MatrixSet(VectorSet(1.0f, 0.0f, 0.0f, 0.0f), VectorSet(0.0f, 1.0f, 0.0f, 0.0f), VectorSet(0.0f, 0.0f, 1.0f, 0.0f), VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	inline MATRIX MatrixScaling(float x, float y, float z)
+	{
+		return MatrixSet(VectorSet(x, 0.0f, 0.0f, 0.0f), VectorSet(0.0f, y, 0.0f, 0.0f), VectorSet(0.0f, 0.0f, z, 0.0f), VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	inline MATRIX MatrixTranslation(float x, float y, float z)
+	{
+		return MatrixSet(VectorSet(1.0f, 0.0f, 0.0f, 0.0f), VectorSet(0.0f, 1.0f, 0.0f, 0.0f), VectorSet(0.0f, 0.0f, 1.0f, 0.0f), VectorSet(x, y, z, 1.0f));
+	}
+
+	inline MATRIX MatrixTranspose(const MATRIX& m)
+	{
+		MATRIX result = m;
+		MatrixTransposeRows(result.r[0], result.r[1], result.r[2], result.r[3]);
+		return result;
+	}
+
+	// a * b: rows of 'a' transformed by 'b', summed as (x + z) + (y + w).
+	inline MATRIX MatrixMultiply(const MATRIX& a, const MATRIX& b)
+	{
+		MATRIX result;
+		for (int i = 0; i < 4; ++i)
+		{
+			VECTOR row = a.r[i];
+			VECTOR x = VectorMultiply(VectorSplatX(row), b.r[0]);
+			VECTOR y = VectorMultiply(VectorSplatY(row), b.r[1]);
+			VECTOR z = VectorMultiply(VectorSplatZ(row), b.r[2]);
+			VECTOR w = VectorMultiply(VectorSplatW(row), b.r[3]);
+			result.r[i] = VectorAdd(VectorAdd(x, z), VectorAdd(y, w));
+		}
+		return result;
+	}
+
+	// Rotation of a normalized quaternion.
+	inline MATRIX MatrixRotationQuaternion(VECTOR quaternion)
+	{
+#if VECTOR_MATH_SSE2
+		// Same lanes as below, kept in registers.
+		const VECTOR mask3 = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		VECTOR doubled = _mm_add_ps(quaternion, quaternion);
+		VECTOR squares = _mm_mul_ps(quaternion, doubled);
+		VECTOR v0 = _mm_and_ps(_mm_shuffle_ps(squares, squares, _MM_SHUFFLE(3, 0, 0, 1)), mask3);
+		VECTOR v1 = _mm_and_ps(_mm_shuffle_ps(squares, squares, _MM_SHUFFLE(3, 1, 2, 2)), mask3);
+		VECTOR diagonal = _mm_sub_ps(_mm_sub_ps(VectorSet(1.0f, 1.0f, 1.0f, 0.0f), v0), v1);
+
+		v0 = _mm_mul_ps(_mm_shuffle_ps(quaternion, quaternion, _MM_SHUFFLE(3, 1, 0, 0)), _mm_shuffle_ps(doubled, doubled, _MM_SHUFFLE(3, 2, 1, 2)));
+		v1 = _mm_mul_ps(VectorSplatW(quaternion), _mm_shuffle_ps(doubled, doubled, _MM_SHUFFLE(3, 0, 2, 1)));
+		VECTOR sum = _mm_add_ps(v0, v1);
+		VECTOR difference = _mm_sub_ps(v0, v1);
+
+		v0 = _mm_shuffle_ps(sum, difference, _MM_SHUFFLE(1, 0, 2, 1));
+		v0 = _mm_shuffle_ps(v0, v0, _MM_SHUFFLE(1, 3, 2, 0));
+		v1 = _mm_shuffle_ps(sum, difference, _MM_SHUFFLE(2, 2, 0, 0));
+		v1 = _mm_shuffle_ps(v1, v1, _MM_SHUFFLE(2, 0, 2, 0));
+
+		MATRIX m;
+		m.r[0] = _mm_shuffle_ps(diagonal, v0, _MM_SHUFFLE(1, 0, 3, 0));
+		m.r[0] = _mm_shuffle_ps(m.r[0], m.r[0], _MM_SHUFFLE(1, 3, 2, 0));
+		m.r[1] = _mm_shuffle_ps(diagonal, v0, _MM_SHUFFLE(3, 2, 3, 1));
+		m.r[1] = _mm_shuffle_ps(m.r[1], m.r[1], _MM_SHUFFLE(1, 3, 0, 2));
+		m.r[2] = _mm_shuffle_ps(v1, diagonal, _MM_SHUFFLE(3, 2, 1, 0));
+		m.r[3] = VectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+		return m;
+#else
+		alignas(16) float q[4];
+		alignas(16) float q2[4];
+		VectorStore(q, quaternion);
+		VECTOR doubled = VectorAdd(quaternion, quaternion);
+		VectorStore(q2, doubled);
+
+		alignas(16) float squares[4];
+		VectorStore(squares, VectorMultiply(quaternion, doubled));
+		VECTOR diagonal = VectorSubtract(VectorSubtract(VectorSet(1.0f, 1.0f, 1.0f, 0.0f), VectorSet(squares[1], squares[0], squares[0], 0.0f)), VectorSet(squares[2], squares[2], squares[1], 0.0f));
+
+		VECTOR products = VectorMultiply(VectorSet(q[0], q[0], q[1], q[3]), VectorSet(q2[2], q2[1], q2[2], q2[3]));
+		VECTOR wProducts = VectorMultiply(VectorSplatW(quaternion), VectorSet(q2[1], q2[2], q2[0], q2[3]));
+
+		alignas(16) float d[4];
+		alignas(16) float sum[4];
+		alignas(16) float difference[4];
+		VectorStore(d, diagonal);
+		VectorStore(sum, VectorAdd(products, wProducts));
+		VectorStore(difference, VectorSubtract(products, wProducts));
+
+		return MatrixSet(VectorSet(d[0], sum[1], difference[0], 0.0f),
+			VectorSet(difference[1], d[1], sum[2], 0.0f),
+			VectorSet(sum[0], difference[2], d[2], 0.0f),
+			VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+#endif
+	}
+
+	// 'eyeDirection' and 'upDirection' need not be normalized.
+	inline MATRIX MatrixLookToLH(VECTOR eyePosition, VECTOR eyeDirection, VECTOR upDirection)
+	{
+		VECTOR r2 = Vector3Normalize(eyeDirection);
+		VECTOR r0 = Vector3Normalize(Vector3Cross(upDirection, r2));
+		VECTOR r1 = Vector3Cross(r2, r0);
+
+		VECTOR negativeEyePosition = VectorNegate(eyePosition);
+		MATRIX m = MatrixSet(VectorSetW(r0, VectorGetX(Vector3Dot(r0, negativeEyePosition))),
+			VectorSetW(r1, VectorGetX(Vector3Dot(r1, negativeEyePosition))),
+			VectorSetW(r2, VectorGetX(Vector3Dot(r2, negativeEyePosition))),
+			VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+		return MatrixTranspose(m);
+	}
+
+	inline MATRIX MatrixLookAtLH(VECTOR eyePosition, VECTOR focusPosition, VECTOR upDirection)
+	{
+		return MatrixLookToLH(eyePosition, VectorSubtract(focusPosition, eyePosition), upDirection);
+	}
+
+	// Depth in [0, 1] from 'nearZ' to 'farZ'.
+	inline MATRIX MatrixPerspectiveFovLH(float fovAngleY, float aspectRatio, float nearZ, float farZ)
+	{
+		float sinFov, cosFov;
+		ScalarSinCos(&sinFov, &cosFov, 0.5f * fovAngleY);
+
+		float range = farZ / (farZ - nearZ);
+		float height = cosFov / sinFov;
+		return MatrixSet(VectorSet(height / aspectRatio, 0.0f, 0.0f, 0.0f),
+			VectorSet(0.0f, height, 0.0f, 0.0f),
+			VectorSet(0.0f, 0.0f, range, 1.0f),
+			VectorSet(0.0f, 0.0f, -range * nearZ, 0.0f));
+	}
+
+	// General inverse by cofactors, not bit-compatible with XMMatrixInverse: keep it
+	// away from anything that must match the GPU, picking only.
+	MATRIX MatrixInverse(const MATRIX& m);
+
+	//
+	// Quaternions
+	//
+
+	// 'normalAxis' is normalized.
+	inline VECTOR QuaternionRotationNormal(VECTOR normalAxis, float angle)
+	{
+		float sine, cosine;
+		ScalarSinCos(&sine, &cosine, 0.5f * angle);
+		return VectorMultiply(VectorSetW(normalAxis, 1.0f), VectorSet(sine, sine, sine, cosine));
+	}
+
+	inline VECTOR QuaternionRotationAxis(VECTOR axis, float angle)
+	{
+		return QuaternionRotationNormal(Vector3Normalize(axis), angle);
+	}
+
+	//
+	// Batches
+	//
+
+	enum MATH_ISA
+	{
+		MATH_ISA_SCALAR,
+		MATH_ISA_SSE2,
+		MATH_ISA_AVX2,		// Two rows per operation
+		MATH_ISA_NEON
+	};
+
+	// Best instruction set supported by the CPU, AVX2 is detected at run time.
+	MATH_ISA GetBestMathIsa();
+	const char* GetMathIsaName(MATH_ISA isa);
+
+	// destination[i] = source[i] * transform, the arrays may be the same. Bit-identical
+	// to MatrixMultiply() with every instruction set.
+	void MultiplyMatrices(FLOAT4X4* destination,
+		const FLOAT4X4* source,
+		uint32_t count,
+		const MATRIX& transform,
+		MATH_ISA isa = GetBestMathIsa());
+}
@@ -0,0 +1,311 @@
+#include "VertexQuantization.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(VERTEX_QUANTIZATION_NO_INTRINSICS)
+#define VERTEX_QUANTIZATION_SSE2 0
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VERTEX_QUANTIZATION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static const float g_snorm16Scale = 32767.0f;
+static const float g_unorm8Scale = 255.0f;
+
+// Both SIMD and scalar paths convert with the default round to nearest even.
+static inline int RoundToInt(float value)
+{
+	return static_cast<int>(std::nearbyint(value));
+}
+
+static void GetPositionEncoding(const MESH_BOUNDS& bounds, float center[3], float inverseHalfExtent[3])
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float halfExtent = (bounds.max[axis] - bounds.min[axis]) * 0.5f;
+		center[axis] = (bounds.min[axis] + bounds.max[axis]) * 0.5f;
+		inverseHalfExtent[axis] = halfExtent > 0.0f ? 1.0f / halfExtent : 0.0f;
+	}
+}
+
+void GetPositionDequantization(const MESH_BOUNDS& bounds, float scale[3], float offset[3])
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		scale[axis] = (bounds.max[axis] - bounds.min[axis]) * 0.5f;
+		offset[axis] = (bounds.min[axis] + bounds.max[axis]) * 0.5f;
+	}
+}
+
+void EncodePositionsSnorm16(int16_t* destination, const float* positions, uint32_t components, size_t vertexCount, const MESH_BOUNDS& bounds)
+{
+	float center[3];
+	float inverseHalfExtent[3];
+	GetPositionEncoding(bounds, center, inverseHalfExtent);
+
+	size_t vertex = 0;
+
+#if VERTEX_QUANTIZATION_SSE2
+	// Four vertices per iteration, one component per register.
+	const __m128 centerX = _mm_set1_ps(center[0]);
+	const __m128 centerY = _mm_set1_ps(center[1]);
+	const __m128 centerZ = _mm_set1_ps(center[2]);
+	const __m128 scaleX = _mm_set1_ps(inverseHalfExtent[0]);
+	const __m128 scaleY = _mm_set1_ps(inverseHalfExtent[1]);
+	const __m128 scaleZ = _mm_set1_ps(inverseHalfExtent[2]);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	const __m128 snorm = _mm_set1_ps(g_snorm16Scale);
+	const __m128i encodedW = _mm_set1_epi32(static_cast<int>(g_snorm16Scale));
+	for (; vertex + 4 <= vertexCount; vertex += 4)
+	{
+		const float* p = positions + vertex * components;
+		__m128 x = _mm_setr_ps(p[0], p[components], p[2 * components], p[3 * components]);
+		__m128 y = _mm_setr_ps(p[1], p[components + 1], p[2 * components + 1], p[3 * components + 1]);
+		__m128 z = _mm_setr_ps(p[2], p[components + 2], p[2 * components + 2], p[3 * components + 2]);
+
+		x = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(x, centerX), scaleX), one), minusOne);
+		y = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(y, centerY), scaleY), one), minusOne);
+		z = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(z, centerZ), scaleZ), one), minusOne);
+
+		// x0..x3 z0..z3 and y0..y3 w0..w3 interleaved into x y z w per vertex.
+		__m128i xz = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(x, snorm)), _mm_cvtps_epi32(_mm_mul_ps(z, snorm)));
+		__m128i yw = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(y, snorm)), encodedW);
+		__m128i xy = _mm_unpacklo_epi16(xz, yw);
+		__m128i zw = _mm_unpackhi_epi16(xz, yw);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + vertex * 4), _mm_unpacklo_epi32(xy, zw));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + vertex * 4 + 8), _mm_unpackhi_epi32(xy, zw));
+	}
+#endif
+
+	for (; vertex < vertexCount; ++vertex)
+	{
+		const float* source = positions + vertex * components;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float p = (source[axis] - center[axis]) * inverseHalfExtent[axis];
+			p = std::max(std::min(p, 1.0f), -1.0f);
+			destination[vertex * 4 + axis] = static_cast<int16_t>(RoundToInt(p * g_snorm16Scale));
+		}
+		destination[vertex * 4 + 3] = static_cast<int16_t>(g_snorm16Scale);
+	}
+}
+
+void EncodeColorsUnorm8(uint8_t* destination, const float* colors, uint32_t components, size_t vertexCount)
+{
+	size_t vertex = 0;
+
+#if VERTEX_QUANTIZATION_SSE2
+	const __m128 alpha = _mm_setr_ps(0.0f, 0.0f, 0.0f, components == 4 ? 0.0f : 1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 unorm = _mm_set1_ps(g_unorm8Scale);
+	for (; vertex < vertexCount; ++vertex)
+	{
+		const float* source = colors + vertex * components;
+		__m128 rg = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+		__m128 ba = components == 4 ?
+			_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + 2))) :
+			_mm_load_ss(source + 2);
+		__m128 c = _mm_add_ps(_mm_movelh_ps(rg, ba), alpha);
+
+		c = _mm_max_ps(_mm_min_ps(c, one), zero);
+		__m128i encoded = _mm_cvtps_epi32(_mm_mul_ps(c, unorm));
+		encoded = _mm_packs_epi32(encoded, encoded);
+		encoded = _mm_packus_epi16(encoded, encoded);
+
+		int32_t packed = _mm_cvtsi128_si32(encoded);
+		memcpy(destination + vertex * 4, &packed, sizeof(packed));
+	}
+#endif
+
+	for (; vertex < vertexCount; ++vertex)
+	{
+		const float* source = colors + vertex * components;
+		for (uint32_t channel = 0; channel < 4; ++channel)
+		{
+			float c = channel < components ? source[channel] : 1.0f;
+			c = std::max(std::min(c, 1.0f), 0.0f);
+			destination[vertex * 4 + channel] = static_cast<uint8_t>(RoundToInt(c * g_unorm8Scale));
+		}
+	}
+}
+
+void EncodeNormalsOctahedral(int16_t* destination, const float* normals, size_t vertexCount)
+{
+	size_t vertex = 0;
+
+#if VERTEX_QUANTIZATION_SSE2
+	// Four vertices per iteration, one component per register.
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 smallest = _mm_set1_ps(FLT_MIN);
+	const __m128 snorm = _mm_set1_ps(g_snorm16Scale);
+	for (; vertex + 4 <= vertexCount; vertex += 4)
+	{
+		const float* n = normals + vertex * 3;
+		__m128 x = _mm_setr_ps(n[0], n[3], n[6], n[9]);
+		__m128 y = _mm_setr_ps(n[1], n[4], n[7], n[10]);
+		__m128 z = _mm_setr_ps(n[2], n[5], n[8], n[11]);
+
+		// Projection on the octahedron |x| + |y| + |z| = 1.
+		__m128 length = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)), _mm_andnot_ps(signMask, z));
+		__m128 inverseLength = _mm_div_ps(one, _mm_max_ps(length, smallest));
+		x = _mm_mul_ps(x, inverseLength);
+		y = _mm_mul_ps(y, inverseLength);
+
+		// The lower hemisphere is folded over the diagonals.
+		__m128 foldedX = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, y)), _mm_and_ps(signMask, x));
+		__m128 foldedY = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, x)), _mm_and_ps(signMask, y));
+		__m128 lower = _mm_cmplt_ps(z, zero);
+		x = _mm_or_ps(_mm_and_ps(lower, foldedX), _mm_andnot_ps(lower, x));
+		y = _mm_or_ps(_mm_and_ps(lower, foldedY), _mm_andnot_ps(lower, y));
+
+		__m128i encodedX = _mm_cvtps_epi32(_mm_mul_ps(x, snorm));
+		__m128i encodedY = _mm_cvtps_epi32(_mm_mul_ps(y, snorm));
+		__m128i encoded = _mm_unpacklo_epi16(_mm_packs_epi32(encodedX, encodedX), _mm_packs_epi32(encodedY, encodedY));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + vertex * 2), encoded);
+	}
+#endif
+
+	for (; vertex < vertexCount; ++vertex)
+	{
+		const float* n = normals + vertex * 3;
+		float length = (std::fabs(n[0]) + std::fabs(n[1])) + std::fabs(n[2]);
+		float inverseLength = 1.0f / std::max(length, FLT_MIN);
+		float x = n[0] * inverseLength;
+		float y = n[1] * inverseLength;
+		if (n[2] < 0.0f)
+		{
+			float foldedX = std::copysign(1.0f - std::fabs(y), x);
+			float foldedY = std::copysign(1.0f - std::fabs(x), y);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		destination[vertex * 2 + 0] = static_cast<int16_t>(RoundToInt(x * g_snorm16Scale));
+		destination[vertex * 2 + 1] = static_cast<int16_t>(RoundToInt(y * g_snorm16Scale));
+	}
+}
+
+void DecodeNormalOctahedral(const int16_t encoded[2], float normal[3])
+{
+	float x = std::max(encoded[0] / g_snorm16Scale, -1.0f);
+	float y = std::max(encoded[1] / g_snorm16Scale, -1.0f);
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+	if (z < 0.0f)
+	{
+		float unfoldedX = std::copysign(1.0f - std::fabs(y), x);
+		float unfoldedY = std::copysign(1.0f - std::fabs(x), y);
+		x = unfoldedX;
+		y = unfoldedY;
+	}
+
+	float inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z);
+	normal[0] = x * inverseLength;
+	normal[1] = y * inverseLength;
+	normal[2] = z * inverseLength;
+}
+
+VERTEX_QUANTIZATION_STATISTICS QuantizeMesh(MESH_DATA& mesh, uint32_t flags)
+{
+	VERTEX_QUANTIZATION_STATISTICS statistics;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		// Half a step, plus the rounding of the float encoding and decoding.
+		float halfExtent = (mesh.bounds.max[axis] - mesh.bounds.min[axis]) * 0.5f;
+		float center = (mesh.bounds.min[axis] + mesh.bounds.max[axis]) * 0.5f;
+		float bound = halfExtent / g_snorm16Scale * 0.5f + (std::fabs(center) + halfExtent) * FLT_EPSILON * 2.0f;
+		statistics.positionErrorBound = std::max(statistics.positionErrorBound, bound);
+	}
+
+	bool positionsQuantized = false;
+	for (MESH_DATA::STREAM& stream : mesh.streams)
+	{
+		statistics.sourceBytes += stream.data.size();
+
+		const bool isFloat = stream.format == MESH_FORMAT_FLOAT3 || stream.format == MESH_FORMAT_FLOAT4;
+		const uint32_t components = GetMeshFormatSize(stream.format) / sizeof(float);
+		const size_t vertexCount = mesh.vertexCount;
+
+		std::vector<float> source;
+		if (isFloat)
+		{
+			source.resize(vertexCount * components);
+			memcpy(source.data(), stream.data.data(), source.size() * sizeof(float));
+		}
+
+		if (isFloat && stream.semantic == MESH_SEMANTIC_POSITION && (flags & QUANTIZE_POSITIONS))
+		{
+			stream.format = MESH_FORMAT_SNORM16X4;
+			stream.data.resize(vertexCount * GetMeshFormatSize(stream.format));
+			EncodePositionsSnorm16(reinterpret_cast<int16_t*>(stream.data.data()), source.data(), components, vertexCount, mesh.bounds);
+
+			for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+			{
+				float decoded[3];
+				DecodeMeshPosition(stream.format, &stream.data[vertex * 8], mesh.bounds, decoded);
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					statistics.positionError = std::max(statistics.positionError, std::fabs(decoded[axis] - source[vertex * components + axis]));
+				}
+			}
+			positionsQuantized = true;
+		}
+		else if (stream.format == MESH_FORMAT_FLOAT3 && stream.semantic == MESH_SEMANTIC_NORMAL && (flags & QUANTIZE_NORMALS))
+		{
+			stream.format = MESH_FORMAT_SNORM16X2;
+			stream.data.resize(vertexCount * GetMeshFormatSize(stream.format));
+			const int16_t* encoded = reinterpret_cast<const int16_t*>(stream.data.data());
+			EncodeNormalsOctahedral(reinterpret_cast<int16_t*>(stream.data.data()), source.data(), vertexCount);
+
+			for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+			{
+				const float* n = &source[vertex * 3];
+				if (n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f)
+				{
+					continue;
+				}
+
+				float decoded[3];
+				DecodeNormalOctahedral(encoded + vertex * 2, decoded);
+				// atan2 keeps its precision for small angles, acos does not.
+				float cross[3] = {
+					decoded[1] * n[2] - decoded[2] * n[1],
+					decoded[2] * n[0] - decoded[0] * n[2],
+					decoded[0] * n[1] - decoded[1] * n[0] };
+				float sine = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+				float cosine = decoded[0] * n[0] + decoded[1] * n[1] + decoded[2] * n[2];
+				statistics.normalError = std::max(statistics.normalError, std::atan2(sine, cosine));
+			}
+		}
+		else if (isFloat && stream.semantic == MESH_SEMANTIC_COLOR && (flags & QUANTIZE_COLORS))
+		{
+			stream.format = MESH_FORMAT_UNORM8X4;
+			stream.data.resize(vertexCount * GetMeshFormatSize(stream.format));
+			EncodeColorsUnorm8(stream.data.data(), source.data(), components, vertexCount);
+
+			for (size_t i = 0; i < source.size(); ++i)
+			{
+				float decoded = stream.data[i / components * 4 + i % components] / g_unorm8Scale;
+				float c = std::max(std::min(source[i], 1.0f), 0.0f);
+				statistics.colorError = std::max(statistics.colorError, std::fabs(decoded - c));
+			}
+		}
+
+		stream.data.shrink_to_fit();
+		statistics.quantizedBytes += stream.data.size();
+	}
+
+	if (positionsQuantized)
+	{
+		ComputeMeshBounds(mesh);
+	}
+
+	return statistics;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "MeshFile.h"
+
+#include <cstdint>
+
+// Compact vertex encodings, decoded for free by the input assembler:
+// positions as MESH_FORMAT_SNORM16X4 relative to the mesh bounds, colors as
+// MESH_FORMAT_UNORM8X4 and unit normals as MESH_FORMAT_SNORM16X2 octahedral
+// coordinates (Cigolle et al. 2014). The SSE2 encoders round like the scalar
+// ones, their output is identical. Defining VERTEX_QUANTIZATION_NO_INTRINSICS
+// builds the scalar encoders only.
+enum VERTEX_QUANTIZATION : uint32_t
+{
+	QUANTIZE_POSITIONS = 0x1,
+	QUANTIZE_NORMALS = 0x2,
+	QUANTIZE_COLORS = 0x4,
+	QUANTIZE_ALL = QUANTIZE_POSITIONS | QUANTIZE_NORMALS | QUANTIZE_COLORS
+};
+
+struct VERTEX_QUANTIZATION_STATISTICS
+{
+	uint64_t	sourceBytes = 0;			// Vertex streams before quantization
+	uint64_t	quantizedBytes = 0;
+	float		positionError = 0.0f;		// Largest distance along an axis, measured
+	float		positionErrorBound = 0.0f;	// Half a quantization step of the largest axis, plus float rounding
+	float		normalError = 0.0f;			// Largest angle in radians, measured
+	float		colorError = 0.0f;			// Largest channel difference, measured, half a step of 1 / 255
+};
+
+// Scale and offset turning the decoded [-1, 1] positions back into the bounds,
+// folded into the world matrix by the renderer.
+void GetPositionDequantization(const MESH_BOUNDS& bounds, float scale[3], float offset[3]);
+
+// 'positions' holds 'components' floats per vertex, the first 3 are encoded, w is set to 1.
+void EncodePositionsSnorm16(int16_t* destination, const float* positions, uint32_t components, size_t vertexCount, const MESH_BOUNDS& bounds);
+
+// 'colors' holds 3 or 4 floats per vertex clamped to [0, 1], alpha is 1 with 3.
+void EncodeColorsUnorm8(uint8_t* destination, const float* colors, uint32_t components, size_t vertexCount);
+
+// 'normals' holds 3 floats per vertex, they need not be normalized. Zero vectors encode as +Z.
+void EncodeNormalsOctahedral(int16_t* destination, const float* normals, size_t vertexCount);
+void DecodeNormalOctahedral(const int16_t encoded[2], float normal[3]);
+
+// Quantizes the float streams selected by 'flags' in place, against the mesh
+// bounds computed by ComputeMeshBounds(). The submesh bounds are recomputed
+// from the decoded positions so they still enclose them.
+VERTEX_QUANTIZATION_STATISTICS QuantizeMesh(MESH_DATA& mesh, uint32_t flags = QUANTIZE_ALL);
\ No newline at end of file
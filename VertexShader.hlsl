@@ -1,12 +1,28 @@
+// Quantized streams (SNORM16 positions, UNORM8 colors) are converted to float by
+// the input assembler, the position bounds are folded into modelToWorld.
 struct VERTEX_POS_COLOR
 {
     float3 position : POSITION;
     float3 color : COLOR;
 };
 
-cbuffer modelViewProjectionCB : register(b0)
+cbuffer viewProjectionCB : register(b0)
 {
-    matrix modelToProj;
+    matrix worldToProj;
+};
+
+// One world matrix per drawn instance, rewritten by the CPU every frame.
+struct INSTANCE
+{
+    matrix modelToWorld;
+};
+
+StructuredBuffer<INSTANCE> instances : register(t0);
+
+// Set by the indirect command, SV_InstanceID does not include StartInstanceLocation.
+cbuffer drawCB : register(b1)
+{
+    uint firstInstance;
 };
 
 struct VERTEX_SHADER_OUTPUT
@@ -15,11 +31,12 @@ struct VERTEX_SHADER_OUTPUT
     float4 position : SV_Position;
 };
 
-VERTEX_SHADER_OUTPUT main(VERTEX_POS_COLOR input)
+VERTEX_SHADER_OUTPUT main(VERTEX_POS_COLOR input, uint instanceId : SV_InstanceID)
 {
     VERTEX_SHADER_OUTPUT output;
     
-    output.position = mul(modelToProj, float4(input.position, 1.0f));
+    float4 worldPosition = mul(instances[firstInstance + instanceId].modelToWorld, float4(input.position, 1.0f));
+    output.position = mul(worldToProj, worldPosition);
     output.color = float4(input.color, 1.0f);
     
     return output;
@@ -3,8 +3,13 @@
 #include "CommandQueue.h"
 #include "Game.h"
 
+#include <algorithm>
 #include <unordered_map>
 
+#if PLATFORM_D3D12
+
+#include "ResourceBarriers.h"
+
 unordered_map<HWND, WINDOW*> WINDOW::gs_Windows;
 
 // Windows initiliazing function headers
@@ -13,7 +18,6 @@ bool CheckTearingSupport();
 LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
 void RegisterWindowClass(HINSTANCE hInst, const wchar_t* windowClassName);
 HWND CreateWindow(const wchar_t* windowClassName, HINSTANCE hInst, const wchar_t* windowTitle, uint32_t width, uint32_t height);
-ComPtr<ID3D12DescriptorHeap> CreateDescriptorHeap(ComPtr<ID3D12Device2> device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptors);
 MouseButtonEventArgs::MouseButton DecodeMouseButton(UINT messageID);
 
 WINDOW::WINDOW(HINSTANCE hInstance, const wstring& name, int width, int height, bool vSync):
@@ -38,6 +42,12 @@ WINDOW::WINDOW(HINSTANCE hInstance, const wstring& name, int width, int height,
     ::GetWindowRect(_hWnd, &_windowRect);
 }
 
+WINDOW::~WINDOW()
+{
+    // Render target views are read when recording, the GPU never sees them.
+    APPLICATION::Instance()->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_RTV)->Free(_rtvDescriptors);
+}
+
 void WINDOW::CreateSwapChain(ComPtr<ID3D12Device2> device, ComPtr<ID3D12CommandQueue> commandQueue)
 {
     ComPtr<IDXGISwapChain4> dxgiSwapChain4;
@@ -83,8 +93,7 @@ void WINDOW::CreateSwapChain(ComPtr<ID3D12Device2> device, ComPtr<ID3D12CommandQ
     // Get first index of back buffer
     _currentBackBufferIndex = _swapChain->GetCurrentBackBufferIndex();
 
-    _rtvDescriptorHeap = CreateDescriptorHeap(device, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, g_numFrames);
-    _rtvDescriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+    _rtvDescriptors = APPLICATION::Instance()->AllocateDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE_RTV, g_numFrames);
 }
 
 void WINDOW::SwitchFullscreen()
@@ -139,37 +148,58 @@ void WINDOW::UpdateRenderTargetViews()
 {
     auto device = APPLICATION::Instance()->GetDevice();
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(_rtvDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
-
-    auto rtvDescriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-
     for (int i = 0; i < g_numFrames; ++i)
     {
         ComPtr<ID3D12Resource> backBuffer;
         ThrowIfFailed(_swapChain->GetBuffer(i, IID_PPV_ARGS(&backBuffer)));
 
-        device->CreateRenderTargetView(backBuffer.Get(), nullptr, rtvHandle);
+        device->CreateRenderTargetView(backBuffer.Get(), nullptr, _rtvDescriptors.GetCpuHandle(i));
+        RegisterResourceState(backBuffer.Get(), D3D12_RESOURCE_STATE_PRESENT);
 
         _backBuffers[i] = backBuffer;
-
-        rtvHandle.Offset(rtvDescriptorSize);
     }
 }
 
-UINT WINDOW::Present()
+uint32_t WINDOW::Present()
 {
     UINT syncInterval = _vSync ? 1 : 0;
     UINT presentFlags = _tearingSupported && !_vSync ? DXGI_PRESENT_ALLOW_TEARING : 0;
     ThrowIfFailed(_swapChain->Present(syncInterval, presentFlags));
 
-    return _swapChain->GetCurrentBackBufferIndex();
+    _currentBackBufferIndex = _swapChain->GetCurrentBackBufferIndex();
+    return _currentBackBufferIndex;
 }
 
 D3D12_CPU_DESCRIPTOR_HANDLE WINDOW::GetCurrentRenderTargetView()
 {
-   return CD3DX12_CPU_DESCRIPTOR_HANDLE(_rtvDescriptorHeap->GetCPUDescriptorHandleForHeapStart(), _currentBackBufferIndex, _rtvDescriptorSize);
+   return _rtvDescriptors.GetCpuHandle(_currentBackBufferIndex);
+}
+
+#else
+
+vector<WINDOW*> WINDOW::gs_Windows;
+
+WINDOW::WINDOW(const wstring&, int width, int height, bool vSync):
+    _clientWidth(width),
+    _clientHeight(height),
+    _vSync(vSync)
+{
+}
+
+WINDOW::~WINDOW()
+{
 }
 
+uint32_t WINDOW::Present()
+{
+    _presentCount++;
+
+    _currentBackBufferIndex = (_currentBackBufferIndex + 1) % g_numFrames;
+    return _currentBackBufferIndex;
+}
+
+#endif
+
 void WINDOW::OnUpdate(UpdateEventArgs&)
 {
     _UpdateClock.Tick();
@@ -249,15 +279,18 @@ void WINDOW::OnMouseWheel(MouseWheelEventArgs& e)
 void WINDOW::OnResize(ResizeEventArgs& e)
 {
     // Update the client size.
-    if (_clientWidth != e.Width || _clientHeight != e.Height)
+    if (static_cast<int>(_clientWidth) != e.Width || static_cast<int>(_clientHeight) != e.Height)
     {
         _clientWidth = std::max(1, e.Width);
         _clientHeight = std::max(1, e.Height);
 
+#if PLATFORM_D3D12
+        // ResizeBuffers requires the GPU to be done with every back buffer.
         APPLICATION::Instance()->Flush();
 
         for (int i = 0; i < g_numFrames; ++i)
         {
+            UnregisterResourceState(_backBuffers[i].Get());
             _backBuffers[i].Reset();
         }
 
@@ -269,6 +302,7 @@ void WINDOW::OnResize(ResizeEventArgs& e)
         _currentBackBufferIndex = _swapChain->GetCurrentBackBufferIndex();
 
         UpdateRenderTargetViews();
+#endif
     }
 
     if (auto pGame = _pGame.lock())
@@ -277,6 +311,8 @@ void WINDOW::OnResize(ResizeEventArgs& e)
     }
 }
 
+#if PLATFORM_D3D12
+
 void EnableDebugLayer()
 {
 #if defined(_DEBUG)
@@ -314,19 +350,6 @@ bool CheckTearingSupport()
     return allowTearing == TRUE;
 }
 
-ComPtr<ID3D12DescriptorHeap> CreateDescriptorHeap(ComPtr<ID3D12Device2> device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptors)
-{
-    ComPtr<ID3D12DescriptorHeap> descriptorHeap;
-
-    D3D12_DESCRIPTOR_HEAP_DESC desc = {};
-    desc.NumDescriptors = numDescriptors;
-    desc.Type = type;
-
-    ThrowIfFailed(device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&descriptorHeap)));
-
-    return descriptorHeap;
-}
-
 //LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
 //{
 //    APPLICATION* application = APPLICATION::Instance();
@@ -666,3 +689,5 @@ MouseButtonEventArgs::MouseButton DecodeMouseButton(UINT messageID)
 
     return mouseButton;
 }
+
+#endif
@@ -1,11 +1,18 @@
 #pragma once
 
-#include "Helpers.h"
+#include "Platform.h"
 #include "Events.h"
 #include "HighResolutionClock.h"
 
-#include <string.h>
+#if PLATFORM_D3D12
+#include "Helpers.h"
+#include "DescriptorAllocator.h"
+#endif
+
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 using namespace std;
 
 class GAME;
@@ -13,15 +20,34 @@ class GAME;
 class WINDOW
 {
 public:
+#if PLATFORM_D3D12
 	WINDOW(HINSTANCE hInstance, const wstring& name, int width, int height, bool vSync);
-	~WINDOW() { ; }
+#else
+	WINDOW(const wstring& name, int width, int height, bool vSync);
+#endif
+	virtual ~WINDOW();
 
+#if PLATFORM_D3D12
 	void CreateSwapChain(ComPtr<ID3D12Device2> device, ComPtr<ID3D12CommandQueue> commandQueue);
 
 	void SwitchFullscreen();
-	UINT Present();
+#endif
+	uint32_t Present();
+#if PLATFORM_D3D12
 	void Show() { ::ShowWindow(_hWnd, SW_SHOW); }
 	void Hide() { ::ShowWindow(_hWnd, SW_HIDE); }
+#else
+	// Headless, Present() only moves to the next back buffer.
+	void Show() { ; }
+	void Hide() { ; }
+
+	// Deleted by the application at the end of the frame, like WM_DESTROY.
+	inline void Close() { _isClosed = true; }
+	inline bool IsClosed() const { return _isClosed; }
+	inline uint64_t GetPresentCount() const { return _presentCount; }
+	inline uint32_t GetClientWidth() const { return _clientWidth; }
+	inline uint32_t GetClientHeight() const { return _clientHeight; }
+#endif
 
 
 	inline void SetIsInitialized() { _isInitialized = true; }
@@ -30,16 +56,17 @@ public:
 	inline bool GetTearingSupported() const { return _tearingSupported; };
 	inline bool isInitialized() const { return _isInitialized; }
 	inline bool GetIsWarp() const { return _useWarp; }
-	inline HWND GetWindowHandle() const { return _hWnd; }
 
-	inline UINT& GetCurrentBackBufferIndex() { return _currentBackBufferIndex; }
+	inline uint32_t& GetCurrentBackBufferIndex() { return _currentBackBufferIndex; }
+#if PLATFORM_D3D12
+	inline HWND GetWindowHandle() const { return _hWnd; }
 	inline ComPtr<ID3D12Resource> GetCurrentBackBuffer() const { return _backBuffers[_currentBackBufferIndex]; }
 	inline ComPtr<IDXGISwapChain4> GetSwapChain() const { return _swapChain; }
-	inline uint64_t& GetCurrentFrameFenceValue() { return _frameFenceValues[_currentBackBufferIndex]; }
 
 	void UpdateRenderTargetViews();
 	
 	D3D12_CPU_DESCRIPTOR_HANDLE GetCurrentRenderTargetView();
+#endif
 
 	inline void RegisterCallbacks(std::shared_ptr<GAME> pGame) { _pGame = pGame; };
 
@@ -64,14 +91,20 @@ public:
 	// The window was resized.
 	virtual void OnResize(ResizeEventArgs& e);
 
+#if PLATFORM_D3D12
 	static unordered_map<HWND, WINDOW*> gs_Windows;
+#else
+	static vector<WINDOW*> gs_Windows;
+#endif
 
 
 protected:
 
+#if PLATFORM_D3D12
 	// Window handle.
 	HWND _hWnd;
 	RECT _windowRect;
+#endif
 
 	// Use WARP adapter
 	bool _useWarp = false;
@@ -85,16 +118,17 @@ protected:
 	// Set to true once the DX12 objects have been initialized.
 	bool _isInitialized = false;
 
+#if PLATFORM_D3D12
 	// DirectX12 objects
 	ComPtr<IDXGISwapChain4>	_swapChain;
-	ComPtr<ID3D12DescriptorHeap> _rtvDescriptorHeap;
+	DESCRIPTOR_ALLOCATION	_rtvDescriptors;
 	ComPtr<ID3D12Resource>	_backBuffers[g_numFrames];
+#else
+	bool		_isClosed = false;
+	uint64_t	_presentCount = 0;
+#endif
 
-	UINT					_rtvDescriptorSize = 0u;
-	UINT					_currentBackBufferIndex = 0u;
-
-	// Synchronization objects
-	uint64_t	_frameFenceValues[g_numFrames] = {};
+	uint32_t				_currentBackBufferIndex = 0u;
 
 	std::weak_ptr<GAME> _pGame;
 
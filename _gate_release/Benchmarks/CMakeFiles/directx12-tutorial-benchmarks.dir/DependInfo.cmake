@@ -0,0 +1,36 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/Benchmarks/ApplicationBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/ApplicationBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/ApplicationBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/AssetStreamerBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/AssetStreamerBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/AssetStreamerBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/BoundingVolumeHierarchyBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/BoundingVolumeHierarchyBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/BoundingVolumeHierarchyBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/CommandQueueBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/CommandQueueBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/CommandQueueBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/FenceCompletionServiceBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/FenceCompletionServiceBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/FenceCompletionServiceBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/FreeListAllocatorBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/FreeListAllocatorBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/FreeListAllocatorBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/FrustumCullingBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/FrustumCullingBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/FrustumCullingBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/IndirectDrawBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/IndirectDrawBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/IndirectDrawBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/InstanceTransformsBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/InstanceTransformsBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/InstanceTransformsBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/JobSystemBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/JobSystemBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/JobSystemBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/MeshFileBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/MeshFileBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/MeshFileBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/RenderGraphBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/RenderGraphBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/RenderGraphBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/RingAllocatorBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/RingAllocatorBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/RingAllocatorBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/TransformHierarchyBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/TransformHierarchyBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/TransformHierarchyBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/VectorMathBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/VectorMathBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/VectorMathBenchmarks.cpp.o.d"
+  "/root/repo/Benchmarks/VertexQuantizationBenchmarks.cpp" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/VertexQuantizationBenchmarks.cpp.o" "gcc" "Benchmarks/CMakeFiles/directx12-tutorial-benchmarks.dir/VertexQuantizationBenchmarks.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_release/CMakeFiles/directx12-tutorial-core.dir/DependInfo.cmake"
+  "/root/repo/_gate_release/CMakeFiles/directx12-tutorial-platform.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,41 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/ApplicationBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/ApplicationBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/AssetStreamerBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/AssetStreamerBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/BoundingVolumeHierarchyBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/BoundingVolumeHierarchyBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/CommandQueueBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/CommandQueueBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/FenceCompletionServiceBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/FenceCompletionServiceBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/FreeListAllocatorBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/FreeListAllocatorBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/FrustumCullingBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/FrustumCullingBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/IndirectDrawBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/IndirectDrawBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/InstanceTransformsBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/InstanceTransformsBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/JobSystemBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/JobSystemBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/MeshFileBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/MeshFileBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/RenderGraphBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/RenderGraphBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/RingAllocatorBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/RingAllocatorBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/TransformHierarchyBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/TransformHierarchyBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/VectorMathBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/VectorMathBenchmarks.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/VertexQuantizationBenchmarks.cpp.o"
+  "CMakeFiles/directx12-tutorial-benchmarks.dir/VertexQuantizationBenchmarks.cpp.o.d"
+  "directx12-tutorial-benchmarks"
+  "directx12-tutorial-benchmarks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/directx12-tutorial-benchmarks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,41 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/AssetStreamer.cpp" "CMakeFiles/directx12-tutorial-core.dir/AssetStreamer.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/AssetStreamer.cpp.o.d"
+  "/root/repo/BarrierTranslation.cpp" "CMakeFiles/directx12-tutorial-core.dir/BarrierTranslation.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/BarrierTranslation.cpp.o.d"
+  "/root/repo/BoundingVolumeHierarchy.cpp" "CMakeFiles/directx12-tutorial-core.dir/BoundingVolumeHierarchy.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/BoundingVolumeHierarchy.cpp.o.d"
+  "/root/repo/BuddyAllocator.cpp" "CMakeFiles/directx12-tutorial-core.dir/BuddyAllocator.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/BuddyAllocator.cpp.o.d"
+  "/root/repo/DeferredReleaseQueue.cpp" "CMakeFiles/directx12-tutorial-core.dir/DeferredReleaseQueue.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/DeferredReleaseQueue.cpp.o.d"
+  "/root/repo/FenceCompletionService.cpp" "CMakeFiles/directx12-tutorial-core.dir/FenceCompletionService.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/FenceCompletionService.cpp.o.d"
+  "/root/repo/FrameScheduler.cpp" "CMakeFiles/directx12-tutorial-core.dir/FrameScheduler.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/FrameScheduler.cpp.o.d"
+  "/root/repo/FreeListAllocator.cpp" "CMakeFiles/directx12-tutorial-core.dir/FreeListAllocator.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/FreeListAllocator.cpp.o.d"
+  "/root/repo/FrustumCulling.cpp" "CMakeFiles/directx12-tutorial-core.dir/FrustumCulling.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/FrustumCulling.cpp.o.d"
+  "/root/repo/HighResolutionClock.cpp" "CMakeFiles/directx12-tutorial-core.dir/HighResolutionClock.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/HighResolutionClock.cpp.o.d"
+  "/root/repo/InstanceTransforms.cpp" "CMakeFiles/directx12-tutorial-core.dir/InstanceTransforms.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/InstanceTransforms.cpp.o.d"
+  "/root/repo/JobSystem.cpp" "CMakeFiles/directx12-tutorial-core.dir/JobSystem.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/JobSystem.cpp.o.d"
+  "/root/repo/MappedFile.cpp" "CMakeFiles/directx12-tutorial-core.dir/MappedFile.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/MappedFile.cpp.o.d"
+  "/root/repo/MeshFile.cpp" "CMakeFiles/directx12-tutorial-core.dir/MeshFile.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/MeshFile.cpp.o.d"
+  "/root/repo/MeshOptimizer.cpp" "CMakeFiles/directx12-tutorial-core.dir/MeshOptimizer.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/MeshOptimizer.cpp.o.d"
+  "/root/repo/NullDevice.cpp" "CMakeFiles/directx12-tutorial-core.dir/NullDevice.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/NullDevice.cpp.o.d"
+  "/root/repo/QueueDependencyTracker.cpp" "CMakeFiles/directx12-tutorial-core.dir/QueueDependencyTracker.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/QueueDependencyTracker.cpp.o.d"
+  "/root/repo/RenderGraph.cpp" "CMakeFiles/directx12-tutorial-core.dir/RenderGraph.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/RenderGraph.cpp.o.d"
+  "/root/repo/ResourceStateTracker.cpp" "CMakeFiles/directx12-tutorial-core.dir/ResourceStateTracker.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/ResourceStateTracker.cpp.o.d"
+  "/root/repo/RingAllocator.cpp" "CMakeFiles/directx12-tutorial-core.dir/RingAllocator.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/RingAllocator.cpp.o.d"
+  "/root/repo/TransformHierarchy.cpp" "CMakeFiles/directx12-tutorial-core.dir/TransformHierarchy.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/TransformHierarchy.cpp.o.d"
+  "/root/repo/VectorMath.cpp" "CMakeFiles/directx12-tutorial-core.dir/VectorMath.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/VectorMath.cpp.o.d"
+  "/root/repo/VertexQuantization.cpp" "CMakeFiles/directx12-tutorial-core.dir/VertexQuantization.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-core.dir/VertexQuantization.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
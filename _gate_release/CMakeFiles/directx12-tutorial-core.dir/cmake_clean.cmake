@@ -0,0 +1,55 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/directx12-tutorial-core.dir/AssetStreamer.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/AssetStreamer.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/BarrierTranslation.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/BarrierTranslation.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/BoundingVolumeHierarchy.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/BoundingVolumeHierarchy.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/BuddyAllocator.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/BuddyAllocator.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/DeferredReleaseQueue.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/DeferredReleaseQueue.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/FenceCompletionService.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/FenceCompletionService.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/FrameScheduler.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/FrameScheduler.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/FreeListAllocator.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/FreeListAllocator.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/FrustumCulling.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/FrustumCulling.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/HighResolutionClock.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/HighResolutionClock.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/InstanceTransforms.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/InstanceTransforms.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/JobSystem.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/JobSystem.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/MappedFile.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/MappedFile.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/MeshFile.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/MeshFile.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/MeshOptimizer.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/MeshOptimizer.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/NullDevice.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/NullDevice.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/QueueDependencyTracker.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/QueueDependencyTracker.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/RenderGraph.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/RenderGraph.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/ResourceStateTracker.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/ResourceStateTracker.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/RingAllocator.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/RingAllocator.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/TransformHierarchy.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/TransformHierarchy.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/VectorMath.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/VectorMath.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-core.dir/VertexQuantization.cpp.o"
+  "CMakeFiles/directx12-tutorial-core.dir/VertexQuantization.cpp.o.d"
+  "libdirectx12-tutorial-core.a"
+  "libdirectx12-tutorial-core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/directx12-tutorial-core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/Application.cpp" "CMakeFiles/directx12-tutorial-platform.dir/Application.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-platform.dir/Application.cpp.o.d"
+  "/root/repo/CommandQueue.cpp" "CMakeFiles/directx12-tutorial-platform.dir/CommandQueue.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-platform.dir/CommandQueue.cpp.o.d"
+  "/root/repo/Game.cpp" "CMakeFiles/directx12-tutorial-platform.dir/Game.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-platform.dir/Game.cpp.o.d"
+  "/root/repo/IndirectDraw.cpp" "CMakeFiles/directx12-tutorial-platform.dir/IndirectDraw.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-platform.dir/IndirectDraw.cpp.o.d"
+  "/root/repo/Window.cpp" "CMakeFiles/directx12-tutorial-platform.dir/Window.cpp.o" "gcc" "CMakeFiles/directx12-tutorial-platform.dir/Window.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_release/CMakeFiles/directx12-tutorial-core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/directx12-tutorial-platform.dir/Application.cpp.o"
+  "CMakeFiles/directx12-tutorial-platform.dir/Application.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-platform.dir/CommandQueue.cpp.o"
+  "CMakeFiles/directx12-tutorial-platform.dir/CommandQueue.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-platform.dir/Game.cpp.o"
+  "CMakeFiles/directx12-tutorial-platform.dir/Game.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-platform.dir/IndirectDraw.cpp.o"
+  "CMakeFiles/directx12-tutorial-platform.dir/IndirectDraw.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-platform.dir/Window.cpp.o"
+  "CMakeFiles/directx12-tutorial-platform.dir/Window.cpp.o.d"
+  "libdirectx12-tutorial-platform.a"
+  "libdirectx12-tutorial-platform.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/directx12-tutorial-platform.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
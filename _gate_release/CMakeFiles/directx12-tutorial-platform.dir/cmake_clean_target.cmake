@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libdirectx12-tutorial-platform.a"
+)
@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/Tools/MeshConverter/GltfImporter.cpp" "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/GltfImporter.cpp.o" "gcc" "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/GltfImporter.cpp.o.d"
+  "/root/repo/Tools/MeshConverter/Json.cpp" "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/Json.cpp.o" "gcc" "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/Json.cpp.o.d"
+  "/root/repo/Tools/MeshConverter/MeshConverter.cpp" "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/MeshConverter.cpp.o" "gcc" "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/MeshConverter.cpp.o.d"
+  "/root/repo/Tools/MeshConverter/ObjImporter.cpp" "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/ObjImporter.cpp.o" "gcc" "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/ObjImporter.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_release/CMakeFiles/directx12-tutorial-core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/GltfImporter.cpp.o"
+  "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/GltfImporter.cpp.o.d"
+  "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/Json.cpp.o"
+  "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/Json.cpp.o.d"
+  "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/MeshConverter.cpp.o"
+  "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/MeshConverter.cpp.o.d"
+  "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/ObjImporter.cpp.o"
+  "CMakeFiles/mesh-converter.dir/Tools/MeshConverter/ObjImporter.cpp.o.d"
+  "mesh-converter"
+  "mesh-converter.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mesh-converter.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
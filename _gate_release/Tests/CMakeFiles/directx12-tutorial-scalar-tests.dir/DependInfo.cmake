@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/Tests/VectorMathTests.cpp" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/VectorMathTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/VectorMathTests.cpp.o.d"
+  "/root/repo/Tests/VertexQuantizationTests.cpp" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/VertexQuantizationTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/VertexQuantizationTests.cpp.o.d"
+  "/root/repo/MappedFile.cpp" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/__/MappedFile.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/__/MappedFile.cpp.o.d"
+  "/root/repo/MeshFile.cpp" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/__/MeshFile.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/__/MeshFile.cpp.o.d"
+  "/root/repo/VectorMath.cpp" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/__/VectorMath.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/__/VectorMath.cpp.o.d"
+  "/root/repo/VertexQuantization.cpp" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/__/VertexQuantization.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-scalar-tests.dir/__/VertexQuantization.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,21 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/VectorMathTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/VectorMathTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/VertexQuantizationTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/VertexQuantizationTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/__/MappedFile.cpp.o"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/__/MappedFile.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/__/MeshFile.cpp.o"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/__/MeshFile.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/__/VectorMath.cpp.o"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/__/VectorMath.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/__/VertexQuantization.cpp.o"
+  "CMakeFiles/directx12-tutorial-scalar-tests.dir/__/VertexQuantization.cpp.o.d"
+  "directx12-tutorial-scalar-tests"
+  "directx12-tutorial-scalar-tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/directx12-tutorial-scalar-tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
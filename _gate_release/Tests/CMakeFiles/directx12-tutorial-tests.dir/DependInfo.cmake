@@ -0,0 +1,40 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/Tests/ApplicationTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/ApplicationTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/ApplicationTests.cpp.o.d"
+  "/root/repo/Tests/BarrierTranslationTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/BarrierTranslationTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/BarrierTranslationTests.cpp.o.d"
+  "/root/repo/Tests/BoundingVolumeHierarchyTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/BoundingVolumeHierarchyTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/BoundingVolumeHierarchyTests.cpp.o.d"
+  "/root/repo/Tests/BuddyAllocatorTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/BuddyAllocatorTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/BuddyAllocatorTests.cpp.o.d"
+  "/root/repo/Tests/CommandAllocatorPoolTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/CommandAllocatorPoolTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/CommandAllocatorPoolTests.cpp.o.d"
+  "/root/repo/Tests/CommandQueueTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/CommandQueueTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/CommandQueueTests.cpp.o.d"
+  "/root/repo/Tests/FenceCompletionServiceTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/FenceCompletionServiceTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/FenceCompletionServiceTests.cpp.o.d"
+  "/root/repo/Tests/FreeListAllocatorTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/FreeListAllocatorTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/FreeListAllocatorTests.cpp.o.d"
+  "/root/repo/Tests/FrustumCullingTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/FrustumCullingTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/FrustumCullingTests.cpp.o.d"
+  "/root/repo/Tests/InstanceTransformsTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/InstanceTransformsTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/InstanceTransformsTests.cpp.o.d"
+  "/root/repo/Tests/JobSystemTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/JobSystemTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/JobSystemTests.cpp.o.d"
+  "/root/repo/Tests/MeshFileTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/MeshFileTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/MeshFileTests.cpp.o.d"
+  "/root/repo/Tests/MeshOptimizerTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/MeshOptimizerTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/MeshOptimizerTests.cpp.o.d"
+  "/root/repo/Tests/QueueDependencyTrackerTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/QueueDependencyTrackerTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/QueueDependencyTrackerTests.cpp.o.d"
+  "/root/repo/Tests/RenderGraphTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/RenderGraphTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/RenderGraphTests.cpp.o.d"
+  "/root/repo/Tests/ResourceStateTrackerTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/ResourceStateTrackerTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/ResourceStateTrackerTests.cpp.o.d"
+  "/root/repo/Tests/RingAllocatorTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/RingAllocatorTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/RingAllocatorTests.cpp.o.d"
+  "/root/repo/Tests/TransformHierarchyTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/TransformHierarchyTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/TransformHierarchyTests.cpp.o.d"
+  "/root/repo/Tests/VectorMathTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/VectorMathTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/VectorMathTests.cpp.o.d"
+  "/root/repo/Tests/VertexQuantizationTests.cpp" "Tests/CMakeFiles/directx12-tutorial-tests.dir/VertexQuantizationTests.cpp.o" "gcc" "Tests/CMakeFiles/directx12-tutorial-tests.dir/VertexQuantizationTests.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_release/CMakeFiles/directx12-tutorial-core.dir/DependInfo.cmake"
+  "/root/repo/_gate_release/CMakeFiles/directx12-tutorial-platform.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,49 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/directx12-tutorial-tests.dir/ApplicationTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/ApplicationTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/BarrierTranslationTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/BarrierTranslationTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/BoundingVolumeHierarchyTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/BoundingVolumeHierarchyTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/BuddyAllocatorTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/BuddyAllocatorTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/CommandAllocatorPoolTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/CommandAllocatorPoolTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/CommandQueueTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/CommandQueueTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/FenceCompletionServiceTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/FenceCompletionServiceTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/FreeListAllocatorTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/FreeListAllocatorTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/FrustumCullingTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/FrustumCullingTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/InstanceTransformsTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/InstanceTransformsTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/JobSystemTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/JobSystemTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/MeshFileTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/MeshFileTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/MeshOptimizerTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/MeshOptimizerTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/QueueDependencyTrackerTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/QueueDependencyTrackerTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/RenderGraphTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/RenderGraphTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/ResourceStateTrackerTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/ResourceStateTrackerTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/RingAllocatorTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/RingAllocatorTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/TransformHierarchyTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/TransformHierarchyTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/VectorMathTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/VectorMathTests.cpp.o.d"
+  "CMakeFiles/directx12-tutorial-tests.dir/VertexQuantizationTests.cpp.o"
+  "CMakeFiles/directx12-tutorial-tests.dir/VertexQuantizationTests.cpp.o.d"
+  "directx12-tutorial-tests"
+  "directx12-tutorial-tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/directx12-tutorial-tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
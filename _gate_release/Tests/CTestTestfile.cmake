@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/Tests
+# Build directory: /root/repo/_gate_release/Tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+include("/root/repo/_gate_release/Tests/directx12-tutorial-tests[1]_include.cmake")
+include("/root/repo/_gate_release/Tests/directx12-tutorial-scalar-tests[1]_include.cmake")
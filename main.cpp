@@ -19,6 +19,7 @@ int CALLBACK main(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR lpCmdLine,
     }
 
     APPLICATION* application = APPLICATION::CreateInstance(hInstance);
+    application->ParseCommandLineArguments();
     {
         std::shared_ptr<TUTORIAL> demo = std::make_shared<TUTORIAL>(L"Learning DirectX 12 - Lesson 2", 1280, 720, false);
         retCode = application->Run(demo);